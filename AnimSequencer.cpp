@@ -0,0 +1,131 @@
+/**
+ * @file AnimSequencer.cpp
+ * @brief タイムラインテーブル駆動のアニメーションシーケンサの実装
+ * @details 仮想時間からステップ/位相を求め、表示するグループとフレームを決定します。
+ */
+#include "AnimSequencer.h"
+
+/**
+ * @brief タイムラインの再生を開始します。
+ * @param steps ステップ配列
+ * @param stepCount ステップ数
+ * @param tempos テンポ配列
+ * @param frameCount 1グループあたりのフレーム数
+ * @param nowMs 開始時刻(ms)
+ * @return なし
+ * @details 仮想時間・ループ回数・位相をすべて初期化します。frameCount が0の場合は1として扱います。
+ */
+void AnimSequencer::begin(const SeqStep* steps, std::size_t stepCount,
+                          const SeqTempo* tempos, std::size_t frameCount, std::uint32_t nowMs)
+{
+    steps_ = steps;
+    stepCount_ = stepCount;
+    tempos_ = tempos;
+    frameCount_ = frameCount == 0 ? 1 : frameCount;
+
+    lastNowMs_ = nowMs;
+    virtMs_ = 0;
+    virtRemUs_ = 0;
+    stepIdx_ = 0;
+    stepStartMs_ = 0;
+    phaseBase_ = 0;
+    for (auto& n : loopsDone_) n = 0;
+    finished_ = (steps_ == nullptr || stepCount_ == 0 || tempos_ == nullptr);
+}
+
+/**
+ * @brief ステップ内の経過時間から位相（フレーム*256）を求めます。
+ * @param st ステップ
+ * @param t ステップ開始からの経過時間(ms)
+ * @return 位相（下位8bitがフレーム内の端数）
+ * @details 速度が speedFrom→speedTo へ線形に変化するため、速度を時間で積分した値（台形の面積）を
+ *          フレーム周期で割って位相とします。 area = s0*t + (s1-s0)*t^2 / (2*D)
+ */
+std::uint64_t AnimSequencer::stepPhase(const SeqStep& st, std::uint32_t t) const
+{
+    const SeqTempo& tp = tempos_[st.tempo];
+    if (tp.frameMs == 0) return 0;
+
+    const std::int64_t s0 = st.speedFrom;
+    const std::int64_t s1 = st.speedTo;
+    const std::int64_t tt = t;
+    std::int64_t area = s0 * tt; ///< 速度(%)×時間(ms)
+    if (st.durationMs != 0 && s1 != s0) {
+        area += ((s1 - s0) * tt * tt) / (2 * static_cast<std::int64_t>(st.durationMs));
+    }
+    if (area <= 0) return 0;
+    return static_cast<std::uint64_t>(area) * 256u / (100u * tp.frameMs);
+}
+
+/**
+ * @brief 現在のステップを終え、次のステップ（またはループ先）へ進みます。
+ * @return なし
+ * @details ループ先へ戻る場合、ループ区間内のステップのループ回数はリセットされ、入れ子のループも再度実行されます。
+ *          ループ回数の記録は先頭16ステップまでで、それ以降のステップの loopTo は無限ループとして扱われます。
+ */
+void AnimSequencer::advanceStep()
+{
+    const SeqStep& st = steps_[stepIdx_];
+    const std::size_t maxTracked = sizeof(loopsDone_) / sizeof(loopsDone_[0]);
+    if (st.loopTo >= 0 && static_cast<std::size_t>(st.loopTo) <= stepIdx_) {
+        bool again = true;
+        if (st.loopCount != 0 && stepIdx_ < maxTracked) {
+            again = loopsDone_[stepIdx_] < st.loopCount;
+        }
+        if (again) {
+            if (stepIdx_ < maxTracked) loopsDone_[stepIdx_]++;
+            for (std::size_t k = static_cast<std::size_t>(st.loopTo); k < stepIdx_ && k < maxTracked; ++k) loopsDone_[k] = 0;
+            stepIdx_ = static_cast<std::size_t>(st.loopTo);
+            return;
+        }
+    }
+    if (++stepIdx_ >= stepCount_) finished_ = true;
+}
+
+/**
+ * @brief 時刻を進めて再生位置を返します。
+ * @param nowMs 現在時刻(ms)
+ * @return 再生位置
+ * @details 実時間の差分に時間倍率を掛けて仮想時間へ加算し（端数はµs単位で繰り越し）、
+ *          仮想時間がステップの長さを超えていればステップを進めます。
+ *          終端に達した後は最後に表示した位置と finished=true を返します。
+ */
+SeqPosition AnimSequencer::update(std::uint32_t nowMs)
+{
+    SeqPosition pos {};
+
+    // 仮想時間を進める（µs単位で端数を保持し、倍率による切り捨て誤差を蓄積させない）
+    const std::uint32_t dt = nowMs - lastNowMs_;
+    lastNowMs_ = nowMs;
+    const std::uint64_t scaledUs = static_cast<std::uint64_t>(dt) * timeScalePct_ * 10u + virtRemUs_;
+    virtMs_ += static_cast<std::uint32_t>(scaledUs / 1000u);
+    virtRemUs_ = static_cast<std::uint32_t>(scaledUs % 1000u);
+
+    std::uint64_t phase = phaseBase_;
+    while (!finished_) {
+        const SeqStep& st = steps_[stepIdx_];
+        const std::uint32_t local = virtMs_ - stepStartMs_;
+        if (st.durationMs != 0 && local >= st.durationMs) {
+            phaseBase_ += stepPhase(st, st.durationMs);
+            stepStartMs_ += st.durationMs;
+            advanceStep();
+            phase = phaseBase_;
+            continue;
+        }
+        phase = phaseBase_ + stepPhase(st, local);
+        break;
+    }
+
+    const std::size_t idx = stepIdx_ < stepCount_ ? stepIdx_ : stepCount_ - 1;
+    if (steps_ && stepCount_ > 0) {
+        pos.group = steps_[idx].group;
+        pos.tempo = steps_[idx].tempo;
+    }
+    const std::uint64_t frameAbs = phase >> 8;
+    pos.frame = static_cast<std::size_t>(frameAbs % frameCount_);
+    pos.prevFrame = frameAbs == 0 ? pos.frame : static_cast<std::size_t>((frameAbs - 1) % frameCount_);
+    pos.fraction = static_cast<std::uint8_t>(phase & 0xFF);
+    pos.isBlend = tempos_ && pos.fraction < tempos_[pos.tempo].blendFrac;
+    pos.finished = finished_;
+    return pos;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file AnimSequencer.h
+ * @brief タイムラインテーブル駆動のアニメーションシーケンサ
+ * @details 経過時間から再生位置（グループ/フレーム/フレーム内位相）を算出するクラスのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief テンポ（1フレームの表示時間と遷移フレームの割合）。
+ * @details キャラクタごとに歩き/走りなどのテンポを配列で与え、タイムラインのステップから番号で参照します。
+ */
+struct SeqTempo {
+    std::uint16_t frameMs;   ///< 等速時の1フレームの周期(ms)
+    std::uint8_t blendFrac;  ///< 周期のうち、前フレームと重ねた遷移表示を行う割合(0..255)
+};
+
+/**
+ * @brief タイムラインの1ステップ。
+ * @details durationMs の間、group のパターンを tempo の速さで再生します。
+ *          速度は speedFrom→speedTo へ線形に変化します（100=等速）。
+ *          終端に達したとき loopTo>=0 なら loopCount 回までそのステップへ戻ります（loopCount=0 は無限）。
+ */
+struct SeqStep {
+    std::uint8_t group;       ///< パターングループ番号
+    std::uint8_t tempo;       ///< SeqTempo 配列のインデックス
+    std::uint16_t speedFrom;  ///< 開始時の速度(%)
+    std::uint16_t speedTo;    ///< 終了時の速度(%)
+    std::int8_t loopTo;       ///< ループ先ステップ（-1でループなし）
+    std::uint8_t loopCount;   ///< ループ回数（0で無限）
+    std::uint32_t durationMs; ///< ステップの長さ(ms)。0なら終端なし
+};
+
+/**
+ * @brief 再生位置。
+ */
+struct SeqPosition {
+    std::uint8_t group;       ///< 表示するパターングループ
+    std::uint8_t tempo;       ///< 現在のテンポ番号
+    std::size_t frame;        ///< 表示するフレーム番号
+    std::size_t prevFrame;    ///< 一つ前のフレーム番号
+    std::uint8_t fraction;    ///< フレーム内の位相(0..255)
+    bool isBlend;             ///< 遷移表示（前フレームと重ねる）区間ならtrue
+    bool finished;            ///< タイムライン終端に達したらtrue
+};
+
+/**
+ * @brief タイムラインテーブルを経過時間で再生するシーケンサ。
+ * @details
+ * - ループの反復回数ではなく、経過時間から再生位置を算出します。描画の頻度とアニメーションの速度は独立しています。
+ * - 再生位置はフレーム単位の固定小数点（下位8bitが端数）で保持します。
+ * - 時間倍率（スローモーション）は再生中にも変更できます。
+ * - ハードウェアに依存しないため、ホスト上で仮想時計を与えて動作させることができます。
+ */
+class AnimSequencer {
+public:
+    AnimSequencer() {}
+
+    /**
+     * @brief タイムラインの再生を開始します。
+     * @param steps ステップ配列
+     * @param stepCount ステップ数
+     * @param tempos テンポ配列
+     * @param frameCount 1グループあたりのフレーム数
+     * @param nowMs 開始時刻(ms)
+     * @return なし
+     */
+    void begin(const SeqStep* steps, std::size_t stepCount,
+               const SeqTempo* tempos, std::size_t frameCount, std::uint32_t nowMs);
+
+    /**
+     * @brief 時刻を進めて再生位置を返します。
+     * @param nowMs 現在時刻(ms)
+     * @return 再生位置
+     * @details 前回呼び出しからの経過時間に時間倍率を掛けて仮想時間を進め、仮想時間から位置を求めます。
+     */
+    SeqPosition update(std::uint32_t nowMs);
+
+    /**
+     * @brief 時間倍率を設定します。
+     * @param percent 倍率(%)。100で等速、50で1/2速
+     * @return なし
+     */
+    void setTimeScale(std::uint16_t percent) { timeScalePct_ = percent; }
+
+    /** @brief 再生開始からの仮想経過時間(ms)を返します。 */
+    inline std::uint32_t elapsedMs() const { return virtMs_; }
+
+private:
+    std::uint64_t stepPhase(const SeqStep& st, std::uint32_t t) const;
+    void advanceStep();
+
+    const SeqStep* steps_ { nullptr };   ///< タイムライン
+    std::size_t stepCount_ { 0 };        ///< ステップ数
+    const SeqTempo* tempos_ { nullptr }; ///< テンポ表
+    std::size_t frameCount_ { 1 };       ///< フレーム数
+
+    std::uint32_t lastNowMs_ { 0 };      ///< 前回の実時刻
+    std::uint32_t virtMs_ { 0 };         ///< 仮想経過時間
+    std::uint32_t virtRemUs_ { 0 };      ///< 時間倍率の端数（切り捨て誤差の繰越）
+    std::uint16_t timeScalePct_ { 100 }; ///< 時間倍率(%)
+
+    std::size_t stepIdx_ { 0 };          ///< 現在のステップ
+    std::uint32_t stepStartMs_ { 0 };    ///< 現在のステップの開始時刻（仮想時間）
+    std::uint64_t phaseBase_ { 0 };      ///< 現在のステップ開始時点の位相（フレーム*256）
+    std::uint8_t loopsDone_[16] {};      ///< ステップごとのループ済み回数
+    bool finished_ { false };            ///< 終端到達
+};
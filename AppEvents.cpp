@@ -0,0 +1,224 @@
+/**
+ * @file AppEvents.cpp
+ * @brief ボタン/タイマーの割り込みをイベントキューへ集約するモジュールの実装
+ * @details
+ * - GPIOは両エッジ割り込みを受け、Debouncer が求めた時刻にアラームでレベルを確認します（ポーリングなし）。
+ * - タイマーはSDKのアラームで実装し、満了をイベントとして積みます。割り込みからアプリの状態は変更しません。
+ * - GPIO割り込みとアラーム割り込みは同一コア・同一優先度で動作するため互いに割り込まず、キューの生産者は実質1つです。
+ */
+#include "AppEvents.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h" // __sev / __wfe
+#include "Debouncer.h"
+#include "TraceRecorder.h"
+
+namespace {
+    /** @brief 登録済みボタン。 */
+    struct ButtonSlot {
+        bool used = false;   ///< 使用中
+        uint pin = 0;        ///< GPIO番号
+        Debouncer deb;       ///< デバウンス判定
+        volatile std::uint64_t waitEdgeUs = 0;  ///< 安定待ちを始めたエッジの時刻(µs)
+        volatile std::uint64_t pressEdgeUs = 0; ///< 直近の押下を始めたエッジの時刻(µs)
+    };
+
+    /** @brief タイマーの状態。 */
+    struct TimerSlot {
+        alarm_id_t alarm = 0;           ///< 動作中のアラーム（0で無し）
+        std::uint32_t periodMs = 0;     ///< 繰り返し周期（0で単発）
+        volatile bool active = false;   ///< 動作中
+        volatile bool queued = false;   ///< 未処理のイベントがキューにある
+        volatile std::uint8_t gen = 0;  ///< 再始動/停止ごとに進める世代番号（古いイベントの破棄用）
+    };
+
+    EventQueue<16> s_queue;             ///< 割り込み→メインループのイベント
+    ButtonSlot s_buttons[4];            ///< ボタン（最大4本）
+    TimerSlot s_timers[TIMER_COUNT];    ///< タイマー
+
+    inline std::uint32_t now_ms() { return to_ms_since_boot(get_absolute_time()); }
+
+    /**
+     * @brief イベントをキューに積み、WFE中のメインループを起こします。
+     * @param type 種類
+     * @param id GPIO番号/タイマー番号
+     * @param gen 世代番号
+     */
+    inline void post(std::uint8_t type, std::uint8_t id, std::uint8_t gen)
+    {
+        AppEvent ev { type, id, gen, now_ms() };
+        if (s_queue.push(ev)) __sev();
+    }
+
+    /**
+     * @brief デバウンス確認用アラームのコールバック（割り込みコンテキスト）。
+     * @return 待ち直しが必要なら負の再スケジュール時間(µs)、不要なら0
+     */
+    int64_t debounce_alarm_cb(alarm_id_t id, void* user_data)
+    {
+        (void)id;
+        ButtonSlot* b = static_cast<ButtonSlot*>(user_data);
+        std::uint32_t retryMs = 0;
+        if (b->deb.onTimer(gpio_get(b->pin), now_ms(), retryMs)) {
+            b->pressEdgeUs = b->waitEdgeUs;
+            post(EVT_BUTTON, static_cast<std::uint8_t>(b->pin), 0);
+        }
+        return retryMs ? -static_cast<int64_t>(retryMs) * 1000 : 0; // 負値: 今から retryMs 後に再実行
+    }
+
+    /**
+     * @brief GPIOエッジ割り込みのコールバック。
+     * @details 安定待ちのアラームが無ければ起動し、そのエッジの時刻（µs）を押下の開始として覚えます。待機中ならエッジ時刻の更新のみ。
+     */
+    void gpio_edge_cb(uint gpio, uint32_t events)
+    {
+        (void)events;
+        for (auto& b : s_buttons) {
+            if (!b.used || b.pin != gpio) continue;
+            if (b.deb.onEdge(now_ms())) {
+                b.waitEdgeUs = time_us_64();
+                if (add_alarm_in_ms(b.deb.settleMs(), debounce_alarm_cb, &b, true) < 0) {
+                    b.deb.reset(b.deb.level()); // アラーム不足時は待機を解除し、次のエッジで再試行
+                }
+            }
+            break;
+        }
+    }
+
+    /**
+     * @brief イベントタイマーのコールバック（割り込みコンテキスト）。
+     * @return 繰り返しなら周期(µs、前回の予定時刻基準)、単発なら0
+     */
+    int64_t timer_alarm_cb(alarm_id_t id, void* user_data)
+    {
+        (void)id;
+        const std::uint8_t tid = static_cast<std::uint8_t>(reinterpret_cast<std::uintptr_t>(user_data));
+        TimerSlot& t = s_timers[tid];
+        if (!t.active) return 0;
+        if (!t.queued) {
+            t.queued = true;
+            post(EVT_TIMER, tid, t.gen);
+        }
+        if (t.periodMs != 0) return static_cast<int64_t>(t.periodMs) * 1000;
+        t.active = false;
+        t.alarm = 0;
+        return 0;
+    }
+}
+
+/**
+ * @brief デバウンス付きのボタン入力を登録します。
+ * @param gpio_pin 対象GPIO
+ * @return 登録できればtrue
+ */
+bool events_add_button(uint gpio_pin)
+{
+    for (auto& b : s_buttons) {
+        if (b.used) continue;
+        b.used = true;
+        b.pin = gpio_pin;
+        b.deb.reset(gpio_get(gpio_pin));
+        gpio_set_irq_enabled_with_callback(gpio_pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &gpio_edge_cb);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 直近の押下を始めたエッジの時刻を返します。
+ * @param gpio_pin 対象GPIO
+ * @return 時刻(µs、time_us_64)。未登録または押下がまだなければ0
+ * @details 押下が確定するまで値は変わらないので、EVT_BUTTON を取り出した後に読めばその押下のエッジです。
+ */
+std::uint64_t events_button_edge_us(uint gpio_pin)
+{
+    for (const auto& b : s_buttons) {
+        if (b.used && b.pin == gpio_pin) return b.pressEdgeUs;
+    }
+    return 0;
+}
+
+/**
+ * @brief タイマーを開始します。
+ * @param id タイマー番号
+ * @param ms 満了までの時間(ms)
+ * @param repeat 繰り返し
+ * @return 開始できればtrue
+ * @details 動作中のアラームを止めて世代番号を進めるため、再始動前に積まれたイベントは events_poll() で破棄されます。
+ */
+bool events_start_timer(std::uint8_t id, std::uint32_t ms, bool repeat)
+{
+    if (id >= TIMER_COUNT) return false;
+    events_cancel_timer(id);
+    TimerSlot& t = s_timers[id];
+    t.periodMs = repeat ? ms : 0;
+    t.active = true;
+    alarm_id_t a = add_alarm_in_ms(ms, timer_alarm_cb, reinterpret_cast<void*>(static_cast<std::uintptr_t>(id)), true);
+    if (a < 0) {
+        t.active = false;
+        return false;
+    }
+    if (t.active) t.alarm = a;
+    return true;
+}
+
+/**
+ * @brief タイマーを停止します。
+ * @param id タイマー番号
+ * @return なし
+ */
+void events_cancel_timer(std::uint8_t id)
+{
+    if (id >= TIMER_COUNT) return;
+    TimerSlot& t = s_timers[id];
+    t.active = false;
+    if (t.alarm > 0) cancel_alarm(t.alarm);
+    t.alarm = 0;
+    t.gen = (std::uint8_t)(t.gen + 1); // volatile への ++ は C++20 で非推奨
+    t.queued = false;
+}
+
+/**
+ * @brief イベントを1つ取り出します（待たない）。
+ * @param ev [out] イベント
+ * @return 取り出せればtrue
+ * @details 停止/再始動済みのタイマーが残したイベントは読み捨てます。
+ */
+bool events_poll(AppEvent& ev)
+{
+    while (s_queue.pop(ev)) {
+        if (ev.type != EVT_TIMER) return true;
+        if (ev.id >= TIMER_COUNT) continue;
+        TimerSlot& t = s_timers[ev.id];
+        if (ev.gen != t.gen) continue;
+        t.queued = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief イベントが来るまで待ちます。
+ * @param ev [out] イベント
+ * @return なし
+ * @details 取り出しに失敗してから WFE するまでの間に積まれたイベントも、SEV によるイベントレジスタで取りこぼしません。
+ */
+void events_wait(AppEvent& ev)
+{
+    LGM_TRACE_SCOPE_NAMED(trace, TRACE_WAIT);
+    while (!events_poll(ev)) {
+        __wfe();
+    }
+    LGM_TRACE_SET_ARGS(trace, ev.type, ev.id);
+}
+
+/**
+ * @brief 未処理のイベントをすべて破棄します。
+ * @return なし
+ */
+void events_flush()
+{
+    AppEvent ev;
+    while (s_queue.pop(ev)) {
+        if (ev.type == EVT_TIMER && ev.id < TIMER_COUNT && ev.gen == s_timers[ev.id].gen) s_timers[ev.id].queued = false;
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file AppEvents.h
+ * @brief ボタン/タイマーの割り込みをイベントキューへ集約するモジュール
+ * @details GPIOエッジ割り込み＋アラームでデバウンスしたボタン押下と、タイマー満了をキューへ積みます。
+ *          メインループは events_wait() でイベントを取り出し、空の間は WFE で休止します。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pico/stdlib.h"
+#include "EventQueue.h"
+
+/**
+ * @brief アプリで使用するタイマー番号。
+ */
+enum TIMER_ID : std::uint8_t {
+    TIMER_CORO = 0, ///< スクリプト（CoroScheduler）の次の期限（遅延/フレーム/無操作タイムアウトの最も早いもの）
+    TIMER_COUNT
+};
+
+/**
+ * @brief デバウンス付きのボタン入力を登録します。
+ * @param gpio_pin 対象GPIO（プルアップ入力として初期化済みであること）
+ * @return 登録できればtrue（上限4本）
+ * @details 両エッジで割り込みを受け、最後のエッジから30ms安定した時点で押下（Active-Low）を EVT_BUTTON として通知します。
+ */
+bool events_add_button(uint gpio_pin);
+
+/**
+ * @brief 直近の押下を始めたエッジ（デバウンス前の最初のエッジ）の時刻を返します。
+ * @param gpio_pin 対象GPIO
+ * @return 時刻(µs、time_us_64)。未登録または押下がまだなければ0
+ * @details GPIO割り込みで記録します。EVT_BUTTON の timeMs はデバウンス後（最後のエッジから30ms後）の時刻です。
+ */
+std::uint64_t events_button_edge_us(uint gpio_pin);
+
+/**
+ * @brief タイマーを開始します。
+ * @param id タイマー番号
+ * @param ms 満了までの時間(ms)
+ * @param repeat true なら ms 周期で繰り返す
+ * @return 開始できればtrue
+ * @details 既に動作中なら再始動します。満了すると EVT_TIMER を通知します。
+ *          未処理の同じタイマーのイベントがキューに残っている間は、次の満了を積みません（取りこぼしより合流を優先）。
+ */
+bool events_start_timer(std::uint8_t id, std::uint32_t ms, bool repeat);
+
+/**
+ * @brief タイマーを停止します。
+ * @param id タイマー番号
+ * @return なし
+ */
+void events_cancel_timer(std::uint8_t id);
+
+/**
+ * @brief イベントを1つ取り出します（待たない）。
+ * @param ev [out] イベント
+ * @return 取り出せればtrue
+ */
+bool events_poll(AppEvent& ev);
+
+/**
+ * @brief イベントが来るまで待ちます。
+ * @param ev [out] イベント
+ * @return なし
+ * @details キューが空の間は WFE でコアを休止します。割り込みハンドラはイベント追加後に SEV で起床させます。
+ */
+void events_wait(AppEvent& ev);
+
+/**
+ * @brief 未処理のイベントをすべて破棄します。
+ * @return なし
+ */
+void events_flush();
@@ -0,0 +1,55 @@
+/**
+ * @file BootFrame.h
+ * @brief 起動直後に表示する、送出順に並べ済みのフレーム（フラッシュに置く）
+ * @details 停止表示の描画（DrawBuffer）と送出データへの変換（WS2812::EncodeWire）を constexpr で行い、
+ *          起動時はパターンの処理もVRAMも使わずに、フラッシュの語列をそのままDMAで送出します。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define BOOT_FRAME_WIDTH 16             ///< 起動フレームの幅（WS2812 の VRAM と同じ）
+#define BOOT_FRAME_HEIGHT 16            ///< 起動フレームの高さ
+#define BOOT_FRAME_SERPENTINE true      ///< 千鳥配線（FrameRender の送出と同じ）
+#define BOOT_FRAME_LEFT_TO_RIGHT false  ///< 偶数行の基準方向（FrameRender の送出と同じ）
+#define BOOT_FRAME_COLOR_REPLACE 0x000700u ///< 置換色（drawStopFrame で isColorReplace のキャラクタに使う色）
+
+namespace bootframe {
+
+/**
+ * @brief 送出順の語列（1ピクセル = c<<8）。
+ */
+template <std::size_t W, std::size_t H>
+struct Wire {
+    std::uint32_t data[W * H];
+};
+
+/**
+ * @brief パターンを描画して送出順の語列にした結果を作成します。
+ * @param pattern パターン（W*H 画素、0x00GGRRBB）
+ * @param colorReplace 置換色（0で無効）
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return 語列
+ * @details VRAM が W x H の1枚のパネルで、DrawBuffer(pattern, W, H, 0, 0, colorReplace, false) の後に
+ *          EncodeWire(serpentine, leftToRight) した結果と同じです。constexpr 変数の初期化に使うとフラッシュに置かれます。
+ */
+template <std::size_t W, std::size_t H, std::size_t N>
+constexpr Wire<W, H> encode(const std::uint32_t (&pattern)[N], std::uint32_t colorReplace, bool serpentine, bool leftToRight)
+{
+    static_assert(N == W * H, "pattern size must match the frame");
+    Wire<W, H> out {};
+    std::size_t i = 0;
+    for (std::size_t y = 0; y < H; ++y) {
+        const bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+        for (std::size_t k = 0; k < W; ++k) {
+            const std::uint32_t c = pattern[y * W + (l2r ? k : W - 1 - k)];
+            out.data[i++] = ((c != 0 && colorReplace != 0) ? colorReplace : c) << 8;
+        }
+    }
+    return out;
+}
+
+} // namespace bootframe
@@ -0,0 +1,56 @@
+/**
+ * @file BootTimeline.cpp
+ * @brief 起動から最初の表示までの各段階の時刻の記録の実装
+ */
+#include <cstdio>
+#include <cstring>
+#include "BootTimeline.h"
+
+/**
+ * @brief 段階の時刻を記録します。
+ * @param name 段階の名前
+ * @param nowUs リセットからの時刻(µs)
+ * @return 記録できたらtrue
+ */
+bool BootTimeline::mark(const char* name, std::uint64_t nowUs)
+{
+    if (printed_ || count_ >= BOOT_TIMELINE_MAX) return false;
+    stages_[count_].name = name;
+    stages_[count_].us = nowUs;
+    count_++;
+    return true;
+}
+
+/**
+ * @brief 記録を出力します（1回だけ）。
+ * @return 出力したらtrue
+ */
+bool BootTimeline::print()
+{
+    if (printed_) return false;
+    printed_ = true;
+    std::uint64_t prev = 0;
+    for (std::size_t i = 0; i < count_; i++) {
+        std::printf("[boot] %-16s %8llu us (+%llu)\n", stages_[i].name, (unsigned long long)stages_[i].us,
+                    (unsigned long long)(stages_[i].us - prev));
+        prev = stages_[i].us;
+    }
+    return true;
+}
+
+/**
+ * @brief 名前で段階の時刻を探します。
+ * @param name 名前
+ * @param us [out] 時刻
+ * @return 見つかればtrue
+ */
+bool BootTimeline::find(const char* name, std::uint64_t& us) const
+{
+    for (std::size_t i = 0; i < count_; i++) {
+        if (std::strcmp(stages_[i].name, name) == 0) {
+            us = stages_[i].us;
+            return true;
+        }
+    }
+    return false;
+}
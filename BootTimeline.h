@@ -0,0 +1,56 @@
+/**
+ * @file BootTimeline.h
+ * @brief 起動（リセット）から最初の表示までの各段階の時刻の記録
+ * @details 時刻は呼び出し側が与える（time_us_64 はリセットからの時間）ため、ホスト上でも同じ記録と出力ができます。
+ *          stdio の初期化より前の段階も記録しておき、最初のキャラクタを表示した後にまとめて出力します。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define BOOT_TIMELINE_MAX 12 ///< 記録できる段階の数
+
+/**
+ * @brief 起動の段階。
+ */
+struct BootStage {
+    const char* name;  ///< 段階の名前（文字列リテラル）
+    std::uint64_t us;  ///< リセットからの時刻(µs)
+};
+
+/**
+ * @brief 起動の各段階の時刻を記録するクラス。
+ */
+class BootTimeline {
+public:
+    BootTimeline() {}
+
+    /**
+     * @brief 段階の時刻を記録します。
+     * @param name 段階の名前（文字列リテラル。ポインタのみ保持）
+     * @param nowUs リセットからの時刻(µs)
+     * @return 記録できたらtrue（BOOT_TIMELINE_MAX を超えた分と、出力後は記録しない）
+     */
+    bool mark(const char* name, std::uint64_t nowUs);
+
+    /**
+     * @brief 記録を出力します（1回だけ）。
+     * @return 出力したらtrue（出力済みなら false）
+     * @details 1行に1段階、リセットからの時刻と前の段階からの差を printf で出力します。
+     */
+    bool print();
+
+    /** @brief 記録した段階の数。 @return 段階の数 */
+    std::size_t count() const { return count_; }
+    /** @brief 記録した段階。 @param i 番号 @return 段階 */
+    const BootStage& stage(std::size_t i) const { return stages_[i]; }
+    /** @brief 名前で段階の時刻を探します。 @param name 名前 @param us [out] 時刻 @return 見つかればtrue */
+    bool find(const char* name, std::uint64_t& us) const;
+
+private:
+    BootStage stages_[BOOT_TIMELINE_MAX] {};
+    std::size_t count_ { 0 };
+    bool printed_ { false };
+};
@@ -0,0 +1,201 @@
+/**
+ * @file ColorPipeline.h
+ * @brief 色補正（レンジ/ガンマ/明度/コントラスト）の constexpr 実装
+ * @details PatManager の実行時補正と、ビルド時にフラッシュへ焼き込む補正済みパターンで同じLUTを使うためのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace colorpipe {
+
+/**
+ * @brief キャラクタの色補正設定。
+ * @details 項目と既定値の意味は Patterns のフィールドと同じです（レンジの min/max が両方0なら補正なし等）。
+ */
+struct Correction {
+    std::uint8_t gMin, gMax;  ///< 緑レンジ
+    std::uint8_t rMin, rMax;  ///< 赤レンジ
+    std::uint8_t bMin, bMax;  ///< 青レンジ
+    float gamma;              ///< ガンマ（0以下または1.0なら補正なし）
+    std::uint8_t brightness;  ///< 明度(%)
+    std::uint8_t contrast;    ///< コントラスト(%)
+};
+
+/** @brief 256要素のLUT。 */
+struct Lut {
+    std::uint8_t v[256];
+};
+
+/**
+ * @brief 補正済みパターン（Count枚 × Pixels画素）。
+ * @details constexpr で作成してフラッシュに置くための入れ物です。
+ */
+template <std::size_t Count, std::size_t Pixels>
+struct Frames {
+    std::uint32_t data[Count][Pixels];
+};
+
+/**
+ * @brief 整数の割り算を四捨五入します（0から遠い方へ丸め）。
+ * @param n 分子
+ * @param d 分母(>0)
+ * @return 丸めた商
+ */
+constexpr int div_round(int n, int d)
+{
+    return n >= 0 ? (n + d / 2) / d : -((-n + d / 2) / d);
+}
+
+/** @brief 0..255 にクリップします。 */
+constexpr std::uint8_t clip_u8(int v)
+{
+    return v < 0 ? 0 : (v > 255 ? 255 : static_cast<std::uint8_t>(v));
+}
+
+/**
+ * @brief チャネルレンジ圧縮用のLUTを作成します。
+ * @param minV 出力最小値
+ * @param maxV 出力最大値
+ * @return LUT
+ * @details v' = min + round((max-min) * v / 255)。v==0（黒）は0を維持します。
+ *          2*span*v は偶数、255*(2k+1) は奇数なので、ちょうど .5 になる入力はなく、浮動小数点の lround と一致します。
+ */
+constexpr Lut range_lut(std::uint8_t minV, std::uint8_t maxV)
+{
+    Lut lut {};
+    const int span = static_cast<int>(maxV) - static_cast<int>(minV);
+    for (int v = 1; v <= 255; ++v) {
+        lut.v[v] = clip_u8(static_cast<int>(minV) + div_round(span * v, 255));
+    }
+    return lut;
+}
+
+/**
+ * @brief 明度/コントラスト補正用の合成LUTを作成します。
+ * @param brightnessPercent 明度(-100..100)
+ * @param contrastPercent コントラスト(-100..100)
+ * @return LUT
+ * @details v' = round((v - 128) * (100 + c) / 100 + 128) + round(255 * b / 100)。範囲外はクリップします。
+ *          百分率のまま整数で計算するため、コンパイル時と実行時（FMAの有無に関わらず）で結果が一致します。
+ *          以前の浮動小数点のLUT（係数 1+c/100 を float で掛ける）とは、(v-128)*(100+c)/100 がちょうど .5 になる所だけ、
+ *          float の誤差で丸めが変わっていた分が 1 違います（40401 組のうち FMA なしで 534 組、FMA ありで 3338 組。bench のテスト baked で確認）。
+ *          出荷しているキャラクタは明度/コントラストを使わないため、表示は変わりません。
+ */
+constexpr Lut bc_lut(int brightnessPercent, int contrastPercent)
+{
+    if (brightnessPercent < -100) brightnessPercent = -100;
+    if (brightnessPercent > 100)  brightnessPercent = 100;
+    if (contrastPercent < -100)   contrastPercent = -100;
+    if (contrastPercent > 100)    contrastPercent = 100;
+
+    Lut lut {};
+    const int add = div_round(255 * brightnessPercent, 100);
+    for (int v = 0; v <= 255; ++v) {
+        lut.v[v] = clip_u8(div_round((v - 128) * (100 + contrastPercent) + 12800, 100) + add);
+    }
+    return lut;
+}
+
+/** @brief ガンマが補正なし（0以下または1.0）ならtrue。 */
+constexpr bool gamma_is_identity(float gamma)
+{
+    return gamma <= 0.0f || gamma == 1.0f;
+}
+
+/** @brief 補正なし（すべての段が素通し）ならtrue。 */
+constexpr bool is_identity(const Correction& c)
+{
+    return c.gMin == 0 && c.gMax == 0 && c.rMin == 0 && c.rMax == 0 && c.bMin == 0 && c.bMax == 0 &&
+           gamma_is_identity(c.gamma) && c.brightness == 0 && c.contrast == 0;
+}
+
+/**
+ * @brief 1ピクセル(0x00GGRRBB)に補正を適用します。
+ * @param px 入力ピクセル
+ * @param c 補正設定
+ * @param lutG/lutR/lutB 各チャネルのレンジLUT
+ * @param lutBC 明度/コントラストLUT
+ * @return 補正済みピクセル
+ * @details 適用順は Patterns::setPatManager と同じ（緑→赤→青レンジ→ガンマ→明度/コントラスト）です。
+ */
+constexpr std::uint32_t apply(std::uint32_t px, const Correction& c,
+                              const Lut& lutG, const Lut& lutR, const Lut& lutB, const Lut& lutBC)
+{
+    std::uint8_t g = static_cast<std::uint8_t>((px >> 16) & 0xFF);
+    std::uint8_t r = static_cast<std::uint8_t>((px >> 8) & 0xFF);
+    std::uint8_t b = static_cast<std::uint8_t>(px & 0xFF);
+    if (c.gMin != 0 || c.gMax != 0) g = lutG.v[g];
+    if (c.rMin != 0 || c.rMax != 0) r = lutR.v[r];
+    if (c.bMin != 0 || c.bMax != 0) b = lutB.v[b];
+    if (c.brightness != 0 || c.contrast != 0) {
+        g = lutBC.v[g];
+        r = lutBC.v[r];
+        b = lutBC.v[b];
+    }
+    return (static_cast<std::uint32_t>(g) << 16) | (static_cast<std::uint32_t>(r) << 8) | b;
+}
+
+/**
+ * @brief ガンマ補正をコンパイル時に行えない場合に呼ばれる（定数式でなくなりコンパイルエラーになる）。
+ * @details std::pow は constexpr でないため、焼き込みは補正なしのガンマ（1.0）に限ります。
+ */
+inline void bake_requires_identity_gamma() {}
+
+/**
+ * @brief パターン群に補正を適用した結果を作成します。
+ * @param src 元パターン（Count枚 × Pixels画素）
+ * @param c 補正設定
+ * @return 補正済みパターン
+ * @details constexpr 変数の初期化に使うと、補正済みパターンがフラッシュに置かれ、実行時の処理とRAMが不要になります。
+ */
+template <std::size_t Count, std::size_t Pixels>
+constexpr Frames<Count, Pixels> bake(const std::uint32_t (&src)[Count][Pixels], const Correction& c)
+{
+    if (!gamma_is_identity(c.gamma)) bake_requires_identity_gamma();
+    const Lut lutG = range_lut(c.gMin, c.gMax);
+    const Lut lutR = range_lut(c.rMin, c.rMax);
+    const Lut lutB = range_lut(c.bMin, c.bMax);
+    const Lut lutBC = bc_lut(c.brightness, c.contrast);
+    Frames<Count, Pixels> out {};
+    for (std::size_t i = 0; i < Count; ++i) {
+        for (std::size_t p = 0; p < Pixels; ++p) {
+            out.data[i][p] = apply(src[i][p], c, lutG, lutR, lutB, lutBC);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief 1枚のパターンに補正を適用した結果を作成します。
+ * @param src 元パターン（Pixels画素）
+ * @param c 補正設定
+ * @return 補正済みパターン（1枚）
+ */
+template <std::size_t Pixels>
+constexpr Frames<1, Pixels> bake(const std::uint32_t (&src)[Pixels], const Correction& c)
+{
+    if (!gamma_is_identity(c.gamma)) bake_requires_identity_gamma();
+    const Lut lutG = range_lut(c.gMin, c.gMax);
+    const Lut lutR = range_lut(c.rMin, c.rMax);
+    const Lut lutB = range_lut(c.bMin, c.bMax);
+    const Lut lutBC = bc_lut(c.brightness, c.contrast);
+    Frames<1, Pixels> out {};
+    for (std::size_t p = 0; p < Pixels; ++p) {
+        out.data[0][p] = apply(src[p], c, lutG, lutR, lutB, lutBC);
+    }
+    return out;
+}
+
+// LUT の検算（手で求めた値。以前の浮動小数点のLUTとの全組の比較は bench のテスト baked）
+static_assert(range_lut(0, 16).v[0] == 0, "black must stay black");
+static_assert(range_lut(0, 16).v[1] == 0 && range_lut(0, 16).v[8] == 1 && range_lut(0, 16).v[128] == 8, "range rounding");
+static_assert(range_lut(0, 16).v[255] == 16 && range_lut(10, 20).v[255] == 20, "range max");
+static_assert(range_lut(20, 10).v[255] == 10 && range_lut(20, 10).v[128] == 15, "inverted range");
+static_assert(bc_lut(0, 0).v[0] == 0 && bc_lut(0, 0).v[200] == 200, "identity b/c");
+static_assert(bc_lut(0, 50).v[129] == 130 && bc_lut(0, 50).v[127] == 127, "contrast rounds half away from zero");
+static_assert(bc_lut(10, 0).v[100] == 126 && bc_lut(-10, 0).v[10] == 0, "brightness add and clip");
+
+} // namespace colorpipe
@@ -0,0 +1,329 @@
+/**
+ * @file CoroScheduler.cpp
+ * @brief C++20 コルーチンの協調スケジューラとフレームプールの実装
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。
+ */
+
+#include "CoroScheduler.h"
+
+static_assert(CORO_FRAME_COUNT >= 1 && CORO_FRAME_COUNT <= 32, "CORO_FRAME_COUNT must be 1..32");
+static_assert(CORO_FRAME_BYTES % alignof(std::max_align_t) == 0, "CORO_FRAME_BYTES must keep blocks aligned");
+
+namespace {
+
+alignas(std::max_align_t) std::uint8_t s_frames[CORO_FRAME_COUNT][CORO_FRAME_BYTES]; ///< フレームプール
+std::uint32_t s_usedMask = 0;   ///< 使用中のブロック（bit i = ブロック i）
+CoroPoolStats s_stats {};       ///< 統計
+CoroScheduler* s_current = nullptr; ///< run() の中で実行中のスケジューラ
+
+/** @brief 期限が来ていればtrue（32bit の一周をまたいでも差で比べる）。 */
+inline bool due(std::uint32_t dueMs, std::uint32_t nowMs)
+{
+    return (std::int32_t)(nowMs - dueMs) >= 0;
+}
+
+} // namespace
+
+/**
+ * @brief フレームをプールから確保します。
+ * @param bytes 大きさ
+ * @return 先頭（確保できなければ nullptr）
+ */
+void* coro_frame_alloc(std::size_t bytes) noexcept
+{
+    if (bytes > s_stats.maxBytes) s_stats.maxBytes = bytes;
+    if (bytes <= CORO_FRAME_BYTES) {
+        for (std::uint32_t i = 0; i < CORO_FRAME_COUNT; i++) {
+            if ((s_usedMask & (1u << i)) == 0) {
+                s_usedMask |= 1u << i;
+                if (++s_stats.used > s_stats.peak) s_stats.peak = s_stats.used;
+                return s_frames[i];
+            }
+        }
+    }
+    s_stats.failures++;
+    return nullptr;
+}
+
+/**
+ * @brief フレームをプールへ戻します。
+ * @param p coro_frame_alloc() の戻り値
+ * @return なし
+ */
+void coro_frame_free(void* p) noexcept
+{
+    if (p == nullptr) return;
+    const std::size_t i = (std::size_t)((std::uint8_t*)p - &s_frames[0][0]) / CORO_FRAME_BYTES;
+    if (i < CORO_FRAME_COUNT && (s_usedMask & (1u << i)) != 0) {
+        s_usedMask &= ~(1u << i);
+        s_stats.used--;
+    }
+}
+
+/**
+ * @brief フレームプールの統計。
+ * @return 統計
+ */
+const CoroPoolStats& coro_pool_stats()
+{
+    return s_stats;
+}
+
+CoroScheduler::~CoroScheduler()
+{
+    for (Slot& s : slots_) {
+        if (s.root) release(s);
+    }
+}
+
+/**
+ * @brief run() の中で実行中のスケジューラ。
+ * @return スケジューラ（run() の外は nullptr）
+ */
+CoroScheduler* CoroScheduler::current()
+{
+    return s_current;
+}
+
+/**
+ * @brief スクリプトを登録します。
+ * @param task スクリプト
+ * @param id [out] 番号
+ * @return 登録できればtrue
+ */
+bool CoroScheduler::spawn(CoroTask&& task, std::uint8_t* id)
+{
+    if (!task.valid()) return false;
+    for (std::uint8_t i = 0; i < CORO_MAX_TASKS; i++) {
+        Slot& s = slots_[i];
+        if (s.root) continue;
+        s = Slot {};
+        s.root = task.release();
+        s.resume = s.root;
+        s.wait = CORO_READY;
+        if (id) *id = i;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief スロットを空にし、スクリプトを破棄します。
+ * @param s スロット
+ * @return なし
+ */
+void CoroScheduler::release(Slot& s)
+{
+    std::coroutine_handle<> root = s.root;
+    s = Slot {};
+    root.destroy(); // 待っている子は、root のフレームにある CoroTask の破棄でまとめて破棄される
+}
+
+/**
+ * @brief スクリプトを止めて破棄します。
+ * @param id spawn() の番号
+ * @return なし
+ */
+void CoroScheduler::cancel(std::uint8_t id)
+{
+    if (id >= CORO_MAX_TASKS || !slots_[id].root) return;
+    if ((int)id == running_) {
+        slots_[id].cancelled = true;
+    } else {
+        release(slots_[id]);
+    }
+}
+
+/**
+ * @brief スクリプトが実行中ならtrue。
+ * @param id spawn() の番号
+ * @return 実行中ならtrue
+ */
+bool CoroScheduler::alive(std::uint8_t id) const
+{
+    return id < CORO_MAX_TASKS && slots_[id].root && !slots_[id].cancelled;
+}
+
+/**
+ * @brief coro_next_frame() の周期を設定します。
+ * @param ms 周期(ms)
+ * @param nowMs 現在時刻(ms)
+ * @return なし
+ */
+void CoroScheduler::setFramePeriod(std::uint32_t ms, std::uint32_t nowMs)
+{
+    frameMs_ = ms == 0 ? 1 : ms;
+    nextFrameMs_ = nowMs + frameMs_;
+}
+
+/**
+ * @brief イベントを渡します。
+ * @param ev イベント
+ * @return 受け取ったスクリプトの数
+ */
+std::size_t CoroScheduler::post(const AppEvent& ev)
+{
+    std::size_t n = 0;
+    for (Slot& s : slots_) {
+        if (!s.root || s.wait != CORO_EVENT) continue;
+        if (s.eventType != EVT_NONE && s.eventType != ev.type) continue;
+        *s.eventOut = ev;
+        s.wait = CORO_READY;
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief 実行中のスロット。
+ * @return スロット（run() の外は nullptr）
+ */
+CoroScheduler::Slot* CoroScheduler::running()
+{
+    return running_ < 0 ? nullptr : &slots_[running_];
+}
+
+/**
+ * @brief 時刻まで待ちます。
+ * @param h 再開するコルーチン
+ * @param ms 待ち時間
+ * @return 待つならtrue
+ */
+bool CoroScheduler::waitDelay(std::coroutine_handle<> h, std::uint32_t ms)
+{
+    Slot* s = running();
+    if (s == nullptr) return false;
+    s->resume = h;
+    s->wait = CORO_DELAY;
+    s->dueMs = nowMs_ + ms;
+    return true;
+}
+
+/**
+ * @brief 次のフレームまで待ちます。
+ * @param h 再開するコルーチン
+ * @return 待つならtrue
+ */
+bool CoroScheduler::waitFrame(std::coroutine_handle<> h)
+{
+    Slot* s = running();
+    if (s == nullptr) return false;
+    s->resume = h;
+    s->wait = CORO_FRAME;
+    if (due(nextFrameMs_, nowMs_)) {
+        // しばらく誰もフレームを待っていなかった: 位相を保って次の刻みへ
+        nextFrameMs_ += ((nowMs_ - nextFrameMs_) / frameMs_ + 1) * frameMs_;
+    }
+    return true;
+}
+
+/**
+ * @brief イベントを待ちます。
+ * @param h 再開するコルーチン
+ * @param type 待つイベントの種類
+ * @param timeoutMs タイムアウト(ms、0なら無期限)
+ * @param out [out] 受け取ったイベント
+ * @return 待つならtrue
+ */
+bool CoroScheduler::waitEvent(std::coroutine_handle<> h, std::uint8_t type, std::uint32_t timeoutMs, AppEvent* out)
+{
+    Slot* s = running();
+    if (s == nullptr) return false;
+    s->resume = h;
+    s->wait = CORO_EVENT;
+    s->eventType = type;
+    s->eventOut = out;
+    s->timed = timeoutMs != 0;
+    s->dueMs = nowMs_ + timeoutMs;
+    return true;
+}
+
+/**
+ * @brief 期限の来たスクリプトと、イベントを受け取ったスクリプトを再開します。
+ * @param nowMs 現在時刻(ms)
+ * @return 再開した回数
+ */
+std::size_t CoroScheduler::run(std::uint32_t nowMs)
+{
+    nowMs_ = nowMs;
+    const bool frameDue = due(nextFrameMs_, nowMs);
+    bool frameTaken = false;
+    for (Slot& s : slots_) {
+        if (!s.root) continue;
+        if (s.wait == CORO_DELAY && due(s.dueMs, nowMs)) {
+            s.wait = CORO_READY;
+        } else if (s.wait == CORO_EVENT && s.timed && due(s.dueMs, nowMs)) {
+            *s.eventOut = AppEvent { EVT_NONE, 0, 0, nowMs };
+            s.wait = CORO_READY;
+        } else if (s.wait == CORO_FRAME && frameDue) {
+            s.wait = CORO_READY;
+            frameTaken = true;
+        }
+    }
+    if (frameTaken) {
+        // 遅れた刻みは飛ばし、位相は保つ
+        nextFrameMs_ += ((nowMs - nextFrameMs_) / frameMs_ + 1) * frameMs_;
+    }
+
+    CoroScheduler* outer = s_current;
+    s_current = this;
+    std::size_t resumed = 0;
+    bool any = true;
+    while (any) {
+        any = false;
+        for (int i = 0; i < CORO_MAX_TASKS; i++) {
+            Slot& s = slots_[i];
+            if (!s.root || s.wait != CORO_READY) continue;
+            running_ = i;
+            s.resume.resume();
+            running_ = -1;
+            resumed++;
+            any = true;
+            if (s.root.done() || s.cancelled) release(s);
+        }
+    }
+    s_current = outer;
+    return resumed;
+}
+
+/**
+ * @brief 次に run() を呼ぶべき時刻までの時間を求めます。
+ * @param nowMs 現在時刻(ms)
+ * @param waitMs [out] 待ち時間(ms)
+ * @return 時刻で再開するスクリプトがあればtrue
+ */
+bool CoroScheduler::nextWake(std::uint32_t nowMs, std::uint32_t& waitMs) const
+{
+    bool found = false;
+    std::int32_t best = 0;
+    for (const Slot& s : slots_) {
+        if (!s.root) continue;
+        std::int32_t d;
+        if (s.wait == CORO_READY) {
+            d = 0;
+        } else if (s.wait == CORO_DELAY || (s.wait == CORO_EVENT && s.timed)) {
+            d = (std::int32_t)(s.dueMs - nowMs);
+        } else if (s.wait == CORO_FRAME) {
+            d = (std::int32_t)(nextFrameMs_ - nowMs);
+        } else {
+            continue;
+        }
+        if (!found || d < best) best = d;
+        found = true;
+    }
+    waitMs = best < 0 ? 0u : (std::uint32_t)best;
+    return found;
+}
+
+/**
+ * @brief 実行中のスクリプトの数。
+ * @return 数
+ */
+std::size_t CoroScheduler::active() const
+{
+    std::size_t n = 0;
+    for (const Slot& s : slots_) {
+        if (s.root) n++;
+    }
+    return n;
+}
@@ -0,0 +1,308 @@
+/**
+ * @file CoroScheduler.h
+ * @brief C++20 コルーチンでアニメーション/入力/アイドル監視を書くための協調スケジューラ
+ * @details
+ * - スクリプトは `co_await coro_next_frame()` / `co_await coro_delay(ms)` / `co_await coro_wait_event(type, timeoutMs)` を
+ *   並べた逐次処理として書きます。待っている間は他のスクリプトが動きます（1コア、割り込みなしの協調動作）。
+ * - コルーチンのフレームはヒープを使わず、固定数・固定長のプールから確保します（足りなければ生成に失敗します）。
+ * - 時刻は呼び出し側が run() に与えるため、ホスト上で仮想時計を与えて動作させることができます。
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include "EventQueue.h"
+
+#ifndef CORO_MAX_TASKS
+#define CORO_MAX_TASKS 8 ///< 同時に実行できるスクリプトの数（spawn() した数。入れ子で待つ子は含まない）
+#endif
+#ifndef CORO_FRAME_COUNT
+#define CORO_FRAME_COUNT 12 ///< フレームプールのブロック数（入れ子で待つ子も1つ使う。32以下）
+#endif
+#ifndef CORO_FRAME_BYTES
+#define CORO_FRAME_BYTES 512 ///< フレームプールの1ブロックの大きさ（バイト。これより大きいフレームは生成に失敗する）
+#endif
+
+/**
+ * @brief フレームプールの統計。
+ */
+struct CoroPoolStats {
+    std::uint32_t used;      ///< 使用中のブロック数
+    std::uint32_t peak;      ///< 使用中のブロック数の最大値
+    std::uint32_t failures;  ///< 空きがない/大きすぎて確保できなかった回数
+    std::size_t maxBytes;    ///< 要求されたフレームの大きさの最大値（CORO_FRAME_BYTES の見直し用）
+};
+
+/** @brief フレームをプールから確保します。 @param bytes 大きさ @return 先頭（確保できなければ nullptr） */
+void* coro_frame_alloc(std::size_t bytes) noexcept;
+/** @brief フレームをプールへ戻します。 @param p coro_frame_alloc() の戻り値 @return なし */
+void coro_frame_free(void* p) noexcept;
+/** @brief フレームプールの統計。 @return 統計 */
+const CoroPoolStats& coro_pool_stats();
+
+/**
+ * @brief スクリプト（戻り値のないコルーチン）。
+ * @details
+ * - 生成直後は止まっており、CoroScheduler::spawn() で実行を始めるか、他のスクリプトから `co_await` して最後まで実行します。
+ * - `co_await` した子のスクリプトが終わると、同じ run() の中で待っていた親がすぐに続きを実行します。
+ * - フレームを確保できなかった場合は空（valid() が false）になります。空のスクリプトは spawn() に失敗し、`co_await` は何もせずに戻ります。
+ * - 所有権だけを持つ移動専用のクラスです。破棄するとフレームもプールへ戻ります。
+ */
+class CoroTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /** @brief 終了時に、待っている親へ制御を移します（親がなければスケジューラへ戻る）。 */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(Handle h) noexcept
+        {
+            std::coroutine_handle<> next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    /** @brief コルーチンの約束オブジェクト（フレームはプールから確保）。 */
+    struct promise_type {
+        std::coroutine_handle<> continuation {}; ///< このスクリプトを co_await している親
+
+        CoroTask get_return_object() noexcept { return CoroTask(Handle::from_promise(*this)); }
+        static CoroTask get_return_object_on_allocation_failure() noexcept { return CoroTask(); }
+        static void* operator new(std::size_t bytes) noexcept { return coro_frame_alloc(bytes); }
+        static void operator delete(void* p) noexcept { coro_frame_free(p); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::abort(); }
+    };
+
+    /** @brief 子のスクリプトを最後まで実行して待ちます。 */
+    struct Awaiter {
+        Handle h;
+        bool await_ready() const noexcept { return !h || h.done(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept
+        {
+            h.promise().continuation = parent;
+            return h;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    CoroTask() {}
+    CoroTask(const CoroTask&) = delete;
+    CoroTask& operator=(const CoroTask&) = delete;
+    CoroTask(CoroTask&& o) noexcept : h_(o.h_) { o.h_ = nullptr; }
+    CoroTask& operator=(CoroTask&& o) noexcept
+    {
+        if (this != &o) {
+            if (h_) h_.destroy();
+            h_ = o.h_;
+            o.h_ = nullptr;
+        }
+        return *this;
+    }
+    ~CoroTask()
+    {
+        if (h_) h_.destroy();
+    }
+
+    /** @brief フレームを確保できていればtrue。 */
+    inline bool valid() const { return (bool)h_; }
+    /** @brief 所有権を手放してハンドルを返します（スケジューラが引き取る）。 @return ハンドル */
+    inline Handle release()
+    {
+        Handle h = h_;
+        h_ = nullptr;
+        return h;
+    }
+    /** @brief 子として最後まで実行して待ちます。 */
+    Awaiter operator co_await() const noexcept { return Awaiter { h_ }; }
+
+private:
+    explicit CoroTask(Handle h) : h_(h) {}
+    Handle h_ {};
+};
+
+/**
+ * @brief スクリプトが待っているもの。
+ */
+enum CORO_WAIT : std::uint8_t {
+    CORO_READY = 0, ///< 実行可能（次の run() で再開）
+    CORO_DELAY = 1, ///< 時刻まで待つ
+    CORO_FRAME = 2, ///< 次のフレームまで待つ
+    CORO_EVENT = 3  ///< イベント（またはタイムアウト）まで待つ
+};
+
+/**
+ * @brief スクリプトを順に再開する協調スケジューラ。
+ * @details
+ * - run(nowMs) が、期限の来たスクリプトと post() でイベントを受け取ったスクリプトを、番号順に再開します。
+ *   再開したスクリプトが次に待つまで、他のスクリプトは動きません（排他制御は不要です）。
+ * - フレームは setFramePeriod() の周期で刻みます。遅れた場合は刻みを飛ばし、位相は保ちます。
+ * - イベントは、その時点で同じ種類を待っているスクリプトすべてに渡します。誰も待っていなければ捨てます。
+ * - 時刻(ms)は 32bit で一周しても、期限の比較は差で行うため約24日先まで正しく扱えます。
+ */
+class CoroScheduler {
+public:
+    CoroScheduler() {}
+    ~CoroScheduler();
+    CoroScheduler(const CoroScheduler&) = delete;
+    CoroScheduler& operator=(const CoroScheduler&) = delete;
+
+    /**
+     * @brief スクリプトを登録します（次の run() から実行）。
+     * @param task スクリプト（所有権を引き取る）
+     * @param id [out] 番号（cancel() 用。nullptr 可）
+     * @return 登録できればtrue（スクリプトが空、または CORO_MAX_TASKS を超える場合は false。スクリプトは破棄）
+     */
+    bool spawn(CoroTask&& task, std::uint8_t* id = nullptr);
+
+    /**
+     * @brief スクリプトを止めて破棄します。
+     * @param id spawn() の番号
+     * @return なし
+     * @details 待っている子のスクリプトもまとめて破棄します。実行中のスクリプトが自分を止めた場合は、次に待った時点で破棄します。
+     */
+    void cancel(std::uint8_t id);
+
+    /** @brief スクリプトが実行中（終了/破棄されていない）ならtrue。 @param id spawn() の番号 */
+    bool alive(std::uint8_t id) const;
+
+    /**
+     * @brief coro_next_frame() の周期を設定します。
+     * @param ms 周期(ms、0は1とみなす)
+     * @param nowMs 現在時刻(ms)。次のフレームは nowMs + ms
+     * @return なし
+     */
+    void setFramePeriod(std::uint32_t ms, std::uint32_t nowMs);
+
+    /**
+     * @brief イベントを渡します（再開は次の run()）。
+     * @param ev イベント
+     * @return 受け取ったスクリプトの数
+     */
+    std::size_t post(const AppEvent& ev);
+
+    /**
+     * @brief 期限の来たスクリプトと、イベントを受け取ったスクリプトを再開します。
+     * @param nowMs 現在時刻(ms)
+     * @return 再開した回数
+     * @details 再開したスクリプトが他のスクリプトを登録したり、イベントを渡したりした場合は、同じ呼び出しの中で続けて再開します。
+     */
+    std::size_t run(std::uint32_t nowMs);
+
+    /**
+     * @brief 次に run() を呼ぶべき時刻までの時間を求めます。
+     * @param nowMs 現在時刻(ms)
+     * @param waitMs [out] 待ち時間(ms。期限を過ぎていれば0)
+     * @return 時刻で再開するスクリプトがあればtrue（イベントだけを待っている/スクリプトがない場合は false）
+     */
+    bool nextWake(std::uint32_t nowMs, std::uint32_t& waitMs) const;
+
+    /** @brief 実行中のスクリプトの数。 */
+    std::size_t active() const;
+    /** @brief 最後に run() に与えた時刻(ms)。 */
+    inline std::uint32_t now() const { return nowMs_; }
+
+    /** @brief run() の中で実行中のスケジューラ（それ以外は nullptr）。 */
+    static CoroScheduler* current();
+
+    /** @brief 時刻まで待ちます（coro_delay の実装用）。 @param h 再開するコルーチン @param ms 待ち時間 @return 待つならtrue */
+    bool waitDelay(std::coroutine_handle<> h, std::uint32_t ms);
+    /** @brief 次のフレームまで待ちます（coro_next_frame の実装用）。 @param h 再開するコルーチン @return 待つならtrue */
+    bool waitFrame(std::coroutine_handle<> h);
+    /**
+     * @brief イベントを待ちます（coro_wait_event の実装用）。
+     * @param h 再開するコルーチン
+     * @param type 待つイベントの種類（EVT_NONE ならすべて）
+     * @param timeoutMs タイムアウト(ms、0なら無期限)
+     * @param out [out] 受け取ったイベント（タイムアウトなら type=EVT_NONE）
+     * @return 待つならtrue
+     */
+    bool waitEvent(std::coroutine_handle<> h, std::uint8_t type, std::uint32_t timeoutMs, AppEvent* out);
+
+private:
+    /** @brief スクリプト1つ分の状態。 */
+    struct Slot {
+        std::coroutine_handle<> root;   ///< spawn() したスクリプト（空なら未使用）
+        std::coroutine_handle<> resume; ///< 再開するコルーチン（root か、root が待っている子）
+        AppEvent* eventOut;             ///< イベントの受け取り先
+        std::uint32_t dueMs;            ///< 期限（CORO_DELAY と、タイムアウト付きの CORO_EVENT）
+        CORO_WAIT wait;                 ///< 待っているもの
+        std::uint8_t eventType;         ///< 待っているイベントの種類
+        bool timed;                     ///< CORO_EVENT にタイムアウトがある
+        bool cancelled;                 ///< 実行中に cancel() された
+    };
+
+    Slot* running();
+    void release(Slot& s);
+
+    Slot slots_[CORO_MAX_TASKS] {};
+    int running_ { -1 };                ///< 実行中のスロット（run() の外は -1）
+    std::uint32_t nowMs_ { 0 };         ///< 現在時刻
+    std::uint32_t frameMs_ { 16 };      ///< フレーム周期
+    std::uint32_t nextFrameMs_ { 16 };  ///< 次のフレームの時刻
+};
+
+/** @brief coro_delay() の待ち。 */
+struct CoroDelayAwaiter {
+    std::uint32_t ms;
+    bool await_ready() const noexcept { return ms == 0; }
+    bool await_suspend(std::coroutine_handle<> h) const noexcept
+    {
+        CoroScheduler* s = CoroScheduler::current();
+        return s != nullptr && s->waitDelay(h, ms);
+    }
+    void await_resume() const noexcept {}
+};
+
+/** @brief coro_next_frame() の待ち。 */
+struct CoroFrameAwaiter {
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) const noexcept
+    {
+        CoroScheduler* s = CoroScheduler::current();
+        return s != nullptr && s->waitFrame(h);
+    }
+    void await_resume() const noexcept {}
+};
+
+/** @brief coro_wait_event() の待ち。 */
+struct CoroEventAwaiter {
+    std::uint8_t type;
+    std::uint32_t timeoutMs;
+    AppEvent ev {};
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        CoroScheduler* s = CoroScheduler::current();
+        return s != nullptr && s->waitEvent(h, type, timeoutMs, &ev);
+    }
+    AppEvent await_resume() const noexcept { return ev; }
+};
+
+/**
+ * @brief 指定時間待ちます。
+ * @param ms 待ち時間(ms、0なら待たない)
+ * @return 待ち（co_await する）
+ */
+inline CoroDelayAwaiter coro_delay(std::uint32_t ms) { return CoroDelayAwaiter { ms }; }
+
+/**
+ * @brief 次のフレーム（CoroScheduler::setFramePeriod の周期）まで待ちます。
+ * @return 待ち（co_await する）
+ */
+inline CoroFrameAwaiter coro_next_frame() { return CoroFrameAwaiter {}; }
+
+/**
+ * @brief イベントを待ちます。
+ * @param type 待つイベントの種類（EVT_NONE ならすべて）
+ * @param timeoutMs タイムアウト(ms、0なら無期限)
+ * @return 待ち（co_await すると AppEvent。タイムアウトなら type=EVT_NONE）
+ */
+inline CoroEventAwaiter coro_wait_event(std::uint8_t type, std::uint32_t timeoutMs = 0) { return CoroEventAwaiter { type, timeoutMs }; }
@@ -0,0 +1,54 @@
+/**
+ * @file Debouncer.cpp
+ * @brief エッジ割り込み＋タイマー確認方式のボタンデバウンスの実装
+ */
+#include "Debouncer.h"
+
+/**
+ * @brief 現在のレベルで初期化します。
+ * @param level 現在のピンのレベル
+ * @return なし
+ */
+void Debouncer::reset(bool level)
+{
+    debounced_ = level;
+    pending_ = false;
+    lastEdgeMs_ = 0;
+}
+
+/**
+ * @brief エッジを記録します。
+ * @param nowMs 現在時刻(ms)
+ * @return タイマー起動が必要ならtrue
+ * @details 既にタイマー待機中であれば時刻の更新だけを行い、満了時に待ち直しさせます。
+ */
+bool Debouncer::onEdge(std::uint32_t nowMs)
+{
+    lastEdgeMs_ = nowMs;
+    if (pending_) return false;
+    pending_ = true;
+    return true;
+}
+
+/**
+ * @brief タイマー満了時にレベルを確定します。
+ * @param level 現在のピンのレベル
+ * @param nowMs 現在時刻(ms)
+ * @param retryMs [out] 待ち直しの残り時間(ms)
+ * @return 押下が確定したらtrue
+ * @details 最後のエッジから settleMs 経過していなければ残り時間を返して待ち直します。
+ *          経過していればレベルを確定し、High→Low の変化なら押下として true を返します。
+ */
+bool Debouncer::onTimer(bool level, std::uint32_t nowMs, std::uint32_t& retryMs)
+{
+    const std::uint32_t elapsed = nowMs - lastEdgeMs_;
+    if (elapsed < settleMs_) {
+        retryMs = settleMs_ - elapsed;
+        return false;
+    }
+    retryMs = 0;
+    pending_ = false;
+    if (level == debounced_) return false;
+    debounced_ = level;
+    return level == false; // 立下り＝押下確定（Active-Low）
+}
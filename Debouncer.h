@@ -0,0 +1,57 @@
+/**
+ * @file Debouncer.h
+ * @brief エッジ割り込み＋タイマー確認方式のボタンデバウンス
+ * @details GPIOの読み取りやタイマーに依存しない判定ロジックだけを持つクラスのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief エッジ割り込みとタイマーによるデバウンス判定。
+ * @details
+ * - エッジ割り込みで onEdge() を呼び、返された時刻にタイマーで onTimer() を呼びます。
+ * - 最後のエッジから settleMs 経過して安定したレベルを確定値とし、確定値が Low に変化した瞬間を押下とします（Active-Low）。
+ * - 押下は1回につき1度だけ通知され、解放（High確定）で再び通知可能になります。
+ * - タイマー待ちの間に再度エッジが来た場合、onTimer() は残り時間を返して待ち直しを指示します。
+ */
+class Debouncer {
+public:
+    /** @brief 安定待ち時間(ms)を指定して構築します。 */
+    explicit Debouncer(std::uint32_t settleMs = 30) : settleMs_(settleMs) {}
+
+    /**
+     * @brief 現在のレベルで初期化します。
+     * @param level 現在のピンのレベル（true=High=解放）
+     * @return なし
+     */
+    void reset(bool level);
+
+    /**
+     * @brief エッジを記録します（エッジ割り込みから呼び出し）。
+     * @param nowMs 現在時刻(ms)
+     * @return 新たにタイマーを起動する必要があればtrue（既に待機中ならfalse）
+     */
+    bool onEdge(std::uint32_t nowMs);
+
+    /**
+     * @brief タイマー満了時にレベルを確定します。
+     * @param level 現在のピンのレベル
+     * @param nowMs 現在時刻(ms)
+     * @param retryMs [out] 待ち直しが必要な場合の残り時間(ms)。不要なら0
+     * @return 押下が確定したらtrue
+     */
+    bool onTimer(bool level, std::uint32_t nowMs, std::uint32_t& retryMs);
+
+    /** @brief 安定待ち時間(ms)。 */
+    inline std::uint32_t settleMs() const { return settleMs_; }
+    /** @brief デバウンス後の安定レベル。 */
+    inline bool level() const { return debounced_; }
+
+private:
+    std::uint32_t settleMs_;             ///< 安定待ち時間
+    volatile std::uint32_t lastEdgeMs_ { 0 }; ///< 直近のエッジ時刻
+    volatile bool pending_ { false };    ///< タイマー待機中
+    bool debounced_ { true };            ///< 確定レベル（プルアップなので解放=High）
+};
@@ -0,0 +1,270 @@
+/**
+ * @file Effects.cpp
+ * @brief VRAMへ直接描くエフェクトの実装
+ */
+#include <cstring>
+#include "Effects.h"
+
+using namespace fxmath;
+
+namespace {
+
+/** @brief パレットの色の区切り（位置 0..255 と色 0x00RRGGBB）。 */
+struct PaletteStop {
+    std::uint8_t pos;
+    std::uint32_t rgb;
+};
+
+const PaletteStop kPlasmaStops[] = {{0, 0x100040}, {64, 0x8000C0}, {128, 0x00A0FF}, {192, 0xFF8000}, {255, 0x100040}};
+const PaletteStop kFireStops[] = {{0, 0x000000}, {64, 0x800000}, {128, 0xFF3000}, {192, 0xFFA000}, {255, 0xFFFFA0}};
+const PaletteStop kRainbowStops[] = {{0, 0xFF0000}, {43, 0xFFFF00}, {85, 0x00FF00}, {128, 0x00FFFF}, {171, 0x0000FF}, {213, 0xFF00FF}, {255, 0xFF0000}};
+const PaletteStop kNoiseStops[] = {{0, 0x000010}, {96, 0x002080}, {160, 0x0080C0}, {224, 0x80E0FF}, {255, 0xFFFFFF}};
+
+/**
+ * @brief 区切りの間を補間して 256 色のパレットを作ります。
+ * @param stops 区切り（pos の昇順。先頭は0、最後は255）
+ * @param count 区切りの数
+ * @param level 明るさ 0..255
+ * @param out 出力（256色、0x00GGRRBB）
+ * @return なし
+ */
+void buildPalette(const PaletteStop* stops, int count, std::uint8_t level, std::uint32_t* out)
+{
+    int seg = 0;
+    for (int i = 0; i < 256; i++) {
+        while (seg + 2 < count && i > stops[seg + 1].pos) seg++;
+        const PaletteStop& a = stops[seg];
+        const PaletteStop& b = stops[seg + 1];
+        const std::uint8_t frac = (std::uint8_t)(((i - a.pos) * 255) / (b.pos - a.pos));
+        const std::uint8_t r = scale8(lerp8((std::uint8_t)(a.rgb >> 16), (std::uint8_t)(b.rgb >> 16), frac), level);
+        const std::uint8_t g = scale8(lerp8((std::uint8_t)(a.rgb >> 8), (std::uint8_t)(b.rgb >> 8), frac), level);
+        const std::uint8_t bl = scale8(lerp8((std::uint8_t)a.rgb, (std::uint8_t)b.rgb, frac), level);
+        out[i] = ((std::uint32_t)g << 16) | ((std::uint32_t)r << 8) | bl;
+    }
+}
+
+/**
+ * @brief バリューノイズの1行分について、格子の列ごとに Y と Z を補間した値を求めます。
+ * @param ix0 最初の格子の列
+ * @param y Y（上位が格子、下位8bitが格子内の位置）
+ * @param z Z（同上）
+ * @param count 列の数
+ * @param out 出力（count 個）
+ * @return なし
+ * @details out[i] と out[i+1] を X で補間すると、fxmath::noise8 と同じ格子・同じ補間係数のノイズになります。
+ */
+void noiseLattice(std::uint32_t ix0, std::uint32_t y, std::uint32_t z, std::uint32_t count, std::uint8_t* out)
+{
+    const std::uint32_t iy = y >> 8, iz = z >> 8;
+    const std::uint8_t fy = ease8((std::uint8_t)y), fz = ease8((std::uint8_t)z);
+    for (std::uint32_t i = 0; i < count; i++) {
+        const std::uint32_t ix = ix0 + i;
+        const std::uint8_t a = lerp8(hash8(ix, iy, iz), hash8(ix, iy + 1, iz), fy);
+        const std::uint8_t b = lerp8(hash8(ix, iy, iz + 1), hash8(ix, iy + 1, iz + 1), fy);
+        out[i] = lerp8(a, b, fz);
+    }
+}
+
+} // namespace
+
+EffectEngine::EffectEngine()
+{
+    buildPalettes();
+}
+
+/**
+ * @brief 描画する大きさを決め、作業領域を確保します。
+ * @param width 幅（ピクセル、1..EFFECT_MAX_WIDTH）
+ * @param height 高さ（ピクセル）
+ * @return 成功ならtrue
+ * @details 同じ大きさで呼び直した場合は作業領域をそのまま使います。
+ */
+bool EffectEngine::begin(std::uint16_t width, std::uint16_t height)
+{
+    if (width == 0 || height == 0 || width > EFFECT_MAX_WIDTH) return false;
+    if (width != width_ || height != height_ || !heat_) {
+        heat_.reset(new std::uint8_t[(std::size_t)width * (height + 2)]);
+        width_ = width;
+        height_ = height;
+    }
+    // 炎は高さの 8 割ほどまで届くよう冷やす。虹は幅+高さで色相を1周させる
+    const std::uint32_t cool = 192u / height;
+    cooling_ = (std::uint8_t)(cool < 1 ? 1 : cool > 64 ? 64 : cool);
+    const std::uint32_t step = 256u / ((std::uint32_t)width + height);
+    hueStep_ = (std::uint8_t)(step < 1 ? 1 : step);
+    select(kind_);
+    return true;
+}
+
+/**
+ * @brief エフェクトを選びます。
+ * @param kind 種類
+ * @return なし
+ */
+void EffectEngine::select(EFFECT_KIND kind)
+{
+    kind_ = kind < EFFECT_COUNT ? kind : EFFECT_PLASMA;
+    if (kind_ == EFFECT_FIRE && heat_) std::memset(heat_.get(), 0, (std::size_t)width_ * (height_ + 2));
+}
+
+/**
+ * @brief 明るさを変えます。
+ * @param level 0..255
+ * @return なし
+ */
+void EffectEngine::setLevel(std::uint8_t level)
+{
+    if (level == level_) return;
+    level_ = level;
+    buildPalettes();
+}
+
+/**
+ * @brief 全エフェクトのパレットを現在の明るさで作り直します。
+ * @return なし
+ */
+void EffectEngine::buildPalettes()
+{
+    buildPalette(kPlasmaStops, sizeof(kPlasmaStops) / sizeof(kPlasmaStops[0]), level_, palette_[EFFECT_PLASMA]);
+    buildPalette(kFireStops, sizeof(kFireStops) / sizeof(kFireStops[0]), level_, palette_[EFFECT_FIRE]);
+    buildPalette(kRainbowStops, sizeof(kRainbowStops) / sizeof(kRainbowStops[0]), level_, palette_[EFFECT_RAINBOW]);
+    buildPalette(kNoiseStops, sizeof(kNoiseStops) / sizeof(kNoiseStops[0]), level_, palette_[EFFECT_NOISE]);
+}
+
+/**
+ * @brief 1フレームを描画します。
+ * @param vram 出力（幅x高さ、0x00GGRRBB）
+ * @param timeMs 時刻(ms)
+ * @return なし
+ */
+void EffectEngine::render(std::uint32_t* vram, std::uint32_t timeMs)
+{
+    if (!heat_) return;
+    switch (kind_) {
+    case EFFECT_PLASMA: renderPlasma(vram, timeMs); break;
+    case EFFECT_FIRE: renderFire(vram); break;
+    case EFFECT_RAINBOW: renderRainbow(vram, timeMs); break;
+    case EFFECT_NOISE: renderNoise(vram, timeMs); break;
+    default: break;
+    }
+}
+
+/**
+ * @brief プラズマ：列・行・2方向の斜めの正弦波の平均。
+ * @param vram 出力
+ * @param t 時刻(ms)
+ * @return なし
+ * @details 列の項は1フレームに1回、行の項は1行に1回だけ計算します。斜めの項は角度を1ピクセルごとに足していきます。
+ */
+void EffectEngine::renderPlasma(std::uint32_t* vram, std::uint32_t t)
+{
+    const std::uint32_t* pal = palette_[EFFECT_PLASMA];
+    const std::uint8_t t1 = (std::uint8_t)(t >> 4), t2 = (std::uint8_t)(t / 24), t3 = (std::uint8_t)(t >> 5), t4 = (std::uint8_t)(t / 40);
+    for (std::uint32_t x = 0; x < width_; x++) column_[x] = sin8((std::uint8_t)(x * 9u + t1));
+    for (std::uint32_t y = 0; y < height_; y++) {
+        const std::uint32_t row = sin8((std::uint8_t)(y * 7u - t2));
+        std::uint8_t a = (std::uint8_t)(y * 5u + t3); // (x+y)*5 + t3
+        std::uint8_t b = (std::uint8_t)(t4 - y * 3u); // (x-y)*3 + t4
+        std::uint32_t* dst = &vram[y * width_];
+        for (std::uint32_t x = 0; x < width_; x++) {
+            dst[x] = pal[(column_[x] + row + sin8(a) + sin8(b)) >> 2];
+            a += 5;
+            b += 3;
+        }
+    }
+}
+
+/**
+ * @brief 炎：下の4ピクセルの平均から冷やした熱を上へ送ります。
+ * @param vram 出力
+ * @return なし
+ * @details 見えない下の2行に毎フレーム乱数で種火を置きます。上の行から順に更新するので、参照する下の行はまだ前のフレームの値です。
+ */
+void EffectEngine::renderFire(std::uint32_t* vram)
+{
+    const std::uint32_t w = width_, h = height_;
+    std::uint8_t* heat = heat_.get();
+    for (std::uint32_t i = h * w; i < (h + 2) * w; i++) {
+        const std::uint32_t r = rng_.next();
+        heat[i] = (r >> 24) < 96 ? 0 : (std::uint8_t)(160u + ((r >> 8) & 0x5Fu));
+    }
+    const std::uint32_t* pal = palette_[EFFECT_FIRE];
+    for (std::uint32_t y = 0; y < h; y++) {
+        std::uint8_t* cur = &heat[y * w];
+        const std::uint8_t* b1 = cur + w;
+        const std::uint8_t* b2 = b1 + w;
+        std::uint32_t* dst = &vram[y * w];
+        for (std::uint32_t x = 0; x < w; x++) {
+            const std::uint32_t l = b1[x > 0 ? x - 1 : x], r = b1[x + 1 < w ? x + 1 : x];
+            const std::uint32_t sum = (l + b1[x] + r + b2[x]) >> 2;
+            const std::uint8_t v = (std::uint8_t)(sum > cooling_ ? sum - cooling_ : 0);
+            cur[x] = v;
+            dst[x] = pal[v];
+        }
+    }
+}
+
+/**
+ * @brief 虹：斜めに色相が変わり、時間とともに流れます。
+ * @param vram 出力
+ * @param t 時刻(ms)
+ * @return なし
+ */
+void EffectEngine::renderRainbow(std::uint32_t* vram, std::uint32_t t)
+{
+    const std::uint32_t* pal = palette_[EFFECT_RAINBOW];
+    const std::uint8_t step = hueStep_;
+    for (std::uint32_t y = 0; y < height_; y++) {
+        std::uint8_t hue = (std::uint8_t)(y * step + (t >> 3));
+        std::uint32_t* dst = &vram[y * width_];
+        for (std::uint32_t x = 0; x < width_; x++) {
+            dst[x] = pal[hue];
+            hue += step;
+        }
+    }
+}
+
+/**
+ * @brief ノイズ：2オクターブのバリューノイズ（Z が時間）。
+ * @param vram 出力
+ * @param t 時刻(ms)
+ * @return なし
+ * @details 1ピクセルを格子の 1/6（大きい模様）と 1/3（細かい模様）にして 3:1 で混ぜます。
+ *          Y と Z の補間は1行に1回、格子の列ごとに済ませ、ピクセルごとには X の補間だけを行います。
+ */
+void EffectEngine::renderNoise(std::uint32_t* vram, std::uint32_t t)
+{
+    const std::uint32_t* pal = palette_[EFFECT_NOISE];
+    const std::uint32_t z1 = t >> 2, z2 = (t >> 1) + 0x8000u;
+    const std::uint32_t step1 = 42u, step2 = 85u, x2 = 0x4000u;
+    std::uint8_t lat1[EFFECT_MAX_WIDTH * 42u / 256u + 2], lat2[EFFECT_MAX_WIDTH * 85u / 256u + 2];
+    const std::uint32_t n1 = ((width_ - 1u) * step1 >> 8) + 2u, n2 = ((width_ - 1u) * step2 >> 8) + 2u;
+    for (std::uint32_t y = 0; y < height_; y++) {
+        noiseLattice(0, y * step1, z1, n1, lat1);
+        noiseLattice(x2 >> 8, y * step2, z2, n2, lat2);
+        std::uint32_t* dst = &vram[y * width_];
+        std::uint32_t u1 = 0, u2 = x2 & 0xFFu;
+        for (std::uint32_t x = 0; x < width_; x++, u1 += step1, u2 += step2) {
+            const std::uint8_t* c1 = &lat1[u1 >> 8];
+            const std::uint8_t* c2 = &lat2[u2 >> 8];
+            const std::uint32_t n = (std::uint32_t)lerp8(c1[0], c1[1], ease8((std::uint8_t)u1)) * 3u + lerp8(c2[0], c2[1], ease8((std::uint8_t)u2));
+            dst[x] = pal[n >> 2];
+        }
+    }
+}
+
+/**
+ * @brief エフェクトの名前。
+ * @param kind 種類
+ * @return 名前
+ */
+const char* EffectEngine::name(EFFECT_KIND kind)
+{
+    switch (kind) {
+    case EFFECT_PLASMA: return "plasma";
+    case EFFECT_FIRE: return "fire";
+    case EFFECT_RAINBOW: return "rainbow";
+    case EFFECT_NOISE: return "noise";
+    default: return "?";
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file Effects.h
+ * @brief VRAMへ直接描くエフェクト（プラズマ・炎・虹・ノイズ）
+ * @details 待機中やアトラクト表示用に、パターンを使わずに毎フレーム計算する映像を描くクラスのヘッダファイル。
+ *          描画中は浮動小数点と libm を使いません（FixedMath.h の表引きと整数演算のみ）。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include "FixedMath.h"
+
+#define EFFECT_MAX_WIDTH 256       ///< 描画できる幅の上限（ピクセル）
+#define EFFECT_DEFAULT_LEVEL 48    ///< 既定の明るさ（0..255。パレットに掛ける）
+
+/**
+ * @brief エフェクトの種類。
+ */
+enum EFFECT_KIND : std::uint8_t {
+    EFFECT_PLASMA = 0,  ///< 正弦波の重ね合わせ
+    EFFECT_FIRE = 1,    ///< 下から燃え上がる炎（前のフレームから計算）
+    EFFECT_RAINBOW = 2, ///< 斜めに流れる虹
+    EFFECT_NOISE = 3,   ///< バリューノイズの雲
+    EFFECT_COUNT
+};
+
+/**
+ * @brief エフェクトの描画。
+ * @details
+ * - 各エフェクトはピクセルごとに 0..255 の値を計算し、エフェクトごとのパレット（256色、0x00GGRRBB）で色にします。
+ * - パレットは setLevel() のときに明るさを掛けて作ります。描画中の計算は整数だけです。
+ * - 炎は前のフレームの熱の分布から次を計算するため、begin() で幅x(高さ+2)バイトの作業領域を1回だけ確保します。
+ */
+class EffectEngine {
+public:
+    EffectEngine();
+
+    /**
+     * @brief 描画する大きさを決め、作業領域を確保します。
+     * @param width 幅（ピクセル、1..EFFECT_MAX_WIDTH）
+     * @param height 高さ（ピクセル）
+     * @return 成功ならtrue
+     */
+    bool begin(std::uint16_t width, std::uint16_t height);
+
+    /** @brief エフェクトを選びます。 @param kind 種類 @return なし @details 炎は熱の分布を消してから始めます。 */
+    void select(EFFECT_KIND kind);
+    /** @brief 選んでいるエフェクト。 */
+    inline EFFECT_KIND current() const { return kind_; }
+
+    /** @brief 明るさを変えます（パレットを作り直す）。 @param level 0..255 @return なし */
+    void setLevel(std::uint8_t level);
+
+    /**
+     * @brief 1フレームを描画します。
+     * @param vram 出力（幅x高さ、0x00GGRRBB、行優先）
+     * @param timeMs 時刻(ms)。プラズマ・虹・ノイズは時刻から、炎は呼び出し回数で進みます
+     * @return なし
+     */
+    void render(std::uint32_t* vram, std::uint32_t timeMs);
+
+    /** @brief エフェクトの名前。 @param kind 種類 @return 名前（ベンチマークの名前にも使う） */
+    static const char* name(EFFECT_KIND kind);
+
+private:
+    void buildPalettes();
+    void renderPlasma(std::uint32_t* vram, std::uint32_t t);
+    void renderFire(std::uint32_t* vram);
+    void renderRainbow(std::uint32_t* vram, std::uint32_t t);
+    void renderNoise(std::uint32_t* vram, std::uint32_t t);
+
+    std::unique_ptr<std::uint8_t[]> heat_;        ///< 炎の熱（幅x(高さ+2)）
+    std::uint16_t width_ { 0 };                   ///< 幅
+    std::uint16_t height_ { 0 };                  ///< 高さ
+    EFFECT_KIND kind_ { EFFECT_PLASMA };          ///< 選んでいるエフェクト
+    std::uint8_t level_ { EFFECT_DEFAULT_LEVEL }; ///< 明るさ
+    std::uint8_t cooling_ { 20 };                 ///< 炎が1行上がるごとに下がる熱
+    std::uint8_t hueStep_ { 8 };                  ///< 虹の1ピクセルあたりの色相の変化
+    fxmath::XorShift32 rng_;                      ///< 炎の種火の乱数
+    std::uint32_t palette_[EFFECT_COUNT][256];    ///< エフェクトごとのパレット（0x00GGRRBB）
+    std::uint8_t column_[EFFECT_MAX_WIDTH];       ///< プラズマの列ごとの項
+};
@@ -0,0 +1,94 @@
+/**
+ * @file EventQueue.h
+ * @brief 割り込みからメインループへイベントを渡すロックフリーキュー
+ * @details 単一生産者/単一消費者のリングバッファ。割り込みハンドラで push、メインループで pop します。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+
+/**
+ * @brief イベントの種類。
+ */
+enum EVENT_TYPE : std::uint8_t {
+    EVT_NONE = 0,   ///< なし
+    EVT_BUTTON = 1, ///< デバウンス済みのボタン押下（id=GPIO番号）
+    EVT_TIMER = 2   ///< タイマー満了（id=タイマー番号）
+};
+
+/**
+ * @brief キューで受け渡すイベント。
+ */
+struct AppEvent {
+    std::uint8_t type;   ///< EVENT_TYPE
+    std::uint8_t id;     ///< GPIO番号/タイマー番号
+    std::uint8_t gen;    ///< タイマーの世代番号（停止済みタイマーのイベント判定用）
+    std::uint32_t timeMs; ///< 発生時刻(ms)
+};
+
+/**
+ * @brief 単一生産者/単一消費者のロックフリーリングバッファ。
+ * @tparam N 要素数（2のべき乗）。実際に格納できるのは N 個
+ * @details
+ * - head_ は生産者だけが、tail_ は消費者だけが書き込みます。インデックスは単調増加させ、差分で残量を求めます。
+ * - 生産者が複数の割り込みハンドラにまたがる場合は、それらが互いに割り込まない（同一優先度・同一コア）ことが前提です。
+ * - 満杯時の push は失敗し、dropped() で破棄数を確認できます。
+ */
+template <std::size_t N>
+class EventQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "EventQueue size must be a power of two");
+
+public:
+    /**
+     * @brief イベントを追加します（生産者側、割り込みから呼び出し可）。
+     * @param ev イベント
+     * @return 追加できればtrue、満杯ならfalse
+     */
+    bool push(const AppEvent& ev) {
+        const std::uint32_t head = head_.load(std::memory_order_relaxed);
+        const std::uint32_t tail = tail_.load(std::memory_order_acquire);
+        if (head - tail >= N) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buf_[head & (N - 1)] = ev;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief イベントを取り出します（消費者側）。
+     * @param ev [out] 取り出したイベント
+     * @return 取り出せればtrue、空ならfalse
+     */
+    bool pop(AppEvent& ev) {
+        const std::uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint32_t head = head_.load(std::memory_order_acquire);
+        if (head == tail) return false;
+        ev = buf_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** @brief 空ならtrue。 */
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    /** @brief 格納中のイベント数。 */
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /** @brief 満杯で破棄したイベント数。 */
+    std::uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    AppEvent buf_[N] {};                      ///< リングバッファ
+    std::atomic<std::uint32_t> head_ { 0 };   ///< 次に書き込む位置（生産者）
+    std::atomic<std::uint32_t> tail_ { 0 };   ///< 次に読み出す位置（消費者）
+    std::atomic<std::uint32_t> dropped_ { 0 }; ///< 破棄数
+};
@@ -0,0 +1,100 @@
+/**
+ * @file FixedMath.h
+ * @brief 固定小数点の三角関数・補間・整数ノイズ
+ * @details 浮動小数点と libm を使わずにエフェクト（Effects.h）を計算するための、表引きと整数演算だけの関数群です。
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 8bit の角度・値を扱う固定小数点演算。
+ * @details 角度は 256 で1周、値は 0..255 です。すべて整数演算で、実行時に表を作る必要はありません。
+ */
+namespace fxmath {
+
+/** @brief 128 + 127*sin(2πi/256) の表。 */
+inline constexpr std::uint8_t kSin8[256] = {
+    128, 131, 134, 137, 140, 144, 147, 150, 153, 156, 159, 162, 165, 168, 171, 174,
+    177, 179, 182, 185, 188, 191, 193, 196, 199, 201, 204, 206, 209, 211, 213, 216,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 239, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 239, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 216, 213, 211, 209, 206, 204, 201, 199, 196, 193, 191, 188, 185, 182, 179,
+    177, 174, 171, 168, 165, 162, 159, 156, 153, 150, 147, 144, 140, 137, 134, 131,
+    128, 125, 122, 119, 116, 112, 109, 106, 103, 100,  97,  94,  91,  88,  85,  82,
+     79,  77,  74,  71,  68,  65,  63,  60,  57,  55,  52,  50,  47,  45,  43,  40,
+     38,  36,  34,  32,  30,  28,  26,  24,  22,  21,  19,  17,  16,  15,  13,  12,
+     11,  10,   8,   7,   6,   6,   5,   4,   3,   3,   2,   2,   2,   1,   1,   1,
+      1,   1,   1,   1,   2,   2,   2,   3,   3,   4,   5,   6,   6,   7,   8,  10,
+     11,  12,  13,  15,  16,  17,  19,  21,  22,  24,  26,  28,  30,  32,  34,  36,
+     38,  40,  43,  45,  47,  50,  52,  55,  57,  60,  63,  65,  68,  71,  74,  77,
+     79,  82,  85,  88,  91,  94,  97, 100, 103, 106, 109, 112, 116, 119, 122, 125,
+};
+
+/** @brief 正弦。 @param a 角度（256で1周） @return 0..255（中心128） */
+inline std::uint8_t sin8(std::uint8_t a) { return kSin8[a]; }
+/** @brief 余弦。 @param a 角度（256で1周） @return 0..255（中心128） */
+inline std::uint8_t cos8(std::uint8_t a) { return kSin8[(std::uint8_t)(a + 64u)]; }
+
+/** @brief a * b / 256（b=255 で a をほぼそのまま返す）。 @param a 値 @param b 倍率 0..255 @return 0..255 */
+inline std::uint8_t scale8(std::uint8_t a, std::uint8_t b) { return (std::uint8_t)(((std::uint32_t)a * ((std::uint32_t)b + 1u)) >> 8); }
+
+/** @brief a から b へ frac/256 だけ進めた値。 @param a 始点 @param b 終点 @param frac 0..255 @return 0..255 */
+inline std::uint8_t lerp8(std::uint8_t a, std::uint8_t b, std::uint8_t frac)
+{
+    return (std::uint8_t)((std::int32_t)a + ((((std::int32_t)b - (std::int32_t)a) * (std::int32_t)frac) >> 8));
+}
+
+/** @brief 3t²-2t³ の滑らかな補間係数。 @param t 0..255 @return 0..255 */
+inline std::uint8_t ease8(std::uint8_t t)
+{
+    const std::uint32_t u = t;
+    return (std::uint8_t)((u * u * (768u - 2u * u)) >> 16);
+}
+
+/** @brief 格子点の整数ハッシュ。 @param x X @param y Y @param z Z（時間） @return 0..255 */
+inline std::uint8_t hash8(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+    std::uint32_t h = x * 0x27D4EB2Du ^ y * 0x165667B1u ^ z * 0x9E3779B1u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return (std::uint8_t)(h >> 24);
+}
+
+/**
+ * @brief 3次元のバリューノイズ（格子点の乱数を滑らかに補間）。
+ * @param x X（上位が格子、下位8bitが格子内の位置）
+ * @param y Y（同上）
+ * @param z Z（同上。時間に使う）
+ * @return 0..255
+ */
+inline std::uint8_t noise8(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+    const std::uint32_t ix = x >> 8, iy = y >> 8, iz = z >> 8;
+    const std::uint8_t fx = ease8((std::uint8_t)x), fy = ease8((std::uint8_t)y), fz = ease8((std::uint8_t)z);
+    const std::uint8_t a0 = lerp8(hash8(ix, iy, iz), hash8(ix + 1, iy, iz), fx);
+    const std::uint8_t b0 = lerp8(hash8(ix, iy + 1, iz), hash8(ix + 1, iy + 1, iz), fx);
+    const std::uint8_t a1 = lerp8(hash8(ix, iy, iz + 1), hash8(ix + 1, iy, iz + 1), fx);
+    const std::uint8_t b1 = lerp8(hash8(ix, iy + 1, iz + 1), hash8(ix + 1, iy + 1, iz + 1), fx);
+    return lerp8(lerp8(a0, b0, fy), lerp8(a1, b1, fy), fz);
+}
+
+/** @brief xorshift32 の乱数（rand() の代わり。状態を持ち、ロックを使わない）。 */
+struct XorShift32 {
+    std::uint32_t s { 0x12345678u }; ///< 状態（0以外）
+
+    /** @brief 次の乱数。 @return 32bit */
+    inline std::uint32_t next()
+    {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+};
+
+} // namespace fxmath
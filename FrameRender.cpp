@@ -0,0 +1,159 @@
+/**
+ * @file FrameRender.cpp
+ * @brief 停止/歩行フレームの合成と送出の実装
+ */
+#include <cstring>
+#include "FrameRender.h"
+#include "TraceRecorder.h"
+
+/**
+ * @brief 表示内容を表す送出データキャッシュのキーを作ります。
+ * @param charNo キャラクタ番号
+ * @param grpNo パターングループ（停止表示は FRAME_KEY_STOP）
+ * @param prevPatNo 重ねて表示する一つ前のパターン番号（重ねない場合は無視）
+ * @param currPatNo パターン番号
+ * @param withPrev 一つ前のパターンを重ねて表示するならtrue
+ * @param isBlend 遷移表示ならtrue
+ * @return キー
+ * @details パターン番号は 24bit ずつ持ちます（以前の 8bit では 256 枚目以降のフレームが同じキーになっていました）。
+ *          重ねない場合の前のパターン番号は FRAME_KEY_MAX_PAT で、パターン番号はそれ未満であること。
+ */
+uint64_t frameKey(int charNo, uint8_t grpNo, size_t prevPatNo, size_t currPatNo, bool withPrev, bool isBlend)
+{
+	return ((uint64_t)(charNo & 0xFF) << 56) | ((uint64_t)isBlend << 55) | ((uint64_t)(grpNo & 0x7F) << 48) |
+	       ((uint64_t)(withPrev ? prevPatNo & FRAME_KEY_MAX_PAT : FRAME_KEY_MAX_PAT) << 24) | (uint64_t)(currPatNo & FRAME_KEY_MAX_PAT);
+}
+
+/**
+ * @brief パターンをVRAMの大きさに合わせて描画します。
+ * @param led_matrix 出力先
+ * @param buf パターン（width x height）
+ * @param width パターンの幅
+ * @param height パターンの高さ
+ * @param colorReplace 置換色（0で無効）
+ * @param isOverlay 黒(0)を透明として重ねる
+ * @return なし
+ * @details VRAMと同じ大きさならそのまま、VRAMが2倍以上大きければ整数倍に拡大して中央へ描きます（絵を描き直さずに使う）。
+ *          それ以外は等倍で中央へ描きます（VRAMより大きいパターンははみ出す部分を切り詰める）。
+ */
+static void drawPattern(WS2812& led_matrix, const std::uint32_t* buf, uint16_t width, uint16_t height, uint32_t colorReplace, bool isOverlay)
+{
+	const uint32_t fitX = led_matrix.xVRam / width;
+	const uint32_t fitY = led_matrix.yVRam / height;
+	const uint32_t fit = fitX < fitY ? fitX : fitY;
+	if (fit <= 1) {
+		led_matrix.DrawBuffer(buf, width, height, ((int32_t)led_matrix.xVRam - width) / 2, ((int32_t)led_matrix.yVRam - height) / 2,
+		                      colorReplace, isOverlay);
+		return;
+	}
+	const int32_t scale = (int32_t)fit * SPRITE_ONE;
+	SpriteXform xf;
+	sprite_xform_make(width, height, (int32_t)(led_matrix.xVRam << 15), (int32_t)(led_matrix.yVRam << 15), scale, scale, 0, xf);
+	led_matrix.DrawTransformed(buf, width, height, xf, colorReplace, isOverlay, SPRITE_NEAREST);
+}
+
+/**
+ * @brief 停止表示のフレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param ch キャラクタ設定
+ * @param pmStay 停止パターン
+ * @param key 送出データキャッシュのキー
+ * @details 送出済みならキャッシュから送出します（キャラ変更/歩行後の再表示で描画しない）。
+ */
+void drawStopFrame(WS2812& led_matrix, const Patterns& ch, const PatManager& pmStay, uint64_t key)
+{
+	LGM_TRACE_SCOPE(TRACE_STOP_FRAME, (uint8_t)(key >> 56), (uint32_t)key, (uint32_t)(key >> 32));
+	if (led_matrix.ShowCached(key, true, false)) return;
+
+	led_matrix.Reset();
+	const std::uint32_t* buf = pmStay.getBufferPtr(0);
+	if (!buf) return;
+	if (led_matrix.xVRam != pmStay.width() || led_matrix.yVRam != pmStay.height()) led_matrix.Clear(0); // 拡大したパターンの外側
+	if (ch.isColorReplace) {
+		drawPattern(led_matrix, buf, pmStay.width(), pmStay.height(), 0x000700, false); // パターンを描画
+	} else {
+		drawPattern(led_matrix, buf, pmStay.width(), pmStay.height(), 0, false); // パターンを描画
+	}
+	led_matrix.ScanBufferCached(key, true, false);
+}
+
+/**
+ * @brief 歩行中の1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param ch キャラクタ設定
+ * @param pm 表示するパターングループ
+ * @param prevPatNo 一つ前のパターン番号
+ * @param currPatNo 現在のパターン番号
+ * @param isBlend true なら一つ前のパターンを暗く重ねた遷移表示
+ * @param key 送出データキャッシュのキー
+ * @details 同じ表示内容を送出済みなら、描画せずにキャッシュから送出します（ループ2周目以降はCPU処理なし）。
+ */
+void drawRunFrame(WS2812& led_matrix, const Patterns& ch, const PatManager& pm, size_t prevPatNo, size_t currPatNo, bool isBlend, uint64_t key)
+{
+	LGM_TRACE_SCOPE(TRACE_RUN_FRAME, (uint8_t)(key >> 56),
+	                (uint32_t)((key >> 48) & 0x7Fu) | ((uint32_t)isBlend << 7) | ((uint32_t)(prevPatNo & FRAME_KEY_MAX_PAT) << 8), (uint32_t)currPatNo);
+	if (led_matrix.ShowCached(key, true, false)) return;
+
+	const std::uint32_t* bufPrev = pm.getBufferPtr(prevPatNo); // 焼き込み済み（フラッシュ上）も読み取り専用で参照
+	const std::uint32_t* bufCurr = pm.getBufferPtr(currPatNo);
+	if (!bufPrev || !bufCurr) return;
+
+	// 一つ前のパターンを暗く表示し、その上に現在のパターンを重ねる。
+	// 置換色モードでは遷移表示の間だけ現在のパターンも少し暗くする。
+	// オーバーレイ時は遷移後も前パターンの残像（暗い色）が残る。
+	uint32_t prevColor = ch.isColorReplace ? 0x030000 : 0;
+	uint32_t currColor = ch.isColorReplace ? (isBlend ? 0x060000 : 0x070000) : 0;
+	led_matrix.Clear(0);
+	led_matrix.Reset();
+	if (isBlend || ch.isOverlay) {
+		drawPattern(led_matrix, bufPrev, pm.width(), pm.height(), prevColor, ch.isOverlay); // パターンを描画 (オーバーレイで短い時間を表示)
+	}
+	drawPattern(led_matrix, bufCurr, pm.width(), pm.height(), currColor, ch.isOverlay);     // パターンを描画
+	led_matrix.ScanBufferCached(key, true, false);
+}
+
+/**
+ * @brief エフェクトの1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param fx エフェクト
+ * @param timeMs 時刻(ms)
+ * @details 毎フレーム内容が変わるので、送出データキャッシュには登録しません（キャラクタのフレームを追い出さない）。
+ */
+void drawEffectFrame(WS2812& led_matrix, EffectEngine& fx, uint32_t timeMs)
+{
+	LGM_TRACE_SCOPE(TRACE_EFFECT_FRAME, (uint8_t)fx.current(), timeMs);
+	fx.render(led_matrix.pVRam, timeMs);
+	led_matrix.Reset();
+	led_matrix.ScanBuffer(true, false);
+}
+
+/**
+ * @brief フィルムの1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param film フィルム
+ * @param index フレーム番号
+ * @return フレームを送出できればtrue
+ * @details
+ * - 毎フレーム内容が変わるので、送出データキャッシュには登録しません。
+ * - VRAMと同じ大きさならそのまま写し、違えば左上へ描きます。
+ * - 送出を始めてから次のフレームの先読みを進めます（送出のDMAと重なる）。
+ */
+bool drawFilmFrame(WS2812& led_matrix, FrameStream& film, size_t index)
+{
+	LGM_TRACE_SCOPE_NAMED(trace, TRACE_FILM_FRAME, 0, (uint32_t)index);
+	[[maybe_unused]] const uint32_t missesBefore = film.stats().misses; // トレースの引数（無効なら使わない）
+	const std::uint32_t* buf = film.frame(index);
+	if (!buf) return false;
+	LGM_TRACE_SET_ARGS(trace, film.stats().misses == missesBefore ? 1 : 0, (uint32_t)index);
+
+	if (film.width() == led_matrix.xVRam && film.height() == led_matrix.yVRam) {
+		std::memcpy(led_matrix.pVRam, buf, (size_t)film.width() * film.height() * sizeof(uint32_t));
+	} else {
+		led_matrix.Clear(0);
+		led_matrix.DrawBuffer(buf, film.width(), film.height(), 0, 0, 0, false);
+	}
+	led_matrix.Reset();
+	led_matrix.ScanBuffer(true, false);
+	film.service();
+	return true;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file FrameRender.h
+ * @brief 停止/歩行フレームの合成と送出
+ * @details キャラクタのパターンをVRAMへ合成し、送出データキャッシュを使って送出する関数のヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "WS2812.h"
+#include "PatManager.h"
+#include "Patterns.h"
+#include "Effects.h"
+#include "FrameStream.h"
+
+#define FRAME_KEY_STOP 0x7F ///< 停止表示のグループ番号（送出データキャッシュのキー用）
+#define FRAME_KEY_MAX_PAT 0xFFFFFFu ///< キーに入るパターン番号の上限（これ以上のパターン数は持てない）
+
+/**
+ * @brief 表示内容を表す送出データキャッシュのキーを作ります。
+ * @param charNo キャラクタ番号
+ * @param grpNo パターングループ（停止表示は FRAME_KEY_STOP）
+ * @param prevPatNo 重ねて表示する一つ前のパターン番号（重ねない場合は無視）
+ * @param currPatNo パターン番号
+ * @param withPrev 一つ前のパターンを重ねて表示するならtrue
+ * @param isBlend 遷移表示ならtrue
+ * @return キー（キャラクタ 8bit、遷移 1bit、グループ 7bit、パターン番号は各 24bit）
+ */
+uint64_t frameKey(int charNo, uint8_t grpNo, size_t prevPatNo, size_t currPatNo, bool withPrev, bool isBlend);
+
+/**
+ * @brief 停止表示のフレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param ch キャラクタ設定
+ * @param pmStay 停止パターン
+ * @param key 送出データキャッシュのキー
+ */
+void drawStopFrame(WS2812& led_matrix, const Patterns& ch, const PatManager& pmStay, uint64_t key);
+
+/**
+ * @brief 歩行中の1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param ch キャラクタ設定
+ * @param pm 表示するパターングループ
+ * @param prevPatNo 一つ前のパターン番号
+ * @param currPatNo 現在のパターン番号
+ * @param isBlend true なら一つ前のパターンを暗く重ねた遷移表示
+ * @param key 送出データキャッシュのキー
+ */
+void drawRunFrame(WS2812& led_matrix, const Patterns& ch, const PatManager& pm, size_t prevPatNo, size_t currPatNo, bool isBlend, uint64_t key);
+
+/**
+ * @brief エフェクトの1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param fx エフェクト（begin() でVRAMと同じ大きさにしておく）
+ * @param timeMs 時刻(ms)
+ */
+void drawEffectFrame(WS2812& led_matrix, EffectEngine& fx, uint32_t timeMs);
+
+/**
+ * @brief フィルム（フラッシュ上の長いアニメーション）の1フレームをVRAMへ描画して送出します。
+ * @param led_matrix 出力先
+ * @param film フィルム（open() 済み）
+ * @param index フレーム番号（フレーム数以上は一周させる）
+ * @return フレームを送出できればtrue
+ */
+bool drawFilmFrame(WS2812& led_matrix, FrameStream& film, size_t index);
@@ -0,0 +1,391 @@
+/**
+ * @file FrameStream.cpp
+ * @brief フラッシュ（XIP）上のフィルムを、数フレーム分のRAMで再生するフレームソースの実装
+ */
+
+#include <cstring>
+#include "FrameStream.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+
+static_assert(sizeof(FilmHeader) == 32, "FilmHeader must be 32 bytes");
+static_assert(FRAME_STREAM_SLOTS >= 2, "FRAME_STREAM_SLOTS must be 2 or more");
+
+namespace {
+
+/**
+ * @brief DMA で読むフラッシュのアドレスを、キャッシュに残さない経路へ置き換えます。
+ * @param p XIP 上のアドレス（それ以外はそのまま）
+ * @return 読み出しに使うアドレス
+ * @details 一度しか読まないフレームでプログラムのキャッシュを追い出さないようにします（キャッシュにあればそこから読む）。
+ */
+inline const void* xip_noalloc(const void* p)
+{
+#if defined(XIP_BASE) && defined(XIP_NOCACHE_NOALLOC_BASE) && defined(PICO_FLASH_SIZE_BYTES)
+    const std::uintptr_t a = (std::uintptr_t)p;
+    if (a >= XIP_BASE && a < XIP_BASE + PICO_FLASH_SIZE_BYTES) return (const void*)(a - XIP_BASE + XIP_NOCACHE_NOALLOC_BASE);
+#endif
+    return p;
+}
+
+} // namespace
+
+/**
+ * @brief 1フレームをランレングスに変換します。
+ * @param px 0x00GGRRBB のフレーム
+ * @param n ピクセル数
+ * @param out [out] 出力（nullptr なら語数だけ求める）
+ * @return 出力の語数
+ */
+std::size_t film_rle_encode(const std::uint32_t* px, std::size_t n, std::uint32_t* out)
+{
+    std::size_t words = 0;
+    for (std::size_t i = 0; i < n;) {
+        const std::uint32_t c = px[i] & 0xFFFFFFu;
+        std::size_t run = 1;
+        while (run < 256 && i + run < n && (px[i + run] & 0xFFFFFFu) == c) run++;
+        if (out) out[words] = ((std::uint32_t)(run - 1) << 24) | c;
+        words++;
+        i += run;
+    }
+    return words;
+}
+
+/**
+ * @brief ランレングスの1フレームを展開します。
+ * @param src ランレングスの語列
+ * @param srcWords 語数
+ * @param dst [out] フレーム
+ * @param n ピクセル数
+ * @return ちょうど n ピクセルになればtrue
+ */
+bool film_rle_decode(const std::uint32_t* src, std::size_t srcWords, std::uint32_t* dst, std::size_t n)
+{
+    std::size_t o = 0;
+    for (std::size_t i = 0; i < srcWords; i++) {
+        const std::uint32_t w = src[i];
+        const std::uint32_t c = w & 0xFFFFFFu;
+        std::size_t run = (w >> 24) + 1;
+        if (o + run > n) run = n - o;
+        for (std::uint32_t* d = dst + o, *e = d + run; d < e; d++) *d = c;
+        o += run;
+        if (o == n) return i + 1 == srcWords;
+    }
+    return o == n;
+}
+
+/**
+ * @brief フレームの列からフィルムを作ります。
+ * @param frames フレームの列
+ * @param count フレーム数
+ * @param width 幅
+ * @param height 高さ
+ * @param codec 圧縮形式
+ * @param out [out] 出力（nullptr なら大きさだけ求める）
+ * @param outWords 出力の語数
+ * @return フィルムの語数（out が足りなければ0）
+ */
+std::size_t film_build(const std::uint32_t* frames, std::size_t count, std::uint16_t width, std::uint16_t height,
+                       FILM_CODEC codec, std::uint32_t* out, std::size_t outWords)
+{
+    const std::size_t n = (std::size_t)width * height;
+    const std::size_t headerWords = sizeof(FilmHeader) / sizeof(std::uint32_t);
+    std::size_t dataWords = 0, maxWords = 0;
+    if (codec == FILM_RLE) {
+        for (std::size_t f = 0; f < count; f++) {
+            const std::size_t w = film_rle_encode(frames + f * n, n, nullptr);
+            dataWords += w;
+            if (w > maxWords) maxWords = w;
+        }
+    } else {
+        dataWords = count * n;
+        maxWords = n;
+    }
+    const std::size_t tableWords = codec == FILM_RLE ? count + 1 : 0;
+    const std::size_t total = headerWords + tableWords + dataWords;
+    if (out == nullptr) return total;
+    if (outWords < total) return 0;
+
+    const FilmHeader h { FILM_MAGIC, FILM_VERSION, (std::uint16_t)codec, width, height, (std::uint32_t)count,
+                         (std::uint32_t)maxWords, (std::uint32_t)dataWords, {0, 0} };
+    std::memcpy(out, &h, sizeof(h));
+    std::uint32_t* table = out + headerWords;
+    std::uint32_t* data = table + tableWords;
+    if (codec == FILM_RLE) {
+        std::size_t pos = 0;
+        for (std::size_t f = 0; f < count; f++) {
+            table[f] = (std::uint32_t)pos;
+            pos += film_rle_encode(frames + f * n, n, data + pos);
+        }
+        table[count] = (std::uint32_t)pos;
+    } else {
+        std::memcpy(data, frames, dataWords * sizeof(std::uint32_t));
+    }
+    return total;
+}
+
+FrameStream::~FrameStream()
+{
+    close();
+}
+
+/**
+ * @brief リングに必要な語数を求めます。
+ * @param h フィルムの先頭
+ * @param slots リングの段数
+ * @return 語数
+ */
+std::size_t FrameStream::ringWords(const FilmHeader& h, std::size_t slots)
+{
+    const std::size_t n = (std::size_t)h.width * h.height;
+    return h.codec == FILM_RLE ? slots * h.maxFrameWords + n : slots * n;
+}
+
+/**
+ * @brief フィルムを開きます。
+ * @param film フィルム
+ * @param bytes 大きさ（バイト）
+ * @param ring リング
+ * @param ringCapacity リングの語数
+ * @return 開けたらtrue
+ */
+bool FrameStream::open(const void* film, std::size_t bytes, std::uint32_t* ring, std::size_t ringCapacity)
+{
+    close();
+    if (film == nullptr || bytes < sizeof(FilmHeader)) return false;
+    FilmHeader h;
+    std::memcpy(&h, film, sizeof(h));
+    const std::size_t n = (std::size_t)h.width * h.height;
+    if (h.magic != FILM_MAGIC || h.version != FILM_VERSION || n == 0 || h.frameCount == 0) return false;
+    const std::size_t words = bytes / sizeof(std::uint32_t);
+    const std::uint32_t* body = (const std::uint32_t*)film + sizeof(FilmHeader) / sizeof(std::uint32_t);
+    const std::size_t bodyWords = words - sizeof(FilmHeader) / sizeof(std::uint32_t);
+
+    if (h.codec == FILM_RAW) {
+        if (h.dataWords != (std::uint64_t)h.frameCount * n || bodyWords < h.dataWords) return false;
+        data_ = body;
+        slotWords_ = n;
+    } else if (h.codec == FILM_RLE) {
+        if (h.maxFrameWords == 0 || h.maxFrameWords > n || bodyWords < (std::size_t)h.frameCount + 1 + h.dataWords) return false;
+        // 表の大きさと並びを確かめておく（再生中はフレームの語数だけを見る）
+        for (std::uint32_t f = 0; f < h.frameCount; f++) {
+            if (body[f + 1] < body[f] || body[f + 1] - body[f] > h.maxFrameWords) return false;
+        }
+        if (body[0] != 0 || body[h.frameCount] != h.dataWords) return false;
+        offsets_ = body;
+        data_ = body + h.frameCount + 1;
+        slotWords_ = h.maxFrameWords;
+    } else {
+        return false;
+    }
+    width_ = h.width;
+    height_ = h.height;
+    codec_ = (FILM_CODEC)h.codec;
+    count_ = h.frameCount;
+    if (!openSlots(ring, ringCapacity)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 先頭のないフレームの列を無圧縮のフィルムとして開きます。
+ * @param frames フレームの列
+ * @param count フレーム数
+ * @param width 幅
+ * @param height 高さ
+ * @param ring リング
+ * @param ringCapacity リングの語数
+ * @return 開けたらtrue
+ */
+bool FrameStream::openRaw(const std::uint32_t* frames, std::size_t count, std::uint16_t width, std::uint16_t height,
+                          std::uint32_t* ring, std::size_t ringCapacity)
+{
+    close();
+    if (frames == nullptr || count == 0 || width == 0 || height == 0) return false;
+    data_ = frames;
+    slotWords_ = (std::size_t)width * height;
+    width_ = width;
+    height_ = height;
+    codec_ = FILM_RAW;
+    count_ = count;
+    if (!openSlots(ring, ringCapacity)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief リングを段に分け、先読みのDMAチャネルを確保します。
+ * @param ring リング
+ * @param ringCapacity リングの語数
+ * @return 2段以上取れればtrue
+ */
+bool FrameStream::openSlots(std::uint32_t* ring, std::size_t ringCapacity)
+{
+    const std::size_t decodeWords = codec_ == FILM_RLE ? (std::size_t)width_ * height_ : 0;
+    if (ring == nullptr || ringCapacity < decodeWords) return false;
+    std::size_t slots = (ringCapacity - decodeWords) / slotWords_;
+    if (slots > FRAME_STREAM_SLOTS) slots = FRAME_STREAM_SLOTS;
+    if (slots < 2) return false;
+    ring_ = ring;
+    slotCount_ = slots;
+    decode_ = codec_ == FILM_RLE ? ring + slots * slotWords_ : nullptr;
+    for (Slot& s : slotInfo_) s = Slot {};
+    current_ = -1;
+    dmaSlot_ = -1;
+    stats_ = FrameStreamStats {};
+    dmaChan_ = dma_claim_unused_channel(false); // 空きがなければ先読みなし（その場で読む）
+    return true;
+}
+
+/**
+ * @brief 先読みを止めて閉じます。
+ * @return なし
+ */
+void FrameStream::close()
+{
+    finishDma();
+    if (dmaChan_ >= 0) dma_channel_unclaim((uint)dmaChan_);
+    dmaChan_ = -1;
+    data_ = nullptr;
+    offsets_ = nullptr;
+    ring_ = nullptr;
+    decode_ = nullptr;
+    slotWords_ = 0;
+    slotCount_ = 0;
+    count_ = 0;
+    current_ = -1;
+}
+
+/**
+ * @brief フレームのフラッシュ上の位置を返します。
+ * @param index フレーム番号
+ * @param words [out] 語数
+ * @return 先頭
+ */
+const std::uint32_t* FrameStream::source(std::size_t index, std::uint32_t& words) const
+{
+    if (offsets_ == nullptr) {
+        words = (std::uint32_t)slotWords_;
+        return data_ + index * slotWords_;
+    }
+    words = offsets_[index + 1] - offsets_[index];
+    return data_ + offsets_[index];
+}
+
+/**
+ * @brief フレームが入っている（DMAで読んでいる途中を含む）段を探します。
+ * @param index フレーム番号
+ * @return 段（なければ -1）
+ */
+int FrameStream::findSlot(std::size_t index) const
+{
+    for (std::size_t i = 0; i < slotCount_; i++) {
+        const Slot& s = slotInfo_[i];
+        if (s.frame == index && (s.valid || (int)i == dmaSlot_)) return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief 次に使う段を選びます（表示中の段と、DMAで読んでいる段は除く）。
+ * @param from 基準のフレーム番号
+ * @return 空きか、from から段数分の先に入らないフレームの段（なければ -1）
+ */
+int FrameStream::freeSlot(std::size_t from) const
+{
+    for (std::size_t i = 0; i < slotCount_; i++) {
+        if ((int)i == current_ || (int)i == dmaSlot_) continue;
+        const Slot& s = slotInfo_[i];
+        if (!s.valid || (s.frame + count_ - from) % count_ >= slotCount_) return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief 先読みのDMAの完了を待ち、段を読み終えたことにします。
+ * @return なし
+ */
+void FrameStream::finishDma()
+{
+    if (dmaSlot_ < 0) return;
+    dma_channel_wait_for_finish_blocking((uint)dmaChan_);
+    slotInfo_[dmaSlot_].valid = true;
+    dmaSlot_ = -1;
+}
+
+/**
+ * @brief フレームを返し、続くフレームの先読みを始めます。
+ * @param index フレーム番号
+ * @return フレーム
+ */
+const std::uint32_t* FrameStream::frame(std::size_t index)
+{
+    if (!isOpen()) return nullptr;
+    index %= count_;
+    stats_.frames++;
+    if (dmaSlot_ >= 0 && !dma_channel_is_busy((uint)dmaChan_)) finishDma();
+    int s = findSlot(index);
+    if (s >= 0) {
+        stats_.hits++;
+        if (s == dmaSlot_) {
+            stats_.waits++; // 先読みが表示に追いついていない
+            finishDma();
+        }
+    } else {
+        // 先読みされていない（最初のフレームか、飛んだ位置）: その場で読む。表示中だった段も使ってよい
+        stats_.misses++;
+        current_ = -1;
+        s = freeSlot(index);
+        if (s < 0) s = dmaSlot_ == 0 ? 1 : 0;
+        std::uint32_t words;
+        const std::uint32_t* src = source(index, words);
+        std::memcpy(ring_ + (std::size_t)s * slotWords_, src, words * sizeof(std::uint32_t));
+        stats_.wordsRead += words;
+        slotInfo_[s] = Slot { (std::uint32_t)index, words, true };
+    }
+    current_ = s;
+
+    const std::uint32_t* out = ring_ + (std::size_t)s * slotWords_;
+    if (codec_ == FILM_RLE) {
+        film_rle_decode(out, slotInfo_[s].words, decode_, (std::size_t)width_ * height_);
+        out = decode_;
+    }
+    service();
+    return out;
+}
+
+/**
+ * @brief 先読みのDMAが終わっていれば、次のフレームの先読みを始めます。
+ * @return なし
+ */
+void FrameStream::service()
+{
+    if (!isOpen() || dmaChan_ < 0 || current_ < 0) return;
+    if (dmaSlot_ >= 0) {
+        if (dma_channel_is_busy((uint)dmaChan_)) return;
+        finishDma();
+    }
+    // 表示中の次から順に、リングにないフレームを1つ読む
+    const std::size_t cur = slotInfo_[current_].frame;
+    for (std::size_t k = 1; k < slotCount_; k++) {
+        const std::size_t f = (cur + k) % count_;
+        if (findSlot(f) >= 0) continue;
+        const int s = freeSlot(cur);
+        if (s < 0) return;
+        std::uint32_t words;
+        const std::uint32_t* src = source(f, words);
+        slotInfo_[s] = Slot { (std::uint32_t)f, words, false };
+        dmaSlot_ = s;
+        dma_channel_config c = dma_channel_get_default_config((uint)dmaChan_);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, true);
+        dma_channel_configure((uint)dmaChan_, &c, ring_ + (std::size_t)s * slotWords_, xip_noalloc(src), words, true);
+        stats_.wordsRead += words;
+        return;
+    }
+}
@@ -0,0 +1,201 @@
+/**
+ * @file FrameStream.h
+ * @brief フラッシュ（XIP）上の長いアニメーション（フィルム）を、数フレーム分のRAMで再生するフレームソース
+ * @details
+ * - PatManager はグループの全フレームをRAMへコピーするため、アニメーションの長さがSRAMで決まります。
+ *   FrameStream はフラッシュ上のフレームを直接読み、表示中に次のフレームを小さなリングへDMAで先読みします。
+ *   RAMの使用量はフレーム数によらず、リングの段数分だけです。
+ * - フィルムは無圧縮（FILM_RAW）か、ランレングス（FILM_RLE）です。RLE の1語は 0x00GGRRBB の空いている上位8bitに
+ *   「同じ色が続く数-1」を入れたもので、無圧縮のピクセルもそのまま長さ1の語として読めます。
+ * - 先読みはフィルムの順（最後の次は先頭）を前提にします。順に読む限り、リングに入るまでの待ちは最初の1フレームだけです。
+ *   飛んだ位置を読んだ場合は、その場でフラッシュから読みます（stats().misses）。
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#define FILM_MAGIC 0x464D474Cu ///< フィルムの先頭（"LGMF"）
+#define FILM_VERSION 1         ///< フィルムの形式の版
+#ifndef FRAME_STREAM_SLOTS
+#define FRAME_STREAM_SLOTS 3   ///< リングの段数（表示中 + 先読み。2以上）
+#endif
+
+/**
+ * @brief フィルムの圧縮形式。
+ */
+enum FILM_CODEC : std::uint16_t {
+    FILM_RAW = 0, ///< 無圧縮（1ピクセル1語、フレームは固定長）
+    FILM_RLE = 1  ///< ランレングス（上位8bit = 続く数-1、フレームは可変長）
+};
+
+/**
+ * @brief フィルムの先頭（32バイト）。
+ * @details 続いて FILM_RLE なら各フレームの開始位置の表（frameCount+1 語、データの先頭からの語数）、その後にデータが並びます。
+ *          FILM_RAW なら表はなく、フレーム i はデータの先頭から i*width*height 語目です。
+ */
+struct FilmHeader {
+    std::uint32_t magic;         ///< FILM_MAGIC
+    std::uint16_t version;       ///< FILM_VERSION
+    std::uint16_t codec;         ///< FILM_CODEC
+    std::uint16_t width;         ///< 幅
+    std::uint16_t height;        ///< 高さ
+    std::uint32_t frameCount;    ///< フレーム数
+    std::uint32_t maxFrameWords; ///< 1フレームの最大の語数（リングの1段の大きさ）
+    std::uint32_t dataWords;     ///< データの語数
+    std::uint32_t reserved[2];   ///< 予約（0）
+};
+
+/**
+ * @brief 1フレームをランレングスに変換します。
+ * @param px 0x00GGRRBB のフレーム
+ * @param n ピクセル数
+ * @param out [out] 出力（n 語あれば足りる。nullptr なら語数だけ求める）
+ * @return 出力の語数
+ */
+std::size_t film_rle_encode(const std::uint32_t* px, std::size_t n, std::uint32_t* out);
+
+/**
+ * @brief ランレングスの1フレームを展開します。
+ * @param src ランレングスの語列
+ * @param srcWords 語数
+ * @param dst [out] 0x00GGRRBB のフレーム
+ * @param n ピクセル数
+ * @return ちょうど n ピクセルになればtrue（はみ出す分は書かない）
+ */
+bool film_rle_decode(const std::uint32_t* src, std::size_t srcWords, std::uint32_t* dst, std::size_t n);
+
+/**
+ * @brief フレームの列からフィルムを作ります（PC側のツールやテスト用）。
+ * @param frames 0x00GGRRBB のフレームの列（count*width*height 語）
+ * @param count フレーム数
+ * @param width 幅
+ * @param height 高さ
+ * @param codec 圧縮形式
+ * @param out [out] 出力（nullptr なら大きさだけ求める）
+ * @param outWords 出力の語数
+ * @return フィルムの語数（out が足りなければ0）
+ */
+std::size_t film_build(const std::uint32_t* frames, std::size_t count, std::uint16_t width, std::uint16_t height,
+                       FILM_CODEC codec, std::uint32_t* out, std::size_t outWords);
+
+/**
+ * @brief 先読みの統計。
+ */
+struct FrameStreamStats {
+    std::uint32_t frames;    ///< frame() の回数
+    std::uint32_t hits;      ///< 先読み済み（DMAの完了を待ったものを含む）
+    std::uint32_t waits;     ///< 先読みのDMAの完了を待った回数
+    std::uint32_t misses;    ///< 先読みされておらず、その場でフラッシュから読んだ回数
+    std::uint64_t wordsRead; ///< フラッシュから読んだ語数
+};
+
+/**
+ * @brief フラッシュ上のフィルムを再生するフレームソース。
+ * @details
+ * - リングはフィルムを開くときに呼び出し側が渡します（静的な配列やアリーナ。ringWords() 語）。ヒープは使いません。
+ * - 先読みは DMA（空きチャネルがなければ先読みなし）で、フラッシュの読み出しはキャッシュに残さない経路を使います
+ *   （プログラムのキャッシュを追い出さない）。
+ * - frame() が返すポインタは、次に frame() を呼ぶまで有効です。
+ */
+class FrameStream {
+public:
+    FrameStream() {}
+    ~FrameStream();
+    FrameStream(const FrameStream&) = delete;
+    FrameStream& operator=(const FrameStream&) = delete;
+
+    /**
+     * @brief リングに必要な語数を求めます。
+     * @param h フィルムの先頭
+     * @param slots リングの段数
+     * @return 語数（FILM_RLE では展開先の1フレーム分を含む）
+     */
+    static std::size_t ringWords(const FilmHeader& h, std::size_t slots = FRAME_STREAM_SLOTS);
+
+    /**
+     * @brief フィルムを開きます。
+     * @param film フィルム（FilmHeader から始まる、4バイト境界）
+     * @param bytes フィルムの大きさ（バイト）
+     * @param ring リング
+     * @param ringCapacity リングの語数（ringWords() 以上。段数はこの大きさから決まる）
+     * @return 形式が正しく、リングが2段以上取れればtrue
+     */
+    bool open(const void* film, std::size_t bytes, std::uint32_t* ring, std::size_t ringCapacity);
+
+    /**
+     * @brief 先頭のないフレームの列（焼き込み済みのパターンなど）を無圧縮のフィルムとして開きます。
+     * @param frames 0x00GGRRBB のフレームの列（count*width*height 語）
+     * @param count フレーム数
+     * @param width 幅
+     * @param height 高さ
+     * @param ring リング
+     * @param ringCapacity リングの語数
+     * @return リングが2段以上取れればtrue
+     */
+    bool openRaw(const std::uint32_t* frames, std::size_t count, std::uint16_t width, std::uint16_t height,
+                 std::uint32_t* ring, std::size_t ringCapacity);
+
+    /** @brief 先読みを止めて閉じます。 @return なし */
+    void close();
+
+    /**
+     * @brief フレームを返し、続くフレームの先読みを始めます。
+     * @param index フレーム番号（フレーム数以上は一周させる）
+     * @return 0x00GGRRBB のフレーム（閉じていれば nullptr）
+     */
+    const std::uint32_t* frame(std::size_t index);
+
+    /**
+     * @brief 先読みのDMAが終わっていれば、次のフレームの先読みを始めます。
+     * @return なし
+     * @details frame() の中でも呼びます。表示の合間（送出中など）に呼ぶと、段数分まで先読みが進みます。
+     */
+    void service();
+
+    /** @brief 開いていればtrue。 */
+    inline bool isOpen() const { return count_ != 0; }
+    /** @brief フレーム数。 */
+    inline std::size_t count() const { return count_; }
+    /** @brief 幅。 */
+    inline std::uint16_t width() const { return width_; }
+    /** @brief 高さ。 */
+    inline std::uint16_t height() const { return height_; }
+    /** @brief 圧縮形式。 */
+    inline FILM_CODEC codec() const { return codec_; }
+    /** @brief リングの段数。 */
+    inline std::size_t slots() const { return slotCount_; }
+    /** @brief 統計。 */
+    inline const FrameStreamStats& stats() const { return stats_; }
+
+private:
+    /** @brief リングの1段。 */
+    struct Slot {
+        std::uint32_t frame; ///< 入っているフレーム
+        std::uint32_t words; ///< 語数
+        bool valid;          ///< 読み終えている
+    };
+
+    bool openSlots(std::uint32_t* ring, std::size_t ringCapacity);
+    const std::uint32_t* source(std::size_t index, std::uint32_t& words) const;
+    int findSlot(std::size_t index) const;
+    int freeSlot(std::size_t from) const;
+    void finishDma();
+
+    const std::uint32_t* data_ { nullptr };    ///< データの先頭（フラッシュ上）
+    const std::uint32_t* offsets_ { nullptr }; ///< 各フレームの開始位置（FILM_RLE のみ）
+    std::uint32_t* ring_ { nullptr };          ///< リング
+    std::uint32_t* decode_ { nullptr };        ///< 展開先（FILM_RLE のみ）
+    std::size_t slotWords_ { 0 };              ///< 1段の語数
+    std::size_t slotCount_ { 0 };              ///< 段数
+    std::size_t count_ { 0 };                  ///< フレーム数
+    std::uint16_t width_ { 0 };                ///< 幅
+    std::uint16_t height_ { 0 };               ///< 高さ
+    FILM_CODEC codec_ { FILM_RAW };            ///< 圧縮形式
+    Slot slotInfo_[FRAME_STREAM_SLOTS] {};     ///< 各段の内容
+    int current_ { -1 };                       ///< 表示中の段
+    int dmaChan_ { -1 };                       ///< 先読みのDMAチャネル
+    int dmaSlot_ { -1 };                       ///< DMAで読んでいる段
+    FrameStreamStats stats_ {};                ///< 統計
+};
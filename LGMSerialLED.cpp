@@ -9,7 +9,6 @@
 #include <array>
 #include "pico/stdlib.h"
 #include "pico/time.h"
-// #include "pico/sleep.h"
 
 #include "hardware/clocks.h" // set_sys_clock_khz
 #include "./WS2812/include/WS2812.h"
@@ -26,8 +25,38 @@
 
 #include "./WS2812/include/GammaCorrector.h"
 #include "PatManager.h"
-static volatile uint8_t timer_count = 0; ///< 10秒タイマーの経過カウント(最大6)
-static volatile bool timer_change = false; ///< タイマー境界のフラグ
+#include "Patterns.h"
+#include "PatCache.h"
+#include "AnimSequencer.h"
+#include "FrameRender.h"
+#include "AppEvents.h"
+#include "PowerManager.h"
+#include "TraceRecorder.h"
+#include "Effects.h"
+#include "BootTimeline.h"
+#include "CoroScheduler.h"
+
+#define SEQ_TICK_MS 5 ///< 歩行中の再生位置の更新周期(ms)。アニメーションの速度とは独立
+#define IDLE_TIMEOUT_MS 30000 ///< 停止表示のまま無操作でこの時間が経つと休止へ
+#define SYS_CLOCK_KHZ_ACTIVE 150000 ///< 描画中（停止表示の作成/歩行）の clk_sys
+#define SYS_CLOCK_KHZ_IDLE 48000     ///< 停止表示のまま待機中の clk_sys
+#define EFFECT_FRAME_MS 16 ///< エフェクトのフレーム周期(ms)（約60FPS）
+#define EFFECT_TIMEOUT_MS 300000 ///< エフェクト表示のまま無操作でこの時間が経つと休止へ
+#ifndef LED_PANEL_WIDTH
+#define LED_PANEL_WIDTH 16  ///< 1枚のパネルの幅（ピクセル）
+#endif
+#ifndef LED_PANEL_HEIGHT
+#define LED_PANEL_HEIGHT 16 ///< 1枚のパネルの高さ（ピクセル）
+#endif
+#ifndef LED_PANELS_X
+#define LED_PANELS_X 1      ///< 水平方向のパネル枚数（例: 16x16 を 8x4 枚で 128x64）
+#endif
+#ifndef LED_PANELS_Y
+#define LED_PANELS_Y 1      ///< 垂直方向のパネル枚数
+#endif
+#ifndef LGM_FAST_BOOT
+#define LGM_FAST_BOOT 1 ///< 1: 起動直後にフラッシュの停止表示を送出し、休止せずに最初のキャラクタを表示する（0: 消灯して休止から開始）
+#endif
 
 /**
  * @brief アプリの状態遷移を表す列挙。
@@ -37,197 +66,274 @@ enum STATE {
 	STATE_STOP = 1,
 	STATE_START = 2,
 	STATE_WALKING = 3,
-	STATE_RUNNING = 4
+	STATE_RUNNING = 4,
+	STATE_EFFECT = 5
 };
-STATE iState = STATE_HIBER; ///< 現在の状態（開始=休止）
+STATE iState = STATE_HIBER; ///< 現在の状態（開始=休止）。トレースの記録用に、スクリプトが進行に合わせて更新する
 
 /**
- * @brief デバウンス付きのボタン押下検出（Active-Low, 1回/押下）。
- * @param gpio_pin 対象GPIO
- * @return 押下エッジでtrue（1回のみ）
- * @details デバウンス付き：押下（プルアップなので Active-Low）を1回だけ検出。任意GPIOのボタンを処理できるよう、GPIOごとに状態を保持する
+ * @brief 表示するキャラクタの一覧。
  */
-static bool button_pressed(uint gpio_pin)
+Patterns CharInfo[] = {
+	{LGMRed, {&LGMPat[0][0], NULL, NULL, NULL}, LGMPatCount, PATTERNS_CORRECTION(LGMCorrection), true, true, iWaitLGMWalk, iWaitLGMRun, true},
+	{MROStayBaked, {MRORunBaked, NULL, NULL, NULL}, MROPatCount, PATTERNS_CORRECTION(MROCorrection), false, false, iWaitMarioWalk, iWaitMarioRun, true},
+	{ZELDAStayBaked, {ZELDARightBaked, ZELDAFrontBaked, ZELDALeftBaked, ZELDABackBaked}, ZELDARightCount, PATTERNS_CORRECTION(ZELDACorrection), false, false, iWaitZeldaWalk, iWaitZeldaRun, true},
+	{KirbyStayBaked, {KirbyWalkBaked, KirbyRollBaked, NULL, NULL}, KirbyWalkCount, PATTERNS_CORRECTION(KirbyCorrection), false, false, iWaitKirbyWalk, iWaitKirbyRun, true},
+	{DQ3StayBaked, {DQ3RightBaked, DQ3FrontBaked, DQ3LeftBaked, DQ3BackBaked}, DQ3RightCount, PATTERNS_CORRECTION(DQ3Correction), false, false, iWaitDQ3Walk, iWaitDQ3Run, true},
+
+};
+PatCache patCache;        ///< 補正済みパターン一式のキャッシュ
+PatSet* curSet = nullptr; ///< 表示中キャラクタのパターン一式
+AnimSequencer sequencer; ///< 歩行アニメーションの再生位置
+SeqTempo seqTempos[2];   ///< 表示中キャラクタのテンポ
+PowerManager power; ///< 休止（低消費電力）の管理
+EffectEngine effects; ///< エフェクト（キャラクタの後に SET で選ぶ）
+BootTimeline bootTimeline; ///< 起動から最初のキャラクタ表示までの各段階の時刻
+CoroScheduler scripts; ///< アニメーション/入力/アイドル監視のスクリプト（メインループが再開する）
+
+/**
+ * @brief clk_sys を変更し、WS2812 の分周を合わせます。
+ * @param led_matrix 分周を合わせるLEDドライバ
+ * @param khz 新しい clk_sys(kHz)
+ * @details 送出を止めてからクロックを変更し、新しいクロックから分周を計算し直して再開します。
+ *          分周器の範囲外（前の分周のまま再開）や、分周誤差が許容範囲を超える場合はUARTへ出力します。
+ */
+static void change_sys_clock(WS2812& led_matrix, uint32_t khz)
 {
-	struct DebounceState {
-		bool used = false;
-		uint pin = 0;
-		bool last_reading = true; // 直近の生読み取り
-		bool debounced = true;    // デバウンス後の安定状態
-		uint32_t last_change_ms = 0;
-		bool armed = true;        // 押下1回につき1度だけtrueを返す
-		bool initialized = false; // 初回初期化済みフラグ
-	};
-
-	// 同時に扱うGPIOの上限（必要に応じて拡張可）
-	static DebounceState states[8];
-
-	// スロット検索/確保
-	DebounceState* st = nullptr;
-	for (auto& s : states) {
-		if (s.used && s.pin == gpio_pin) {
-			st = &s;
-			break;
-		}
+	if (clock_get_hz(clk_sys) == khz * 1000u) return;
+	LGM_TRACE_SCOPE(TRACE_CLOCK, 0, khz);
+	led_matrix.Suspend();
+	set_sys_clock_khz(khz, true);
+	if (!led_matrix.Resume()) {
+		printf("[clock] %lu kHz: WS2812 divider out of range, keeping the previous one\n", (unsigned long)khz);
+		return;
 	}
-	if (!st) {
-		for (auto& s : states) {
-			if (!s.used) {
-				st = &s;
-				break;
-			}
-		}
-	}
-	if (!st) {
-		// スロット不足時は最初を使い回し（稀なケース）
-		st = &states[0];
-	}
-	if (!st->used) {
-		st->used = true;
-		st->pin = gpio_pin;
-		st->last_reading = gpio_get(gpio_pin);
-		st->debounced = st->last_reading;
-		st->last_change_ms = to_ms_since_boot(get_absolute_time());
-		st->armed = true;
-		st->initialized = true;
+	const WS2812Timing& t = led_matrix.GetTiming();
+	if (t.errorPpm > WS2812_MAX_ERROR_PPM || t.errorPpm < -WS2812_MAX_ERROR_PPM) {
+		printf("[clock] %lu kHz: WS2812 div %u+%u/256, error %ld ppm, jitter %lu ns\n",
+		       (unsigned long)khz, t.divInt, t.divFrac, (long)t.errorPpm, (unsigned long)t.jitterNs);
 	}
+}
 
-	bool reading = gpio_get(gpio_pin);
-	uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+/** @brief 起動からの時刻(ms)。スクリプトの時計。 */
+static inline uint32_t now_ms()
+{
+	return to_ms_since_boot(get_absolute_time());
+}
 
-	if (reading != st->last_reading) {
-		st->last_change_ms = now_ms; // 変化を検出、デバウンス計測開始
-		st->last_reading = reading;
-	}
+/**
+ * @brief LEDを消灯して休止し、ボタンで起床するまで戻りません。
+ * @param led_matrix LEDドライバ
+ * @return なし
+ * @details 休止中に届いたイベント（起床のボタン押下を含む）は捨てます。
+ */
+static void hibernate(WS2812& led_matrix)
+{
+	iState = STATE_HIBER;
+#if LGM_TRACE_ENABLE
+	g_trace.Dump();
+	g_trace.Clear();
+#endif
+	led_matrix.Reset();
+	led_matrix.Clear(0);
+	led_matrix.ScanBuffer();
+	events_cancel_timer(TIMER_CORO);
+	events_flush();
 
-	// 30ms安定したら確定
-	if ((now_ms - st->last_change_ms) > 30) {
-		if (st->debounced != reading) {
-			st->debounced = reading;
-			if (st->debounced == false) {
-				// 立下り＝押下確定（Active-Low）
-				if (st->armed) {
-					st->armed = false; // 次の解放まで無効化
-					return true;
-				}
-			} else {
-				// 解放で再武装
-				st->armed = true;
-			}
-		}
-	}
-	return false;
+	// いずれかのボタンが押されるまで低消費電力で休止
+	power.hibernate(led_matrix);
+	events_flush();
 }
 
 /**
- * @brief 10秒タイマーのコールバック。6回到達で停止。
- * @param rt タイマー
- * @return 継続可否（6回でfalse）
+ * @brief キャラクタの停止表示を作って表示します。
+ * @param led_matrix LEDドライバ
+ * @param iCharNo キャラクタ番号
+ * @return 表示できたらtrue（パターン一式のメモリが足りなければ false）
+ * @details 表示後、SETで次に表示するキャラクタを前もって処理しておきます（表示中の一式は残す）。
  */
-bool one_shot_cb(repeating_timer_t* rt)
+static bool showStop(WS2812& led_matrix, int iCharNo)
 {
-	(void)rt;
-	timer_count++;
-	timer_change = true;
-	if (timer_count >= 6) {
-		timer_count = 0;
-		iState = STATE_STOP;
-		return false; // タイマーは停止
+	iState = STATE_STOP;
+	change_sys_clock(led_matrix, SYS_CLOCK_KHZ_ACTIVE); // パターンの前処理は高いクロックで
+	{
+		LGM_TRACE_SCOPE(TRACE_SET_CHAR, (uint8_t)iCharNo);
+		curSet = patCache.acquire(CharInfo[iCharNo]); // 処理済みならキャッシュから（キャラ変更/歩行後の再表示）
+	}
+	if (curSet == nullptr) {
+		printf("[patcache] %d: out of memory\n", iCharNo);
+		return false;
+	}
+
+	drawStopFrame(led_matrix, CharInfo[iCharNo], curSet->stay, frameKey(iCharNo, FRAME_KEY_STOP, 0, 0, false, false));
+	power.frameShown(); // 休止からの起床直後なら、起床→表示のレイテンシを出力
+	if (bootTimeline.mark("first character", time_us_64())) bootTimeline.print(); // 起動後の最初の1回だけ
+
+	size_t nextCharNo = (iCharNo + 1) % (sizeof(CharInfo) / sizeof(CharInfo[0]));
+	{
+		LGM_TRACE_SCOPE(TRACE_SET_CHAR, (uint8_t)nextCharNo, 1);
+		patCache.prefetch(CharInfo[nextCharNo]);
 	}
 	return true;
 }
 
 /**
- * @brief GPIO割り込みコールバック（休止復帰の可視化）。
+ * @brief 歩行タイムラインを最後まで再生するスクリプト。
+ * @param led_matrix LEDドライバ
+ * @param iCharNo キャラクタ番号
+ * @return スクリプト
+ * @details 再生位置は経過時間から求め、表示内容が変わったときだけ送出します。歩行中のボタン押下は誰も待たないので捨てられます。
  */
-void gpio_callback(uint gpio, uint32_t events)
+static CoroTask walkScript(WS2812& led_matrix, int iCharNo)
 {
-	if (gpio == BUTTON_PIN_ENTER) {
-		// 割り込み発生時の処理
-		gpio_put(PICO_DEFAULT_LED_PIN, 0);
-	} else if (gpio == BUTTON_PIN_SET) {
-		// 割り込み発生時の処理
-		gpio_put(PICO_DEFAULT_LED_PIN, 1);
+	iState = STATE_WALKING;
+	const Patterns& ch = CharInfo[iCharNo];
+	size_t stepCount;
+	const SeqStep* steps = ch.timeline(stepCount);
+	ch.makeTempos(seqTempos);
+	sequencer.begin(steps, stepCount, seqTempos, ch.PatWalkCount, now_ms());
+	scripts.setFramePeriod(SEQ_TICK_MS, now_ms());
+
+	// 表示済みの内容（変化があったときだけ送出する）
+	size_t shownPatNo = 0;
+	uint8_t shownGrpNo = 0;
+	bool shownBlend = false;
+	bool isShown = false;
+	while (true) {
+		SeqPosition pos = sequencer.update(now_ms());
+		if (pos.finished) co_return;
+		uint8_t patGrpNo = pos.group;
+		if (patGrpNo >= 4 || curSet->run[patGrpNo].isInitialized == false) {
+			patGrpNo = 0;
+		}
+		if (!isShown || pos.frame != shownPatNo || pos.isBlend != shownBlend || patGrpNo != shownGrpNo) {
+			uint64_t key = frameKey(iCharNo, patGrpNo, pos.prevFrame, pos.frame, pos.isBlend || ch.isOverlay, pos.isBlend);
+			drawRunFrame(led_matrix, ch, curSet->run[patGrpNo], pos.prevFrame, pos.frame, pos.isBlend, key);
+			shownPatNo = pos.frame;
+			shownGrpNo = patGrpNo;
+			shownBlend = pos.isBlend;
+			isShown = true;
+		}
+		co_await coro_next_frame();
 	}
 }
 
-/** @brief 色レンジ指定（各チャネルの最小/最大）。 */
-struct COLOR_RANGE { uint8_t min; uint8_t max; };
+/**
+ * @brief 選択中のエフェクトを毎フレーム描画するスクリプト（止められるまで続く）。
+ * @param led_matrix LEDドライバ
+ * @return スクリプト
+ */
+static CoroTask effectScript(WS2812& led_matrix)
+{
+	scripts.setFramePeriod(EFFECT_FRAME_MS, now_ms());
+	while (true) {
+		// 時刻から1フレームを計算して送出する
+		drawEffectFrame(led_matrix, effects, now_ms());
+		power.frameShown();
+		co_await coro_next_frame();
+	}
+}
 
 /**
- * @brief キャラクタごとの描画設定とパターン群。
- * @details 停止1枚 + 最大4グループの連番パターンで構成します。
+ * @brief アプリ全体（停止表示→ボタン待ち→歩行/キャラ変更/エフェクト→無操作で休止）のスクリプト。
+ * @param led_matrix LEDドライバ
+ * @param fastBoot 起動直後の表示済み（休止せずに最初のキャラクタを表示する）
+ * @return スクリプト
+ * @details エフェクト中の描画は別のスクリプトに任せ、こちらはボタンとアイドルを待ちます。
  */
-class Patterns {
-	public:
-	const std::uint32_t* PatStopFlat;			/// 停止パターンは１つだけ
-	const std::uint32_t* PatWalkFlat[4];		///　パターングループとして４つまで登録可能
-	size_t PatWalkCount;						/// 各パターンの数。本当は、パターングループに含まれるパターンごとに違う可能性もあるが、ゲームという特性上ほぼ同じなので１つにする。
-	COLOR_RANGE GreenRange;						/// 
-	COLOR_RANGE RedRange;
-	COLOR_RANGE BlueRange;
-	float Gamma;
-	uint8_t BrightnessPercent;
-	uint8_t ContrastPercent;
-	bool isColorReplace;
-	bool isOverlay;
-	uint16_t iWaitWalk;
-	uint16_t iWaitRun;
-
-	/**
-	 * @brief PatManagerへパターンをロードし、補正を適用します。
-	 * @param pmStay 停止パターン用
-	 * @param pmRun  走行パターン用(最大4グループ)
-	 */
-	void setPatManager(PatManager &pmStay,  PatManager* pmRun) 
-	{
-		pmStay.reset();
-		for (int i = 0; i < 4; i++) {
-			if (pmRun[i].isInitialized) pmRun[i].reset();
-		}	
-		pmStay.init(PatStopFlat, 1, 16, 16);
-		pmStay.setGreenRange(GreenRange.min, GreenRange.max);
-		pmStay.setRedRange(RedRange.min, RedRange.max);
-		pmStay.setBlueRange(BlueRange.min, BlueRange.max);
-		if (Gamma > 0.0f) pmStay.setGamma(Gamma);
-		if (BrightnessPercent !=0 || ContrastPercent != 0) pmStay.setBrightnessContrast(BrightnessPercent, ContrastPercent);
-
-		for (int i = 0; i < 4; i++) {
-			if (PatWalkFlat[i] == NULL) break;
-
-			pmRun[i].init(PatWalkFlat[i], PatWalkCount, 16, 16);
-			pmRun[i].setGreenRange(GreenRange.min, GreenRange.max);
-			pmRun[i].setRedRange(RedRange.min, RedRange.max);
-			pmRun[i].setBlueRange(BlueRange.min, BlueRange.max);
-			if (Gamma > 0.0f) pmRun[i].setGamma(Gamma);
-			if (BrightnessPercent != 0 || ContrastPercent != 0) pmRun[i].setBrightnessContrast(BrightnessPercent, ContrastPercent);
+static CoroTask appScript(WS2812& led_matrix, bool fastBoot)
+{
+	const int charCount = (int)(sizeof(CharInfo) / sizeof(CharInfo[0]));
+	int iCharNo = 0;
+	if (!fastBoot) hibernate(led_matrix);
+	while (true) {
+		if (!showStop(led_matrix, iCharNo)) {
+			hibernate(led_matrix);
+			continue;
+		}
+		change_sys_clock(led_matrix, SYS_CLOCK_KHZ_IDLE); // 待機中はクロックを下げる（LEDは表示を保持）
+
+		// ボタンを待つ。無操作が続いたら休止へ
+		iState = STATE_START;
+		AppEvent ev = co_await coro_wait_event(EVT_BUTTON, IDLE_TIMEOUT_MS);
+		if (ev.type == EVT_NONE) {
+			hibernate(led_matrix);
+		} else if (ev.id == BUTTON_PIN_ENTER) {
+			// 歩行タイムラインを最後まで再生して、停止表示へ戻る
+			change_sys_clock(led_matrix, SYS_CLOCK_KHZ_ACTIVE);
+			co_await walkScript(led_matrix, iCharNo);
+		} else if (ev.id == BUTTON_PIN_SET && ++iCharNo >= charCount) {
+			// 最後のキャラクタの次はエフェクト（全エフェクトの後は最初のキャラクタへ戻る）
+			iCharNo = 0;
+			iState = STATE_EFFECT;
+			change_sys_clock(led_matrix, SYS_CLOCK_KHZ_ACTIVE);
+			effects.select(EFFECT_PLASMA);
+			std::uint8_t anim = 0;
+			if (!scripts.spawn(effectScript(led_matrix), &anim)) printf("[coro] effect script: not started\n");
+			bool idle = false;
+			while (true) {
+				ev = co_await coro_wait_event(EVT_BUTTON, EFFECT_TIMEOUT_MS); // SETでアイドル計測も再始動
+				if (ev.type == EVT_NONE) {
+					idle = true;
+					break;
+				}
+				if (ev.id == BUTTON_PIN_ENTER) break;
+				if (ev.id != BUTTON_PIN_SET) continue;
+				// 次のエフェクトへ。最後のエフェクトの次は最初のキャラクタの停止表示
+				int next = (int)effects.current() + 1;
+				if (next >= EFFECT_COUNT) break;
+				effects.select((EFFECT_KIND)next);
+			}
+			scripts.cancel(anim);
+			if (idle) hibernate(led_matrix);
 		}
-
 	}
+}
 
-} CharInfo[] = {
-	{LGMRed, {&LGMPat[0][0], NULL, NULL, NULL}, LGMPatCount, {0, 0}, {0, 0}, {0, 0}, 1.0f, 0, 0, true, true, iWaitLGMWalk, iWaitLGMRun},
-	{MROStay, {&MRORun[0][0], NULL, NULL, NULL}, MROPatCount, {0, 16}, {0, 16}, {0, 16}, 1.0f, 0, 0, false, false, iWaitMarioWalk, iWaitMarioRun},
-	{ZELDAStay, {&ZELDARight[0][0], &ZELDAFront[0][0], &ZELDALeft[0][0], &ZELDABack[0][0]}, ZELDARightCount, {0, 16}, {0, 16}, {0, 16}, 1.0f, 0, 0, false, false, iWaitZeldaWalk, iWaitZeldaRun},
-	{KirbyStay, {&KirbyWalk[0][0], &KirbyRoll[0][0], NULL, NULL}, KirbyWalkCount, {0, 16}, {0, 16}, {0, 16}, 1.0f, 0, 0, false, false, iWaitKirbyWalk, iWaitKirbyRun},
-	{DQ3Stay, {&DQ3Right[0][0], &DQ3Front[0][0], &DQ3Left[0][0], &DQ3Back[0][0]}, DQ3RightCount, {0, 16}, {0, 16}, {0, 16}, 1.0f, 0, 0, false, false, iWaitDQ3Walk, iWaitDQ3Run},
-
-};
-PatManager pmRun[4]; ///< 走行用パターングループ
-PatManager pmStay;   ///< 停止表示用
 /**
  * @brief エントリーポイント。
  * @return 実行ステータス
  */
 int main()
 {
-
-	// WS2812 のタイミング定数が 125MHz 前提のため、起動直後に 125MHz に固定
-	set_sys_clock_khz(125000, true);
+	// time_us_64() はリセットからの時間（ここまでが起動ROMとランタイムの初期化）
+	bootTimeline.mark("main", time_us_64());
+
+	// WS2812 の分周は clk_sys から計算するため、クロックは任意（描画用の周波数で起動）
+	set_sys_clock_khz(SYS_CLOCK_KHZ_ACTIVE, true);
+	bootTimeline.mark("clock", time_us_64());
+
+	// パネルの大きさと枚数はビルド時に指定（既定は 16x16 を1枚）。キャラクタのパターンはVRAMに合わせて拡大して描く
+	WS2812 led_matrix(PIN_WS2812_1, LED_PANEL_WIDTH, LED_PANEL_HEIGHT, LED_PANELS_X, LED_PANELS_Y);
+	led_matrix.SetDeltaTransmit(true); // 変化したLEDまでだけ送る（停止表示などの同じフレームは送らない）
+	bootTimeline.mark("ws2812", time_us_64());
+
+	// 電源投入ですぐ点灯させる: 最初のキャラクタの停止表示（送出順に並べ済み、フラッシュ上）をそのままDMAで送る。
+	// パターンの処理・VRAMへの描画は、この後の最初の STATE_STOP で行う（表示内容は同じ）
+#if LGM_FAST_BOOT
+	const bool fastBoot = led_matrix.WireWords() == LGMBootWireWords;
+#else
+	const bool fastBoot = false;
+#endif
+	if (fastBoot) {
+		led_matrix.Reset();
+		sleep_us(100); // ScanBuffer() と同じく、リセット直後の安全待ち
+		led_matrix.TransmitWire(LGMBootWire, LGMBootWireWords);
+		bootTimeline.mark("boot frame", time_us_64());
+	}
 
 	stdio_init_all();
-	// 1枚 8x8 パネルを前提（必要に応じて枚数を変更）
-	WS2812 led_matrix(PIN_WS2812_1, 16, 16);
+	bootTimeline.mark("stdio", time_us_64());
+
+	// 実行時に補正するキャラクタのバッファは起動時に固定領域として確保する（キャラクタ切り替えでヒープを使わない）。
+	// 焼き込み済みのキャラクタはバッファを使わない（processedBytes() が 0）ので、すべて焼き込み済みなら確保しない。
+	size_t maxSetBytes = 0;
+	for (const Patterns& ch : CharInfo) {
+		if (ch.processedBytes() > maxSetBytes) maxSetBytes = ch.processedBytes();
+	}
+	if (maxSetBytes > 0 && !patCache.reserveArena(maxSetBytes)) {
+		printf("[patcache] arena %u bytes: not reserved, using heap\n", (unsigned)maxSetBytes);
+	}
 
 	// ボタン(GP28)をプルアップ入力で初期化
 	gpio_init(BUTTON_PIN_ENTER);
@@ -239,141 +345,41 @@ int main()
 	gpio_pull_up(BUTTON_PIN_SET);
 	gpio_set_dir(BUTTON_PIN_SET, GPIO_IN);
 
-	led_matrix.Reset();
-	led_matrix.Clear(0);
-	led_matrix.ScanBuffer();
-	int currPatNo = 0;
-	int prevPatNo = 0;
-
-	// 時刻開始（マイクロ秒単位）
-	uint64_t start_us = time_us_64();
-	repeating_timer_t rt;
-
-	int iCharNo = 0;
-	set_sys_clock_khz(125000, true);
-
-	uint8_t patGrpNo = 0;
+	if (!fastBoot) {
+		led_matrix.Reset();
+		led_matrix.Clear(0);
+		led_matrix.ScanBuffer();
+	}
+	effects.begin((uint16_t)led_matrix.xVRam, (uint16_t)led_matrix.yVRam); // VRAMと同じ大きさ（炎の作業領域はここで1回だけ確保）
+
+	// ボタンはエッジ割り込み＋アラームでデバウンスし、イベントとして受け取る（ポーリングしない）
+	events_add_button(BUTTON_PIN_ENTER);
+	events_add_button(BUTTON_PIN_SET);
+	power.addWakePin(BUTTON_PIN_ENTER);
+	power.addWakePin(BUTTON_PIN_SET);
+#if LGM_TRACE_ENABLE
+	g_trace.Enable(true); // 休止に入るたびに UART へ出力して空にする
+#endif
+	bootTimeline.mark("init", time_us_64());
+	iState = fastBoot ? STATE_STOP : STATE_HIBER; // 高速起動なら休止せず、最初のキャラクタを処理して表示する
+
+	if (!scripts.spawn(appScript(led_matrix, fastBoot))) {
+		printf("[coro] app script: no frame (%u bytes > %u)\n", (unsigned)coro_pool_stats().maxBytes, (unsigned)CORO_FRAME_BYTES);
+	}
 
+	// スクリプトを再開し、次の期限（遅延/フレーム/タイムアウト）までタイマーを掛けてイベントを待つ
 	while (true) {
-
-		while (true) {
-			if (iState == STATE_HIBER) {
-				// アクティブローのボタンなので、押下で起床するよう立下りエッジで割り込み
-				gpio_set_irq_enabled_with_callback(BUTTON_PIN_ENTER, GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
-				gpio_set_irq_enabled_with_callback(BUTTON_PIN_SET,   GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
-				led_matrix.Reset();
-				led_matrix.Clear(0);
-				led_matrix.ScanBuffer();
-				__asm("  wfi");
-				gpio_set_irq_enabled_with_callback(BUTTON_PIN_ENTER, GPIO_IRQ_EDGE_FALL, false, &gpio_callback);
-				gpio_set_irq_enabled_with_callback(BUTTON_PIN_SET,   GPIO_IRQ_EDGE_FALL, false, &gpio_callback);
-
-				iState = STATE_STOP;
-
-			} else if (iState == STATE_STOP) {
-				led_matrix.Reset();
-				CharInfo[iCharNo].setPatManager(pmStay, pmRun);
-
-
-
-				if (CharInfo[iCharNo].isColorReplace) {
-					const std::uint32_t* buf = static_cast<const std::uint32_t*>(pmStay.getBufferPtr(0));
-					led_matrix.DrawBuffer(buf, 16, 16, 0, 0, 0x000700, false); // パターンを描画
-				} else {
-					const std::uint32_t* buf = static_cast<const std::uint32_t*>(pmStay.getBufferPtr(0));
-					led_matrix.DrawBuffer(buf, 16, 16, 0, 0, 0, false); // パターンを描画
-				}
-				led_matrix.ScanBuffer(true, false);
-
-				iState = STATE_START;
-			} else if (iState == STATE_START) {
-				// アイドル監視: STATE_STARTに入ってからの無操作時間を計測
-				static uint32_t idle_start_ms = 0;
-				uint32_t now_ms_state = to_ms_since_boot(get_absolute_time());
-				if (idle_start_ms == 0) idle_start_ms = now_ms_state;
-
-				// ボタンが押されたら、１０秒間隔のタイマーを開始する。
-				if (button_pressed(BUTTON_PIN_ENTER)) {
-					// 時刻開始（マイクロ秒単位）
-					// １０秒間隔タイマー
-					if (!add_repeating_timer_ms(10000, one_shot_cb, NULL, &rt)) {
-						printf("Failed to add timer\n");
-						return 1;
-					}
-					idle_start_ms = 0; // 動作開始でアイドル計測はリセット
-					iState = STATE_WALKING;
-				} else if (button_pressed(BUTTON_PIN_SET)) {
-					// キャラ変更ボタンが押された場合の処理
-					iCharNo++;
-					if (iCharNo >= (sizeof(CharInfo) / sizeof(CharInfo[0]))) {
-						iCharNo = 0;
-					}	
-					idle_start_ms = now_ms_state; // 操作があったので起点を更新
-					iState = STATE_STOP;
-				} else {
-					// 無操作が30秒続いたら休止へ
-					if ((now_ms_state - idle_start_ms) >= 30000u) {
-						idle_start_ms = 0;
-						iState = STATE_HIBER;
-					}
-				}
-
-
-			} else if (iState == STATE_WALKING || iState == STATE_RUNNING) {
-				int iWaitMs;
-				int iTransMs;
-				if (timer_count < 5) {
-					iWaitMs = CharInfo[iCharNo].iWaitWalk;
-					iTransMs = iWaitMs / 4;
-				} else {
-					iWaitMs = CharInfo[iCharNo].iWaitRun;
-					iTransMs = iWaitMs / 6;
-				}
-				if (timer_change) {
-					timer_change = false;
-					patGrpNo++;
-					if (patGrpNo >= 4) patGrpNo = 0;
-					if (pmRun[patGrpNo].isInitialized == false) {
-						patGrpNo = 0;
-					}
-				}
-
-
-				// 一つ前のパターンを暗く表示
-				led_matrix.Clear(0);
-
-				led_matrix.Reset();
-				if (CharInfo[iCharNo].isColorReplace) {
-					const std::uint32_t* bufPrev = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(prevPatNo)); // 明示的にconstへ
-					const std::uint32_t* bufCurr = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(currPatNo)); // 明示的にconstへ
-					led_matrix.DrawBuffer(bufPrev, 16, 16, 0, 0, 0x030000, CharInfo[iCharNo].isOverlay);              // パターンを描画 (オーバーレイで短い時間を表示)
-					led_matrix.DrawBuffer(bufCurr, 16, 16, 0, 0, 0x060000, CharInfo[iCharNo].isOverlay);             // パターンを描画 (オーバーレイで短い時間を表示)
-				} else {
-					const std::uint32_t* bufPrev = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(prevPatNo)); // 明示的にconstへ
-					const std::uint32_t* bufCurr = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(currPatNo)); // 明示的にconstへ
-					led_matrix.DrawBuffer(bufPrev, 16, 16, 0, 0, 0, CharInfo[iCharNo].isOverlay);                                      // パターンを描画 (オーバーレイで短い時間を表示)
-					led_matrix.DrawBuffer(bufCurr, 16, 16, 0, 0, 0, CharInfo[iCharNo].isOverlay);                                      // パターンを描画 (オーバーレイで短い時間を表示)
-				}
-				led_matrix.ScanBuffer(true, false);
-				sleep_ms(iTransMs);
-
-				led_matrix.Reset();
-				if (CharInfo[iCharNo].isColorReplace) {
-					const std::uint32_t* buf = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(currPatNo)); // 明示的にconstへ
-					led_matrix.DrawBuffer(buf, 16, 16, 0, 0, 0x070000, CharInfo[iCharNo].isOverlay);                // パターンを描画
-				} else {
-					const std::uint32_t* buf = static_cast<const std::uint32_t*>(pmRun[patGrpNo].getBufferPtr(currPatNo));         // 明示的にconstへ
-					led_matrix.DrawBuffer(buf, 16, 16, 0, 0, 0, CharInfo[iCharNo].isOverlay);                                      // パターンを描画
-				}
-				led_matrix.ScanBuffer(true, false);
-
-				// led_matrix.Keep();
-				sleep_ms(iWaitMs);
-				prevPatNo = currPatNo;             // 前のパターン番号を保存
-				if (++currPatNo >= CharInfo[iCharNo].PatWalkCount) { // パターン番号設定
-					currPatNo = 0;                 // パターン番号をリセット
-				}
-			}
+		LGM_TRACE_SCOPE(TRACE_STATE, (uint8_t)iState);
+		scripts.run(now_ms());
+		uint32_t waitMs;
+		if (scripts.nextWake(now_ms(), waitMs)) {
+			if (waitMs == 0) continue;
+			events_start_timer(TIMER_CORO, waitMs, false);
+		} else {
+			events_cancel_timer(TIMER_CORO);
 		}
+		AppEvent ev;
+		events_wait(ev);
+		if (ev.type == EVT_BUTTON) scripts.post(ev); // タイマーは起床のためだけ（期限はスケジューラが時刻で判定）
 	}
 }
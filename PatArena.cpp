@@ -0,0 +1,56 @@
+/**
+ * @file PatArena.cpp
+ * @brief パターン用バッファの固定領域（アリーナ）の実装
+ */
+#include "PatArena.h"
+#include <new>
+
+/**
+ * @brief 領域を確保します。
+ * @param bytes 大きさ（バイト）
+ * @return 成功ならtrue
+ */
+bool PatArena::reserve(std::size_t bytes)
+{
+    const std::size_t words = (bytes + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+    owned_.reset();
+    mem_ = nullptr;
+    capWords_ = usedWords_ = peakWords_ = 0;
+    if (words == 0) return true;
+    owned_.reset(new (std::nothrow) std::uint32_t[words]);
+    if (!owned_) return false;
+    mem_ = owned_.get();
+    capWords_ = words;
+    return true;
+}
+
+/**
+ * @brief 他の領域を使います（所有しない）。
+ * @param mem 領域
+ * @param words 大きさ（語）
+ * @return なし
+ */
+void PatArena::attach(std::uint32_t* mem, std::size_t words)
+{
+    owned_.reset();
+    mem_ = mem;
+    capWords_ = mem ? words : 0;
+    usedWords_ = peakWords_ = 0;
+}
+
+/**
+ * @brief 領域から切り出します。
+ * @param words 大きさ（語）
+ * @return 先頭（空きが足りない場合は nullptr）
+ */
+std::uint32_t* PatArena::allocate(std::size_t words)
+{
+    if (words > capWords_ - usedWords_) {
+        failures_++;
+        return nullptr;
+    }
+    std::uint32_t* p = mem_ + usedWords_;
+    usedWords_ += words;
+    if (usedWords_ > peakWords_) peakWords_ = usedWords_;
+    return p;
+}
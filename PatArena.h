@@ -0,0 +1,70 @@
+/**
+ * @file PatArena.h
+ * @brief パターン用バッファの固定領域（アリーナ）
+ * @details 起動時に1回だけ確保した領域から順に切り出し、まとめて解放するクラスのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief 固定領域から順に切り出すアロケータ（バンプアロケータ）。
+ * @details
+ * - reserve() で起動時に1回だけ確保するか、attach() で他の領域（親のアリーナの一部など）を使います。
+ * - allocate() は先頭から順に切り出すだけで、個別の解放はしません。releaseAll() でまとめて空にします。
+ * - キャラクタの切り替えのたびに new/delete しないので、長時間動かしてもヒープが断片化しません。
+ */
+class PatArena {
+public:
+    PatArena() = default;
+    PatArena(const PatArena&) = delete;
+    PatArena& operator=(const PatArena&) = delete;
+
+    /**
+     * @brief 領域を確保します（起動時に1回）。
+     * @param bytes 大きさ（バイト。4バイト単位に切り上げ）
+     * @return 成功ならtrue
+     * @details 既に領域がある場合は置き換えます（切り出したバッファはすべて無効になります）。
+     */
+    bool reserve(std::size_t bytes);
+
+    /**
+     * @brief 他の領域を使います（所有しない）。
+     * @param mem 領域
+     * @param words 大きさ（語）
+     * @return なし
+     */
+    void attach(std::uint32_t* mem, std::size_t words);
+
+    /**
+     * @brief 領域から切り出します。
+     * @param words 大きさ（語）
+     * @return 先頭（空きが足りない場合は nullptr）
+     */
+    std::uint32_t* allocate(std::size_t words);
+
+    /** @brief 切り出したバッファをまとめて解放します。@return なし @details 使用量の最大値は残します。 */
+    inline void releaseAll() { usedWords_ = 0; }
+
+    /** @brief 領域の大きさ（バイト）。 */
+    inline std::size_t capacityBytes() const { return capWords_ * sizeof(std::uint32_t); }
+    /** @brief 使用中の大きさ（バイト）。 */
+    inline std::size_t usedBytes() const { return usedWords_ * sizeof(std::uint32_t); }
+    /** @brief 使用量の最大値（バイト）。 */
+    inline std::size_t peakBytes() const { return peakWords_ * sizeof(std::uint32_t); }
+    /** @brief 空きが足りずに allocate() が失敗した回数。 */
+    inline std::uint32_t failures() const { return failures_; }
+    /** @brief p がこの領域の中を指すならtrue。 */
+    inline bool contains(const std::uint32_t* p) const { return mem_ != nullptr && p >= mem_ && p < mem_ + capWords_; }
+
+private:
+    std::unique_ptr<std::uint32_t[]> owned_; ///< reserve() で確保した領域
+    std::uint32_t* mem_ { nullptr };         ///< 領域の先頭
+    std::size_t capWords_ { 0 };             ///< 大きさ（語）
+    std::size_t usedWords_ { 0 };            ///< 使用中（語）
+    std::size_t peakWords_ { 0 };            ///< 使用量の最大値（語）
+    std::uint32_t failures_ { 0 };           ///< allocate() の失敗回数
+};
@@ -0,0 +1,178 @@
+/**
+ * @file PatCache.cpp
+ * @brief 補正済みパターン一式のキャッシュの実装
+ */
+#include "PatCache.h"
+#include "Patterns.h"
+#include "pico/time.h"
+
+/**
+ * @brief キャッシュ内の一式を探します。
+ * @param ch キャラクタ設定
+ * @param hash 補正設定のハッシュ
+ * @return スロット番号（なければ -1）
+ */
+int PatCache::find(const Patterns& ch, std::uint32_t hash) const
+{
+    for (int i = 0; i < PATCACHE_SLOTS; i++) {
+        if (slots_[i].owner == &ch && slots_[i].hash == hash) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief スロットを解放します。
+ * @param idx スロット番号
+ * @return なし
+ */
+void PatCache::release(int idx)
+{
+    Slot& s = slots_[idx];
+    s.set.stay.reset();
+    for (int i = 0; i < 4; i++) {
+        if (s.set.run[i].isInitialized) s.set.run[i].reset();
+    }
+    s.arena.releaseAll(); // アリーナから切り出したバッファはここでまとめて解放
+    usedBytes_ -= s.bytes;
+    s.owner = nullptr;
+    s.bytes = 0;
+}
+
+/**
+ * @brief 空きを作ってから一式を処理し、スロットへ登録します。
+ * @param ch キャラクタ設定
+ * @param hash 補正設定のハッシュ
+ * @return スロット番号（上限に収まらない、または確保に失敗した場合は -1）
+ * @details 表示中（current_）のスロット以外から、最も古いものを順に追い出します。
+ */
+int PatCache::load(const Patterns& ch, std::uint32_t hash)
+{
+    const std::size_t bytes = ch.processedBytes();
+    const std::size_t pinned = current_ >= 0 ? slots_[current_].bytes : 0;
+    if (bytes + pinned > maxBytes_) return -1;
+    if (arenaSlots_ > 0 && bytes > slots_[0].arena.capacityBytes()) return -1; // 1スロットに収まらない
+    const int slotCount = arenaSlots_ > 0 ? arenaSlots_ : PATCACHE_SLOTS;
+
+    int freeIdx = -1;
+    for (;;) {
+        freeIdx = -1;
+        for (int i = 0; i < slotCount; i++) {
+            if (slots_[i].owner == nullptr) { freeIdx = i; break; }
+        }
+        if (freeIdx >= 0 && usedBytes_ + bytes <= maxBytes_) break;
+
+        int lru = -1;
+        for (int i = 0; i < slotCount; i++) {
+            if (slots_[i].owner == nullptr || i == current_) continue;
+            if (lru < 0 || slots_[i].lastUse < slots_[lru].lastUse) lru = i;
+        }
+        if (lru < 0) return -1;
+        release(lru);
+        stats_.evictions++;
+    }
+
+    const std::uint64_t t0 = time_us_64();
+    Slot& s = slots_[freeIdx];
+    ch.setPatManager(s.set.stay, s.set.run, arenaSlots_ > 0 ? &s.arena : nullptr);
+    if (!s.set.stay.isInitialized) {
+        s.set.stay.reset();
+        s.arena.releaseAll();
+        return -1;
+    }
+    s.owner = &ch;
+    s.hash = hash;
+    s.bytes = bytes;
+    s.lastUse = ++useCounter_;
+    usedBytes_ += bytes;
+    if (usedBytes_ > stats_.peakBytes) stats_.peakBytes = static_cast<std::uint32_t>(usedBytes_);
+    stats_.lastBuildUs = static_cast<std::uint32_t>(time_us_64() - t0);
+    return freeIdx;
+}
+
+/**
+ * @brief キャラクタの補正済みパターン一式を返します。
+ * @param ch キャラクタ設定
+ * @return パターン一式（処理に失敗した場合は nullptr）
+ */
+PatSet* PatCache::acquire(const Patterns& ch)
+{
+    const std::uint32_t hash = ch.settingsHash();
+    int idx = find(ch, hash);
+    if (idx >= 0) {
+        stats_.hits++;
+    } else {
+        stats_.misses++;
+        current_ = -1; // 表示を切り替えるので、前の一式も追い出し対象にする
+        idx = load(ch, hash);
+        if (idx < 0) return nullptr;
+    }
+    slots_[idx].lastUse = ++useCounter_;
+    current_ = idx;
+    return &slots_[idx].set;
+}
+
+/**
+ * @brief キャラクタの補正済みパターン一式を前もって処理します。
+ * @param ch キャラクタ設定
+ * @return キャッシュにある（処理した）ならtrue
+ */
+bool PatCache::prefetch(const Patterns& ch)
+{
+    const std::uint32_t hash = ch.settingsHash();
+    if (find(ch, hash) >= 0) return true;
+    if (load(ch, hash) < 0) return false;
+    stats_.prefetches++;
+    return true;
+}
+
+/**
+ * @brief 保持している一式をすべて解放します。
+ * @return なし
+ */
+void PatCache::clear()
+{
+    for (int i = 0; i < PATCACHE_SLOTS; i++) {
+        if (slots_[i].owner != nullptr) release(i);
+    }
+    current_ = -1;
+}
+
+/**
+ * @brief スロットごとのバッファを固定領域（アリーナ）にします。
+ * @param setBytes 1スロットの大きさ（バイト）
+ * @return 成功ならtrue
+ * @details 合計の上限に収まる数のスロット分を1回で確保し、スロットごとに切り分けます。
+ *          焼き込み済みのキャラクタだけなら setBytes は 0 で、領域は確保しません（スロット数は PATCACHE_SLOTS）。
+ */
+bool PatCache::reserveArena(std::size_t setBytes)
+{
+    clear();
+    const std::size_t words = (setBytes + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+    const std::size_t slotBytes = words * sizeof(std::uint32_t);
+    std::size_t slots = PATCACHE_SLOTS;
+    if (slotBytes > 0 && maxBytes_ / slotBytes < slots) slots = maxBytes_ / slotBytes;
+    arenaSlots_ = 0;
+    if (slots == 0 || !arena_.reserve(slots * slotBytes)) {
+        arena_.reserve(0);
+        for (int i = 0; i < PATCACHE_SLOTS; i++) slots_[i].arena.attach(nullptr, 0);
+        return false;
+    }
+    for (int i = 0; i < PATCACHE_SLOTS; i++) {
+        slots_[i].arena.attach(i < (int)slots ? arena_.allocate(words) : nullptr, words);
+    }
+    arenaSlots_ = static_cast<int>(slots);
+    return true;
+}
+
+/**
+ * @brief 1スロットで使ったアリーナの最大値。
+ * @return バイト数
+ */
+std::size_t PatCache::arenaPeakBytes() const
+{
+    std::size_t peak = 0;
+    for (int i = 0; i < arenaSlots_; i++) {
+        if (slots_[i].arena.peakBytes() > peak) peak = slots_[i].arena.peakBytes();
+    }
+    return peak;
+}
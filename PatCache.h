@@ -0,0 +1,119 @@
+/**
+ * @file PatCache.h
+ * @brief 補正済みパターン一式のキャッシュ
+ * @details キャラクタと補正設定をキーに、PatManager で処理済みのパターン一式を保持するクラスのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "PatManager.h"
+#include "PatArena.h"
+
+class Patterns;
+
+#define PATCACHE_SLOTS 4               ///< 保持できるパターン一式の数
+#define PATCACHE_MAX_BYTES (32 * 1024) ///< 保持するバッファの合計の上限（バイト）
+
+/**
+ * @brief 補正済みのパターン一式（停止1枚 + 走行最大4グループ）。
+ */
+struct PatSet {
+    PatManager stay;   ///< 停止表示用
+    PatManager run[4]; ///< 走行用パターングループ
+};
+
+/** @brief キャッシュの統計。 */
+struct PatCacheStats {
+    std::uint32_t hits;      ///< acquire() でキャッシュにあった回数
+    std::uint32_t misses;    ///< acquire() で処理が必要だった回数
+    std::uint32_t prefetches; ///< prefetch() で処理した回数
+    std::uint32_t evictions; ///< LRU で追い出した回数
+    std::uint32_t lastBuildUs; ///< 直近の処理時間(µs)
+    std::uint32_t peakBytes; ///< 保持したバッファの合計の最大値（バイト）
+};
+
+/**
+ * @brief 補正済みパターン一式のキャッシュ（LRU）。
+ * @details
+ * - キーは キャラクタ（Patterns のアドレス）+ 補正設定のハッシュ です。設定を変えると別の一式として処理します。
+ * - スロット数（PATCACHE_SLOTS）と合計バイト数（コンストラクタで指定）の両方を上限とし、
+ *   超える場合は最も長く使われていない一式から解放します。
+ * - acquire() で返した一式（表示中）は、次の acquire() まで追い出しません。
+ * - prefetch() は表示中の一式を残したまま、次に表示する一式を前もって処理します。
+ * - reserveArena() を呼ぶと、各スロットのバッファを起動時に確保した固定領域から切り出し、追い出すときにまとめて解放します。
+ *   以降はキャラクタを切り替えてもヒープを使わないので、長時間動かしても断片化しません。
+ */
+class PatCache {
+public:
+    /**
+     * @brief コンストラクタ。
+     * @param maxBytes 保持するバッファの合計の上限（バイト）
+     */
+    explicit PatCache(std::size_t maxBytes = PATCACHE_MAX_BYTES) : maxBytes_(maxBytes) {}
+
+    /**
+     * @brief キャラクタの補正済みパターン一式を返します。
+     * @param ch キャラクタ設定
+     * @return パターン一式（処理に失敗した場合は nullptr）
+     * @details キャッシュになければ処理して登録します。返した一式は次の acquire() まで有効です。
+     */
+    PatSet* acquire(const Patterns& ch);
+
+    /**
+     * @brief キャラクタの補正済みパターン一式を前もって処理します。
+     * @param ch キャラクタ設定
+     * @return キャッシュにある（処理した）ならtrue
+     * @details 表示中の一式は追い出しません。上限に収まらない場合は何もしません。
+     */
+    bool prefetch(const Patterns& ch);
+
+    /** @brief 保持している一式をすべて解放します。@return なし */
+    void clear();
+
+    /**
+     * @brief スロットごとのバッファを固定領域（アリーナ）にします（起動時に1回）。
+     * @param setBytes 1スロットの大きさ（バイト）。最も大きいキャラクタの Patterns::processedBytes()
+     * @return 成功ならtrue（1スロットも確保できない場合はfalseで、従来どおりヒープを使う）
+     * @details 領域は 合計の上限 / setBytes 個（最大 PATCACHE_SLOTS）のスロット分を1回で確保します。
+     *          保持している一式は解放されます。焼き込み済みのキャラクタはバッファを使わない（processedBytes() が 0）ため、対象外です。
+     */
+    bool reserveArena(std::size_t setBytes);
+
+    /** @brief アリーナで使えるスロット数（reserveArena() 前は 0）。 */
+    inline int arenaSlots() const { return arenaSlots_; }
+    /** @brief アリーナ全体の大きさ（バイト）。 */
+    inline std::size_t arenaBytes() const { return arena_.capacityBytes(); }
+    /** @brief 1スロットで使ったアリーナの最大値（バイト）。 */
+    std::size_t arenaPeakBytes() const;
+
+    /** @brief 統計。 */
+    inline const PatCacheStats& stats() const { return stats_; }
+    /** @brief 保持しているバッファの合計（バイト）。 */
+    inline std::size_t usedBytes() const { return usedBytes_; }
+
+private:
+    /** @brief キャッシュの1エントリ。 */
+    struct Slot {
+        const Patterns* owner { nullptr }; ///< キャラクタ（nullptr なら空き）
+        std::uint32_t hash { 0 };          ///< 補正設定のハッシュ
+        std::size_t bytes { 0 };           ///< バッファのバイト数
+        std::uint32_t lastUse { 0 };       ///< 最後に使った順番（大きいほど新しい）
+        PatSet set;                        ///< 補正済みパターン一式
+        PatArena arena;                    ///< set のバッファ（reserveArena() 後。arena_ の一部）
+    };
+
+    int find(const Patterns& ch, std::uint32_t hash) const;
+    int load(const Patterns& ch, std::uint32_t hash);
+    void release(int idx);
+
+    Slot slots_[PATCACHE_SLOTS];
+    PatArena arena_;                ///< 全スロットのアリーナ（reserveArena() で確保）
+    int arenaSlots_ { 0 };          ///< アリーナで使えるスロット数（0 ならヒープ）
+    std::size_t maxBytes_;          ///< 合計バイト数の上限
+    std::size_t usedBytes_ { 0 };   ///< 保持しているバイト数
+    std::uint32_t useCounter_ { 0 }; ///< LRU の順番
+    int current_ { -1 };            ///< acquire() で返したスロット
+    PatCacheStats stats_ {};
+};
@@ -175,5 +175,24 @@
 	extern const std::size_t DQ3FrontCount = sizeof(DQ3Front) / sizeof(DQ3Front[0]);
 	extern const std::size_t DQ3BackCount = sizeof(DQ3Back) / sizeof(DQ3Back[0]);
 
+	// 補正済みパターン（コンパイル時に作成し、フラッシュに置く）
+	namespace {
+		constexpr std::uint32_t kStay[] = STAY;
+		constexpr std::uint32_t kLeft[][16 * 16] = {LEFT_1, LEFT_2};
+		constexpr std::uint32_t kRight[][16 * 16] = {RIGHT_1, RIGHT_2};
+		constexpr std::uint32_t kFront[][16 * 16] = {FRONT_1, FRONT_2};
+		constexpr std::uint32_t kBack[][16 * 16] = {BACK_1, BACK_2};
+		constexpr auto kStayBaked = colorpipe::bake(kStay, DQ3Correction);
+		constexpr auto kLeftBaked = colorpipe::bake(kLeft, DQ3Correction);
+		constexpr auto kRightBaked = colorpipe::bake(kRight, DQ3Correction);
+		constexpr auto kFrontBaked = colorpipe::bake(kFront, DQ3Correction);
+		constexpr auto kBackBaked = colorpipe::bake(kBack, DQ3Correction);
+	}
+	extern const std::uint32_t* const DQ3StayBaked = &kStayBaked.data[0][0];
+	extern const std::uint32_t* const DQ3LeftBaked = &kLeftBaked.data[0][0];
+	extern const std::uint32_t* const DQ3RightBaked = &kRightBaked.data[0][0];
+	extern const std::uint32_t* const DQ3FrontBaked = &kFrontBaked.data[0][0];
+	extern const std::uint32_t* const DQ3BackBaked = &kBackBaked.data[0][0];
+
 	extern const std::uint16_t iWaitDQ3Walk = 240;
 	extern const std::uint16_t iWaitDQ3Run = 120;
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "ColorPipeline.h"
 
 // LGMPat: 16x16 のパターンを並べた配列（各要素は 0x00GGRRBB）
 extern const std::uint32_t DQ3Left[][16 * 16];
@@ -16,6 +17,14 @@ extern const std::size_t DQ3RightCount;
 extern const std::size_t DQ3FrontCount;
 extern const std::size_t DQ3BackCount;
 
+// 色補正（ビルド時に焼き込み済みの配列: フラッシュ上、実行時の補正処理は不要）
+constexpr colorpipe::Correction DQ3Correction = {0, 16, 0, 16, 0, 16, 1.0f, 0, 0};
+extern const std::uint32_t* const DQ3StayBaked;
+extern const std::uint32_t* const DQ3LeftBaked;
+extern const std::uint32_t* const DQ3RightBaked;
+extern const std::uint32_t* const DQ3FrontBaked;
+extern const std::uint32_t* const DQ3BackBaked;
+
 // 歩く速度
 extern const std::uint16_t iWaitDQ3Walk;
 extern const std::uint16_t iWaitDQ3Run;
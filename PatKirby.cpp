@@ -172,5 +172,18 @@ extern const std::uint32_t KirbyRoll[][16 * 16] = {ROLL_1, ROLL_2, ROLL_3, ROLL_
 extern const std::size_t KirbyWalkCount = sizeof(KirbyWalk) / sizeof(KirbyWalk[0]);
 extern const std::size_t KirbyRollcount = sizeof(KirbyRoll) / sizeof(KirbyRoll[0]);
 
+// 補正済みパターン（コンパイル時に作成し、フラッシュに置く）
+namespace {
+	constexpr std::uint32_t kStay[] = STAY;
+	constexpr std::uint32_t kWalk[][16 * 16] = {WALK_1,WALK_2,WALK_3,WALK_2};
+	constexpr std::uint32_t kRoll[][16 * 16] = {ROLL_1, ROLL_2, ROLL_3, ROLL_4, ROLL_5};
+	constexpr auto kStayBaked = colorpipe::bake(kStay, KirbyCorrection);
+	constexpr auto kWalkBaked = colorpipe::bake(kWalk, KirbyCorrection);
+	constexpr auto kRollBaked = colorpipe::bake(kRoll, KirbyCorrection);
+}
+extern const std::uint32_t* const KirbyStayBaked = &kStayBaked.data[0][0];
+extern const std::uint32_t* const KirbyWalkBaked = &kWalkBaked.data[0][0];
+extern const std::uint32_t* const KirbyRollBaked = &kRollBaked.data[0][0];
+
 extern const std::uint16_t iWaitKirbyWalk = 240;
 extern const std::uint16_t iWaitKirbyRun = 120;
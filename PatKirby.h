@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "ColorPipeline.h"
 
 extern const std::uint32_t KirbyStay[];
 extern const std::uint32_t KirbyWalk[][16 * 16];
@@ -10,5 +11,11 @@ extern const std::uint32_t KirbyRoll[][16 * 16];
 extern const std::size_t KirbyWalkCount;
 extern const std::size_t KirbyRollcount;
 
+// 色補正（ビルド時に焼き込み済みの配列: フラッシュ上、実行時の補正処理は不要）
+constexpr colorpipe::Correction KirbyCorrection = {0, 16, 0, 16, 0, 16, 1.0f, 0, 0};
+extern const std::uint32_t* const KirbyStayBaked;
+extern const std::uint32_t* const KirbyWalkBaked;
+extern const std::uint32_t* const KirbyRollBaked;
+
 extern const std::uint16_t iWaitKirbyWalk;
 extern const std::uint16_t iWaitKirbyRun;
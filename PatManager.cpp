@@ -9,6 +9,8 @@
  * @details フラット配列(0x00GGRRBB)を内部に保持し、LUTベースで破壊的に変換します。
  */
 #include "PatManager.h"
+#include "PatArena.h"
+#include "ColorPipeline.h"
 #include "stdio.h"
 #include <cmath>
 #include <cstring>
@@ -73,26 +75,11 @@ namespace {
      * @param contrastPercent コントラストパーセント（-100..100）
      * @param lut 出力先のLUT配列（256要素）
      * @return なし
-     * @details コントラスト→明度の順で適用する合成LUTを作成します。
-     *          範囲外の値は内部でクリップされます。
-     *          手順: v' = (v - 128) * (1 + c/100) + 128 → v'' = v' + (255 * b/100)
+     * @details ビルド時の焼き込み（ColorPipeline.h）と同じ整数演算のLUTを使います。
      */
     inline void build_bc_lut(int brightnessPercent, int contrastPercent, std::uint8_t lut[256]) {
-        // クリップ
-        if (brightnessPercent < -100) brightnessPercent = -100;
-        if (brightnessPercent > 100)  brightnessPercent = 100;
-        if (contrastPercent < -100)   contrastPercent = -100;
-        if (contrastPercent > 100)    contrastPercent = 100;
-
-        const float c = 1.0f + static_cast<float>(contrastPercent) / 100.0f; ///< コントラスト係数
-        const float b = static_cast<float>(brightnessPercent) / 100.0f;      ///< 明度係数
-        const int add = static_cast<int>(std::round(255.0f * b));            ///< 明度加算値
-
-        for (int v = 0; v <= 255; ++v) {
-            float v1 = (static_cast<float>(v) - 128.0f) * c + 128.0f; ///< コントラスト適用
-            int v2 = static_cast<int>(std::round(v1)) + add;          ///< 明度適用
-            lut[v] = clip_u8_int(v2);
-        }
+        const colorpipe::Lut l = colorpipe::bc_lut(brightnessPercent, contrastPercent);
+        std::memcpy(lut, l.v, sizeof(l.v));
     }
 
     /**
@@ -102,20 +89,11 @@ namespace {
      * @param lut 出力先のLUT配列（256要素）
      * @return なし
      * @details v' = min + round((max-min) * v / 255) で変換しますが、v==0（黒）は0を維持します。
+     *          ビルド時の焼き込み（ColorPipeline.h）と同じ整数演算のLUTを使います。
      */
     inline void build_range_lut(std::uint8_t minV, std::uint8_t maxV, std::uint8_t lut[256]) {
-        int minI = static_cast<int>(minV); ///< 最小値（整数）
-        int maxI = static_cast<int>(maxV); ///< 最大値（整数）
-        int span = maxI - minI; ///< レンジ幅
-        for (int v = 0; v <= 255; ++v) {
-            if (v == 0) { ///< 黒は維持
-                lut[v] = 0;
-                continue;
-            }
-            int mapped = minI + static_cast<int>(std::lround((span * v) / 255.0)); ///< レンジマッピング
-            if (mapped < 0) mapped = 0; else if (mapped > 255) mapped = 255;       ///< クリッピング
-            lut[v] = static_cast<std::uint8_t>(mapped);
-        }
+        const colorpipe::Lut l = colorpipe::range_lut(minV, maxV);
+        std::memcpy(lut, l.v, sizeof(l.v));
     }
 
     /**
@@ -150,7 +128,10 @@ namespace {
  */
 void PatManager::reset()
 {
-	buf_.reset();
+	if (ownsBuf_) delete[] buf_;
+	buf_ = nullptr;
+	ownsBuf_ = false;
+	view_ = nullptr;
 	isInitialized = false;
 	count_ = 0;
 	width_ = 0;
@@ -174,6 +155,7 @@ PatManager::~PatManager()
  * @param count パターン数
  * @param width 幅
  * @param height 高さ
+ * @param arena 内部バッファを切り出すアリーナ（nullptr ならヒープ）
  * @return 成功ならtrue
  * @details フラット配列からデータをコピーして内部バッファを初期化します。
  *          パラメータの妥当性をチェックし、メモリ確保を行います。
@@ -182,19 +164,23 @@ PatManager::~PatManager()
 bool PatManager::init(const std::uint32_t* srcFlat,
                       std::size_t count,
                       std::uint16_t width,
-                      std::uint16_t height)
+                      std::uint16_t height,
+                      PatArena* arena)
 {
     if (!srcFlat || count == 0 || width == 0 || height == 0) return false;
 
     const std::size_t pixelsPerPat = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
     const std::size_t total = pixelsPerPat * count;
 
-    // メモリ確保（既存を置き換え）
-    std::unique_ptr<std::uint32_t[]> tmp(new (std::nothrow) std::uint32_t[total]);
+    // メモリ確保（既存を置き換え）。アリーナがあれば切り出すだけで、ヒープは使わない
+    std::uint32_t* tmp = arena ? arena->allocate(total) : new (std::nothrow) std::uint32_t[total];
     if (!tmp) return false;
 
-    std::memcpy(tmp.get(), srcFlat, total * sizeof(std::uint32_t));
-    buf_ = std::move(tmp);
+    std::memcpy(tmp, srcFlat, total * sizeof(std::uint32_t));
+    if (ownsBuf_) delete[] buf_;
+    buf_ = tmp;
+    ownsBuf_ = arena == nullptr;
+    view_ = nullptr;
     count_ = count;
     width_ = width;
     height_ = height;
@@ -202,17 +188,43 @@ bool PatManager::init(const std::uint32_t* srcFlat,
 	return true;
 }
 
+/**
+ * @brief 補正済みのフラット配列（フラッシュ上）をコピーせずに参照します。
+ * @param srcFlat 補正済みの配列(0x00GGRRBB)
+ * @param count パターン数
+ * @param width 幅
+ * @param height 高さ
+ * @return 成功ならtrue
+ * @details 内部バッファは確保しません。参照中は読み取り専用となり、補正関数はfalseを返します。
+ */
+bool PatManager::attach(const std::uint32_t* srcFlat,
+                        std::size_t count,
+                        std::uint16_t width,
+                        std::uint16_t height)
+{
+    if (!srcFlat || count == 0 || width == 0 || height == 0) return false;
+    if (ownsBuf_) delete[] buf_;
+    buf_ = nullptr;
+    ownsBuf_ = false;
+    view_ = srcFlat;
+    count_ = count;
+    width_ = width;
+    height_ = height;
+    isInitialized = true;
+    return true;
+}
+
 /**
  * @brief ガンマ補正をLUTで適用します。
  * @param gamma ガンマ値(>0)
  * @return 成功ならtrue
  * @details LUTベースでガンマ補正を全ピクセルに適用します。
- *          gamma <= 0の場合は処理をスキップしてtrueを返します。
+ *          gamma <= 0 または 1.0（素通し）の場合は処理をスキップしてtrueを返します。
  *          すべてのチャネル（緑/赤/青）に同一のガンマ値が適用されます。
  */
 bool PatManager::setGamma(float gamma)
 {
-	if (gamma <= 0.0f) return true;
+	if (gamma <= 0.0f || gamma == 1.0f) return true; // 1.0 は素通し（焼き込み側と同じ）
 	if (!buf_ || count_ == 0 || width_ == 0 || height_ == 0) return false;
 
     std::uint8_t lut[256];
@@ -295,7 +307,21 @@ std::uint32_t* PatManager::getBufferPtr(std::size_t patternIndex)
 {
     if (patternIndex >= count_ || !buf_) return nullptr;
     const std::size_t pixelsPerPat = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
-	return buf_.get() + patternIndex * pixelsPerPat;
+	return buf_ + patternIndex * pixelsPerPat;
+}
+
+/**
+ * @brief 指定パターン先頭ポインタを返します（読み取り専用）。
+ * @param patternIndex パターン番号
+ * @return 先頭ポインタ（範囲外はnullptr）
+ * @details attach() で参照している配列にも使えます。
+ */
+const std::uint32_t* PatManager::getBufferPtr(std::size_t patternIndex) const
+{
+    const std::uint32_t* base = view_ ? view_ : buf_;
+    if (patternIndex >= count_ || !base) return nullptr;
+    const std::size_t pixelsPerPat = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+	return base + patternIndex * pixelsPerPat;
 }
 
 /**
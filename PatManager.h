@@ -10,6 +10,8 @@
 #include <cstddef>
 #include <memory>
 
+class PatArena;
+
 /**
  * @brief パターン配列(0x00GGRRBB)を保持し、各種補正を上書き適用する管理クラス。
  * @details
@@ -23,6 +25,8 @@ public:
 public:
     /** @brief 既定コンストラクタ。@details フラグは未初期化(false)。 */
     PatManager() { isInitialized = false; }
+    PatManager(const PatManager&) = delete;
+    PatManager& operator=(const PatManager&) = delete;
     /** @brief デストラクタ。@details 内部バッファを解放します。 */
     ~PatManager();
     /** @brief 内部状態を解放/初期化します。@return なし */
@@ -34,15 +38,33 @@ public:
      * @param count パターン数
      * @param width 幅(ピクセル)
      * @param height 高さ(ピクセル)
+     * @param arena 内部バッファを切り出すアリーナ（nullptr ならヒープ）
      * @return 成功ならtrue
      * @details フラット配列から内部バッファにデータをコピーして初期化します。
      *          既存のバッファは置き換えられます。パラメータの妥当性チェックを行い、
      *          メモリ確保に失敗した場合はfalseを返します。
+     *          アリーナから切り出したバッファは reset() では解放されません（PatArena::releaseAll() でまとめて解放）。
      */
     bool init(const std::uint32_t* srcFlat,
               std::size_t count,
               std::uint16_t width,
-              std::uint16_t height);
+              std::uint16_t height,
+              PatArena* arena = nullptr);
+
+    /**
+     * @brief 補正済みのフラット配列（フラッシュ上）をコピーせずに参照します。
+     * @param srcFlat 補正済みの 0x00GGRRBB フラット配列
+     * @param count パターン数
+     * @param width 幅(ピクセル)
+     * @param height 高さ(ピクセル)
+     * @return 成功ならtrue
+     * @details ビルド時に補正を焼き込んだ配列（ColorPipeline.h）用です。RAMを確保せず、
+     *          参照中は読み取り専用となります（補正関数は内部バッファがないためfalseを返します）。
+     */
+    bool attach(const std::uint32_t* srcFlat,
+                std::size_t count,
+                std::uint16_t width,
+                std::uint16_t height);
 
     /**
      * @brief ガンマ補正を上書き適用します（G/R/B同一ガンマ）。
@@ -50,7 +72,7 @@ public:
      * @return 成功ならtrue
      * @details すべてのチャネル（緑/赤/青）に同一のガンマ値を適用します。
      *          LUTベースで効率的に処理され、既存データを上書きします。
-     *          gamma <= 0の場合は処理をスキップしてtrueを返します。
+     *          gamma <= 0 または 1.0（素通し）の場合は処理をスキップしてtrueを返します。
      */
     bool setGamma(float gamma);
 
@@ -102,13 +124,26 @@ public:
      */
     std::uint32_t* getBufferPtr(std::size_t patternIndex);
 
+    /**
+     * @brief 指定パターンの先頭アドレスを返します（読み取り専用）。
+     * @param patternIndex 取得するパターン番号
+     * @return 先頭ポインタ（範囲外は nullptr）
+     * @details attach() で参照している配列も返します。表示だけならこちらを使ってください。
+     */
+    const std::uint32_t* getBufferPtr(std::size_t patternIndex) const;
+
+    /** @brief attach() でフラッシュ上の配列を参照している（読み取り専用）ならtrue。 */
+    inline bool isAttached() const { return view_ != nullptr; }
+
     // 便宜的なゲッター
     inline std::size_t count() const { return count_; }      ///< 保持パターン数
     inline std::uint16_t width() const { return width_; }    ///< パターン幅
     inline std::uint16_t height() const { return height_; }  ///< パターン高
 
 private:
-    std::unique_ptr<std::uint32_t[]> buf_; ///< 内部作業バッファ（0x00GGRRBB）
+    std::uint32_t* buf_ { nullptr };        ///< 内部作業バッファ（0x00GGRRBB）
+    bool ownsBuf_ { false };                ///< buf_ をヒープから確保した（reset() で解放する）ならtrue
+    const std::uint32_t* view_ { nullptr }; ///< attach() で参照している配列（所有しない）
     std::size_t count_ { 0 };              ///< パターン数
     std::uint16_t width_ { 0 };            ///< 幅
     std::uint16_t height_ { 0 };           ///< 高さ
@@ -75,5 +75,15 @@ extern const std::uint32_t MROStay[] = PAT_0;
 extern const std::uint32_t MRORun[][16 * 16] = {PAT_1, PAT_2, PAT_3};
 extern const std::size_t MROPatCount = sizeof(MRORun) / sizeof(MRORun[0]);
 
+// 補正済みパターン（コンパイル時に作成し、フラッシュに置く）
+namespace {
+	constexpr std::uint32_t kStay[] = PAT_0;
+	constexpr std::uint32_t kRun[][16 * 16] = {PAT_1, PAT_2, PAT_3};
+	constexpr auto kStayBaked = colorpipe::bake(kStay, MROCorrection);
+	constexpr auto kRunBaked = colorpipe::bake(kRun, MROCorrection);
+}
+extern const std::uint32_t* const MROStayBaked = &kStayBaked.data[0][0];
+extern const std::uint32_t* const MRORunBaked = &kRunBaked.data[0][0];
+
 extern const std::uint16_t iWaitMarioWalk = 100;
 extern const std::uint16_t iWaitMarioRun = 50;
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "ColorPipeline.h"
 
 // LGMPat: 16x16 のパターンを並べた配列（各要素は 0x00GGRRBB）
 extern const std::uint32_t MRORun[][16 * 16];
@@ -9,6 +10,11 @@ extern const std::uint32_t MROStay[];
 // LGMPat の総パターン数（定義側で sizeof から自動算出）
 extern const std::size_t MROPatCount;
 
+// 色補正（ビルド時に焼き込み済みの配列: フラッシュ上、実行時の補正処理は不要）
+constexpr colorpipe::Correction MROCorrection = {0, 16, 0, 16, 0, 16, 1.0f, 0, 0};
+extern const std::uint32_t* const MROStayBaked;
+extern const std::uint32_t* const MRORunBaked;
+
 // 歩く速度
 extern const std::uint16_t iWaitMarioWalk;
 extern const std::uint16_t iWaitMarioRun;
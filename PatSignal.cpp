@@ -2,6 +2,7 @@
 #include <cstdint>
 #include <cstddef>
 #include "PatSignal.h"
+#include "BootFrame.h"
 
 #define PAT_RED \
 	{0xffffff, 0xffffff, 0xffffff, 0x000000, 0x000000, 0x000000, 0x0000FF, 0x0000FF, 0x0000FF, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,\
@@ -155,5 +156,13 @@ extern const std::size_t LGMPatCount = sizeof(LGMPat) / sizeof(LGMPat[0]);
 
 extern const std::uint32_t LGMRed[] = PAT_RED;
 
+// 起動直後に表示する停止表示（LGMRed を置換色で描いて送出順に並べたもの。コンパイル時に作成し、フラッシュに置く）
+namespace {
+	constexpr std::uint32_t kRed[] = PAT_RED;
+	constexpr auto kBootWire = bootframe::encode<BOOT_FRAME_WIDTH, BOOT_FRAME_HEIGHT>(kRed, BOOT_FRAME_COLOR_REPLACE, BOOT_FRAME_SERPENTINE, BOOT_FRAME_LEFT_TO_RIGHT);
+}
+extern const std::uint32_t* const LGMBootWire = kBootWire.data;
+extern const std::size_t LGMBootWireWords = sizeof(kBootWire.data) / sizeof(kBootWire.data[0]);
+
 extern const std::uint16_t iWaitLGMWalk = 120;
 extern const std::uint16_t iWaitLGMRun = 30;
\ No newline at end of file
@@ -2,11 +2,18 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "ColorPipeline.h"
 
 // LGMPat: 16x16 のパターンを並べた配列（各要素は 0x00GGRRBB）
 extern const std::uint32_t LGMPat[][16 * 16];
 extern const std::uint32_t LGMRed[];
+// LGMRed の停止表示を送出順の語列（1ピクセル = c<<8）にしたもの。起動直後にDMAでそのまま送出する（BootFrame.h）
+extern const std::uint32_t* const LGMBootWire;
+extern const std::size_t LGMBootWireWords;
 // LGMPat の総パターン数（定義側で sizeof から自動算出）
 extern const std::size_t LGMPatCount;
+// 色補正なし（元の配列をそのまま焼き込み済みとして参照する）
+constexpr colorpipe::Correction LGMCorrection = {0, 0, 0, 0, 0, 0, 1.0f, 0, 0};
+static_assert(colorpipe::is_identity(LGMCorrection), "LGM patterns are used without correction");
 extern const std::uint16_t iWaitLGMWalk;
 extern const std::uint16_t iWaitLGMRun;
\ No newline at end of file
@@ -175,5 +175,24 @@ extern const std::size_t ZELDARightCount = sizeof(ZELDARight) / sizeof(ZELDARigh
 extern const std::size_t ZELDAFrontCount = sizeof(ZELDAFront) / sizeof(ZELDAFront[0]);
 extern const std::size_t ZELDABackCount = sizeof(ZELDABack) / sizeof(ZELDABack[0]);
 
+// 補正済みパターン（コンパイル時に作成し、フラッシュに置く）
+namespace {
+	constexpr std::uint32_t kStay[] = STAY;
+	constexpr std::uint32_t kLeft[][16 * 16] = {LEFT_1, LEFT_2};
+	constexpr std::uint32_t kRight[][16 * 16] = {RIGHT_1, RIGHT_2};
+	constexpr std::uint32_t kFront[][16 * 16] = {FRONT_1, FRONT_2};
+	constexpr std::uint32_t kBack[][16 * 16] = {BACK_1, BACK_2};
+	constexpr auto kStayBaked = colorpipe::bake(kStay, ZELDACorrection);
+	constexpr auto kLeftBaked = colorpipe::bake(kLeft, ZELDACorrection);
+	constexpr auto kRightBaked = colorpipe::bake(kRight, ZELDACorrection);
+	constexpr auto kFrontBaked = colorpipe::bake(kFront, ZELDACorrection);
+	constexpr auto kBackBaked = colorpipe::bake(kBack, ZELDACorrection);
+}
+extern const std::uint32_t* const ZELDAStayBaked = &kStayBaked.data[0][0];
+extern const std::uint32_t* const ZELDALeftBaked = &kLeftBaked.data[0][0];
+extern const std::uint32_t* const ZELDARightBaked = &kRightBaked.data[0][0];
+extern const std::uint32_t* const ZELDAFrontBaked = &kFrontBaked.data[0][0];
+extern const std::uint32_t* const ZELDABackBaked = &kBackBaked.data[0][0];
+
 extern const std::uint16_t iWaitZeldaWalk = 240;
 extern const std::uint16_t iWaitZeldaRun = 120;
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstddef>
+#include "ColorPipeline.h"
 
 // LGMPat: 16x16 のパターンを並べた配列（各要素は 0x00GGRRBB）
 extern const std::uint32_t ZELDALeft[][16 * 16];
@@ -16,6 +17,14 @@ extern const std::size_t ZELDARightCount;
 extern const std::size_t ZELDAFrontCount;
 extern const std::size_t ZELDABackCount;
 
+// 色補正（ビルド時に焼き込み済みの配列: フラッシュ上、実行時の補正処理は不要）
+constexpr colorpipe::Correction ZELDACorrection = {0, 16, 0, 16, 0, 16, 1.0f, 0, 0};
+extern const std::uint32_t* const ZELDAStayBaked;
+extern const std::uint32_t* const ZELDALeftBaked;
+extern const std::uint32_t* const ZELDARightBaked;
+extern const std::uint32_t* const ZELDAFrontBaked;
+extern const std::uint32_t* const ZELDABackBaked;
+
 // 歩く速度
 extern const std::uint16_t iWaitZeldaWalk;
 extern const std::uint16_t iWaitZeldaRun;
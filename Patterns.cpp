@@ -0,0 +1,141 @@
+/**
+ * @file Patterns.cpp
+ * @brief キャラクタごとの描画設定とパターン群の実装
+ */
+#include <cstring>
+#include "Patterns.h"
+
+/**
+ * @brief 歩行タイムライン（パターングループ数ごと）。
+ * @details 50秒歩き（10秒ごとにグループ切替）→ 10秒走り の計60秒で終端に達し、停止状態へ戻ります。
+ */
+static const SeqStep kTimeline1[] = {
+	{0, TEMPO_WALK, 100, 100, -1, 0, 50000},
+	{0, TEMPO_RUN,  100, 100, -1, 0, 10000},
+};
+static const SeqStep kTimeline2[] = {
+	{0, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{1, TEMPO_WALK, 100, 100,  0, 1, 10000}, // 0→1 を2回
+	{0, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{1, TEMPO_RUN,  100, 100, -1, 0, 10000},
+};
+static const SeqStep kTimeline4[] = {
+	{0, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{1, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{2, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{3, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{0, TEMPO_WALK, 100, 100, -1, 0, 10000},
+	{1, TEMPO_RUN,  100, 100, -1, 0, 10000},
+};
+
+/**
+ * @brief 登録済みパターングループ数（0..4）。
+ * @return グループ数
+ */
+int Patterns::groupCount() const
+{
+	int groups = 0;
+	while (groups < 4 && PatWalkFlat[groups] != NULL) groups++;
+	return groups;
+}
+
+/**
+ * @brief 登録済みパターングループ数に応じた歩行タイムラインを返します。
+ * @param count [out] ステップ数
+ * @return タイムライン
+ */
+const SeqStep* Patterns::timeline(size_t& count) const
+{
+	int groups = groupCount();
+	if (groups >= 4) { count = sizeof(kTimeline4) / sizeof(kTimeline4[0]); return kTimeline4; }
+	if (groups >= 2) { count = sizeof(kTimeline2) / sizeof(kTimeline2[0]); return kTimeline2; }
+	count = sizeof(kTimeline1) / sizeof(kTimeline1[0]);
+	return kTimeline1;
+}
+
+/**
+ * @brief 歩き/走りのテンポを作成します。
+ * @param tempos [out] TEMPO_WALK/TEMPO_RUN の2要素
+ */
+void Patterns::makeTempos(SeqTempo tempos[2]) const
+{
+	uint16_t transWalk = iWaitWalk / 4;
+	uint16_t transRun = iWaitRun / 6;
+	tempos[TEMPO_WALK].frameMs = iWaitWalk + transWalk;
+	tempos[TEMPO_WALK].blendFrac = (uint8_t)(256u * transWalk / (iWaitWalk + transWalk));
+	tempos[TEMPO_RUN].frameMs = iWaitRun + transRun;
+	tempos[TEMPO_RUN].blendFrac = (uint8_t)(256u * transRun / (iWaitRun + transRun));
+}
+
+/**
+ * @brief PatManagerへパターンをロードし、補正を適用します。
+ * @param pmStay 停止パターン用
+ * @param pmRun  走行パターン用(最大4グループ)
+ * @param arena  バッファを切り出すアリーナ（nullptr ならヒープ）
+ */
+void Patterns::setPatManager(PatManager &pmStay,  PatManager* pmRun, PatArena* arena) const
+{
+	pmStay.reset();
+	for (int i = 0; i < 4; i++) {
+		if (pmRun[i].isInitialized) pmRun[i].reset();
+	}
+	if (isBaked) {
+		// 補正済みの配列をフラッシュ上のまま参照する（コピー/補正なし）
+		pmStay.attach(PatStopFlat, 1, PatWidth, PatHeight);
+		for (int i = 0; i < 4; i++) {
+			if (PatWalkFlat[i] == NULL) break;
+			pmRun[i].attach(PatWalkFlat[i], PatWalkCount, PatWidth, PatHeight);
+		}
+		return;
+	}
+	pmStay.init(PatStopFlat, 1, PatWidth, PatHeight, arena);
+	pmStay.setGreenRange(GreenRange.min, GreenRange.max);
+	pmStay.setRedRange(RedRange.min, RedRange.max);
+	pmStay.setBlueRange(BlueRange.min, BlueRange.max);
+	if (Gamma > 0.0f) pmStay.setGamma(Gamma);
+	if (BrightnessPercent !=0 || ContrastPercent != 0) pmStay.setBrightnessContrast(BrightnessPercent, ContrastPercent);
+
+	for (int i = 0; i < 4; i++) {
+		if (PatWalkFlat[i] == NULL) break;
+
+		pmRun[i].init(PatWalkFlat[i], PatWalkCount, PatWidth, PatHeight, arena);
+		pmRun[i].setGreenRange(GreenRange.min, GreenRange.max);
+		pmRun[i].setRedRange(RedRange.min, RedRange.max);
+		pmRun[i].setBlueRange(BlueRange.min, BlueRange.max);
+		if (Gamma > 0.0f) pmRun[i].setGamma(Gamma);
+		if (BrightnessPercent != 0 || ContrastPercent != 0) pmRun[i].setBrightnessContrast(BrightnessPercent, ContrastPercent);
+	}
+
+}
+
+/**
+ * @brief 補正済みパターン一式（停止+全グループ）が使うバッファのバイト数。
+ * @return バイト数（焼き込み済みならRAMを使わないので0）
+ */
+size_t Patterns::processedBytes() const
+{
+	if (isBaked) return 0;
+	const size_t patBytes = (size_t)PatWidth * PatHeight * sizeof(std::uint32_t);
+	return patBytes * (1 + (size_t)groupCount() * PatWalkCount);
+}
+
+/**
+ * @brief 補正設定のハッシュ（FNV-1a 32bit）。
+ * @return ハッシュ値
+ */
+std::uint32_t Patterns::settingsHash() const
+{
+	std::uint32_t gammaBits;
+	std::memcpy(&gammaBits, &Gamma, sizeof(gammaBits));
+	const std::uint8_t bytes[] = {
+		GreenRange.min, GreenRange.max, RedRange.min, RedRange.max, BlueRange.min, BlueRange.max,
+		(std::uint8_t)gammaBits, (std::uint8_t)(gammaBits >> 8), (std::uint8_t)(gammaBits >> 16), (std::uint8_t)(gammaBits >> 24),
+		BrightnessPercent, ContrastPercent,
+	};
+	std::uint32_t h = 2166136261u;
+	for (size_t i = 0; i < sizeof(bytes); i++) {
+		h ^= bytes[i];
+		h *= 16777619u;
+	}
+	return h;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Patterns.h
+ * @brief キャラクタごとの描画設定とパターン群
+ * @details パターン配列（フラッシュ上）、色補正の設定、歩行テンポをまとめた定義のヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include "PatManager.h"
+#include "AnimSequencer.h"
+#include "ColorPipeline.h"
+
+/** @brief タイムラインのテンポ番号。 */
+enum TEMPO {
+	TEMPO_WALK = 0,
+	TEMPO_RUN = 1
+};
+
+/** @brief 色レンジ指定（各チャネルの最小/最大）。 */
+struct COLOR_RANGE { uint8_t min; uint8_t max; };
+
+/**
+ * @brief colorpipe::Correction を Patterns の補正フィールド（GreenRange～ContrastPercent）に展開します。
+ * @details 焼き込みに使った設定と CharInfo の設定を一致させるために使います。
+ */
+#define PATTERNS_CORRECTION(c) {(c).gMin, (c).gMax}, {(c).rMin, (c).rMax}, {(c).bMin, (c).bMax}, (c).gamma, (c).brightness, (c).contrast
+
+/**
+ * @brief キャラクタごとの描画設定とパターン群。
+ * @details 停止1枚 + 最大4グループの連番パターンで構成します。パターンの大きさは PatWidth x PatHeight（既定は 16x16）です。
+ *          isBaked の場合、補正フィールドは焼き込みに使った設定（キャッシュキーと表示用）で、実行時には適用しません。
+ */
+class Patterns {
+	public:
+	const std::uint32_t* PatStopFlat;			/// 停止パターンは１つだけ
+	const std::uint32_t* PatWalkFlat[4];		///　パターングループとして４つまで登録可能
+	size_t PatWalkCount;						/// 各パターンの数。本当は、パターングループに含まれるパターンごとに違う可能性もあるが、ゲームという特性上ほぼ同じなので１つにする。
+	COLOR_RANGE GreenRange;						/// 
+	COLOR_RANGE RedRange;
+	COLOR_RANGE BlueRange;
+	float Gamma;
+	uint8_t BrightnessPercent;
+	uint8_t ContrastPercent;
+	bool isColorReplace;
+	bool isOverlay;
+	uint16_t iWaitWalk;
+	uint16_t iWaitRun;
+	bool isBaked;								/// true ならパターンは補正済み（ビルド時に焼き込み済み）。フラッシュ上を直接参照する
+	std::uint16_t PatWidth = 16;				/// パターンの幅（ピクセル）。停止パターンと全グループで共通。省略すると16
+	std::uint16_t PatHeight = 16;				/// パターンの高さ（ピクセル）。省略すると16
+
+	/**
+	 * @brief 登録済みパターングループ数に応じた歩行タイムラインを返します。
+	 * @param count [out] ステップ数
+	 * @return タイムライン
+	 */
+	const SeqStep* timeline(size_t& count) const;
+
+	/**
+	 * @brief 歩き/走りのテンポを作成します。
+	 * @param tempos [out] TEMPO_WALK/TEMPO_RUN の2要素
+	 * @details 1フレームは「前のパターンと重ねた遷移表示」+「パターン表示」で構成します。
+	 *          遷移表示は歩きで表示時間の1/4、走りで1/6です。
+	 */
+	void makeTempos(SeqTempo tempos[2]) const;
+
+	/**
+	 * @brief PatManagerへパターンをロードし、補正を適用します。
+	 * @param pmStay 停止パターン用
+	 * @param pmRun  走行パターン用(最大4グループ)
+	 * @param arena  バッファを切り出すアリーナ（nullptr ならヒープ。processedBytes() 以上の空きが必要）
+	 */
+	void setPatManager(PatManager &pmStay,  PatManager* pmRun, PatArena* arena = nullptr) const;
+
+	/** @brief 登録済みパターングループ数（0..4）。 */
+	int groupCount() const;
+
+	/**
+	 * @brief 補正済みパターン一式（停止+全グループ）が使うバッファのバイト数。
+	 * @return バイト数（焼き込み済みなら0）
+	 */
+	size_t processedBytes() const;
+
+	/**
+	 * @brief 補正設定（レンジ/ガンマ/明度/コントラスト）のハッシュ。
+	 * @return FNV-1a 32bit
+	 * @details 補正済みパターンのキャッシュキーに使います。設定を変えると別のキーになります。
+	 */
+	std::uint32_t settingsHash() const;
+};
@@ -0,0 +1,134 @@
+/**
+ * @file PowerManager.cpp
+ * @brief 休止時の低消費電力化（クロック低下/DORMANT）と起床レイテンシ計測の実装
+ */
+#include <stdio.h>
+#include "PowerManager.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/gpio.h"
+#include "WS2812.h"
+#include "AppEvents.h"
+#include "TraceRecorder.h"
+#if LGM_HAVE_PICO_SLEEP
+#include "pico/sleep.h"
+#endif
+
+/**
+ * @brief 起床用のGPIOを登録します。
+ * @param pin GPIO
+ * @return 登録できればtrue
+ */
+bool PowerManager::addWakePin(uint pin)
+{
+    if (wakePinCount_ >= sizeof(wakePins_) / sizeof(wakePins_[0])) return false;
+    wakePins_[wakePinCount_++] = pin;
+    return true;
+}
+
+/**
+ * @brief clk_sys を XOSC に切り替え、PLL_SYS を停止します。
+ * @return なし
+ * @details clk_ref は XOSC(12MHz) なので、clk_sys を clk_ref へ切り替えてから PLL を止めます。
+ *          タイマーは clk_ref から生成されるティックで動くため、アラーム（デバウンス）は休止中も動作します。
+ */
+void PowerManager::lowerClocks()
+{
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, XOSC_HZ, XOSC_HZ);
+    pll_deinit(pll_sys);
+}
+
+/**
+ * @brief clk_sys を休止前の周波数に戻します。
+ * @return なし
+ */
+void PowerManager::restoreClocks()
+{
+    set_sys_clock_khz(activeKhz_, true);
+}
+
+/**
+ * @brief 休止し、起床するまで戻りません。
+ * @param led 休止中に停止するLEDドライバ
+ * @return 起床要因のGPIO
+ * @details
+ * 1. PIOのSMを停止（クロック変更中に波形が崩れないように）
+ * 2. クロックを下げて休止（DORMANT または XOSC+WFE）
+ * 3. 起床時刻を記録し、クロックとPIOの分周を復帰
+ *
+ * 起床時刻はボタンのエッジの時刻です（デバウンス済みの EVT_BUTTON を取り出した時刻ではありません）。
+ * 既定のビルドではGPIO割り込みが記録した最初のエッジ（events_button_edge_us()）を使うので、起床レイテンシにデバウンスの 30ms が含まれます。
+ * DORMANT ではエッジでチップが起きるため、sleep_power_up() の直後を起床時刻とします。
+ */
+uint PowerManager::hibernate(WS2812& led)
+{
+    LGM_TRACE_SCOPE_NAMED(trace, TRACE_HIBERNATE);
+    uint wakePin = wakePinCount_ ? wakePins_[0] : 0;
+
+    fsm_.requestSleep(time_us_64());
+    activeKhz_ = clock_get_hz(clk_sys) / 1000u;
+    led.Suspend();
+
+#if LGM_HAVE_PICO_SLEEP
+    // DORMANT: 水晶も止まるため、UARTの送信を終えてから入る
+    stdio_flush();
+    sleep_run_from_xosc();
+    for (std::uint8_t i = 1; i < wakePinCount_; i++) {
+        gpio_set_dormant_irq_enabled(wakePins_[i], GPIO_IRQ_EDGE_FALL, true);
+    }
+    // DORMANT 中はタイマーが止まるため、休止時間（totalSleepUs）に DORMANT の間は含まれない（休止時間は無効）
+    fsm_.sleepEntered(time_us_64());
+    sleep_goto_dormant_until_pin(wakePins_[0], true, false); // 立下りエッジで起床
+    sleep_power_up();
+    const std::uint64_t wakeUs = time_us_64(); // タイマーは起床のエッジから再び進む
+    for (std::uint8_t i = 1; i < wakePinCount_; i++) {
+        gpio_set_dormant_irq_enabled(wakePins_[i], GPIO_IRQ_EDGE_FALL, false);
+    }
+    // 起床要因は押されているピン（読めなければ先頭）
+    for (std::uint8_t i = 0; i < wakePinCount_; i++) {
+        if (!gpio_get(wakePins_[i])) {
+            wakePin = wakePins_[i];
+            break;
+        }
+    }
+#else
+    // XOSC で動作させ、ボタン（デバウンス済み）のイベントが来るまで WFE
+    lowerClocks();
+    const std::uint64_t sleptUs = time_us_64();
+    fsm_.sleepEntered(sleptUs);
+    AppEvent ev;
+    do {
+        events_wait(ev);
+    } while (ev.type != EVT_BUTTON);
+    wakePin = ev.id;
+    std::uint64_t wakeUs = events_button_edge_us(wakePin); // 押下の最初のエッジ（GPIO割り込みで記録）
+    if (wakeUs < sleptUs) wakeUs = sleptUs; // 休止に入る前に押し始めていた
+#endif
+
+    fsm_.wake(static_cast<std::uint8_t>(wakePin), wakeUs);
+    restoreClocks();
+    led.Resume();
+    LGM_TRACE_SET_ARGS(trace, 0, wakePin);
+    return wakePin;
+}
+
+/**
+ * @brief フレームを表示したことを通知します。
+ * @return 起床後最初のフレームならtrue
+ */
+bool PowerManager::frameShown()
+{
+    if (!fsm_.frameShown(time_us_64())) return false;
+    const PowerStats& st = fsm_.stats();
+#if LGM_HAVE_PICO_SLEEP
+    // DORMANT 中はタイマーが止まるため、休止時間は出力しない
+    printf("[power] wake(GPIO%u) -> first frame: %lu us (max %lu us, sleeps %lu)\n",
+           (unsigned)st.lastWakePin, (unsigned long)st.lastWakeLatencyUs, (unsigned long)st.maxWakeLatencyUs,
+           (unsigned long)st.sleepCount);
+#else
+    printf("[power] wake(GPIO%u) -> first frame: %lu us (max %lu us, sleeps %lu, slept %llu ms)\n",
+           (unsigned)st.lastWakePin, (unsigned long)st.lastWakeLatencyUs, (unsigned long)st.maxWakeLatencyUs,
+           (unsigned long)st.sleepCount, (unsigned long long)(st.totalSleepUs / 1000u));
+#endif
+    return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file PowerManager.h
+ * @brief 休止時の低消費電力化（クロック低下/DORMANT）と起床レイテンシ計測
+ * @details LED消灯→PIO停止→クロック低下→ボタンで起床→クロック/PIO復帰 の手順をまとめたクラスのヘッダファイル
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pico/stdlib.h"
+#include "PowerState.h"
+
+class WS2812;
+
+/**
+ * @brief 休止（低消費電力）を管理するクラス。
+ * @details
+ * - pico-extras の pico/sleep.h が使える場合（LGM_HAVE_PICO_SLEEP=1）は DORMANT に入り、起床ピンのエッジで復帰します。
+ *   DORMANT 中は水晶発振も止まるため、タイマー（time_us_64）も進みません。このため PowerStats::totalSleepUs は DORMANT の間を含まず、休止時間としては無効です。
+ * - 使えない場合は clk_sys を XOSC(12MHz) に切り替えて PLL_SYS を停止し、ボタンイベントが来るまで WFE で待ちます。
+ *   clk_peri は PLL_USB から供給されるため、UART はそのまま使えます。
+ *   既定のビルド（pico-extras なし）はこちらで、DORMANT には入りません。XOSC と PLL_USB は動いたままで、コアは WFE とアラーム/GPIO の割り込みで起きます。
+ * - どちらの場合も起床後に clk_sys を休止前の周波数に戻し、WS2812 の分周を設定し直します。
+ * - 起床（ボタンのエッジ）から最初のフレーム表示までの時間を計測し、UARTへ出力します。既定のビルドではデバウンスの 30ms を含みます。
+ */
+class PowerManager {
+public:
+    PowerManager() {}
+
+    /**
+     * @brief 起床用のGPIOを登録します（プルアップ入力、Active-Low）。
+     * @param pin GPIO
+     * @return 登録できればtrue（最大2本）
+     */
+    bool addWakePin(uint pin);
+
+    /**
+     * @brief 休止し、起床するまで戻りません。
+     * @param led 休止中に停止するLEDドライバ
+     * @return 起床要因のGPIO
+     * @details 呼び出し前にLEDを消灯（黒を送出）しておいてください。
+     */
+    uint hibernate(WS2812& led);
+
+    /**
+     * @brief フレームを表示したことを通知します。
+     * @return 起床後最初のフレームで、レイテンシを記録したらtrue
+     * @details 起床後最初の呼び出しでのみ、起床→最初のフレームまでの時間を記録して出力します。
+     */
+    bool frameShown();
+
+    /** @brief 状態機械と統計。 */
+    inline const PowerStateMachine& fsm() const { return fsm_; }
+
+private:
+    void lowerClocks();
+    void restoreClocks();
+
+    std::uint32_t activeKhz_ { 0 };  ///< 休止前の clk_sys(kHz)
+    uint wakePins_[2] {};            ///< 起床用GPIO
+    std::uint8_t wakePinCount_ { 0 }; ///< 起床用GPIOの数
+    PowerStateMachine fsm_;          ///< 電源状態
+};
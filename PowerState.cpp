@@ -0,0 +1,64 @@
+/**
+ * @file PowerState.cpp
+ * @brief 休止（低消費電力）への出入りを管理する状態機械の実装
+ */
+#include "PowerState.h"
+
+/**
+ * @brief 休止を開始します。
+ * @param nowUs 現在時刻(µs)
+ * @return ACTIVEから遷移したらtrue
+ */
+bool PowerStateMachine::requestSleep(std::uint64_t nowUs)
+{
+    (void)nowUs;
+    if (state_ != PWR_ACTIVE) return false;
+    state_ = PWR_SUSPENDING;
+    return true;
+}
+
+/**
+ * @brief 休止に入りました。
+ * @param nowUs 現在時刻(µs)
+ * @return SUSPENDINGから遷移したらtrue
+ */
+bool PowerStateMachine::sleepEntered(std::uint64_t nowUs)
+{
+    if (state_ != PWR_SUSPENDING) return false;
+    state_ = PWR_SLEEPING;
+    sleepStartUs_ = nowUs;
+    stats_.sleepCount++;
+    return true;
+}
+
+/**
+ * @brief 起床しました。
+ * @param pin 起床要因のGPIO
+ * @param nowUs 現在時刻(µs)
+ * @return SLEEPINGから遷移したらtrue
+ */
+bool PowerStateMachine::wake(std::uint8_t pin, std::uint64_t nowUs)
+{
+    if (state_ != PWR_SLEEPING) return false;
+    state_ = PWR_RESUMING;
+    wakeUs_ = nowUs;
+    stats_.lastWakePin = pin;
+    stats_.totalSleepUs += nowUs - sleepStartUs_;
+    return true;
+}
+
+/**
+ * @brief フレームを表示しました。
+ * @param nowUs 現在時刻(µs)
+ * @return RESUMINGから遷移したらtrue
+ * @details 起床から最初のフレーム表示までの時間を記録し、最大値も更新します。
+ */
+bool PowerStateMachine::frameShown(std::uint64_t nowUs)
+{
+    if (state_ != PWR_RESUMING) return false;
+    state_ = PWR_ACTIVE;
+    const std::uint64_t lat = nowUs - wakeUs_;
+    stats_.lastWakeLatencyUs = lat > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<std::uint32_t>(lat);
+    if (stats_.lastWakeLatencyUs > stats_.maxWakeLatencyUs) stats_.maxWakeLatencyUs = stats_.lastWakeLatencyUs;
+    return true;
+}
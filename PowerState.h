@@ -0,0 +1,66 @@
+/**
+ * @file PowerState.h
+ * @brief 休止（低消費電力）への出入りを管理する状態機械
+ * @details クロックや割り込みに依存しない遷移と計測だけを持つクラスのヘッダファイル。
+ *          時刻は呼び出し側が与えるため、ホスト上で遷移を再現できます。
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief 電源状態。
+ */
+enum POWER_STATE : std::uint8_t {
+    PWR_ACTIVE = 0,     ///< 通常動作
+    PWR_SUSPENDING = 1, ///< LED消灯・PIO停止・クロック低下の途中
+    PWR_SLEEPING = 2,   ///< 休止中（ボタンで起床）
+    PWR_RESUMING = 3    ///< 起床後、最初のフレームを表示するまで
+};
+
+/**
+ * @brief 休止の統計。
+ */
+struct PowerStats {
+    std::uint32_t sleepCount;        ///< 休止回数
+    std::uint32_t lastWakeLatencyUs; ///< 直近の起床→最初のフレーム表示までの時間(µs)
+    std::uint32_t maxWakeLatencyUs;  ///< 起床→最初のフレーム表示までの最大時間(µs)
+    std::uint64_t totalSleepUs;      ///< 休止していた合計時間(µs)。DORMANT（タイマーが止まる）の間は含まない
+    std::uint8_t lastWakePin;        ///< 直近の起床要因のGPIO
+};
+
+/**
+ * @brief 休止への出入りの状態機械。
+ * @details ACTIVE → SUSPENDING → SLEEPING → RESUMING → ACTIVE の順にのみ遷移します。
+ *          順序に反する呼び出しは false を返し、状態を変えません。
+ */
+class PowerStateMachine {
+public:
+    PowerStateMachine() {}
+
+    /** @brief 休止を開始します（ACTIVE→SUSPENDING）。 @param nowUs 現在時刻(µs) @return 遷移したらtrue */
+    bool requestSleep(std::uint64_t nowUs);
+    /** @brief 休止に入りました（SUSPENDING→SLEEPING）。 @param nowUs 現在時刻(µs) @return 遷移したらtrue */
+    bool sleepEntered(std::uint64_t nowUs);
+    /** @brief 起床しました（SLEEPING→RESUMING）。 @param pin 起床要因のGPIO @param nowUs 現在時刻(µs) @return 遷移したらtrue */
+    bool wake(std::uint8_t pin, std::uint64_t nowUs);
+    /**
+     * @brief フレームを表示しました（RESUMING→ACTIVE）。
+     * @param nowUs 現在時刻(µs)
+     * @return 起床後最初のフレームで遷移したらtrue（ACTIVE中は何もせずfalse）
+     * @details 起床からの経過時間を起床レイテンシとして記録します。
+     */
+    bool frameShown(std::uint64_t nowUs);
+
+    /** @brief 現在の状態。 */
+    inline POWER_STATE state() const { return state_; }
+    /** @brief 統計。 */
+    inline const PowerStats& stats() const { return stats_; }
+
+private:
+    POWER_STATE state_ { PWR_ACTIVE }; ///< 現在の状態
+    PowerStats stats_ {};              ///< 統計
+    std::uint64_t sleepStartUs_ { 0 }; ///< 休止開始時刻
+    std::uint64_t wakeUs_ { 0 };       ///< 起床時刻
+};
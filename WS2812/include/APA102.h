@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "LedCanvas.h"
+#include "APA102Frame.h"
+
+#define APA102_DEFAULT_BAUD_HZ 16000000 ///< 既定のクロック(Hz)。APA102/SK9822 は 10〜20MHz 程度まで
+
+/**
+ * @brief APA102/SK9822（クロック+データの2線式）を SPI と DMA で駆動するクラス。
+ * @details
+ * - VRAM(0x00GGRRBB)と描画APIは LedCanvas から継承します。走査（serpentine/leftToRight）とパネル分割は WS2812 と同じです。
+ * - ScanBuffer() は VRAM を送出フレーム（スタート + LED + エンド）へ変換し、DMA で SPI へ送ります（待たない）。
+ * - 各LEDの5bit輝度フィールドを使い、16bit の線形値を 8bit x 5bit で表します（暗い色の階調が細かくなる）。
+ */
+class APA102 : public LedCanvas {
+				spi_inst_t* m_spi;    ///< 使用するSPI
+				uint8_t m_sckPin;     ///< クロック出力GPIO
+				uint8_t m_mosiPin;    ///< データ出力GPIO
+				uint32_t m_baudHz;    ///< 目標クロック(Hz)
+				uint32_t m_actualHz;  ///< 実際のクロック(Hz)
+				int m_dmaChan;        ///< 送出用DMAチャネル
+				float m_gamma;        ///< ガンマ
+				uint16_t m_level;     ///< 全体の明るさ 0..256
+				uint16_t m_lut[256];  ///< 8bit→16bit 線形値
+				uint8_t* m_frame;     ///< 送出フレーム
+				size_t m_frameBytes;  ///< 送出フレームのバイト数
+
+				public:
+					// １枚のパネルサイズと、そのパネルが複数枚ある場合の数。パネルのカスケード順は左上から右下に固定とする
+					uint16_t xSize;        ///< 1パネルの横ピクセル数
+					uint16_t ySize;        ///< 1パネルの縦ピクセル数
+					uint16_t xPanelCount;  ///< 水平方向のパネル枚数
+					uint16_t yPanelCount;  ///< 垂直方向のパネル枚数
+
+				public:
+					/**
+					 * @brief ドライバを構築・初期化します。
+					 * @param spi 使用するSPI（spi0/spi1）
+					 * @param sckPin クロック出力GPIO（SPIのSCK）
+					 * @param mosiPin データ出力GPIO（SPIのTX）
+					 * @param a_xSize 1枚のパネルの幅（ピクセル）
+					 * @param a_ySize 1枚のパネルの高さ（ピクセル）
+					 * @param a_xPanelCount パネルの水平方向枚数
+					 * @param a_yPanelCount パネルの垂直方向枚数
+					 * @param baudHz クロック(Hz)
+					 * @details SPI をモード0・8bitで初期化し、VRAMと送出フレームを確保します。
+					 */
+					APA102(spi_inst_t* spi, uint8_t sckPin, uint8_t mosiPin, uint16_t a_xSize, uint16_t a_ySize, uint16_t a_xPanelCount = 1, uint16_t a_yPanelCount = 1, uint32_t baudHz = APA102_DEFAULT_BAUD_HZ);
+
+					/** @brief 全パネルを送信します（DMA、待たない）。 @param serpentine 千鳥配線 @param leftToRight 偶数行の基準方向 @return なし */
+					void ScanBuffer(bool serpentine = false, bool leftToRight = true);
+					/** @brief VRAMを送出フレームに変換します。 @param dst 出力（FrameBytes() バイト） @param serpentine 千鳥配線 @param leftToRight 偶数行の基準方向 @return なし */
+					void EncodeFrame(uint8_t* dst, bool serpentine, bool leftToRight) const;
+					/** @brief 送出フレームのバイト数。 @return バイト数 */
+					size_t FrameBytes() const { return m_frameBytes; }
+					/** @brief DMA送出の完了を待ちます。 @return なし */
+					void WaitTransmit();
+					/** @brief 現在の clk_peri に合わせてクロックを設定し直します。 @return 実際のクロック(Hz) @details 送出中でないときに呼び出してください。 */
+					uint32_t UpdateClock();
+					/** @brief 実際のクロック(Hz)。 @return クロック */
+					uint32_t GetBaudHz() const { return m_actualHz; }
+					/** @brief ガンマを変更します。 @param gamma ガンマ（1.0で線形） @return なし @details 次の ScanBuffer() から反映されます。 */
+					void SetGamma(float gamma);
+					/** @brief 全体の明るさを変更します。 @param level 0..256（256で等倍） @return なし @details 16bit で掛けるため、暗くしても階調が落ちません。 */
+					void SetBrightness(uint16_t level);
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define APA102_START_BYTES 4         ///< スタートフレーム（0x00 x 4）のバイト数
+#define APA102_LED_BYTES 4           ///< 1LEDのバイト数（0xE0|輝度5bit, B, G, R）
+#define APA102_MAX_GLOBAL 31         ///< LEDごとの輝度（5bit）の最大
+
+/**
+ * @brief エンドフレームのバイト数。
+ * @param leds LEDの数
+ * @return バイト数
+ * @details データは1LEDごとにクロック半周期ずつ遅れるため、LED数/2 クロック（LED数/16 バイト）を追加で送ります。
+ *          SK9822 は次のフレームの前に 32bit の 0 が必要なので、それも含めます（APA102 でも害はありません）。
+ */
+static inline size_t apa102_end_bytes(size_t leds) { return 4u + (leds + 15u) / 16u; }
+
+/** @brief 1フレーム（スタート + LED + エンド）のバイト数。 @param leds LEDの数 @return バイト数 */
+static inline size_t apa102_frame_bytes(size_t leds) { return APA102_START_BYTES + leds * APA102_LED_BYTES + apa102_end_bytes(leds); }
+
+/**
+ * @brief 8bitチャネル値を 16bit の線形値へ変換する表を作ります。
+ * @param gamma ガンマ（1.0 で線形）
+ * @param level 全体の明るさ 0..256（256で等倍）
+ * @param lut [out] 256要素
+ * @return なし
+ * @details 明るさは 16bit で掛けるので、暗くしても階調は 5bit の輝度フィールドで保たれます。
+ */
+void apa102_build_lut(float gamma, uint16_t level, uint16_t lut[256]);
+
+/**
+ * @brief 16bitの線形値（R,G,B）を 1LED分の4バイトへ変換します。
+ * @param r 赤（0..65535）
+ * @param g 緑（0..65535）
+ * @param b 青（0..65535）
+ * @return 下位バイトから順に 0xE0|輝度, B, G, R（メモリへそのまま書けば送出順）
+ * @details 最大のチャネルが 8bit に収まる最小の輝度（1..31）を選び、各チャネルをその輝度で割り戻します。
+ *          暗い色ほど小さい輝度と大きい 8bit 値になるため、8bit のみより細かい階調で表せます。
+ */
+uint32_t apa102_pack_hdr(uint32_t r, uint32_t g, uint32_t b);
+
+/**
+ * @brief スタートフレームを書き込みます。
+ * @param dst 出力（APA102_START_BYTES バイト）
+ * @return 次に書く位置
+ */
+uint8_t* apa102_write_start(uint8_t* dst);
+
+/**
+ * @brief エンドフレームを書き込みます。
+ * @param dst 出力（apa102_end_bytes(leds) バイト）
+ * @param leds LEDの数
+ * @return 次に書く位置
+ */
+uint8_t* apa102_write_end(uint8_t* dst, size_t leds);
+
+/**
+ * @brief VRAM（0x00GGRRBB）のピクセル列を LED フレームへ変換します。
+ * @param src ピクセル列
+ * @param count ピクセル数
+ * @param step src の次のピクセルまでの要素数（1: 左→右、-1: 右→左）
+ * @param lut apa102_build_lut() の表
+ * @param dst 出力（count*APA102_LED_BYTES バイト）
+ * @return 次に書く位置
+ */
+uint8_t* apa102_encode_pixels(const uint32_t* src, size_t count, int step, const uint16_t lut[256], uint8_t* dst);
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "LedCanvas.h"
+#include "HUB75Planes.h"
+
+#define HUB75_DEFAULT_PANEL_CLK_HZ 20000000 ///< 既定のシフトクロック(Hz)。一般的なパネルの上限（25MHz前後）より低め
+#define HUB75_DEFAULT_REFRESH_HZ 240        ///< 既定の目標リフレッシュレート(Hz)
+
+/**
+ * @brief HUB75 のピン割り当て。
+ * @details データ6本、行アドレス5本、LAT/OE の2本はそれぞれ連続したGPIOにしてください。
+ */
+struct HUB75Pins {
+	uint8_t r0;    ///< R0（R0 G0 B0 R1 G1 B1 の順に6本）
+	uint8_t addrA; ///< 行アドレスA（A B C D E の順に5本）
+	uint8_t clk;   ///< CLK
+	uint8_t lat;   ///< LAT（OE は lat+1）
+};
+
+/**
+ * @brief HUB75 RGBマトリクスを RP2350 の PIO と DMA で駆動するクラス。
+ * @details
+ * - VRAM(0x00GGRRBB)と描画APIは LedCanvas から継承します（WS2812 と同じ）。
+ * - Show() で VRAM を BCM（Binary Coded Modulation）のビットプレーンへ変換し、次のフレームの先頭で切り替えます。
+ * - 行の走査は PIO（データSM + 行SM）と、自分自身を再起動する DMA（データ/制御語の2組）だけで行い、CPUは関与しません。
+ */
+class HUB75 : public LedCanvas {
+				HUB75Pins m_pins;        ///< ピン割り当て
+				PIO m_pio;               ///< 使用するPIOインスタンス
+				uint m_smData;           ///< データ用ステートマシン
+				uint m_smRow;            ///< 行アドレス/ラッチ/点灯用ステートマシン
+				int m_offsetData;        ///< データ用プログラムのロードオフセット
+				int m_offsetRow;         ///< 行用プログラムのロードオフセット
+				Hub75Geometry m_geom;    ///< 大きさとビット深度
+				uint32_t m_panelClkHz;   ///< 目標シフトクロック(Hz)
+				uint32_t m_refreshHz;    ///< 目標リフレッシュレート(Hz)
+				Hub75Timing m_timing;    ///< 現在の分周設定
+				uint16_t m_lut[256];     ///< 8bit→ビット深度の変換表
+				size_t m_planeWords;     ///< ビットプレーン1面の語数
+				uint32_t* m_planes[2];   ///< ビットプレーン（表示中/書き込み用）
+				uint8_t m_front;         ///< 表示中のビットプレーン
+				uint32_t* m_ctrl;        ///< 行SMへの制御語（行アドレスと点灯サイクル数）
+				const uint32_t* m_dataHead; ///< データDMAの再起動時の読み出し先（DMAが読む）
+				const uint32_t* m_ctrlHead; ///< 制御語DMAの再起動時の読み出し先（DMAが読む）
+				int m_dmaData;           ///< ビットプレーン→データSM
+				int m_dmaDataReload;     ///< m_dmaData の読み出し先を戻して再起動する
+				int m_dmaCtrl;           ///< 制御語→行SM
+				int m_dmaCtrlReload;     ///< m_dmaCtrl の読み出し先を戻して再起動する
+				bool m_running;          ///< 走査中ならtrue
+
+				public:
+					/**
+					 * @brief ドライバを構築・初期化します。
+					 * @param pins ピン割り当て
+					 * @param width パネルの幅（ピクセル、4の倍数）
+					 * @param height パネルの高さ（ピクセル、64まで）
+					 * @param depth ビット深度（1..HUB75_MAX_DEPTH）
+					 * @param refreshHz 目標リフレッシュレート(Hz)
+					 * @param panelClkHz 目標シフトクロック(Hz)
+					 * @details PIOへ2つのプログラムをロードし、DMAを4チャネル確保します。走査は Start() で開始します。
+					 */
+					HUB75(const HUB75Pins& pins, uint16_t width, uint16_t height, uint8_t depth = 8, uint32_t refreshHz = HUB75_DEFAULT_REFRESH_HZ, uint32_t panelClkHz = HUB75_DEFAULT_PANEL_CLK_HZ);
+
+					/** @brief 走査を開始します。 @return なし @details 以降はCPUを使わずにリフレッシュし続けます。 */
+					void Start();
+					/** @brief 走査を停止して消灯します。 @return なし @details クロック変更や休止の前に呼び出してください。 */
+					void Stop();
+					/** @brief VRAMをビットプレーンへ変換し、次のフレームから表示します。 @return なし */
+					void Show();
+					/** @brief 現在の clk_sys に合わせて分周と点灯時間を設定し直します。 @return 目標リフレッシュを満たせればtrue */
+					bool UpdateClock();
+					/** @brief 8bit→ビット深度の変換のガンマを変更します。 @param gamma ガンマ（1.0で線形） @return なし @details 次の Show() から反映されます。 */
+					void SetGamma(float gamma);
+					/** @brief 現在の分周設定とリフレッシュレートを返します。 @return 分周設定 */
+					const Hub75Timing& GetTiming() const { return m_timing; }
+					/** @brief 大きさとビット深度を返します。 @return 大きさとビット深度 */
+					const Hub75Geometry& GetGeometry() const { return m_geom; }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HUB75_MAX_DEPTH 10            ///< BCMの最大ビット深度（1チャネルあたり）
+#define HUB75_MAX_ROW_PAIRS 32        ///< 行アドレス A..E で選べる行ペアの数（64行パネルまで）
+#define HUB75_DATA_CYCLES_PER_WORD 9  ///< データSMの1語（4ピクセル）あたりのサイクル数（out 8回 + jmp）
+#define HUB75_DATA_ROW_OVERHEAD 3     ///< データSMの1行あたりの追加サイクル数（mov + irq + wait）
+#define HUB75_ROW_OVERHEAD 7          ///< 行SMの1行あたりの点灯以外のサイクル数（out 2回 + wait + ラッチ3 + irq）
+#define HUB75_HANDSHAKE_CYCLES 5      ///< シフト完了からデータSMが次の行を始めるまでの行SM側のサイクル数（wait + ラッチ3 + irq）
+
+/**
+ * @brief HUB75 パネルの大きさとビット深度。
+ * @details 上半分の行 r と下半分の行 r+height/2 を同時に表示します（行ペア）。
+ */
+struct Hub75Geometry {
+	uint16_t width;  ///< 幅（ピクセル、4の倍数）
+	uint16_t height; ///< 高さ（ピクセル、偶数で height/2 <= HUB75_MAX_ROW_PAIRS）
+	uint8_t depth;   ///< ビット深度（1..HUB75_MAX_DEPTH）
+};
+
+/**
+ * @brief HUB75 の分周設定と、その設定で得られるリフレッシュ。
+ * @details 行SMは clk_sys で動かし、点灯時間（OE）は clk_sys のサイクル数で表します。
+ */
+struct Hub75Timing {
+	uint32_t sysHz;          ///< 計算に用いた clk_sys(Hz)
+	uint16_t dataDivInt;     ///< データSMの分周の整数部
+	uint8_t dataDivFrac;     ///< データSMの分周の小数部（1/256単位）
+	uint32_t panelClkHz;     ///< 実際のシフトクロック(Hz)
+	uint32_t shiftCycles;    ///< 1行（1ビットプレーン）のシフトに要する clk_sys サイクル数
+	uint32_t oeBaseCycles;   ///< 最下位ビットプレーンの点灯サイクル数（プレーン b は oeBaseCycles<<b）
+	uint32_t frameCycles;    ///< 1フレーム（全行ペア×全プレーン）の clk_sys サイクル数
+	uint32_t refreshHz;      ///< 実際のリフレッシュレート(Hz)
+	uint16_t oePermille;     ///< フレームのうちいずれかの行が点灯している割合（‰）
+};
+
+/**
+ * @brief clk_sys と目標値から、HUB75 の分周と最下位プレーンの点灯時間を求めます。
+ * @param sysHz clk_sys(Hz)
+ * @param geom パネルの大きさとビット深度
+ * @param panelClkHz 目標シフトクロック(Hz)（パネルの上限以下）
+ * @param refreshHz 目標リフレッシュレート(Hz)
+ * @param out [out] 分周設定と実際のタイミング
+ * @return 分周器の範囲内で、最下位プレーン1サイクル点灯でも目標リフレッシュを満たせればtrue
+ * @details 目標リフレッシュを満たす範囲で点灯時間（明るさ）が最大になる oeBaseCycles を選びます。
+ *          1プレーンの周期は max(シフト時間+受け渡し, 行SMの処理+点灯時間) です（シフトと点灯は並行して進みます）。
+ */
+bool hub75_calc_timing(uint32_t sysHz, const Hub75Geometry& geom, uint32_t panelClkHz, uint32_t refreshHz, Hub75Timing& out);
+
+/** @brief ビットプレーン1面分（全行ペア×全プレーン）の語数。 @param geom 大きさとビット深度 @return 語数 */
+size_t hub75_plane_words(const Hub75Geometry& geom);
+
+/**
+ * @brief 8bitチャネル値をビット深度 depth の値へ変換する表を作ります。
+ * @param depth ビット深度（1..HUB75_MAX_DEPTH）
+ * @param gamma ガンマ（1.0 で線形）
+ * @param lut [out] 256要素
+ * @return なし
+ * @details 8bitより深いビット深度は、ガンマ補正後の暗い階調を潰さずに表すために使います。
+ */
+void hub75_build_lut(uint8_t depth, float gamma, uint16_t lut[256]);
+
+/**
+ * @brief 行SMへ送る制御語（行アドレスと点灯サイクル数）を作ります。
+ * @param geom 大きさとビット深度
+ * @param timing hub75_calc_timing() の結果
+ * @param ctrl [out] (height/2)*depth 語
+ * @return なし
+ * @details 並びは hub75_encode_planes() と同じ（行ペア順、その中でプレーン順）。1語 = アドレス | (点灯サイクル数-1)<<5。
+ */
+void hub75_build_control(const Hub75Geometry& geom, const Hub75Timing& timing, uint32_t* ctrl);
+
+/**
+ * @brief VRAM（0x00GGRRBB）をBCMのビットプレーンに変換します。
+ * @param vram VRAM
+ * @param stride VRAMの1行の要素数
+ * @param geom 大きさとビット深度
+ * @param lut hub75_build_lut() の表
+ * @param planes [out] hub75_plane_words() 語
+ * @return なし
+ * @details 1ピクセル=1バイト（bit0..5 = R0 G0 B0 R1 G1 B1）、1語に4ピクセルをLSBから詰めます（データSMは右シフトで出力）。
+ */
+void hub75_encode_planes(const uint32_t* vram, uint32_t stride, const Hub75Geometry& geom, const uint16_t lut[256], uint32_t* planes);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "PixelOps.h"
+
+#define LEDCAL_ONE 4096        ///< 色補正行列の 1.0（Q12。要素は -8.0..+8.0）
+#define LEDCAL_GAIN_UNITY 255  ///< LEDごとの明るさの等倍
+
+/**
+ * @brief 色補正行列（Q12 固定小数点）。
+ * @details 出力 = m * 入力（列ベクトル R,G,B）。m[0..2] が出力 R の行、m[3..5] が G、m[6..8] が B です。
+ *          LEDのロットによる色味の違い（例: 緑が青寄り）を、チャネル間の混ぜ合わせで打ち消します。
+ */
+struct LedColorMatrix {
+	int16_t m[9]; ///< 行優先 R,G,B
+};
+
+/**
+ * @brief 送出データを作るときに掛ける補正。
+ * @details
+ * - panelMatrix: パネルごとの行列（パネル順 = 左上→右下、xPanelCount*yPanelCount 個）。同じロットのパネルは同じ行列を指してよい。
+ * - ledGain: LEDごとの明るさ（物理順 = 送出順、1LED 1バイト、LEDCAL_GAIN_UNITY で等倍）。
+ * - どちらも nullptr なら補正しません。メモリは 18バイト/パネル + 1バイト/LED です（VRAM の 1/4）。
+ * - 補正は送出データへ変換するとき（WS2812::EncodeWire/ScanPanel）に掛けるので、VRAMやパターンは変わりません。
+ */
+struct LedCalibration {
+	const LedColorMatrix* panelMatrix; ///< パネルごとの行列（nullptr で無効）
+	const uint8_t* ledGain;            ///< LEDごとの明るさ（nullptr で無効）
+};
+
+/** @brief 単位行列を作ります。 @param out [out] 行列 @return なし */
+void ledcal_matrix_identity(LedColorMatrix& out);
+
+/**
+ * @brief 実数の行列から Q12 の行列を作ります（起動時の設定用）。
+ * @param m 行優先 3x3（出力 R,G,B の行）
+ * @param out [out] 行列（範囲外は -8.0..+8.0 に丸める）
+ * @return なし
+ */
+void ledcal_matrix_from_float(const float m[9], LedColorMatrix& out);
+
+/** @brief Q12 の値を 0..255.0 に収めます。 */
+static inline uint32_t ledcal_clamp_q12(int32_t v)
+{
+	return v < 0 ? 0u : v > 255 * LEDCAL_ONE ? 255u * LEDCAL_ONE : (uint32_t)v;
+}
+
+/**
+ * @brief 1ピクセルに行列と明るさを掛けます。
+ * @param c 0x00GGRRBB
+ * @param m 行列（nullptr なら掛けない）
+ * @param gain 明るさ 0..255（LEDCAL_GAIN_UNITY で等倍）
+ * @return 0x00GGRRBB
+ * @details 行列の結果を 0..255 に収め、明るさ gain/255 を掛けてから四捨五入します（丸めは1回）。
+ *          行列がない場合の明るさは PixelOps の px_scale（切り捨て）で3チャネルをまとめて掛けます。
+ */
+static inline uint32_t ledcal_apply(uint32_t c, const LedColorMatrix* m, uint32_t gain)
+{
+	if (m == nullptr) return gain == LEDCAL_GAIN_UNITY ? c : pixelops::px_scale(c, gain + 1u);
+	const int32_t g = (int32_t)((c >> 16) & 0xFFu), r = (int32_t)((c >> 8) & 0xFFu), b = (int32_t)(c & 0xFFu);
+	// 明るさ gain/255 を Q16 で（255 → 0xFFFF）。行列の結果（Q12）は Q4 に落として32bitに収め、丸めは最後の1回だけ
+	const uint32_t gq = gain * 257u;
+	const uint32_t ro = ((ledcal_clamp_q12(m->m[0] * r + m->m[1] * g + m->m[2] * b) >> 8) * gq + (1u << 19)) >> 20;
+	const uint32_t go = ((ledcal_clamp_q12(m->m[3] * r + m->m[4] * g + m->m[5] * b) >> 8) * gq + (1u << 19)) >> 20;
+	const uint32_t bo = ((ledcal_clamp_q12(m->m[6] * r + m->m[7] * g + m->m[8] * b) >> 8) * gq + (1u << 19)) >> 20;
+	return (go << 16) | (ro << 8) | bo;
+}
+
+/**
+ * @brief 1行を補正しながら送出データ（c<<8）へ変換します。
+ * @param src VRAMの行の、送出順で最初のピクセル
+ * @param step 次のピクセルへの増分（左→右 +1、右→左 -1）
+ * @param dst 出力（n 語）
+ * @param n ピクセル数
+ * @param m 行列（nullptr なら掛けない）
+ * @param gain 最初のLEDの明るさ（nullptr なら等倍）。送出順に n 個
+ * @return なし
+ */
+void ledcal_encode_row(const uint32_t* src, int step, uint32_t* dst, uint32_t n, const LedColorMatrix* m, const uint8_t* gain);
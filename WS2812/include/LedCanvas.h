@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include "SpriteBlit.h"
+#include "TileMap.h"
+
+/**
+ * @brief VRAM（0x00GGRRBB）と描画APIを持つ基底クラス。
+ * @details
+ * - WS2812（1線式）と HUB75（行走査マトリクス）は、このクラスを継承して同じVRAMと描画APIを使います。
+ * - 描画はVRAMだけを書き換えます。パネルへの送出は派生クラスの担当です。
+ */
+class LedCanvas {
+				public:
+					uint32_t* pVRam;  ///< VRAM（GRB 24bit、1要素=1ピクセル）
+					uint32_t xVRam;   ///< VRAMの幅（ピクセル）
+					uint32_t yVRam;   ///< VRAMの高さ（ピクセル）
+
+				private:
+					bool m_ownsVRam;  ///< pVRam をこのオブジェクトが確保した（デストラクタで解放する）
+
+				public:
+					/** @brief VRAMを確保して黒で初期化します。 @param width 幅（ピクセル） @param height 高さ（ピクセル） */
+					LedCanvas(uint32_t width, uint32_t height);
+					/** @brief 呼び出し側のメモリをVRAMとして使い、黒で初期化します。 @param vram width*height 要素 @param width 幅（ピクセル） @param height 高さ（ピクセル） @details 静的に確保したVRAM（WS2812Static）用。 */
+					LedCanvas(uint32_t* vram, uint32_t width, uint32_t height);
+					/** @brief 自分で確保したVRAMだけを解放します（呼び出し側のメモリは解放しません）。 */
+					virtual ~LedCanvas();
+
+					LedCanvas(const LedCanvas&) = delete;
+					LedCanvas& operator=(const LedCanvas&) = delete;
+
+					// VRAM 操作用のユーティリティ
+					/** @brief VRAMを指定色で塗りつぶします。 @param rgb 0x00GGRRBB @return なし */
+					void Clear(uint32_t rgb = 0);
+					/** @brief VRAMの1ピクセルを書き換えます。 @param x X @param y Y @param rgb 0x00GGRRBB @return なし */
+					void SetPixel(uint16_t x, uint16_t y, uint32_t rgb);
+
+					/**
+					 * @brief 任意のパターン配列をVRAMへ描画します。
+					 * @param pattern 0x00GGRRBB のフラット配列
+					 * @param width パターン幅
+					 * @param height パターン高さ
+					 * @param X 貼り付け先 左上X（負ならパターンの左側を切り詰める）
+					 * @param y 貼り付け先 左上Y（負ならパターンの上側を切り詰める）
+					 * @param colorReplace 置換色（0で無効）
+					 * @param isOverlay 黒(0)を透明として重ねる
+					 * @return なし
+					 */
+					void DrawBuffer(const uint32_t pattern[], uint16_t width, uint16_t height, int32_t X, int32_t y, uint32_t colorReplace, bool isOverlay);
+					/**
+					 * @brief パターン配列を拡大・縮小・回転してVRAMへ描画します。
+					 * @param pattern 0x00GGRRBB のフラット配列
+					 * @param width パターン幅
+					 * @param height パターン高さ
+					 * @param xf 変換（sprite_xform_make() で作る）
+					 * @param colorReplace 置換色（0で無効）
+					 * @param isOverlay 黒(0)を透明として重ねる
+					 * @param filter サンプリング方法（ドット絵の整数倍は SPRITE_NEAREST）
+					 * @return なし
+					 */
+					void DrawTransformed(const uint32_t pattern[], uint16_t width, uint16_t height, const SpriteXform& xf, uint32_t colorReplace, bool isOverlay, SpriteFilter filter = SPRITE_NEAREST);
+					/**
+					 * @brief タイルマップをVRAM全体へ描画します（背景など大きな静止画向け）。
+					 * @param ts タイルセット（8x8/16x16、4bpp/8bpp）
+					 * @param map タイルマップ
+					 * @param scrollX VRAMの左端に来るマップのX（マップの端で一周する）
+					 * @param scrollY VRAMの上端に来るマップのY
+					 * @param isOverlay 番号0の画素を透明として重ねる
+					 * @return なし
+					 */
+					void DrawTileMap(const TileSet& ts, const TileMap& map, int32_t scrollX, int32_t scrollY, bool isOverlay = false);
+
+					// VRAM 全体への一括処理（PixelOps.h のパック済みピクセル演算）
+					/** @brief VRAM全体をアルファ倍します。 @param alpha 0..256（256で等倍） @return なし */
+					void Scale(uint16_t alpha);
+					/** @brief VRAMと同じ大きさのフレームへクロスフェードします。 @param frame xVRam*yVRam 要素の 0x00GGRRBB @param alpha 0..256（256でframe） @return なし */
+					void Blend(const uint32_t frame[], uint16_t alpha);
+					/** @brief チャネル値の合計が上限を超えないようにVRAM全体を暗くします。 @param maxLevel 合計の上限 @return 適用したアルファ（256なら変更なし） */
+					uint16_t LimitPower(uint32_t maxLevel);
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined(__ARM_FEATURE_SIMD32) && __ARM_FEATURE_SIMD32
+#include <arm_acle.h>
+#define PIXELOPS_USE_DSP 1
+#else
+#define PIXELOPS_USE_DSP 0
+#endif
+
+/**
+ * @brief パック済みピクセル(0x00GGRRBB)を1語のまま処理するカーネル群。
+ * @details
+ * - 各チャネル（8bit×4レーン）を分解せずに、飽和加算/減算・平均・最大・アルファ倍・ブレンドを行います。
+ * - Cortex-M33(RP2350) では DSP 拡張の SIMD 命令（UQADD8/UQSUB8/UHADD8/USUB8+SEL/USADA8）を使います。
+ * - それ以外（ホスト等）では同じ結果になる SWAR（レーン間の桁上がりをマスクする整数演算）で処理します。
+ * - ref:: はチャネルごとに分解する基準実装です。SWAR/DSP版はこれとビット単位で一致します。
+ * - アルファは 0..256（256 で等倍）。レーンの結果は (v * alpha) >> 8 です。
+ */
+namespace pixelops {
+
+/** @brief チャネルごとに分解して処理する基準実装。 */
+namespace ref {
+	constexpr uint32_t lane(uint32_t c, int i) { return (c >> (i * 8)) & 0xFFu; }
+
+	constexpr uint32_t add_sat(uint32_t a, uint32_t b)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) {
+			uint32_t v = lane(a, i) + lane(b, i);
+			r |= (v > 255u ? 255u : v) << (i * 8);
+		}
+		return r;
+	}
+	constexpr uint32_t sub_sat(uint32_t a, uint32_t b)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) {
+			uint32_t v = lane(a, i) > lane(b, i) ? lane(a, i) - lane(b, i) : 0u;
+			r |= v << (i * 8);
+		}
+		return r;
+	}
+	constexpr uint32_t avg(uint32_t a, uint32_t b)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) r |= ((lane(a, i) + lane(b, i)) >> 1) << (i * 8);
+		return r;
+	}
+	constexpr uint32_t max(uint32_t a, uint32_t b)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) r |= (lane(a, i) > lane(b, i) ? lane(a, i) : lane(b, i)) << (i * 8);
+		return r;
+	}
+	constexpr uint32_t scale(uint32_t c, uint32_t alpha)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) r |= ((lane(c, i) * alpha) >> 8) << (i * 8);
+		return r;
+	}
+	constexpr uint32_t blend(uint32_t a, uint32_t b, uint32_t alpha)
+	{
+		uint32_t r = 0;
+		for (int i = 0; i < 4; i++) r |= ((lane(a, i) * (256u - alpha) + lane(b, i) * alpha) >> 8) << (i * 8);
+		return r;
+	}
+	constexpr uint32_t sum(uint32_t c) { return lane(c, 0) + lane(c, 1) + lane(c, 2) + lane(c, 3); }
+}
+
+/** @brief レーン間の桁上がりをマスクして1語で処理する実装（どの環境でも使える）。 */
+namespace swar {
+	constexpr uint32_t kHigh = 0x80808080u; ///< 各レーンの最上位bit
+	constexpr uint32_t kLow7 = 0x7F7F7F7Fu; ///< 各レーンの下位7bit
+	constexpr uint32_t kEven = 0x00FF00FFu; ///< レーン0/2（B/G）
+
+	constexpr uint32_t add_sat(uint32_t a, uint32_t b)
+	{
+		const uint32_t s = (a & kLow7) + (b & kLow7);          // 下位7bitの和（bit7 に桁上がり）
+		const uint32_t carry = ((a & b) | ((a | b) & s)) & kHigh; // レーンからの桁あふれ
+		return (s ^ ((a ^ b) & kHigh)) | ((carry >> 7) * 0xFFu);
+	}
+	constexpr uint32_t sub_sat(uint32_t a, uint32_t b) { return ~add_sat(~a, b); } // 255-min(255, 255-a+b)
+	constexpr uint32_t avg(uint32_t a, uint32_t b) { return (a & b) + (((a ^ b) >> 1) & kLow7); }
+	constexpr uint32_t max(uint32_t a, uint32_t b) { return b + sub_sat(a, b); }
+	constexpr uint32_t scale(uint32_t c, uint32_t alpha)
+	{
+		// 16bitレーン2本ずつ乗算（255*256 < 65536 なので隣へあふれない）
+		return (((c & kEven) * alpha >> 8) & kEven) | ((((c >> 8) & kEven) * alpha) & ~kEven);
+	}
+	constexpr uint32_t blend(uint32_t a, uint32_t b, uint32_t alpha)
+	{
+		const uint32_t ia = 256u - alpha;
+		const uint32_t even = (((a & kEven) * ia + (b & kEven) * alpha) >> 8) & kEven;
+		const uint32_t odd = (((a >> 8) & kEven) * ia + ((b >> 8) & kEven) * alpha) & ~kEven;
+		return even | odd;
+	}
+	constexpr uint32_t sum(uint32_t c)
+	{
+		const uint32_t x = (c & kEven) + ((c >> 8) & kEven);
+		return (x & 0xFFFFu) + (x >> 16);
+	}
+
+	// 基準実装との一致（境界値）
+	static_assert(add_sat(0x00FF8001u, 0x00018080u) == ref::add_sat(0x00FF8001u, 0x00018080u), "add_sat");
+	static_assert(add_sat(0x7F7F7F7Fu, 0x01010101u) == ref::add_sat(0x7F7F7F7Fu, 0x01010101u), "add_sat carry");
+	static_assert(sub_sat(0x00108000u, 0x00208101u) == ref::sub_sat(0x00108000u, 0x00208101u), "sub_sat");
+	static_assert(avg(0x00FF01FFu, 0x00FF0200u) == ref::avg(0x00FF01FFu, 0x00FF0200u), "avg");
+	static_assert(max(0x00108020u, 0x00207F10u) == ref::max(0x00108020u, 0x00207F10u), "max");
+	static_assert(scale(0x00FFFFFFu, 256) == 0x00FFFFFFu && scale(0x00FF8001u, 128) == ref::scale(0x00FF8001u, 128), "scale");
+	static_assert(blend(0x00FF0000u, 0x0000FF80u, 64) == ref::blend(0x00FF0000u, 0x0000FF80u, 64), "blend");
+	static_assert(sum(0x00FFFFFFu) == 765u, "sum");
+}
+
+/** @brief チャネルごとの飽和加算。 */
+static inline uint32_t px_add_sat(uint32_t a, uint32_t b)
+{
+#if PIXELOPS_USE_DSP
+	return __uqadd8(a, b);
+#else
+	return swar::add_sat(a, b);
+#endif
+}
+
+/** @brief チャネルごとの飽和減算（a-b、0未満は0）。 */
+static inline uint32_t px_sub_sat(uint32_t a, uint32_t b)
+{
+#if PIXELOPS_USE_DSP
+	return __uqsub8(a, b);
+#else
+	return swar::sub_sat(a, b);
+#endif
+}
+
+/** @brief チャネルごとの平均（切り捨て）。 */
+static inline uint32_t px_avg(uint32_t a, uint32_t b)
+{
+#if PIXELOPS_USE_DSP
+	return __uhadd8(a, b);
+#else
+	return swar::avg(a, b);
+#endif
+}
+
+/** @brief チャネルごとの最大。 */
+static inline uint32_t px_max(uint32_t a, uint32_t b)
+{
+#if PIXELOPS_USE_DSP
+	(void)__usub8(a, b); // GEフラグ: a>=b のレーン
+	return __sel(a, b);
+#else
+	return swar::max(a, b);
+#endif
+}
+
+/** @brief アルファ倍（alpha: 0..256、256で等倍）。 */
+static inline uint32_t px_scale(uint32_t c, uint32_t alpha) { return swar::scale(c, alpha); }
+
+/** @brief a→b のブレンド（alpha: 0..256、0でa、256でb）。 */
+static inline uint32_t px_blend(uint32_t a, uint32_t b, uint32_t alpha) { return swar::blend(a, b, alpha); }
+
+/** @brief 全チャネルの合計（消費電流の目安）。 */
+static inline uint32_t px_sum(uint32_t c)
+{
+#if PIXELOPS_USE_DSP
+	return __usada8(c, 0u, 0u);
+#else
+	return swar::sum(c);
+#endif
+}
+
+/**
+ * @brief バッファ全体をアルファ倍します。
+ * @param dst 出力（src と同じでもよい）
+ * @param src 入力
+ * @param n ピクセル数
+ * @param alpha 0..256
+ */
+static inline void px_scale_buffer(uint32_t* dst, const uint32_t* src, size_t n, uint32_t alpha)
+{
+	if (alpha >= 256u) {
+		if (dst != src) for (size_t i = 0; i < n; i++) dst[i] = src[i];
+		return;
+	}
+	for (size_t i = 0; i < n; i++) dst[i] = px_scale(src[i], alpha);
+}
+
+/**
+ * @brief 2つのバッファをブレンドします（クロスフェード）。
+ * @param dst 出力（a/b と同じでもよい）
+ * @param a alpha=0 側
+ * @param b alpha=256 側
+ * @param n ピクセル数
+ * @param alpha 0..256
+ */
+static inline void px_blend_buffer(uint32_t* dst, const uint32_t* a, const uint32_t* b, size_t n, uint32_t alpha)
+{
+	for (size_t i = 0; i < n; i++) dst[i] = px_blend(a[i], b[i], alpha);
+}
+
+/** @brief dst に src を飽和加算します。 */
+static inline void px_add_buffer(uint32_t* dst, const uint32_t* src, size_t n)
+{
+	for (size_t i = 0; i < n; i++) dst[i] = px_add_sat(dst[i], src[i]);
+}
+
+/** @brief dst を dst と src のチャネルごとの最大にします。 */
+static inline void px_max_buffer(uint32_t* dst, const uint32_t* src, size_t n)
+{
+	for (size_t i = 0; i < n; i++) dst[i] = px_max(dst[i], src[i]);
+}
+
+/** @brief バッファ全体のチャネル合計。 */
+static inline uint32_t px_sum_buffer(const uint32_t* src, size_t n)
+{
+	uint32_t acc = 0;
+#if PIXELOPS_USE_DSP
+	for (size_t i = 0; i < n; i++) acc = __usada8(src[i], 0u, acc);
+#else
+	for (size_t i = 0; i < n; i++) acc += swar::sum(src[i]);
+#endif
+	return acc;
+}
+
+} // namespace pixelops
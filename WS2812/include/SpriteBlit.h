@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPRITE_ONE 65536       ///< 固定小数点（16.16）の 1.0
+#define SPRITE_ANGLE_FULL 256  ///< 1周の角度（sprite_xform_make の angle）
+
+/**
+ * @brief 変形描画のサンプリング方法。
+ */
+enum SpriteFilter : uint8_t {
+	SPRITE_NEAREST = 0,   ///< 最近傍（ドット絵をそのまま拡大）
+	SPRITE_BILINEAR = 1,  ///< 双線形補間（縮小・回転で角を滑らかに）
+};
+
+/**
+ * @brief 描画先の座標から元画像の座標を求めるアフィン変換（16.16 固定小数点）。
+ * @details
+ * - 描画先のピクセル (dx, dy) の中心に対応する元画像の座標は (x0 + a*dx + b*dy, y0 + c*dx + d*dy) です。
+ *   元画像のピクセル i は [i, i+1) を覆います。
+ * - 1行の中では x 方向に (a, c) ずつ足すだけで元画像の座標が求まります（乗算は行ごとに1回）。
+ * - dstLeft..dstBottom は元画像の4隅を描画先へ写した範囲（ピクセル、右下は含まない）です。
+ */
+struct SpriteXform {
+	int32_t a, b;         ///< 描画先 X/Y が1増えたときの元画像 X の増分
+	int32_t c, d;         ///< 描画先 X/Y が1増えたときの元画像 Y の増分
+	int32_t x0, y0;       ///< 描画先 (0,0) の中心に対応する元画像の座標
+	int16_t dstLeft;      ///< 描画される範囲の左端
+	int16_t dstTop;       ///< 描画される範囲の上端
+	int16_t dstRight;     ///< 描画される範囲の右端（含まない）
+	int16_t dstBottom;    ///< 描画される範囲の下端（含まない）
+};
+
+/**
+ * @brief 拡大率と回転角から変換を作ります。
+ * @param srcW 元画像の幅
+ * @param srcH 元画像の高さ
+ * @param dstCx 元画像の中心を置く描画先の X（16.16）
+ * @param dstCy 元画像の中心を置く描画先の Y（16.16）
+ * @param scaleX X の拡大率（16.16、SPRITE_ONE で等倍、0以下は不可）
+ * @param scaleY Y の拡大率（16.16）
+ * @param angle 回転角（SPRITE_ANGLE_FULL で1周、時計回り。64 で 90°）
+ * @param out [out] 変換
+ * @return なし
+ * @details 角度は 1/4 周期の正弦表で求めるので、0/64/128/192 は誤差なく 90° 単位の回転になります。
+ *          整数倍の拡大（回転なし）では、各ピクセルがちょうど scale x scale に複製されます。
+ */
+void sprite_xform_make(uint32_t srcW, uint32_t srcH, int32_t dstCx, int32_t dstCy, int32_t scaleX, int32_t scaleY, uint8_t angle, SpriteXform& out);
+
+/**
+ * @brief 元画像を変形して描画します。
+ * @param dst 描画先（0x00GGRRBB）
+ * @param dstW 描画先の幅
+ * @param dstH 描画先の高さ
+ * @param src 元画像（0x00GGRRBB、srcW*srcH 要素）
+ * @param srcW 元画像の幅
+ * @param srcH 元画像の高さ
+ * @param xf 変換（sprite_xform_make() など）
+ * @param filter サンプリング方法
+ * @param colorReplace 置換色（0で無効）
+ * @param isOverlay 黒(0)を透明として重ねる
+ * @return 書き込んだピクセル数
+ * @details
+ * - LedCanvas::DrawBuffer と同じく、元画像の黒(0)は isOverlay なら透明、そうでなければ黒として描きます。元画像の外側には描きません。
+ * - 行ごとに、元画像の内側に入る X の範囲を先に求めるので、ピクセルごとの範囲判定はありません。
+ * - 双線形補間でも描く/描かないは最近傍のピクセルで決め、黒の近傍は最近傍の色に置き換えて混ぜます（輪郭が黒くにじまない）。
+ */
+size_t sprite_blit(uint32_t* dst, uint32_t dstW, uint32_t dstH, const uint32_t* src, uint32_t srcW, uint32_t srcH,
+                   const SpriteXform& xf, SpriteFilter filter, uint32_t colorReplace, bool isOverlay);
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TILE_INDEX_MASK 0x03FFu   ///< タイルマップの1マス: タイル番号（0..1023）
+#define TILE_PALETTE_SHIFT 10     ///< タイルマップの1マス: パレット番号の位置（4bit、4bpp のみ）
+#define TILE_PALETTE_MASK 0x3C00u ///< タイルマップの1マス: パレット番号
+#define TILE_HFLIP 0x4000u        ///< タイルマップの1マス: 左右反転
+#define TILE_VFLIP 0x8000u        ///< タイルマップの1マス: 上下反転
+
+/**
+ * @brief タイルマップの1マスを作ります。
+ * @param tile タイル番号
+ * @param pal パレット番号（4bpp のみ）
+ * @param flags TILE_HFLIP / TILE_VFLIP
+ */
+#define TILE_CELL(tile, pal, flags) ((uint16_t)(((tile) & TILE_INDEX_MASK) | (((uint32_t)(pal) << TILE_PALETTE_SHIFT) & TILE_PALETTE_MASK) | (flags)))
+
+/**
+ * @brief タイルセット（マップのすべてのマスで共有する、タイルの画像とパレット）。
+ * @details
+ * - タイルは一辺 8 か 16 の正方形で、画素はパレットの番号です。4bpp は1バイトに2画素（左の画素が下位4bit）、8bpp は1バイトに1画素。
+ *   タイル i は pixels の i*(一辺*一辺*bpp/8) バイト目から、行優先で並びます。
+ * - 色は 0x00GGRRBB です。4bpp は16色のパレットを paletteCount 個（マスごとに選ぶ）、8bpp は256色のパレットを1個使います。
+ * - 番号0は、重ねて描く場合（isOverlay）に透明です（DrawBuffer の黒と同じ扱い）。
+ */
+struct TileSet {
+	const uint8_t* pixels;   ///< タイルの画素（パレットの番号）
+	const uint32_t* palette; ///< 色（4bpp: 16*paletteCount 色、8bpp: 256色）
+	uint16_t tileCount;      ///< タイル数
+	uint8_t tileSize;        ///< タイルの一辺（8 または 16）
+	uint8_t bitsPerPixel;    ///< 4 または 8
+	uint8_t paletteCount;    ///< パレット数（4bpp のみ、1..16）
+};
+
+/**
+ * @brief タイルマップ（マスごとのタイル番号・パレット・反転）。
+ * @details マスは TILE_CELL() で作り、行優先で width*height 個並べます。描画ではマップの端でつながる（一周する）ものとして扱います。
+ */
+struct TileMap {
+	const uint16_t* cells; ///< マス（width*height 個）
+	uint16_t width;        ///< 横のマス数
+	uint16_t height;       ///< 縦のマス数
+};
+
+/**
+ * @brief タイルセットの設定が正しいかを確かめます。
+ * @param ts タイルセット
+ * @return 描画できればtrue
+ */
+bool tileset_valid(const TileSet& ts);
+
+/**
+ * @brief タイルマップを描画先へ描きます。
+ * @param dst 描画先（0x00GGRRBB）
+ * @param dstW 描画先の幅
+ * @param dstH 描画先の高さ
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @param scrollX 描画先の左端に来るマップのX（ピクセル、負やマップの幅以上は一周させる）
+ * @param scrollY 描画先の上端に来るマップのY
+ * @param isOverlay 番号0の画素を透明として重ねる
+ * @param firstRow 描く最初の行（描画先のY）
+ * @param rows 描く行数（描画先の下端で切り詰める）
+ * @return 描いた範囲のピクセル数（透明を含む）
+ * @details
+ * - マスの切れ目ごとにタイルの行・パレット・反転を1回だけ求め、その中はパレットを引いて並べるだけです（ピクセルごとの割り算なし）。
+ * - タイル数以上のタイル番号は番号0だけのタイル、パレット数以上のパレット番号は0番のパレットとして描きます。
+ * - 行の範囲を分けて呼べば、VRAMの一部（送出するパネルの行など）だけを描けます。結果は一度に描いた場合と同じです。
+ */
+size_t tilemap_draw(uint32_t* dst, uint32_t dstW, uint32_t dstH, const TileSet& ts, const TileMap& map, int32_t scrollX, int32_t scrollY,
+                    bool isOverlay, uint32_t firstRow = 0, uint32_t rows = UINT32_MAX);
+
+/**
+ * @brief タイルセットとマップが使うバイト数。
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @return タイルの画素 + パレット + マス のバイト数
+ */
+size_t tilemap_bytes(const TileSet& ts, const TileMap& map);
+
+/**
+ * @brief 画像から 8bpp のタイルセットとマップを作ります（PC側のツールやテスト用）。
+ * @param image 0x00GGRRBB の画像（width*height）
+ * @param width 幅（tileSize の倍数）
+ * @param height 高さ（tileSize の倍数）
+ * @param tileSize タイルの一辺（8 または 16）
+ * @param pixels [out] タイルの画素（maxTiles*tileSize*tileSize バイト）
+ * @param maxTiles pixels に入るタイル数
+ * @param palette [out] 256色のパレット（0番は黒 = 透明）
+ * @param cells [out] マス（(width/tileSize)*(height/tileSize) 個）
+ * @param ts [out] タイルセット（pixels/palette を指す）
+ * @param map [out] タイルマップ（cells を指す）
+ * @return 色が256色以内でタイルが maxTiles に収まればtrue
+ * @details 同じタイルと、左右/上下を反転すると同じになるタイルは1つにまとめ、マスの反転ビットで表します。
+ */
+bool tilemap_build(const uint32_t* image, uint32_t width, uint32_t height, uint8_t tileSize, uint8_t* pixels, size_t maxTiles,
+                   uint32_t* palette, uint16_t* cells, TileSet& ts, TileMap& map);
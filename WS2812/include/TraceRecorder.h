@@ -0,0 +1,218 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @file TraceRecorder.h
+ * @brief 描画コマンドのトレース（リングバッファへの記録と UART への出力）
+ * @details
+ * - メインループの状態、パターン一式の取得、DrawBuffer（引数つき）、ScanBuffer、休止/待ちと受け取ったボタン/タイマーのイベントなどを
+ *   16バイトの固定長レコードでリングバッファへ記録します（古いものから上書き）。
+ * - LGM_TRACE_ENABLE が 0（既定）ならマクロは何も生成しません。1 でも Enable(false) の間は
+ *   フラグを1回読んで分岐するだけです。
+ * - Dump() は UART へ16進の行で出力し、ホストの LGMSerialLED_hostbench --replay で再実行/集計します。
+ */
+
+#ifndef LGM_TRACE_ENABLE
+#define LGM_TRACE_ENABLE 0 ///< 1 ならトレースの記録コードを組み込む
+#endif
+
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 2048 ///< リングバッファのレコード数（16バイト/件、歩行中は約1.5秒分）
+#endif
+
+#define TRACE_DUMP_BEGIN "@trace-begin" ///< Dump() の開始行
+#define TRACE_DUMP_LINE "@t"            ///< Dump() のレコード行
+#define TRACE_DUMP_END "@trace-end"     ///< Dump() の終了行
+
+/**
+ * @brief 記録する操作。
+ * @details 引数（arg8/argA/argB）の意味は操作ごとに決めています。
+ */
+enum TraceOp : uint8_t {
+	TRACE_STATE = 1,        ///< メインループの1回（arg8=状態）
+	TRACE_WAIT = 2,         ///< イベント待ち（WFE）と受け取ったイベント（arg8=種類, argA=ID）
+	TRACE_HIBERNATE = 3,    ///< 休止（argA=起床要因のGPIO）
+	TRACE_SET_CHAR = 4,     ///< パターン一式の取得（arg8=キャラクタ番号, argA=先読みなら1）
+	TRACE_STOP_FRAME = 5,   ///< 停止表示（arg8=キャラクタ番号, argA=キーの下位32bit, argB=上位32bit）
+	TRACE_RUN_FRAME = 6,    ///< 歩行フレーム（arg8=キャラクタ番号, argA=グループ|遷移<<7|前<<8（24bit）, argB=現在）
+	TRACE_DRAW_BUFFER = 7,  ///< DrawBuffer（arg8=isOverlay|置換あり<<1, argA=幅|高さ<<16, argB=X|Y<<16（各16bit、負は2の補数））
+	TRACE_SCAN_BUFFER = 8,  ///< ScanBuffer/ScanBufferCached（arg8=走査タグ, argA=キーの下位32bit, argB=上位32bit）
+	TRACE_SHOW_CACHED = 9,  ///< ShowCached（arg8=ヒットなら1, argA=キーの下位32bit, argB=上位32bit）
+	TRACE_RESET = 10,       ///< Reset
+	TRACE_CLEAR = 11,       ///< Clear（argA=色）
+	TRACE_CLOCK = 12,       ///< clk_sys の変更（argA=kHz）
+	TRACE_EFFECT_FRAME = 13, ///< エフェクトの1フレーム（arg8=種類, argA=時刻ms）
+	TRACE_FILM_FRAME = 14,   ///< フィルムの1フレーム（arg8=先読み済みなら1, argA=フレーム番号）
+	TRACE_DRAW_TILEMAP = 15, ///< DrawTileMap（arg8=isOverlay, argA=横のマス数|縦のマス数<<16, argB=スクロールX|Y<<16（各16bit））
+	TRACE_OP_COUNT
+};
+
+/** @brief トレースの1レコード（16バイト）。 */
+struct TraceRecord {
+	uint32_t startUs; ///< 開始時刻（起動からのµs、32ビットで一周）
+	uint16_t dur;     ///< 所要時間（TraceRecorder::EncodeDuration() の形式）
+	uint8_t op;       ///< 下位5ビット: TraceOp、上位3ビット: スコープの深さ（0..7で飽和）
+	uint8_t arg8;     ///< 引数
+	uint32_t argA;    ///< 引数
+	uint32_t argB;    ///< 引数
+};
+static_assert(sizeof(TraceRecord) == 16, "TraceRecord must stay 16 bytes");
+
+/**
+ * @brief トレースのリングバッファ。
+ * @details ハードウェアに依存しません（時刻は呼び出し側が渡します）。
+ */
+class TraceRecorder {
+	public:
+		/** @brief 記録の有効/無効を切り替えます。 @param enable 有効ならtrue @return なし */
+		void Enable(bool enable) { m_enabled = enable; }
+
+		/** @brief 記録中ならtrue。 */
+		bool IsEnabled() const { return m_enabled; }
+
+		/**
+		 * @brief 1件記録します（満杯なら最も古いものを上書き）。
+		 * @param op 操作
+		 * @param depth スコープの深さ
+		 * @param startUs 開始時刻(µs)
+		 * @param durUs 所要時間(µs)
+		 * @param arg8 引数
+		 * @param argA 引数
+		 * @param argB 引数
+		 * @return なし
+		 */
+		void Record(uint8_t op, uint8_t depth, uint32_t startUs, uint32_t durUs, uint8_t arg8, uint32_t argA, uint32_t argB);
+
+		/** @brief スコープに入ります（TraceScope が使用）。 @return 入る前の深さ */
+		uint8_t Enter() { return m_depth++; }
+
+		/** @brief スコープから出ます（TraceScope が使用）。 @return なし */
+		void Leave() { if (m_depth) m_depth--; }
+
+		/** @brief 現在のスコープの深さ。 */
+		uint8_t Depth() const { return m_depth; }
+
+		/** @brief レコードの操作。 @param r レコード @return TraceOp */
+		static uint8_t OpOf(const TraceRecord& r) { return r.op & 0x1Fu; }
+
+		/** @brief レコードのスコープの深さ。 @param r レコード @return 深さ（0が最も外側） */
+		static uint8_t DepthOf(const TraceRecord& r) { return r.op >> 5; }
+
+		/** @brief 保持している件数。 */
+		size_t Count() const { return m_count; }
+
+		/** @brief 上書きで失った件数。 */
+		uint32_t Dropped() const { return m_dropped; }
+
+		/** @brief i 番目（古い順）のレコード。 @param i 番号（0..Count()-1） */
+		const TraceRecord& At(size_t i) const { return m_ring[(m_head + TRACE_CAPACITY - m_count + i) % TRACE_CAPACITY]; }
+
+		/** @brief すべて破棄します。 @return なし */
+		void Clear() { m_head = 0; m_count = 0; m_dropped = 0; }
+
+		/**
+		 * @brief 保持している内容を標準出力（UART）へ出力します。
+		 * @return なし
+		 * @details "@trace-begin n=.. dropped=.."、レコードごとに "@t <32桁の16進>"、"@trace-end" の順に出力します。
+		 *          16進はレコードの各フィールドをビッグエンディアンで並べたものです（startUs, dur, op, arg8, argA, argB）。
+		 */
+		void Dump() const;
+
+		/**
+		 * @brief Dump() の1行を解析します（ホストの再実行用）。
+		 * @param line 1行
+		 * @param rec [out] レコード
+		 * @return レコード行ならtrue
+		 */
+		static bool ParseLine(const char* line, TraceRecord& rec);
+
+		/**
+		 * @brief 所要時間を16ビットに符号化します。
+		 * @param us 所要時間(µs)
+		 * @return 32767µs 以下はそのまま、それ以上は最上位ビットを立てて1024µs単位（約33.5秒で飽和）
+		 */
+		static uint16_t EncodeDuration(uint32_t us)
+		{
+			if (us < 0x8000u) return (uint16_t)us;
+			const uint32_t units = us >> 10;
+			return (uint16_t)(0x8000u | (units > 0x7FFFu ? 0x7FFFu : units));
+		}
+
+		/** @brief 符号化した所要時間を µs に戻します。 @param dur 符号化した値 @return µs */
+		static uint32_t DecodeDuration(uint16_t dur) { return (dur & 0x8000u) ? (uint32_t)(dur & 0x7FFFu) << 10 : dur; }
+
+		/** @brief 操作の名前。 @param op 操作 @return 名前（不明なら "?"） */
+		static const char* OpName(uint8_t op);
+
+	private:
+		TraceRecord m_ring[TRACE_CAPACITY] = {};
+		size_t m_head = 0;
+		size_t m_count = 0;
+		uint32_t m_dropped = 0;
+		uint8_t m_depth = 0;
+		volatile bool m_enabled = false;
+};
+
+extern TraceRecorder g_trace; ///< アプリ全体で1つのトレース
+
+#if LGM_TRACE_ENABLE
+#include "pico/stdlib.h"
+
+/**
+ * @brief スコープの開始から終了までを1件として記録するヘルパ。
+ * @details 無効時はコンストラクタでフラグを読むだけです。引数は終了時に SetArgs() で変えられます。
+ */
+class TraceScope {
+	public:
+		TraceScope(uint8_t op, uint8_t arg8 = 0, uint32_t argA = 0, uint32_t argB = 0)
+			: m_active(g_trace.IsEnabled()), m_op(op), m_arg8(arg8), m_argA(argA), m_argB(argB)
+		{
+			if (__builtin_expect(m_active, 0)) {
+				m_depth = g_trace.Enter();
+				m_start = time_us_32();
+			}
+		}
+		~TraceScope()
+		{
+			if (__builtin_expect(m_active, 0)) {
+				g_trace.Leave();
+				g_trace.Record(m_op, m_depth, m_start, time_us_32() - m_start, m_arg8, m_argA, m_argB);
+			}
+		}
+		/** @brief 記録する引数を変更します。 @return なし */
+		void SetArgs(uint8_t arg8, uint32_t argA, uint32_t argB = 0) { m_arg8 = arg8; m_argA = argA; m_argB = argB; }
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+
+	private:
+		bool m_active;
+		uint8_t m_op;
+		uint8_t m_depth = 0;
+		uint8_t m_arg8;
+		uint32_t m_argA;
+		uint32_t m_argB;
+		uint32_t m_start = 0;
+};
+
+#define LGM_TRACE_CONCAT_(a, b) a##b
+#define LGM_TRACE_CONCAT(a, b) LGM_TRACE_CONCAT_(a, b)
+/** @brief スコープの終了までを1件として記録します。 */
+#define LGM_TRACE_SCOPE(...) TraceScope LGM_TRACE_CONCAT(lgmTraceScope_, __LINE__)(__VA_ARGS__)
+/** @brief 名前つきのスコープ（終了時に引数を変えるとき）。 */
+#define LGM_TRACE_SCOPE_NAMED(name, ...) TraceScope name(__VA_ARGS__)
+/** @brief 名前つきスコープの引数を変更します。 */
+#define LGM_TRACE_SET_ARGS(name, ...) name.SetArgs(__VA_ARGS__)
+/** @brief 所要時間のない1件を記録します。 */
+#define LGM_TRACE_MARK(op, arg8, argA, argB) \
+	do { \
+		if (__builtin_expect(g_trace.IsEnabled(), 0)) g_trace.Record((op), g_trace.Depth(), time_us_32(), 0, (arg8), (argA), (argB)); \
+	} while (0)
+#else
+#define LGM_TRACE_SCOPE(...) do { } while (0)
+#define LGM_TRACE_SCOPE_NAMED(name, ...) do { } while (0)
+#define LGM_TRACE_SET_ARGS(name, ...) do { } while (0)
+#define LGM_TRACE_MARK(op, arg8, argA, argB) do { } while (0)
+#endif
@@ -4,30 +4,84 @@
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "pico/time.h"
+#include "WS2812Timing.h"
+#include "WireCache.h"
+#include "LedCanvas.h"
+#include "LedCalibration.h"
+#include "WirePack.h"
+
+#define WS2812_CYCLES_PER_BIT 10     ///< PIOプログラムの1bitあたりのサイクル数（T1+T2+T3）
+#define WS2812_MAX_ERROR_PPM 20000   ///< 許容するビットレート誤差(ppm)。±150ns/1.25µs より十分小さい値
+#define WS2812_WIRE_CACHE_BYTES (16 * 1024) ///< 送出データキャッシュの既定の上限（バイト）。16x16 なら16フレーム
+#ifndef WS2812_TILE_PIXELS
+#define WS2812_TILE_PIXELS 1024 ///< ScanBuffer() が1回に変換して送るピクセル数の目安。これより大きなVRAMはパネルの行ごとにDMAで送る
+#endif
+#ifndef WS2812_DELTA_MAX_LEDS
+#define WS2812_DELTA_MAX_LEDS 4096 ///< SetDeltaTransmit() でLEDの状態を覚えるLED数の上限。これより大きなVRAMは毎フレームすべて送る
+#endif
+
+/** @brief 変化したLEDまでだけ送る送出（WS2812::SetDeltaTransmit）の統計。 */
+struct WireDeltaStats {
+	uint32_t frames;    ///< 送出しようとしたフレーム数
+	uint32_t skipped;   ///< 変化がなく、リセットラッチも含めて送らなかったフレーム数
+	uint32_t partial;   ///< 先頭から最後に変化したLEDまでだけ送ったフレーム数
+	uint64_t wordsSent; ///< 送った語数
+	uint64_t wordsFull; ///< すべて送った場合の語数
+};
 
 /**
  * @brief WS2812(NeoPixel) を RP2040 の PIO で駆動するためのユーティリティクラス。
  * @details
  * - PIO ステートマシンで 1-wire プロトコルを生成し、VRAM(0x00GGRRBB)からフレームを送出します。
- * - 走査（serpentine/leftToRight）やパネル分割に対応し、簡易描画ヘルパーも提供します。
+ * - 走査（serpentine/leftToRight）やパネル分割に対応します。VRAMと描画APIは LedCanvas から継承します。
  */
-class WS2812 {
+class WS2812 : public LedCanvas {
 				uint8_t m_pin;      ///< データ出力GPIO
 				PIO m_pio;          ///< 使用するPIOインスタンス
 				uint m_sm;          ///< ステートマシン番号
 				int m_offset;       ///< PIOプログラムのロードオフセット
+				uint32_t m_bitHz;   ///< 目標ビットレート(Hz)
+				WS2812Timing m_timing; ///< 現在の分周設定
+				int m_dmaChan;      ///< 送出用DMAチャネル
+				WireCache m_wireCache; ///< 送出データ（FIFO用の語列）のキャッシュ
+				uint32_t* m_tileWire;    ///< パネルの行ごとに送る場合の送出データ（TileRows() 行分。区画が2つ以上なら x 2）
+				size_t m_tileWireWords;  ///< m_tileWire の語数
+				LedCalibration m_cal; ///< 送出データへの変換時に掛ける色補正
+				bool m_packed;        ///< 送出データを 4ピクセル = 3語 に詰める（autopull 32bit）
+				uint32_t m_fifoAcc;   ///< FIFOへ書いていないビット（詰める場合、左詰め）
+				uint32_t m_fifoBits;  ///< m_fifoAcc のビット数（0/8/16/24）
+				bool m_delta;         ///< 変化したLEDまでだけ送る
+				bool m_latchPending;  ///< Reset() を送出の直前まで遅らせている（m_delta のみ）
+				bool m_shownValid;    ///< m_shownWire がLEDの状態と一致している
+				uint32_t* m_shownWire; ///< LEDが保持している送出データ（最後に送った語列、WireWords() 語）
+				size_t m_shownWords;   ///< m_shownWire の語数（詰めない場合の大きさ。確保していなければ 0）
+				WireDeltaStats m_deltaStats; ///< m_delta の統計
 
-				public:
-					uint32_t* pVRam;  ///< VRAM（GRB 24bit、1要素=1ピクセル）
-					uint32_t xVRam;   ///< VRAMの幅（ピクセル）
-					uint32_t yVRam;   ///< VRAMの高さ（ピクセル）
+				void InitHardware();
+				void PutWire(uint32_t w);
+				void FlushWire();
+				void Latch();
+				void LatchPending();
+				size_t DeltaWords(const uint32_t* words, size_t count);
+				size_t DeltaTiles(uint32_t* tile, uint32_t rows, bool serpentine, bool leftToRight, bool& firstEncoded);
+				uint32_t TileRows() const;
+				size_t TileOffset(uint32_t panelRow) const;
+				uint32_t* TileWire();
+				bool ScanTiles(bool serpentine, bool leftToRight);
+
+				protected:
+					static uint8_t WireTag(bool serpentine, bool leftToRight) { return (uint8_t)((serpentine ? 1u : 0u) | (leftToRight ? 2u : 0u)); }
+					/** @brief 呼び出し側のメモリをVRAMとして構築します（WS2812Static 用）。 @param vram VRAM（全パネル分） @param pin データ出力GPIO @param a_xSize パネル幅 @param a_ySize パネル高 @param a_xPanelCount パネル数(横) @param a_yPanelCount パネル数(縦) */
+					WS2812(uint32_t* vram, uint8_t pin, uint16_t a_xSize, uint16_t a_ySize, uint16_t a_xPanelCount, uint16_t a_yPanelCount);
+					/** @brief Reset() 直後の安全待ち（100µs）。 @return なし @details 遅らせたリセットラッチは送出の直前に待ちを含めて行うので、その間は待ちません。 */
+					void WaitAfterReset() { if (!m_latchPending) sleep_us(100); }
 
 				public:
 					// １枚のパネルサイズと、そのパネルが複数枚ある場合の数。パネルのカスケード順は左上から右下に固定とする
-					uint8_t xSize;        ///< 1パネルの横ピクセル数
-					uint8_t ySize;        ///< 1パネルの縦ピクセル数
-					uint8_t xPanelCount;  ///< 水平方向のパネル枚数
-					uint8_t yPanelCount;  ///< 垂直方向のパネル枚数
+					uint16_t xSize;        ///< 1パネルの横ピクセル数
+					uint16_t ySize;        ///< 1パネルの縦ピクセル数
+					uint16_t xPanelCount;  ///< 水平方向のパネル枚数
+					uint16_t yPanelCount;  ///< 垂直方向のパネル枚数
 
 				public:
 					/**
@@ -40,12 +94,22 @@ class WS2812 {
 					 * @return なし
 					 * @details PIOへプログラムをロードし、800kHz相当でSMを初期化。VRAMを確保します。
 					 */
-					WS2812(uint8_t pin, uint8_t a_xSize, uint8_t a_ySize, uint8_t a_xPanelCount = 1, uint8_t a_yPanelCount = 1);
+					WS2812(uint8_t pin, uint16_t a_xSize, uint16_t a_ySize, uint16_t a_xPanelCount = 1, uint16_t a_yPanelCount = 1);
+					/** @brief 送出の完了を待ち、送出データの領域を解放して、SM・DMAチャネル・PIOプログラムを返します。 */
+					~WS2812() override;
 
-					/** @brief リセットラッチ用 Low パルスを出力します。 @return なし @details フレーム送出前に呼び出してください。 */
+					/** @brief リセットラッチ用 Low パルスを出力します。 @return なし @details フレーム送出前に呼び出してください。SetDeltaTransmit(true) の間は、実際に送出するときまで遅らせます。 */
 					void Reset();
 					/** @brief アイドル時に High を維持します。 @return なし @details PIOのidleループへ遷移します。 */
 					void Keep();
+					/** @brief 休止に備えて送出を停止します。 @return なし @details FIFOが空になるのを待ってラインをLowにし、SMを停止します。 */
+					void Suspend();
+					/** @brief 休止から復帰します。 @return 分周を求められたらtrue @details 現在の clk_sys から分周を設定し直してSMを再開し、リセットラッチを出力します。範囲外なら最後に求められた分周のままです。 */
+					bool Resume();
+					/** @brief 現在の clk_sys に合わせて分周を設定し直します。 @return 誤差が許容範囲ならtrue @details フレーム間（FIFOが空の間）に呼び出してください。範囲外なら分周と GetTiming() を変更しません。 */
+					bool UpdateClock();
+					/** @brief 現在の分周設定とビットタイミングを返します。 @return 分周設定 */
+					const WS2812Timing& GetTiming() const { return m_timing; }
 					/** @brief 1ピクセルを即時送信します。 @param r 赤 @param g 緑 @param b 青 @return なし @details VRAMを使わずブロッキング送信。 */
 					void setColorDirect(uint8_t r, uint8_t g, uint8_t b);
 					/** @brief 24bit GRB値を即時送信します。 @param c 0x00GGRRBB @return なし */
@@ -56,32 +120,118 @@ class WS2812 {
 					// 画面の更新
 					// serpentine=true の場合、行ごとに左右が反転。leftToRight は偶数行(行0,2,...)の基準方向。
 					/** @brief 1パネル分を送信します。 @param posX パネル左上X @param posY パネル左上Y @param serpentine 千鳥配線 @param leftToRight 偶数行の基準方向 @return なし */
-					void ScanPanel(uint8_t posX, uint8_t posY, bool serpentine = false, bool leftToRight = true);
-					/** @brief 全パネルを送信します。 @param serpentine 千鳥配線 @param leftToRight 偶数行の基準方向 @return なし */
+					void ScanPanel(uint16_t posX, uint16_t posY, bool serpentine = false, bool leftToRight = true);
+					/**
+					 * @brief 全パネルを送信します。
+					 * @param serpentine 千鳥配線
+					 * @param leftToRight 偶数行の基準方向
+					 * @return なし
+					 * @details VRAMが WS2812_TILE_PIXELS より大きい場合と SetDeltaTransmit(true) の間は、パネルの行いくつかずつ送出データへ変換してDMAで送ります
+					 *          （作業領域は2区画分だけ。変換と送出が重なり、最後の区画の送出は待たずに戻ります）。
+					 *          作業領域を確保できない場合は、パネルごとにCPUでFIFOへすべて送ります。
+					 */
 					void ScanBuffer(bool serpentine = false, bool leftToRight = true);
 
-					// VRAM 操作用のユーティリティ
-					/** @brief VRAMを指定色で塗りつぶします。 @param rgb 0x00GGRRBB @return なし */
-					void Clear(uint32_t rgb = 0);
-					/** @brief VRAMの1ピクセルを書き換えます。 @param x X @param y Y @param rgb 0x00GGRRBB @return なし */
-					void SetPixel(uint16_t x, uint16_t y, uint32_t rgb);
-         
-					// 各パネルの外枠に色を描く
-					/** @brief 指定パネルの外枠を描画します。 @param panelX Xインデックス @param panelY Yインデックス @param rgb 0x00GGRRBB @return なし */
-					void DrawPanelBorder(uint8_t panelX, uint8_t panelY, uint32_t rgb);
-					/** @brief すべてのパネルにランダム外枠を描画します。 @return なし */
-					void DrawRandomBorders();
+					// 送出データのキャッシュとDMA送出
+					/**
+					 * @brief キャッシュ済みのフレームを送出します。
+					 * @param key フレームID（呼び出し側で決める。表示内容が同じなら同じID）
+					 * @param serpentine 千鳥配線
+					 * @param leftToRight 偶数行の基準方向
+					 * @return キャッシュにあり、送出を開始したらtrue（VRAMは変更しない）
+					 * @details リセットラッチを出力してから、キャッシュの語列をDMAでFIFOへ送ります。CPUは待ちません。
+					 */
+					bool ShowCached(uint64_t key, bool serpentine = false, bool leftToRight = true);
+					/**
+					 * @brief VRAMを送出順の語列に変換してキャッシュに登録し、DMAで送出します。
+					 * @param key フレームID
+					 * @param serpentine 千鳥配線
+					 * @param leftToRight 偶数行の基準方向
+					 * @return なし
+					 * @details ScanBuffer() と同じく Reset() の後に呼び出してください。上限に収まらない場合は登録せずに ScanBuffer() で送出します。
+					 */
+					void ScanBufferCached(uint64_t key, bool serpentine = false, bool leftToRight = true);
+					/** @brief VRAMを送出順の語列（1ピクセル = c<<8、詰める場合は 4ピクセル = 3語）に変換します。 @param dst 出力（WireWords() 語） @param serpentine 千鳥配線 @param leftToRight 偶数行の基準方向 @return なし */
+					void EncodeWire(uint32_t* dst, bool serpentine, bool leftToRight) const;
+					/**
+					 * @brief VRAMのパネルの行を送出順の語列に変換します（EncodeWire() の一部分）。
+					 * @param dst 出力（詰めない場合 panelRows*xVRam*ySize 語）
+					 * @param serpentine 千鳥配線
+					 * @param leftToRight 偶数行の基準方向
+					 * @param firstPanelRow 最初のパネルの行
+					 * @param panelRows パネルの行数
+					 * @return 出力した語数
+					 * @details 続けて並べると EncodeWire() と同じ語列です。詰める場合は、最後の区画以外のピクセル数を4の倍数にしてください。
+					 */
+					size_t EncodeWireRows(uint32_t* dst, bool serpentine, bool leftToRight, uint32_t firstPanelRow, uint32_t panelRows) const;
+					/** @brief 語列をDMAで送出します（待たない）。 @param words 語列 @param count 語数 @return なし @details 語列は送出完了まで保持してください。SetDeltaTransmit(true) の間は、1フレーム分（WireWords() 語）なら変化したLEDまでだけ送ります。 */
+					void TransmitWire(const uint32_t* words, size_t count);
+					/** @brief DMA送出の完了を待ちます。 @return なし */
+					void WaitTransmit();
+					/** @brief 送出データキャッシュの上限を変更します。 @param bytes 上限（バイト） @return なし */
+					void SetWireCacheBudget(size_t bytes);
+					/** @brief 送出データキャッシュを空にします。 @return なし */
+					void ClearWireCache();
+					/** @brief 送出データキャッシュの統計（ヒット/ミス/使用量）。 @return 統計 */
+					const WireCacheStats& GetWireCacheStats() const { return m_wireCache.Stats(); }
+
+					// 送出データの形式
+					/**
+					 * @brief 送出データを 24bit ずつ隙間なく詰めるかを切り替えます。
+					 * @param packed true で 4ピクセルを3語に詰める（PIOの autopull 32bit）。false で 1ピクセル1語（autopull 24bit、既定）
+					 * @return なし
+					 * @details FIFO/DMAの転送量が 3/4 になります。送出の完了を待ってからSMを設定し直し、送出データのキャッシュを空にします。
+					 *          詰める場合、ScanPanel()/setColorDirect() の端数は次の ScanPanel() へ続き、ScanBuffer() の最後か Reset() で書き出されます。
+					 */
+					void SetPackedWire(bool packed);
+					/** @brief 送出データを詰めているか。 @return 詰めていればtrue */
+					bool IsPackedWire() const { return m_packed; }
+					/** @brief 1フレームの送出データの語数。 @return 語数（詰める場合は WIRE_PACK_WORDS(xVRam*yVRam)） */
+					size_t WireWords() const { return m_packed ? WIRE_PACK_WORDS(xVRam * yVRam) : (size_t)xVRam * yVRam; }
 
+					// 変化したLEDまでだけ送る（WS2812 は次のデータが来るまで色を保持する）
 					/**
-					 * @brief 任意のパターン配列をVRAMへ描画します。
-					 * @param pattern 0x00GGRRBB のフラット配列
-					 * @param width パターン幅
-					 * @param height パターン高さ
-					 * @param X 貼り付け先 左上X
-					 * @param y 貼り付け先 左上Y
-					 * @param colorReplace 置換色（0で無効）
-					 * @param isOverlay 黒(0)を透明として重ねる
+					 * @brief 最後に送ったフレームと比べ、変化したLEDまでだけ送るかを切り替えます。
+					 * @param enable true で有効（LEDの状態を保持する WireWords() 語の領域を確保する）
 					 * @return なし
+					 * @details
+					 * - VRAMが WS2812_DELTA_MAX_LEDS より大きい場合と、領域を確保できない場合は有効にしません（すべて送る。IsDeltaTransmit() は false）。
+					 * - ScanBuffer() はパネルの行ごとに変換し、後ろの区画から比べて最後に変化した語を探してから、先頭からその語までをDMAで送ります。
+					 *   VRAM全体の送出データは作らないので、作業領域は区画2つとLEDの状態だけです。
+					 * - 送出順で最後に変化したLEDが K 番目なら、先頭の K 個だけを送ります（後ろのLEDは前の色を保持）。変化がなければ送りません。
+					 * - Reset() のリセットラッチは実際に送出するときまで遅らせるので、送らないフレームはラッチの待ち時間もかかりません。
+					 * - 詰めた送出データ（SetPackedWire）では、語の境界がそろう4ピクセル単位に切り上げます。
+					 * - ScanPanel()/setColorDirect() で直接送った後は、次のフレームをすべて送ります。
 					 */
-					void DrawBuffer(const uint32_t pattern[],uint8_t width , uint8_t height, uint8_t X, uint8_t y,uint32_t colorReplace , bool isOverlay);
+					void SetDeltaTransmit(bool enable);
+					/** @brief 変化したLEDまでだけ送っているか。 @return 有効ならtrue */
+					bool IsDeltaTransmit() const { return m_delta; }
+					/** @brief LEDの状態が分からなくなったことを知らせます（次のフレームはすべて送る）。 @return なし @details LEDの電源を切った場合などに呼び出してください。 */
+					void InvalidateShown() { m_shownValid = false; }
+					/** @brief 変化したLEDまでだけ送る送出の統計。 @return 統計 */
+					const WireDeltaStats& GetDeltaStats() const { return m_deltaStats; }
+					/** @brief 送出用に確保した作業領域（パネルの行ごとの送出データとLEDの状態）のバイト数。 @return バイト数（送出データキャッシュを除く） */
+					size_t WireBufferBytes() const { return (m_tileWireWords + m_shownWords) * sizeof(uint32_t); }
+
+					// 色補正（送出データへの変換時に掛ける。VRAMは変更しない）
+					/**
+					 * @brief パネルごとの色補正行列とLEDごとの明るさを設定します。
+					 * @param panelMatrix パネルごとの行列（xPanelCount*yPanelCount 個、パネル順）。nullptr で無効
+					 * @param ledGain LEDごとの明るさ（xVRam*yVRam 個、送出順）。nullptr で無効
+					 * @return なし
+					 * @details 配列はコピーしないので、使う間は保持してください。送出データのキャッシュは空にします。
+					 *          ScanBuffer/ScanPanel/EncodeWire（ScanBufferCached）のすべてに掛かります。
+					 */
+					void SetCalibration(const LedColorMatrix* panelMatrix, const uint8_t* ledGain);
+					/** @brief 現在の色補正。 @return 色補正 */
+					const LedCalibration& GetCalibration() const { return m_cal; }
+					/** @brief 色補正が有効か。 @return 行列か明るさのどちらかが設定されていればtrue */
+					bool IsCalibrated() const { return m_cal.panelMatrix != nullptr || m_cal.ledGain != nullptr; }
+
+					// パネル単位の描画（VRAMのみ。その他の描画は LedCanvas）
+					/** @brief 指定パネルの外枠を描画します。 @param panelX Xインデックス @param panelY Yインデックス @param rgb 0x00GGRRBB @return なし */
+					void DrawPanelBorder(uint16_t panelX, uint16_t panelY, uint32_t rgb);
+					/** @brief すべてのパネルにランダム外枠を描画します。 @return なし */
+					void DrawRandomBorders();
+
 };
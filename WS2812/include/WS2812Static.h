@@ -0,0 +1,218 @@
+#pragma once
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "WS2812.h"
+#include "TraceRecorder.h"
+
+/**
+ * @brief パネル内の走査順（配線）をコンパイル時に決める型。
+ * @tparam Serpentine 千鳥配線（行ごとに左右が反転）
+ * @tparam LeftToRight 偶数行(行0,2,...)の基準方向
+ * @details WS2812::ScanBuffer(serpentine, leftToRight) の引数と同じ意味です。
+ */
+template <bool Serpentine, bool LeftToRight>
+struct WS2812Layout {
+				static constexpr bool serpentine = Serpentine;   ///< 千鳥配線
+				static constexpr bool leftToRight = LeftToRight; ///< 偶数行の基準方向
+
+				/** @brief パネル内の行 y を左から右へ送るか。 @param y パネル内の行 @return 左→右ならtrue */
+				static constexpr bool RowLeftToRight(uint32_t y) { return Serpentine ? (((y & 1u) != 0) != LeftToRight) : LeftToRight; }
+};
+
+typedef WS2812Layout<false, true> WS2812Progressive;   ///< 全行 左→右
+typedef WS2812Layout<true, true> WS2812SerpentineLR;   ///< 千鳥、偶数行が左→右
+typedef WS2812Layout<true, false> WS2812SerpentineRL;  ///< 千鳥、偶数行が右→左（LGMSerialLED.cpp の配線）
+
+/**
+ * @brief WS2812Static のVRAMと送出データの置き場所。
+ * @tparam Pixels 全パネルの画素数
+ * @details 基底クラスより先に構築されるよう、WS2812 より前に継承します。
+ */
+template <uint32_t Pixels>
+struct WS2812StaticStorage {
+				uint32_t m_vram[Pixels]; ///< VRAM（0x00GGRRBB）
+				uint32_t m_wire[Pixels]; ///< 送出データ（FIFOへ書く値 c<<8）
+};
+
+/**
+ * @brief パネルの大きさ・枚数・配線をコンパイル時に決めた WS2812。
+ * @tparam XSize 1パネルの横ピクセル数
+ * @tparam YSize 1パネルの縦ピクセル数
+ * @tparam XPanels 水平方向のパネル枚数
+ * @tparam YPanels 垂直方向のパネル枚数
+ * @tparam Layout 走査順（WS2812Layout）
+ * @details
+ * - VRAMと送出データはオブジェクトの中に固定長で持ちます（VRAMと ScanBuffer() の送出はヒープを使わない）。グローバル変数や static に置けば .bss に入ります。
+ * - 次の機能は基底の WS2812 と同じくヒープに確保します（解放は ~WS2812）: SetDeltaTransmit(true) のLEDの状態、ShowCached/ScanBufferCached の送出データキャッシュ、
+ *   WS2812& から呼んだ WS2812::ScanBuffer() が行ごとに送る場合（差分送出中・パネルの行が多い場合）の送出データ。
+ * - Clear/SetPixel/DrawBuffer/EncodeWire/ScanBuffer はVRAMの幅とループ回数が定数になり、展開・ベクトル化できます。
+ * - 送出（Reset/Keep/DMA/キャッシュ）と WS2812& を受け取る既存の処理はそのまま使えます（基底の関数は実行時の大きさで動きます）。
+ * - 大きさや配線を実行時に決める場合は WS2812 を使ってください。
+ */
+template <uint16_t XSize, uint16_t YSize, uint16_t XPanels = 1, uint16_t YPanels = 1, class Layout = WS2812Progressive>
+class WS2812Static : private WS2812StaticStorage<(uint32_t)XSize * XPanels * YSize * YPanels>, public WS2812 {
+				static_assert(XSize > 0 && YSize > 0 && XPanels > 0 && YPanels > 0, "panel size and count must be non-zero");
+
+				typedef WS2812StaticStorage<(uint32_t)XSize * XPanels * YSize * YPanels> Storage;
+
+				public:
+					static constexpr uint32_t kWidth = (uint32_t)XSize * XPanels;   ///< VRAMの幅（ピクセル）
+					static constexpr uint32_t kHeight = (uint32_t)YSize * YPanels;  ///< VRAMの高さ（ピクセル）
+					static constexpr uint32_t kPixels = kWidth * kHeight;           ///< VRAMの画素数
+
+				private:
+					/** @brief 1行を送出データへ変換します。 @tparam L2R 左→右 @param row VRAMの行（パネルの左端） @param dst 出力（XSize 語） @return なし */
+					template <bool L2R>
+					static void EncodeRow(const uint32_t* row, uint32_t* dst)
+					{
+						if (L2R) {
+							for (uint32_t x = 0; x < XSize; ++x) dst[x] = row[x] << 8;
+						} else {
+							for (uint32_t x = 0; x < XSize; ++x) dst[x] = row[XSize - 1 - x] << 8;
+						}
+					}
+
+				public:
+					/**
+					 * @brief ドライバを構築・初期化します。
+					 * @param pin データ出力GPIO
+					 * @details PIO/SMとDMAの初期化は WS2812 と同じです。VRAMは黒で初期化されます。
+					 */
+					explicit WS2812Static(uint8_t pin)
+						: WS2812(Storage::m_vram, pin, XSize, YSize, XPanels, YPanels)
+					{
+					}
+
+					using WS2812::EncodeWire;
+
+					/** @brief VRAMを指定色で塗りつぶします。 @param rgb 0x00GGRRBB @return なし */
+					void Clear(uint32_t rgb = 0)
+					{
+						LGM_TRACE_SCOPE(TRACE_CLEAR, 0, rgb);
+						for (uint32_t i = 0; i < kPixels; ++i) this->m_vram[i] = rgb;
+					}
+
+					/** @brief VRAMの1ピクセルを書き換えます。 @param x X @param y Y @param rgb 0x00GGRRBB @return なし */
+					void SetPixel(uint16_t x, uint16_t y, uint32_t rgb)
+					{
+						if (x < kWidth && y < kHeight) this->m_vram[(uint32_t)y * kWidth + x] = rgb;
+					}
+
+					/**
+					 * @brief 任意のパターン配列をVRAMへ描画します（LedCanvas::DrawBuffer と同じ結果）。
+					 * @param pattern 0x00GGRRBB のフラット配列
+					 * @param width パターン幅
+					 * @param height パターン高さ
+					 * @param X 貼り付け先 左上X（負でもよい）
+					 * @param y 貼り付け先 左上Y（負でもよい）
+					 * @param colorReplace 置換色（0で無効）
+					 * @param isOverlay 黒(0)を透明として重ねる
+					 * @return なし
+					 * @details VRAMからはみ出す場合は LedCanvas::DrawBuffer で切り詰めて描きます。
+					 */
+					void DrawBuffer(const uint32_t pattern[], uint16_t width, uint16_t height, int32_t X, int32_t y, uint32_t colorReplace, bool isOverlay)
+					{
+						if (X < 0 || y < 0 || (uint32_t)X + width > kWidth || (uint32_t)y + height > kHeight) {
+							LedCanvas::DrawBuffer(pattern, width, height, X, y, colorReplace, isOverlay);
+							return;
+						}
+						LGM_TRACE_SCOPE(TRACE_DRAW_BUFFER, (uint8_t)(isOverlay | ((colorReplace != 0) << 1)), (uint32_t)width | ((uint32_t)height << 16), (uint32_t)X | ((uint32_t)y << 16));
+						const bool bisReplace = colorReplace != 0x0;
+						for (uint32_t py = 0; py < height; ++py) {
+							const uint32_t* src = &pattern[py * width];
+							uint32_t* dst = &this->m_vram[((uint32_t)y + py) * kWidth + (uint32_t)X];
+							for (uint32_t px = 0; px < width; ++px) {
+								uint32_t color = src[px];
+								uint32_t nz = 0u - (uint32_t)(color != 0);
+								uint32_t fg = bisReplace ? colorReplace : color;
+								uint32_t bg = isOverlay ? dst[px] : 0u;
+								dst[px] = (fg & nz) | (bg & ~nz);
+							}
+						}
+					}
+
+					/**
+					 * @brief 大きさがコンパイル時に決まるパターンをVRAMへ描画します。
+					 * @tparam W パターン幅
+					 * @tparam H パターン高さ
+					 * @param pattern 0x00GGRRBB のフラット配列（W*H 要素）
+					 * @param X 貼り付け先 左上X
+					 * @param y 貼り付け先 左上Y
+					 * @param colorReplace 置換色（0で無効）
+					 * @param isOverlay 黒(0)を透明として重ねる
+					 * @return なし
+					 * @details VRAMに収まる場合は行・列とも定数回のループで描きます。はみ出す場合は DrawBuffer() と同じく切り詰めます。
+					 */
+					template <uint16_t W, uint16_t H>
+					void DrawSprite(const uint32_t pattern[], int32_t X, int32_t y, uint32_t colorReplace, bool isOverlay)
+					{
+						if (X < 0 || y < 0 || (uint32_t)X + W > kWidth || (uint32_t)y + H > kHeight) {
+							LedCanvas::DrawBuffer(pattern, W, H, X, y, colorReplace, isOverlay);
+							return;
+						}
+						LGM_TRACE_SCOPE(TRACE_DRAW_BUFFER, (uint8_t)(isOverlay | ((colorReplace != 0) << 1)), (uint32_t)W | ((uint32_t)H << 16), (uint32_t)X | ((uint32_t)y << 16));
+						const bool bisReplace = colorReplace != 0x0;
+						uint32_t* dst = &this->m_vram[(uint32_t)y * kWidth + (uint32_t)X];
+						for (uint32_t py = 0; py < H; ++py, pattern += W, dst += kWidth) {
+							for (uint32_t px = 0; px < W; ++px) {
+								uint32_t color = pattern[px];
+								uint32_t nz = 0u - (uint32_t)(color != 0);
+								uint32_t fg = bisReplace ? colorReplace : color;
+								uint32_t bg = isOverlay ? dst[px] : 0u;
+								dst[px] = (fg & nz) | (bg & ~nz);
+							}
+						}
+					}
+
+					/**
+					 * @brief VRAMを送出順の語列（1ピクセル = c<<8）に変換します。
+					 * @param dst 出力（kPixels 語）
+					 * @return なし
+					 * @details WS2812::EncodeWire(dst, Layout::serpentine, Layout::leftToRight) と同じ結果です。千鳥配線は2行ずつ処理し、行の向きを定数にします。
+					 *          色補正が有効な場合と送出データを詰める場合（SetPackedWire）は基底の EncodeWire を使います（出力は WireWords() 語）。
+					 */
+					void EncodeWire(uint32_t* dst) const
+					{
+						if (IsCalibrated() || IsPackedWire()) { // 色補正と詰める形式は基底の処理で
+							WS2812::EncodeWire(dst, Layout::serpentine, Layout::leftToRight);
+							return;
+						}
+						constexpr uint32_t kRowStep = Layout::serpentine ? 2u : 1u;
+						for (uint32_t py = 0; py < YPanels; ++py) {
+							for (uint32_t px = 0; px < XPanels; ++px) {
+								const uint32_t* row = &this->m_vram[py * YSize * kWidth + px * XSize];
+								uint32_t y = 0;
+								for (; y + kRowStep <= YSize; y += kRowStep) {
+									EncodeRow<Layout::RowLeftToRight(0)>(row, dst);
+									if (kRowStep == 2u) EncodeRow<Layout::RowLeftToRight(1)>(row + kWidth, dst + XSize);
+									row += kRowStep * kWidth;
+									dst += kRowStep * XSize;
+								}
+								if (y < YSize) { // 千鳥配線で行数が奇数の場合の最後の行（偶数行）
+									EncodeRow<Layout::RowLeftToRight(0)>(row, dst);
+									dst += XSize;
+								}
+							}
+						}
+					}
+
+					/**
+					 * @brief 全パネルを送信します（DMA、待たない）。
+					 * @return なし
+					 * @details Reset() の後に呼び出してください。前の送出の完了を待ってから送出データを作り、DMAでFIFOへ送ります。
+					 */
+					void ScanBuffer()
+					{
+						LGM_TRACE_SCOPE(TRACE_SCAN_BUFFER, WireTag(Layout::serpentine, Layout::leftToRight));
+						WaitTransmit();
+						EncodeWire(this->m_wire);
+						WaitAfterReset(); // 直前のリセットからの安全待ち（WS2812::ScanBuffer と同じ）
+						TransmitWire(this->m_wire, WireWords());
+					}
+
+					/** @brief キャッシュ済みのフレームを送出します（配線は Layout）。 @param key フレームID @return キャッシュにあり、送出を開始したらtrue */
+					bool ShowCached(uint64_t key) { return WS2812::ShowCached(key, Layout::serpentine, Layout::leftToRight); }
+					/** @brief VRAMをキャッシュに登録し、DMAで送出します（配線は Layout）。 @param key フレームID @return なし */
+					void ScanBufferCached(uint64_t key) { WS2812::ScanBufferCached(key, Layout::serpentine, Layout::leftToRight); }
+};
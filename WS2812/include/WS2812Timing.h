@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief WS2812 のPIO分周設定と、その設定で得られるビットタイミング。
+ * @details PIOの分周器は 整数16bit + 小数8bit（1/256単位）です。
+ */
+struct WS2812Timing {
+	uint32_t sysHz;     ///< 計算に用いた clk_sys(Hz)
+	uint16_t divInt;    ///< 分周の整数部（1..65535）
+	uint8_t divFrac;    ///< 分周の小数部（1/256単位）
+	uint32_t bitHz;     ///< 実際のビットレート(Hz)
+	int32_t errorPpm;   ///< 目標ビットレートに対する誤差(ppm)
+	uint32_t bitNs;     ///< 1bitの周期(ns)
+	uint32_t t0HighNs;  ///< '0' の High 時間(ns)
+	uint32_t t1HighNs;  ///< '1' の High 時間(ns)
+	uint32_t jitterNs;  ///< 小数分周による各エッジの揺らぎ(ns)。小数部が0なら0
+};
+
+/**
+ * @brief clk_sys と目標ビットレートから、PIOの分周（整数部+小数部）を求めます。
+ * @param sysHz clk_sys(Hz)
+ * @param bitHz 目標ビットレート(Hz)（例: 800000）
+ * @param cyclesPerBit PIOプログラムの1bitあたりのサイクル数（T1+T2+T3）
+ * @param t1 T1 サイクル数（'0'/'1'共通の High 区間）
+ * @param t2 T2 サイクル数（'1' の場合に High を延長する区間）
+ * @param out [out] 分周設定と実際のタイミング
+ * @return 分周器の範囲内（1.0～65535+255/256）に収まればtrue
+ * @details 分周 = sysHz / (bitHz*cyclesPerBit) を 1/256 単位で四捨五入します。浮動小数点は使いません。
+ */
+bool ws2812_calc_timing(uint32_t sysHz, uint32_t bitHz, uint32_t cyclesPerBit, uint32_t t1, uint32_t t2, WS2812Timing& out);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define WIRECACHE_MAX_ENTRIES 32 ///< 保持できるフレーム数の上限
+
+/** @brief 送出データキャッシュの統計。 */
+struct WireCacheStats {
+	uint32_t hits;       ///< find() で見つかった回数
+	uint32_t misses;     ///< find() で見つからなかった回数
+	uint32_t evictions;  ///< LRU で追い出した回数
+	uint32_t entries;    ///< 保持しているフレーム数
+	size_t usedBytes;    ///< 保持しているバイト数
+	size_t peakBytes;    ///< 保持したバイト数の最大
+};
+
+/**
+ * @brief 送出順に並べた FIFO 用の語列（1ピクセル = c<<8）をフレーム単位で保持するキャッシュ。
+ * @details
+ * - キーは呼び出し側が決めるフレームID（キャラクタ/パターン/遷移表示の組など）と、走査方法（serpentine 等）のタグです。
+ * - 合計バイト数の上限を超える場合は、最も長く使われていないフレームから解放します。
+ * - ハードウェアに依存しません（送出は WS2812 が DMA で行います）。
+ */
+class WireCache {
+	public:
+		/**
+		 * @brief コンストラクタ。
+		 * @param budgetBytes 保持する語列の合計の上限（バイト）
+		 */
+		explicit WireCache(size_t budgetBytes) : m_budget(budgetBytes) {}
+		~WireCache() { Clear(); }
+
+		WireCache(const WireCache&) = delete;
+		WireCache& operator=(const WireCache&) = delete;
+
+		/**
+		 * @brief フレームを探します。
+		 * @param key フレームID
+		 * @param tag 走査方法などの付加情報
+		 * @param words [out] 語数
+		 * @return 語列（なければ nullptr）
+		 */
+		const uint32_t* Find(uint64_t key, uint8_t tag, size_t& words);
+
+		/**
+		 * @brief フレームの領域を確保します（書き込みは呼び出し側）。
+		 * @param key フレームID
+		 * @param tag 走査方法などの付加情報
+		 * @param words 語数
+		 * @return 書き込み先（上限に収まらない/確保できない場合は nullptr）
+		 * @details 同じキーがあれば置き換えます。返した領域は次の Insert()/Clear() まで有効です。
+		 */
+		uint32_t* Insert(uint64_t key, uint8_t tag, size_t words);
+
+		/** @brief 上限を変更します。 @param budgetBytes 合計の上限（バイト） @return なし @details 超える分は古い順に解放します。 */
+		void SetBudget(size_t budgetBytes);
+
+		/** @brief すべて解放します。 @return なし */
+		void Clear();
+
+		/** @brief 統計。 */
+		const WireCacheStats& Stats() const { return m_stats; }
+
+	private:
+		/** @brief 1フレーム分の語列。 */
+		struct Entry {
+			uint64_t key;
+			uint8_t tag;
+			bool used;
+			uint32_t lastUse;
+			size_t words;
+			uint32_t* data;
+		};
+
+		void Release(int idx);
+		bool EvictOldest(int keep);
+
+		Entry m_entries[WIRECACHE_MAX_ENTRIES] = {};
+		size_t m_budget;
+		uint32_t m_useCounter = 0;
+		WireCacheStats m_stats = {};
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** @brief n ピクセルを詰めた送出データの語数（4ピクセル = 3語、最後の語の余りは0）。 */
+#define WIRE_PACK_WORDS(n) (((uint32_t)(n) * 3u + 3u) / 4u)
+
+/**
+ * @brief 1ピクセル1語の送出データ（c<<8、上位24bitが GRB）を、24bit ずつ隙間なく32bit語へ詰めます。
+ * @details
+ * - PIOの autopull を32bitにすると、MSBから順に G7..G0 R7..R0 B7..B0 が続けて送出されます（1語に 1と1/3 ピクセル）。
+ * - 4ピクセルごとに語の境界がそろうので、そろっている間は4ピクセルを3語へまとめて変換します。
+ * - 最後に finish() で端数を1語にして書き出します（余りのビットは0。チェーンの末尾より先へ流れるだけ）。
+ * - ハードウェアに依存しません（ホストのベンチマークでも同じコードを使います）。
+ */
+struct WirePacker {
+	uint32_t* dst; ///< 次に書く語
+	uint32_t acc;  ///< 書き出していないビット（左詰め）
+	uint32_t bits; ///< acc のビット数（0/8/16/24）
+
+	/** @brief 書き込み先を設定します。 @param d 出力 @return なし */
+	void begin(uint32_t* d)
+	{
+		dst = d;
+		acc = 0;
+		bits = 0;
+	}
+
+	/** @brief 1ピクセルを追加します。 @param w 送出データ（c<<8） @return なし */
+	void put(uint32_t w)
+	{
+		if (bits == 0) {
+			acc = w;
+			bits = 24;
+			return;
+		}
+		*dst++ = acc | (w >> bits);
+		acc = w << (32u - bits); // bits==8 なら下位8bit（常に0）だけが残る
+		bits -= 8;
+	}
+
+	/** @brief 続けて n ピクセルを追加します。 @param w 送出データ（c<<8） @param n ピクセル数 @return なし */
+	void putRow(const uint32_t* w, uint32_t n)
+	{
+		uint32_t i = 0;
+		while (bits != 0 && i < n) put(w[i++]);
+		uint32_t* d = dst;
+		for (; i + 4 <= n; i += 4, d += 3) {
+			d[0] = w[i] | (w[i + 1] >> 24);
+			d[1] = (w[i + 1] << 8) | (w[i + 2] >> 16);
+			d[2] = (w[i + 2] << 16) | (w[i + 3] >> 8);
+		}
+		dst = d;
+		for (; i < n; i++) put(w[i]);
+	}
+
+	/** @brief 端数を書き出します。 @return 書き終えた次の位置 */
+	uint32_t* finish()
+	{
+		if (bits != 0) {
+			*dst++ = acc;
+			bits = 0;
+		}
+		return dst;
+	}
+};
+
+/**
+ * @brief 1ピクセル1語の送出データを詰めます。
+ * @param dst 出力（WIRE_PACK_WORDS(n) 語。src と同じでもよい）
+ * @param src 送出データ（c<<8、n 語）
+ * @param n ピクセル数
+ * @return 出力した語数
+ * @details 4ピクセルを読んでから3語を書くので、src と同じ領域へ上書きできます（キャッシュ済みの語列の変換用）。
+ */
+static inline size_t wire_pack(uint32_t* dst, const uint32_t* src, size_t n)
+{
+	WirePacker pk;
+	pk.begin(dst);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		const uint32_t w0 = src[i], w1 = src[i + 1], w2 = src[i + 2], w3 = src[i + 3];
+		uint32_t* d = pk.dst;
+		d[0] = w0 | (w1 >> 24);
+		d[1] = (w1 << 8) | (w2 >> 16);
+		d[2] = (w2 << 16) | (w3 >> 8);
+		pk.dst = d + 3;
+	}
+	for (; i < n; i++) pk.put(src[i]);
+	return (size_t)(pk.finish() - dst);
+}
+
+/**
+ * @brief VRAMの行（0x00GGRRBB）を、そろった位置から直接詰めます（4ピクセル = 3語）。
+ * @param dst 出力（n*3/4 語）
+ * @param src 送出順で最初のピクセル
+ * @param step 次のピクセルへの増分（+1/-1）
+ * @param n ピクセル数（4の倍数）
+ * @return 書き終えた次の位置
+ * @details パネルの幅が4の倍数で色補正がない場合、行ごとに語の境界がそろうので、1ピクセル1語の語列を作らずに詰められます。
+ */
+static inline uint32_t* wire_pack_pixels(uint32_t* dst, const uint32_t* src, int step, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i += 4, src += 4 * step, dst += 3) {
+		const uint32_t p0 = src[0], p1 = src[step], p2 = src[2 * step], p3 = src[3 * step];
+		dst[0] = (p0 << 8) | (p1 >> 16);
+		dst[1] = (p1 << 16) | (p2 >> 8);
+		dst[2] = (p2 << 24) | (p3 & 0xFFFFFFu);
+	}
+	return dst;
+}
@@ -0,0 +1,135 @@
+/**
+ * @brief SPI+DMA による APA102/SK9822 の駆動モジュール。
+ * @details
+ * - APA102 はクロック同期なので、WS2812 のような厳密なビットタイミングは不要です。SPI（モード0、MSBファースト）をそのまま使います。
+ * - 1フレーム = スタート（0x00 x 4）+ LEDごとに 0xE0|輝度, B, G, R + エンド（0x00 x (4 + LED数/16)）。
+ * - 16MHz では 1LED = 2µs（WS2812 は 30µs）。16x16 なら1フレーム約0.5ms です。
+ */
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "APA102.h"
+
+/**
+ * @brief コンストラクタ。SPIとDMAの初期化、VRAMと送出フレームの確保を行います。
+ * @param spi 使用するSPI
+ * @param sckPin クロック出力GPIO
+ * @param mosiPin データ出力GPIO
+ * @param a_xSize パネル幅
+ * @param a_ySize パネル高
+ * @param a_xPanelCount パネル数(横)
+ * @param a_yPanelCount パネル数(縦)
+ * @param baudHz クロック(Hz)
+ */
+APA102::APA102(spi_inst_t* spi, uint8_t sckPin, uint8_t mosiPin, uint16_t a_xSize, uint16_t a_ySize, uint16_t a_xPanelCount, uint16_t a_yPanelCount, uint32_t baudHz)
+	: LedCanvas((uint32_t)a_xSize * a_xPanelCount, (uint32_t)a_ySize * a_yPanelCount), m_spi(spi), m_sckPin(sckPin), m_mosiPin(mosiPin), m_baudHz(baudHz),
+	  m_gamma(1.0f), m_level(256), xSize(a_xSize), ySize(a_ySize), xPanelCount(a_xPanelCount), yPanelCount(a_yPanelCount)
+{
+	// SPI: モード0（クロックの立ち上がりでデータを取り込む）、8bit、MSBファースト。受信は使わない
+	m_actualHz = spi_init(m_spi, m_baudHz);
+	spi_set_format(m_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+	gpio_set_function(m_sckPin, GPIO_FUNC_SPI);
+	gpio_set_function(m_mosiPin, GPIO_FUNC_SPI);
+
+	apa102_build_lut(m_gamma, m_level, m_lut);
+	m_frameBytes = apa102_frame_bytes((size_t)xVRam * yVRam);
+	m_frame = new uint8_t[m_frameBytes];
+
+	// 送出用DMA: 8bit単位でメモリ→SPI TX FIFO。FIFOの空き(DREQ)に合わせて転送する
+	m_dmaChan = dma_claim_unused_channel(true);
+	dma_channel_config dc = dma_channel_get_default_config(m_dmaChan);
+	channel_config_set_transfer_data_size(&dc, DMA_SIZE_8);
+	channel_config_set_read_increment(&dc, true);
+	channel_config_set_write_increment(&dc, false);
+	channel_config_set_dreq(&dc, spi_get_dreq(m_spi, true));
+	dma_channel_configure(m_dmaChan, &dc, &spi_get_hw(m_spi)->dr, NULL, 0, false);
+}
+
+/**
+ * @brief VRAMを送出フレームに変換します。
+ * @param dst 出力（FrameBytes() バイト）
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return なし
+ * @details WS2812::EncodeWire() と同じ順（パネルは左上→右下、パネル内は行優先）で並べます。
+ */
+void APA102::EncodeFrame(uint8_t* dst, bool serpentine, bool leftToRight) const
+{
+	dst = apa102_write_start(dst);
+	for (uint32_t py = 0; py < yPanelCount; py++) {
+		for (uint32_t px = 0; px < xPanelCount; px++) {
+			const uint32_t posX = px * xSize;
+			const uint32_t posY = py * ySize;
+			for (uint32_t y = 0; y < ySize; ++y) {
+				bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+				const uint32_t* row = &pVRam[(posY + y) * xVRam + posX];
+				if (l2r) {
+					dst = apa102_encode_pixels(row, xSize, 1, m_lut, dst);
+				} else {
+					dst = apa102_encode_pixels(row + xSize - 1, xSize, -1, m_lut, dst);
+				}
+			}
+		}
+	}
+	apa102_write_end(dst, (size_t)xVRam * yVRam);
+}
+
+/**
+ * @brief 全パネルを送信します（DMA、待たない）。
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return なし
+ * @details 送出中のフレームを書き換えないよう、前の送出の完了を待ってから変換します。
+ */
+void APA102::ScanBuffer(bool serpentine, bool leftToRight)
+{
+	WaitTransmit();
+	EncodeFrame(m_frame, serpentine, leftToRight);
+	dma_channel_transfer_from_buffer_now(m_dmaChan, m_frame, m_frameBytes);
+}
+
+/**
+ * @brief DMA送出の完了を待ちます。
+ * @return なし
+ * @details DMAが渡し終えた後、SPIのFIFOが空になる（最後のバイトを送り終える）まで待ちます。
+ */
+void APA102::WaitTransmit()
+{
+	dma_channel_wait_for_finish_blocking(m_dmaChan);
+	while (spi_is_busy(m_spi)) tight_loop_contents();
+}
+
+/**
+ * @brief 現在の clk_peri に合わせてクロックを設定し直します。
+ * @return 実際のクロック(Hz)
+ */
+uint32_t APA102::UpdateClock()
+{
+	WaitTransmit();
+	m_actualHz = spi_set_baudrate(m_spi, m_baudHz);
+	return m_actualHz;
+}
+
+/**
+ * @brief ガンマを変更します。
+ * @param gamma ガンマ
+ * @return なし
+ */
+void APA102::SetGamma(float gamma)
+{
+	m_gamma = gamma;
+	apa102_build_lut(m_gamma, m_level, m_lut);
+}
+
+/**
+ * @brief 全体の明るさを変更します。
+ * @param level 0..256
+ * @return なし
+ */
+void APA102::SetBrightness(uint16_t level)
+{
+	m_level = level > 256 ? 256 : level;
+	apa102_build_lut(m_gamma, m_level, m_lut);
+}
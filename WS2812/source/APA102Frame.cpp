@@ -0,0 +1,98 @@
+/**
+ * @brief APA102/SK9822 の送出フレームの作成。
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。
+ */
+#include <math.h>
+#include <string.h>
+#include "APA102Frame.h"
+
+/**
+ * @brief 8bitチャネル値を 16bit の線形値へ変換する表を作ります。
+ * @param gamma ガンマ（1.0 で線形）
+ * @param level 全体の明るさ 0..256
+ * @param lut [out] 256要素
+ * @return なし
+ */
+void apa102_build_lut(float gamma, uint16_t level, uint16_t lut[256])
+{
+	if (level > 256) level = 256;
+	for (uint32_t v = 0; v < 256; v++) {
+		uint32_t lin;
+		if (gamma == 1.0f) {
+			lin = v * 257u;
+		} else {
+			lin = (uint32_t)lroundf(powf(v / 255.0f, gamma) * 65535.0f);
+		}
+		lut[v] = (uint16_t)((lin * level + 128u) >> 8);
+	}
+}
+
+/**
+ * @brief 16bitの線形値を 1LED分の4バイトへ変換します。
+ * @param r 赤
+ * @param g 緑
+ * @param b 青
+ * @return 下位バイトから 0xE0|輝度, B, G, R
+ */
+uint32_t apa102_pack_hdr(uint32_t r, uint32_t g, uint32_t b)
+{
+	uint32_t m = r > g ? r : g;
+	if (b > m) m = b;
+	if (m == 0) return 0xE0u;
+
+	// 8bit = c * 31 / (輝度 * 257)。最大のチャネルが 255 以下になる最小の輝度を選ぶ
+	const uint32_t bri = (m * APA102_MAX_GLOBAL + 65534u) / 65535u;
+	const uint32_t den = bri * 257u;
+	const uint32_t r8 = (r * APA102_MAX_GLOBAL + den / 2) / den;
+	const uint32_t g8 = (g * APA102_MAX_GLOBAL + den / 2) / den;
+	const uint32_t b8 = (b * APA102_MAX_GLOBAL + den / 2) / den;
+	return (0xE0u | bri) | ((b8 > 255u ? 255u : b8) << 8) | ((g8 > 255u ? 255u : g8) << 16) | ((r8 > 255u ? 255u : r8) << 24);
+}
+
+/**
+ * @brief スタートフレームを書き込みます。
+ * @param dst 出力
+ * @return 次に書く位置
+ */
+uint8_t* apa102_write_start(uint8_t* dst)
+{
+	memset(dst, 0x00, APA102_START_BYTES);
+	return dst + APA102_START_BYTES;
+}
+
+/**
+ * @brief エンドフレームを書き込みます。
+ * @param dst 出力
+ * @param leds LEDの数
+ * @return 次に書く位置
+ * @details 0xFF ではなく 0x00 で送ります（0xFF は余分なLEDがあると白で点灯するため）。
+ */
+uint8_t* apa102_write_end(uint8_t* dst, size_t leds)
+{
+	const size_t n = apa102_end_bytes(leds);
+	memset(dst, 0x00, n);
+	return dst + n;
+}
+
+/**
+ * @brief VRAM のピクセル列を LED フレームへ変換します。
+ * @param src ピクセル列
+ * @param count ピクセル数
+ * @param step 次のピクセルまでの要素数
+ * @param lut apa102_build_lut() の表
+ * @param dst 出力
+ * @return 次に書く位置
+ */
+uint8_t* apa102_encode_pixels(const uint32_t* src, size_t count, int step, const uint16_t lut[256], uint8_t* dst)
+{
+	for (size_t i = 0; i < count; i++, src += step) {
+		const uint32_t c = *src; // 0x00GGRRBB
+		const uint32_t w = apa102_pack_hdr(lut[(c >> 8) & 0xFFu], lut[(c >> 16) & 0xFFu], lut[c & 0xFFu]);
+		dst[0] = (uint8_t)w;
+		dst[1] = (uint8_t)(w >> 8);
+		dst[2] = (uint8_t)(w >> 16);
+		dst[3] = (uint8_t)(w >> 24);
+		dst += APA102_LED_BYTES;
+	}
+	return dst;
+}
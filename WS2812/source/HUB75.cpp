@@ -0,0 +1,256 @@
+/**
+ * @brief PIO+DMA による HUB75 RGBマトリクスの駆動モジュール。
+ * @details
+ * - データSM: ビットプレーン（1ピクセル=1バイト）を CLK に合わせて6本のデータ線へシフトします。
+ * - 行SM: 1行分のシフトを待って行アドレスを切り替え、ラッチし、制御語のサイクル数だけ点灯します。
+ *   2つのSMは PIO の IRQ 4/5 で同期し、次の行のシフトは前の行の点灯と並行して進みます。
+ * - DMA: データ/制御語それぞれ「転送用」と「再起動用」の2チャネル。転送用が終わると再起動用へチェインし、
+ *   再起動用が転送用の読み出しアドレスを先頭に戻して起動し直すため、フレームの繰り返しにCPUは関与しません。
+ * - ダブルバッファ: Show() は書き込み用の面へ変換してから再起動用の読み出し先を差し替えます（次のフレームの先頭で切り替わる）。
+ */
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "HUB75.h"
+#include "hub75.pio.h" // PIOアセンブリをインクルード（.pio はビルドで .h に生成される想定)
+
+/**
+ * @brief データSMを初期化します。
+ * @param pio 使用するPIO
+ * @param sm ステートマシン番号
+ * @param offset プログラムオフセット
+ * @param pins ピン割り当て
+ * @param wordsPerRow 1行の語数
+ * @param timing 分周設定
+ * @return なし
+ */
+static void hub75_data_program_init(PIO pio, uint sm, uint offset, const HUB75Pins& pins, uint32_t wordsPerRow, const Hub75Timing& timing)
+{
+	pio_sm_config c = hub75_data_program_get_default_config(offset);
+	sm_config_set_out_pins(&c, pins.r0, 6);
+	sm_config_set_sideset_pins(&c, pins.clk);
+	sm_config_set_out_shift(&c, true, true, 32); // LSB first（1バイト目が先）、autopull 32-bit
+	sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+	sm_config_set_clkdiv_int_frac(&c, timing.dataDivInt, timing.dataDivFrac);
+	for (uint i = 0; i < 6; i++) pio_gpio_init(pio, pins.r0 + i);
+	pio_gpio_init(pio, pins.clk);
+	pio_sm_set_consecutive_pindirs(pio, sm, pins.r0, 6, true);
+	pio_sm_set_consecutive_pindirs(pio, sm, pins.clk, 1, true);
+	pio_sm_init(pio, sm, offset, &c);
+
+	// y = 1行の語数-1（プログラムの mov x, y で毎行読み直す）
+	pio_sm_put_blocking(pio, sm, wordsPerRow - 1);
+	pio_sm_exec(pio, sm, pio_encode_pull(false, true));
+	pio_sm_exec(pio, sm, pio_encode_out(pio_y, 32));
+}
+
+/**
+ * @brief 行SMを初期化します。
+ * @param pio 使用するPIO
+ * @param sm ステートマシン番号
+ * @param offset プログラムオフセット
+ * @param pins ピン割り当て
+ * @return なし
+ * @details 点灯時間を clk_sys のサイクル数で数えるため、分周は1です。
+ */
+static void hub75_row_program_init(PIO pio, uint sm, uint offset, const HUB75Pins& pins)
+{
+	pio_sm_config c = hub75_row_program_get_default_config(offset);
+	sm_config_set_out_pins(&c, pins.addrA, 5);
+	sm_config_set_sideset_pins(&c, pins.lat);
+	sm_config_set_out_shift(&c, true, true, 32); // LSB first、autopull 32-bit
+	sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
+	sm_config_set_clkdiv_int_frac(&c, 1, 0);
+	for (uint i = 0; i < 5; i++) pio_gpio_init(pio, pins.addrA + i);
+	pio_gpio_init(pio, pins.lat);
+	pio_gpio_init(pio, pins.lat + 1);
+	pio_sm_set_consecutive_pindirs(pio, sm, pins.addrA, 5, true);
+	pio_sm_set_consecutive_pindirs(pio, sm, pins.lat, 2, true);
+	pio_sm_init(pio, sm, offset, &c);
+	pio_sm_exec(pio, sm, pio_encode_nop() | pio_encode_sideset(2, 0b10)); // 消灯（OE=High）
+}
+
+/**
+ * @brief 転送用と再起動用のDMAチャネルを設定します。
+ * @param chan 転送用チャネル（メモリ→PIO TX FIFO）
+ * @param reload 再起動用チャネル（*head → chan の読み出しアドレス）
+ * @param pio 使用するPIO
+ * @param sm 送り先のステートマシン
+ * @param head 再起動時の読み出し先を保持する変数
+ * @param words 1フレームの語数
+ * @return なし
+ * @details 転送用は終わると再起動用へチェインし、再起動用は読み出しアドレスへの書き込みで転送用を起動します。
+ */
+static void hub75_dma_ring_init(uint chan, uint reload, PIO pio, uint sm, const uint32_t* const* head, size_t words)
+{
+	dma_channel_config c = dma_channel_get_default_config(chan);
+	channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+	channel_config_set_read_increment(&c, true);
+	channel_config_set_write_increment(&c, false);
+	channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+	channel_config_set_chain_to(&c, reload);
+	dma_channel_configure(chan, &c, &pio->txf[sm], NULL, words, false);
+
+	dma_channel_config r = dma_channel_get_default_config(reload);
+	channel_config_set_transfer_data_size(&r, DMA_SIZE_32);
+	channel_config_set_read_increment(&r, false);
+	channel_config_set_write_increment(&r, false);
+	dma_channel_configure(reload, &r, &dma_hw->ch[chan].al3_read_addr_trig, head, 1, false);
+}
+
+/**
+ * @brief 転送用と再起動用のDMAチャネルを止めます。
+ * @param chan 転送用チャネル
+ * @param reload 再起動用チャネル
+ * @return なし
+ * @details チェインを自分自身へ向けて（=チェインなし）から中断し、止めた直後に再起動されないようにします。
+ */
+static void hub75_dma_ring_stop(uint chan, uint reload)
+{
+	dma_channel_config c = dma_get_channel_config(chan);
+	channel_config_set_chain_to(&c, chan);
+	dma_channel_set_config(chan, &c, false);
+	dma_channel_abort(reload);
+	dma_channel_abort(chan);
+}
+
+/**
+ * @brief コンストラクタ。VRAM/ビットプレーンの確保、PIO/SMとDMAの初期化を行います。
+ * @param pins ピン割り当て
+ * @param width パネルの幅
+ * @param height パネルの高さ
+ * @param depth ビット深度
+ * @param refreshHz 目標リフレッシュレート(Hz)
+ * @param panelClkHz 目標シフトクロック(Hz)
+ */
+HUB75::HUB75(const HUB75Pins& pins, uint16_t width, uint16_t height, uint8_t depth, uint32_t refreshHz, uint32_t panelClkHz)
+	: LedCanvas(width, height), m_pins(pins), m_panelClkHz(panelClkHz), m_refreshHz(refreshHz), m_front(0), m_running(false)
+{
+	m_geom = Hub75Geometry { width, height, depth };
+	if (!hub75_calc_timing(clock_get_hz(clk_sys), m_geom, m_panelClkHz, m_refreshHz, m_timing)) {
+		printf("HUB75: %ux%u depth %u cannot reach %luHz (%luHz)\n", width, height, depth, (unsigned long)m_refreshHz, (unsigned long)m_timing.refreshHz);
+	}
+	hub75_build_lut(depth, 1.0f, m_lut);
+
+	// ビットプレーン2面と制御語: 64x64・10bit で 2*40KB + 1.3KB
+	m_planeWords = hub75_plane_words(m_geom);
+	m_planes[0] = new uint32_t[m_planeWords];
+	m_planes[1] = new uint32_t[m_planeWords];
+	memset(m_planes[0], 0, m_planeWords * sizeof(uint32_t));
+	memset(m_planes[1], 0, m_planeWords * sizeof(uint32_t));
+	m_ctrl = new uint32_t[(height / 2u) * depth];
+	hub75_build_control(m_geom, m_timing, m_ctrl);
+	m_dataHead = m_planes[m_front];
+	m_ctrlHead = m_ctrl;
+
+	// PIO: 同じPIOに2つのSM（IRQフラグ 4/5 で同期するため）
+	m_pio = pio1;
+	m_offsetData = pio_add_program(m_pio, &hub75_data_program);
+	m_offsetRow = pio_add_program(m_pio, &hub75_row_program);
+	m_smData = pio_claim_unused_sm(m_pio, true);
+	m_smRow = pio_claim_unused_sm(m_pio, true);
+	hub75_data_program_init(m_pio, m_smData, m_offsetData, m_pins, width / 4u, m_timing);
+	hub75_row_program_init(m_pio, m_smRow, m_offsetRow, m_pins);
+
+	m_dmaData = dma_claim_unused_channel(true);
+	m_dmaDataReload = dma_claim_unused_channel(true);
+	m_dmaCtrl = dma_claim_unused_channel(true);
+	m_dmaCtrlReload = dma_claim_unused_channel(true);
+	hub75_dma_ring_init(m_dmaData, m_dmaDataReload, m_pio, m_smData, &m_dataHead, m_planeWords);
+	hub75_dma_ring_init(m_dmaCtrl, m_dmaCtrlReload, m_pio, m_smRow, &m_ctrlHead, (height / 2u) * depth);
+}
+
+/**
+ * @brief 走査を開始します。
+ * @return なし
+ * @details 再起動用のDMAを起動すると、以降はフレームの先頭へ戻りながら送り続けます。
+ */
+void HUB75::Start()
+{
+	if (m_running) return;
+	pio_sm_clear_fifos(m_pio, m_smData);
+	pio_sm_clear_fifos(m_pio, m_smRow);
+	dma_start_channel_mask((1u << m_dmaDataReload) | (1u << m_dmaCtrlReload));
+	pio_enable_sm_mask_in_sync(m_pio, (1u << m_smData) | (1u << m_smRow));
+	m_running = true;
+}
+
+/**
+ * @brief 走査を停止して消灯します。
+ * @return なし
+ * @details DMAを止め、SMを停止してから OE を High（消灯）にします。次の Start() はフレームの先頭から送り直します。
+ */
+void HUB75::Stop()
+{
+	if (!m_running) return;
+	hub75_dma_ring_stop(m_dmaData, m_dmaDataReload);
+	hub75_dma_ring_stop(m_dmaCtrl, m_dmaCtrlReload);
+	pio_set_sm_mask_enabled(m_pio, (1u << m_smData) | (1u << m_smRow), false);
+	pio_sm_exec(m_pio, m_smRow, pio_encode_nop() | pio_encode_sideset(2, 0b10));
+
+	// SMをプログラムの先頭から（データSMの y は保持される）、DMAはチェインを戻す
+	pio_sm_restart(m_pio, m_smData);
+	pio_sm_restart(m_pio, m_smRow);
+	pio_sm_clear_fifos(m_pio, m_smData);
+	pio_sm_clear_fifos(m_pio, m_smRow);
+	pio_sm_exec(m_pio, m_smData, pio_encode_jmp(m_offsetData));
+	pio_sm_exec(m_pio, m_smRow, pio_encode_jmp(m_offsetRow));
+	pio_interrupt_clear(m_pio, 4);
+	pio_interrupt_clear(m_pio, 5);
+	hub75_dma_ring_init(m_dmaData, m_dmaDataReload, m_pio, m_smData, &m_dataHead, m_planeWords);
+	hub75_dma_ring_init(m_dmaCtrl, m_dmaCtrlReload, m_pio, m_smRow, &m_ctrlHead, (m_geom.height / 2u) * m_geom.depth);
+	m_running = false;
+}
+
+/**
+ * @brief VRAMをビットプレーンへ変換し、次のフレームから表示します。
+ * @return なし
+ * @details 書き込み用の面が直前の Show() の前まで表示されていた場合、表示が切り替わる（フレームの先頭に来る）まで待ちます。
+ */
+void HUB75::Show()
+{
+	uint32_t* back = m_planes[m_front ^ 1u];
+	if (m_running) {
+		// DMAがまだ書き込み用の面を読んでいる間は待つ（最大1フレーム）
+		const uintptr_t lo = (uintptr_t)back;
+		const uintptr_t hi = lo + m_planeWords * sizeof(uint32_t);
+		for (;;) {
+			const uintptr_t rd = (uintptr_t)dma_hw->ch[m_dmaData].read_addr;
+			if (rd < lo || rd >= hi) break;
+			tight_loop_contents();
+		}
+	}
+	hub75_encode_planes(pVRam, xVRam, m_geom, m_lut, back);
+	m_front ^= 1u;
+	m_dataHead = back; // 再起動用DMAが次のフレームの先頭で読む
+}
+
+/**
+ * @brief 現在の clk_sys に合わせて分周と点灯時間を設定し直します。
+ * @return 目標リフレッシュを満たせればtrue
+ * @details 制御語は走査中に書き換えるため、切り替えのフレームだけ点灯時間が混在します。
+ */
+bool HUB75::UpdateClock()
+{
+	Hub75Timing t;
+	const bool ok = hub75_calc_timing(clock_get_hz(clk_sys), m_geom, m_panelClkHz, m_refreshHz, t);
+	if (t.dataDivInt == 0) return false; // 分周器の範囲外
+	m_timing = t;
+	hub75_build_control(m_geom, m_timing, m_ctrl);
+	pio_sm_set_clkdiv_int_frac(m_pio, m_smData, t.dataDivInt, t.dataDivFrac);
+	pio_sm_clkdiv_restart(m_pio, m_smData);
+	return ok;
+}
+
+/**
+ * @brief 8bit→ビット深度の変換のガンマを変更します。
+ * @param gamma ガンマ（1.0で線形）
+ * @return なし
+ */
+void HUB75::SetGamma(float gamma)
+{
+	hub75_build_lut(m_geom.depth, gamma, m_lut);
+}
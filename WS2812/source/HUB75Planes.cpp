@@ -0,0 +1,173 @@
+/**
+ * @brief HUB75 のビットプレーン生成とタイミング計算。
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。
+ */
+#include <math.h>
+#include "HUB75Planes.h"
+
+/** @brief 分周(1/256単位)でのサイクル数を clk_sys のサイクル数へ（切り上げ）。 */
+static inline uint32_t sys_cycles(uint64_t div256, uint32_t smCycles)
+{
+	return (uint32_t)((div256 * smCycles + 255u) / 256u);
+}
+
+/** @brief 最下位プレーンの点灯サイクル数が base のときの1フレームのサイクル数。 */
+static uint64_t frame_cycles(const Hub75Geometry& geom, uint32_t shiftCycles, uint32_t base)
+{
+	const uint64_t shift = (uint64_t)shiftCycles + HUB75_HANDSHAKE_CYCLES;
+	uint64_t perRow = 0;
+	for (uint32_t b = 0; b < geom.depth; b++) {
+		const uint64_t lit = HUB75_ROW_OVERHEAD + ((uint64_t)base << b);
+		perRow += lit > shift ? lit : shift; // シフトと点灯は並行、遅い方で決まる
+	}
+	return perRow * (geom.height / 2u);
+}
+
+/**
+ * @brief clk_sys と目標値から、HUB75 の分周と最下位プレーンの点灯時間を求めます。
+ * @param sysHz clk_sys(Hz)
+ * @param geom 大きさとビット深度
+ * @param panelClkHz 目標シフトクロック(Hz)
+ * @param refreshHz 目標リフレッシュレート(Hz)
+ * @param out [out] 分周設定と実際のタイミング
+ * @return 目標を満たせればtrue
+ */
+bool hub75_calc_timing(uint32_t sysHz, const Hub75Geometry& geom, uint32_t panelClkHz, uint32_t refreshHz, Hub75Timing& out)
+{
+	out = Hub75Timing {};
+	out.sysHz = sysHz;
+	if (sysHz == 0 || panelClkHz == 0 || refreshHz == 0) return false;
+	if (geom.depth == 0 || geom.depth > HUB75_MAX_DEPTH) return false;
+	if (geom.width == 0 || (geom.width & 3u) != 0) return false;
+	if (geom.height == 0 || (geom.height & 1u) != 0 || geom.height / 2u > HUB75_MAX_ROW_PAIRS) return false;
+
+	// データSMは2サイクルで1クロック（out pins side 0 → out null side 1）
+	const uint64_t smHz = (uint64_t)panelClkHz * 2u;
+	const uint64_t div256 = ((uint64_t)sysHz * 256u + smHz / 2) / smHz;
+	if (div256 < 256u || div256 > 0xFFFFFFu) return false;
+	out.dataDivInt = (uint16_t)(div256 >> 8);
+	out.dataDivFrac = (uint8_t)(div256 & 0xFFu);
+	out.panelClkHz = (uint32_t)(((uint64_t)sysHz * 256u + div256) / (div256 * 2u));
+	out.shiftCycles = sys_cycles(div256, HUB75_DATA_CYCLES_PER_WORD * (geom.width / 4u) + HUB75_DATA_ROW_OVERHEAD);
+
+	// 目標リフレッシュに収まる最大の点灯時間（frame_cycles は base について単調増加）
+	const uint64_t budget = sysHz / refreshHz;
+	uint32_t base = 1;
+	bool ok = frame_cycles(geom, out.shiftCycles, 1) <= budget;
+	if (ok) {
+		// 上限: 最上位プレーンだけで予算を超える値、または制御語の27bitに収まらない値
+		uint32_t hi = (uint32_t)(budget >> (geom.depth - 1)) + 1u;
+		const uint32_t maxBase = (1u << 27) >> (geom.depth - 1);
+		if (hi > maxBase + 1u) hi = maxBase + 1u;
+		uint32_t lo = 1;
+		while (lo + 1 < hi) {
+			const uint32_t mid = lo + (hi - lo) / 2;
+			if (frame_cycles(geom, out.shiftCycles, mid) <= budget) lo = mid;
+			else hi = mid;
+		}
+		base = lo;
+	}
+	out.oeBaseCycles = base;
+	const uint64_t frame = frame_cycles(geom, out.shiftCycles, base);
+	out.frameCycles = (uint32_t)frame;
+	out.refreshHz = (uint32_t)(((uint64_t)sysHz + frame / 2) / frame);
+	const uint64_t lit = (uint64_t)base * ((1u << geom.depth) - 1u) * (geom.height / 2u);
+	out.oePermille = (uint16_t)(lit * 1000u / frame);
+	return ok;
+}
+
+/**
+ * @brief ビットプレーン1面分の語数。
+ * @param geom 大きさとビット深度
+ * @return 語数
+ */
+size_t hub75_plane_words(const Hub75Geometry& geom)
+{
+	return (size_t)(geom.height / 2u) * geom.depth * (geom.width / 4u);
+}
+
+/**
+ * @brief 8bitチャネル値をビット深度 depth の値へ変換する表を作ります。
+ * @param depth ビット深度
+ * @param gamma ガンマ（1.0 で線形）
+ * @param lut [out] 256要素
+ * @return なし
+ */
+void hub75_build_lut(uint8_t depth, float gamma, uint16_t lut[256])
+{
+	const uint32_t maxOut = (1u << depth) - 1u;
+	for (uint32_t v = 0; v < 256; v++) {
+		if (gamma == 1.0f) {
+			lut[v] = (uint16_t)((v * maxOut + 127u) / 255u);
+		} else {
+			lut[v] = (uint16_t)lroundf(powf(v / 255.0f, gamma) * (float)maxOut);
+		}
+	}
+}
+
+/**
+ * @brief 行SMへ送る制御語を作ります。
+ * @param geom 大きさとビット深度
+ * @param timing hub75_calc_timing() の結果
+ * @param ctrl [out] (height/2)*depth 語
+ * @return なし
+ */
+void hub75_build_control(const Hub75Geometry& geom, const Hub75Timing& timing, uint32_t* ctrl)
+{
+	for (uint32_t r = 0; r < geom.height / 2u; r++) {
+		for (uint32_t b = 0; b < geom.depth; b++) {
+			*ctrl++ = (r & 0x1Fu) | (((timing.oeBaseCycles << b) - 1u) << 5);
+		}
+	}
+}
+
+/**
+ * @brief 8bit値の bit p を bit 8p へ広げます（1バイト = 1プレーン）。
+ * @details 下位7bitは乗算で広げます（部分積 p+7q は7bit以内なら重ならず、桁上がりしない）。bit7 は bit0 の部分積と重なるため別に置きます。
+ */
+static inline uint64_t spread8(uint32_t v)
+{
+	return (((uint64_t)(v & 0x7Fu) * 0x0002040810204081ull) & 0x0001010101010101ull) | ((uint64_t)((v >> 7) & 1u) << 56);
+}
+
+/**
+ * @brief VRAM（0x00GGRRBB）をBCMのビットプレーンに変換します。
+ * @param vram VRAM
+ * @param stride VRAMの1行の要素数
+ * @param geom 大きさとビット深度
+ * @param lut hub75_build_lut() の表
+ * @param planes [out] hub75_plane_words() 語
+ * @return なし
+ * @details 1ピクセルの6チャネル（上下の行×RGB）をまとめて広げ、8プレーン分のバイトを一度に求めます。
+ *          出力は行ペア順、その中でプレーン順（hub75_build_control() と同じ並び）。
+ */
+void hub75_encode_planes(const uint32_t* vram, uint32_t stride, const Hub75Geometry& geom, const uint16_t lut[256], uint32_t* planes)
+{
+	const uint32_t rows = geom.height / 2u;
+	const uint32_t width = geom.width;
+	const uint32_t depth = geom.depth;
+	const uint32_t lowPlanes = depth < 8u ? depth : 8u;
+	uint8_t* out = (uint8_t*)planes; // リトルエンディアン: 語の下位バイトが先に出力される
+
+	for (uint32_t r = 0; r < rows; r++) {
+		const uint32_t* top = &vram[r * stride];
+		const uint32_t* bottom = &vram[(r + rows) * stride];
+		uint8_t* row = &out[r * depth * width];
+		for (uint32_t x = 0; x < width; x++) {
+			const uint32_t t = top[x];
+			const uint32_t u = bottom[x];
+			const uint32_t ch[6] = {
+				lut[(t >> 8) & 0xFFu], lut[(t >> 16) & 0xFFu], lut[t & 0xFFu], // R0 G0 B0
+				lut[(u >> 8) & 0xFFu], lut[(u >> 16) & 0xFFu], lut[u & 0xFFu], // R1 G1 B1
+			};
+			uint64_t lo = 0;
+			for (uint32_t c = 0; c < 6; c++) lo |= spread8(ch[c]) << c;
+			for (uint32_t b = 0; b < lowPlanes; b++) row[b * width + x] = (uint8_t)(lo >> (b * 8u));
+			if (depth > 8u) {
+				uint64_t hi = 0;
+				for (uint32_t c = 0; c < 6; c++) hi |= spread8(ch[c] >> 8) << c;
+				for (uint32_t b = 8; b < depth; b++) row[b * width + x] = (uint8_t)(hi >> ((b - 8u) * 8u));
+			}
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/**
+ * @brief LEDごと/パネルごとの色補正（送出データへの変換時に掛ける）。
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。
+ */
+#include "LedCalibration.h"
+
+/**
+ * @brief 単位行列を作ります。
+ * @param out [out] 行列
+ * @return なし
+ */
+void ledcal_matrix_identity(LedColorMatrix& out)
+{
+	for (int i = 0; i < 9; i++) out.m[i] = (i % 4 == 0) ? LEDCAL_ONE : 0;
+}
+
+/**
+ * @brief 実数の行列から Q12 の行列を作ります。
+ * @param m 行優先 3x3
+ * @param out [out] 行列
+ * @return なし
+ */
+void ledcal_matrix_from_float(const float m[9], LedColorMatrix& out)
+{
+	for (int i = 0; i < 9; i++) {
+		float v = m[i] * LEDCAL_ONE;
+		v = v < 0 ? v - 0.5f : v + 0.5f; // 四捨五入
+		out.m[i] = (int16_t)(v < -32768.0f ? -32768 : v > 32767.0f ? 32767 : (int32_t)v);
+	}
+}
+
+/**
+ * @brief 1行を補正しながら送出データへ変換します。
+ * @param src 送出順で最初のピクセル
+ * @param step 次のピクセルへの増分
+ * @param dst 出力
+ * @param n ピクセル数
+ * @param m 行列（nullptr なら掛けない）
+ * @param gain 明るさ（nullptr なら等倍）
+ * @return なし
+ * @details 明るさだけの場合は3チャネルをまとめて1回の乗算で掛けます（行列の分解をしない）。
+ */
+void ledcal_encode_row(const uint32_t* src, int step, uint32_t* dst, uint32_t n, const LedColorMatrix* m, const uint8_t* gain)
+{
+	if (m == nullptr && gain == nullptr) {
+		for (uint32_t i = 0; i < n; i++, src += step) dst[i] = *src << 8;
+	} else if (m == nullptr) {
+		for (uint32_t i = 0; i < n; i++, src += step) dst[i] = pixelops::px_scale(*src, gain[i] + 1u) << 8;
+	} else {
+		const LedColorMatrix mm = *m; // dst への書き込みで読み直さないよう、行列は手元に写す
+		if (gain == nullptr) {
+			for (uint32_t i = 0; i < n; i++, src += step) dst[i] = ledcal_apply(*src, &mm, LEDCAL_GAIN_UNITY) << 8;
+		} else {
+			for (uint32_t i = 0; i < n; i++, src += step) dst[i] = ledcal_apply(*src, &mm, gain[i]) << 8;
+		}
+	}
+}
@@ -0,0 +1,186 @@
+/**
+ * @brief VRAM（0x00GGRRBB）と、出力方式に依らない描画処理。
+ * @details
+ * - WS2812/HUB75 などの出力クラスはこのクラスを継承し、VRAMと描画APIを共有します。
+ * - ここでは VRAM だけを操作します。送出（PIO/DMA）は派生クラスが行います。
+ */
+#include <stdio.h>
+#include "LedCanvas.h"
+#include "PixelOps.h"
+#include "TraceRecorder.h"
+
+/**
+ * @brief VRAMを確保して黒で初期化します。
+ * @param width VRAMの幅（ピクセル）
+ * @param height VRAMの高さ（ピクセル）
+ * @details メモリ使用量は画素数*4バイト。高解像度ではヒープを圧迫する点に注意。
+ */
+LedCanvas::LedCanvas(uint32_t width, uint32_t height)
+	: pVRam(new uint32_t[width * height]), xVRam(width), yVRam(height), m_ownsVRam(true)
+{
+	for (uint32_t i = 0; i < xVRam * yVRam; i++) pVRam[i] = 0;
+}
+
+/**
+ * @brief 呼び出し側のメモリをVRAMとして使い、黒で初期化します。
+ * @param vram VRAM（width*height 要素。このオブジェクトより長く保持すること）
+ * @param width VRAMの幅（ピクセル）
+ * @param height VRAMの高さ（ピクセル）
+ * @details VRAMにヒープを使いません。大きさがコンパイル時に決まる場合（WS2812Static）に使います。
+ *          vram の所有権は呼び出し側に残り、デストラクタでは解放しません。
+ */
+LedCanvas::LedCanvas(uint32_t* vram, uint32_t width, uint32_t height)
+	: pVRam(vram), xVRam(width), yVRam(height), m_ownsVRam(false)
+{
+	for (uint32_t i = 0; i < xVRam * yVRam; i++) pVRam[i] = 0;
+}
+
+/**
+ * @brief VRAMを解放します。
+ * @details 幅と高さを渡すコンストラクタで確保した場合だけ delete[] します。
+ */
+LedCanvas::~LedCanvas()
+{
+	if (m_ownsVRam) delete[] pVRam;
+}
+
+/**
+ * @brief VRAM全体を指定色で塗りつぶします。
+ * @param rgb 0x00GGRRBB
+ * @return なし
+ */
+void LedCanvas::Clear(uint32_t rgb)
+{
+	LGM_TRACE_SCOPE(TRACE_CLEAR, 0, rgb);
+	// VRAM全体を1色で初期化。描画のベース色や消去に使用。
+	for (uint32_t i = 0; i < xVRam * yVRam; ++i) pVRam[i] = rgb;
+}
+/**
+ * @brief 指定座標のピクセル値を設定します（VRAMのみ）。
+ * @param x X座標
+ * @param y Y座標
+ * @param rgb 0x00GGRRBB
+ * @return なし
+ */
+void LedCanvas::SetPixel(uint16_t x, uint16_t y, uint32_t rgb)
+{
+	// 範囲内なら1画素だけ更新（VRAM）。送信は行わない。
+	if (x < xVRam && y < yVRam) pVRam[y * xVRam + x] = rgb;
+}
+
+/**
+ * @brief 任意のパターン配列をVRAMにブレンド/置換して描画します。
+ * @param pattern 0x00GGRRBB配列（width*height）
+ * @param width パターン幅
+ * @param height パターン高さ
+ * @param X VRAM貼り付け先 左上X（負でもよい）
+ * @param y VRAM貼り付け先 左上Y（負でもよい）
+ * @param colorReplace 置換色（0で無効）
+ * @param isOverlay 黒を透明扱い
+ * @return なし
+ * @details colorReplace!=0 の場合は非0画素を置換色で塗り、0画素は isOverlay に応じて透過/黒上書きします。
+ *          VRAMからはみ出す部分（左上/右下とも）は描きません。大きなVRAMでスクロールさせる場合などに使えます。
+ */
+void LedCanvas::DrawBuffer(const uint32_t pattern[], uint16_t width, uint16_t height, int32_t X, int32_t y, uint32_t colorReplace, bool isOverlay)
+{
+	LGM_TRACE_SCOPE(TRACE_DRAW_BUFFER, (uint8_t)(isOverlay | ((colorReplace != 0) << 1)), (uint32_t)width | ((uint32_t)height << 16), (uint32_t)(uint16_t)X | ((uint32_t)(uint16_t)y << 16));
+	bool bisReplace = colorReplace != 0x0;
+
+	// VRAM外の画素は描かない（範囲は先に切り詰め、行ごとに直接書き込む）
+	const uint32_t sx = X < 0 ? (uint32_t)-X : 0; // パターンの左端で描かない列数
+	const uint32_t sy = y < 0 ? (uint32_t)-y : 0; // パターンの上端で描かない行数
+	if (sx >= width || sy >= height) return;
+	if (X >= (int32_t)xVRam || y >= (int32_t)yVRam) return;
+	const uint32_t dx = (uint32_t)(X + (int32_t)sx);
+	const uint32_t dy = (uint32_t)(y + (int32_t)sy);
+	uint32_t w = width - sx;
+	uint32_t h = height - sy;
+	if (dx + w > xVRam) w = xVRam - dx;
+	if (dy + h > yVRam) h = yVRam - dy;
+
+	// 非0画素: 置換色 or パターン色、0画素: オーバーレイならVRAMのまま、そうでなければ黒
+	// 分岐せず、非0のマスクで選択する
+	for (uint32_t py = 0; py < h; ++py) {
+		const uint32_t* src = &pattern[(size_t)(sy + py) * width + sx];
+		uint32_t* dst = &pVRam[(size_t)(dy + py) * xVRam + dx];
+		for (uint32_t px = 0; px < w; ++px) {
+			uint32_t color = src[px];
+			uint32_t nz = 0u - (uint32_t)(color != 0);
+			uint32_t fg = bisReplace ? colorReplace : color;
+			uint32_t bg = isOverlay ? dst[px] : 0u;
+			dst[px] = (fg & nz) | (bg & ~nz);
+		}
+	}
+}
+
+/**
+ * @brief パターン配列を拡大・縮小・回転してVRAMへ描画します。
+ * @param pattern 0x00GGRRBB配列（width*height）
+ * @param width パターン幅
+ * @param height パターン高さ
+ * @param xf 変換
+ * @param colorReplace 置換色（0で無効）
+ * @param isOverlay 黒を透明扱い
+ * @param filter サンプリング方法
+ * @return なし
+ * @details 黒/置換色の扱いは DrawBuffer() と同じです。16x16 のパターンを大きなパネルへ拡大して使う場合などに使います（SpriteBlit.h）。
+ */
+void LedCanvas::DrawTransformed(const uint32_t pattern[], uint16_t width, uint16_t height, const SpriteXform& xf, uint32_t colorReplace, bool isOverlay, SpriteFilter filter)
+{
+	LGM_TRACE_SCOPE(TRACE_DRAW_BUFFER, (uint8_t)(isOverlay | ((colorReplace != 0) << 1)), (uint32_t)width | ((uint32_t)height << 16), (uint32_t)(uint16_t)xf.dstLeft | ((uint32_t)(uint16_t)xf.dstTop << 16));
+	sprite_blit(pVRam, xVRam, yVRam, pattern, width, height, xf, filter, colorReplace, isOverlay);
+}
+
+/**
+ * @brief タイルマップをVRAM全体へ描画します。
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @param scrollX VRAMの左端に来るマップのX（マップの端で一周する）
+ * @param scrollY VRAMの上端に来るマップのY
+ * @param isOverlay 番号0の画素を透明として重ねる
+ * @return なし
+ * @details 1ピクセル4バイトの画像の代わりに、共有するタイルとマスごとの2バイトだけで背景を持てます（TileMap.h）。
+ */
+void LedCanvas::DrawTileMap(const TileSet& ts, const TileMap& map, int32_t scrollX, int32_t scrollY, bool isOverlay)
+{
+	LGM_TRACE_SCOPE(TRACE_DRAW_TILEMAP, (uint8_t)isOverlay, (uint32_t)map.width | ((uint32_t)map.height << 16), (uint32_t)(uint16_t)scrollX | ((uint32_t)(uint16_t)scrollY << 16));
+	tilemap_draw(pVRam, xVRam, yVRam, ts, map, scrollX, scrollY, isOverlay);
+}
+
+/**
+ * @brief VRAM全体をアルファ倍します（明るさの一括変更/フェード）。
+ * @param alpha 0..256（256で等倍）
+ * @return なし
+ * @details チャネルを分解せず、1ピクセル=1語のまま処理します（PixelOps.h）。
+ */
+void LedCanvas::Scale(uint16_t alpha)
+{
+	pixelops::px_scale_buffer(pVRam, pVRam, xVRam * yVRam, alpha);
+}
+
+/**
+ * @brief VRAMと同じ大きさのフレームへクロスフェードします。
+ * @param frame 0x00GGRRBB のフラット配列（xVRam*yVRam 要素）
+ * @param alpha 0..256（0でVRAMのまま、256でframe）
+ * @return なし
+ */
+void LedCanvas::Blend(const uint32_t frame[], uint16_t alpha)
+{
+	pixelops::px_blend_buffer(pVRam, pVRam, frame, xVRam * yVRam, alpha);
+}
+
+/**
+ * @brief VRAM全体のチャネル合計が上限を超えないように暗くします（電流制限）。
+ * @param maxLevel チャネル値の合計の上限（1チャネル255が最大。全点灯白なら 765*ピクセル数）
+ * @return 適用したアルファ（0..256、256なら変更なし）
+ * @details WS2812 の消費電流はチャネル値の合計にほぼ比例するため、合計から倍率を求めて一括で暗くします。
+ */
+uint16_t LedCanvas::LimitPower(uint32_t maxLevel)
+{
+	const uint32_t n = xVRam * yVRam;
+	const uint32_t total = pixelops::px_sum_buffer(pVRam, n);
+	if (total <= maxLevel) return 256;
+	uint16_t alpha = (uint16_t)(((uint64_t)maxLevel << 8) / total); // 切り捨てなので上限は超えない
+	pixelops::px_scale_buffer(pVRam, pVRam, n, alpha);
+	return alpha;
+}
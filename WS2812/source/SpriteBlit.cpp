@@ -0,0 +1,209 @@
+/**
+ * @brief パターンの拡大・縮小・回転描画（アフィン変換、16.16 固定小数点）。
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。浮動小数点は使いません。
+ */
+#include "SpriteBlit.h"
+#include "PixelOps.h"
+
+/** @brief 65536*sin(2πi/256) の 1/4 周期分（i = 0..64）。 */
+static const int32_t kSinQ16[65] = {
+	0, 1608, 3216, 4821, 6424, 8022, 9616, 11204,
+	12785, 14359, 15924, 17479, 19024, 20557, 22078, 23586,
+	25080, 26558, 28020, 29466, 30893, 32303, 33692, 35062,
+	36410, 37736, 39040, 40320, 41576, 42806, 44011, 45190,
+	46341, 47464, 48559, 49624, 50660, 51665, 52639, 53581,
+	54491, 55368, 56212, 57022, 57798, 58538, 59244, 59914,
+	60547, 61145, 61705, 62228, 62714, 63162, 63572, 63944,
+	64277, 64571, 64827, 65043, 65220, 65358, 65457, 65516,
+	65536,
+};
+
+/** @brief 正弦（16.16）。 @param angle 256で1周 */
+static int32_t sin_q16(uint8_t angle)
+{
+	const uint32_t i = angle & 63u;
+	switch (angle >> 6) {
+	case 0: return kSinQ16[i];
+	case 1: return kSinQ16[64 - i];
+	case 2: return -kSinQ16[i];
+	default: return -kSinQ16[64 - i];
+	}
+}
+
+/** @brief 負の数も切り捨てる割り算。 @param n 分子 @param d 分母（正） */
+static inline int64_t floor_div(int64_t n, int64_t d)
+{
+	int64_t q = n / d;
+	if ((n % d) != 0 && n < 0) q--;
+	return q;
+}
+
+/** @brief 負の数も切り上げる割り算。 @param n 分子 @param d 分母（正） */
+static inline int64_t ceil_div(int64_t n, int64_t d) { return -floor_div(-n, d); }
+
+/**
+ * @brief f0 + s*i が 0..limit-1 に入る整数 i の範囲を求めます。
+ * @param f0 i=0 での値
+ * @param s i が1増えたときの増分
+ * @param limit 範囲の上限（含まない）
+ * @param lo [in,out] 下限（これより大きければ更新）
+ * @param hi [in,out] 上限（含まない。これより小さければ更新）
+ */
+static void clip_span(int64_t f0, int64_t s, int64_t limit, int64_t& lo, int64_t& hi)
+{
+	int64_t l, h;
+	if (s > 0) {
+		l = ceil_div(-f0, s);
+		h = floor_div(limit - 1 - f0, s) + 1;
+	} else if (s < 0) {
+		l = ceil_div(f0 - limit + 1, -s);
+		h = floor_div(f0, -s) + 1;
+	} else {
+		if (f0 >= 0 && f0 < limit) return;
+		l = 0;
+		h = 0;
+	}
+	if (l > lo) lo = l;
+	if (h < hi) hi = h;
+}
+
+/** @brief 16.16 の値を、描画範囲に使える int16 へ収めます。 */
+static int16_t clamp_i16(int64_t v)
+{
+	return (int16_t)(v < -32768 ? -32768 : v > 32767 ? 32767 : v);
+}
+
+/**
+ * @brief 拡大率と回転角から変換を作ります。
+ * @param srcW 元画像の幅
+ * @param srcH 元画像の高さ
+ * @param dstCx 元画像の中心を置く描画先の X（16.16）
+ * @param dstCy 元画像の中心を置く描画先の Y（16.16）
+ * @param scaleX X の拡大率（16.16）
+ * @param scaleY Y の拡大率（16.16）
+ * @param angle 回転角（256で1周、時計回り）
+ * @param out [out] 変換
+ * @return なし
+ */
+void sprite_xform_make(uint32_t srcW, uint32_t srcH, int32_t dstCx, int32_t dstCy, int32_t scaleX, int32_t scaleY, uint8_t angle, SpriteXform& out)
+{
+	if (scaleX <= 0) scaleX = 1;
+	if (scaleY <= 0) scaleY = 1;
+	const int64_t cosv = sin_q16((uint8_t)(angle + 64u));
+	const int64_t sinv = sin_q16(angle);
+
+	// 逆変換: 元画像 = 拡大の逆 * 回転の逆 * (描画先 - 中心) + 元画像の中心
+	out.a = (int32_t)((cosv << 16) / scaleX);
+	out.b = (int32_t)((sinv << 16) / scaleX);
+	out.c = (int32_t)((-sinv << 16) / scaleY);
+	out.d = (int32_t)((cosv << 16) / scaleY);
+	const int64_t u = SPRITE_ONE / 2 - (int64_t)dstCx; // 描画先 (0,0) の中心から見た位置
+	const int64_t v = SPRITE_ONE / 2 - (int64_t)dstCy;
+	out.x0 = (int32_t)(((int64_t)srcW << 15) + ((out.a * u + out.b * v) >> 16));
+	out.y0 = (int32_t)(((int64_t)srcH << 15) + ((out.c * u + out.d * v) >> 16));
+
+	// 順変換で4隅を写し、描画される範囲を求める
+	int64_t minX = INT64_MAX, minY = INT64_MAX, maxX = INT64_MIN, maxY = INT64_MIN;
+	for (int k = 0; k < 4; k++) {
+		const int64_t su = ((((k & 1) ? (int64_t)srcW : 0) << 16) - ((int64_t)srcW << 15)) * scaleX >> 16;
+		const int64_t sv = ((((k & 2) ? (int64_t)srcH : 0) << 16) - ((int64_t)srcH << 15)) * scaleY >> 16;
+		const int64_t x = dstCx + ((cosv * su - sinv * sv) >> 16);
+		const int64_t y = dstCy + ((sinv * su + cosv * sv) >> 16);
+		if (x < minX) minX = x;
+		if (x > maxX) maxX = x;
+		if (y < minY) minY = y;
+		if (y > maxY) maxY = y;
+	}
+	out.dstLeft = clamp_i16(minX >> 16);
+	out.dstTop = clamp_i16(minY >> 16);
+	out.dstRight = clamp_i16((maxX + SPRITE_ONE - 1) >> 16);
+	out.dstBottom = clamp_i16((maxY + SPRITE_ONE - 1) >> 16);
+}
+
+/** @brief 双線形補間の近傍の添字（範囲外は端に寄せる）。 */
+static inline uint32_t clamp_index(int32_t i, uint32_t n)
+{
+	return i < 0 ? 0u : (uint32_t)i >= n ? n - 1u : (uint32_t)i;
+}
+
+/**
+ * @brief 元画像を変形して描画します。
+ * @param dst 描画先
+ * @param dstW 描画先の幅
+ * @param dstH 描画先の高さ
+ * @param src 元画像
+ * @param srcW 元画像の幅
+ * @param srcH 元画像の高さ
+ * @param xf 変換
+ * @param filter サンプリング方法
+ * @param colorReplace 置換色（0で無効）
+ * @param isOverlay 黒(0)を透明として重ねる
+ * @return 書き込んだピクセル数
+ */
+size_t sprite_blit(uint32_t* dst, uint32_t dstW, uint32_t dstH, const uint32_t* src, uint32_t srcW, uint32_t srcH,
+                   const SpriteXform& xf, SpriteFilter filter, uint32_t colorReplace, bool isOverlay)
+{
+	if (srcW == 0 || srcH == 0) return 0;
+	const int32_t top = xf.dstTop < 0 ? 0 : xf.dstTop;
+	const int32_t bottom = xf.dstBottom > (int32_t)dstH ? (int32_t)dstH : xf.dstBottom;
+	const int32_t left = xf.dstLeft < 0 ? 0 : xf.dstLeft;
+	const int32_t right = xf.dstRight > (int32_t)dstW ? (int32_t)dstW : xf.dstRight;
+	const int64_t limX = (int64_t)srcW << 16;
+	const int64_t limY = (int64_t)srcH << 16;
+	const bool bisReplace = colorReplace != 0x0;
+	size_t written = 0;
+
+	for (int32_t y = top; y < bottom; y++) {
+		// この行で元画像の内側に入る X の範囲（以降はピクセルごとの範囲判定なし）
+		const int64_t fx = (int64_t)xf.x0 + (int64_t)xf.b * y;
+		const int64_t fy = (int64_t)xf.y0 + (int64_t)xf.d * y;
+		int64_t lo = left, hi = right;
+		clip_span(fx, xf.a, limX, lo, hi);
+		clip_span(fy, xf.c, limY, lo, hi);
+		if (lo >= hi) continue;
+
+		int32_t sx = (int32_t)(fx + (int64_t)xf.a * lo);
+		int32_t sy = (int32_t)(fy + (int64_t)xf.c * lo);
+		uint32_t* out = &dst[(uint32_t)y * dstW];
+		written += (size_t)(hi - lo);
+		if (filter == SPRITE_NEAREST && xf.c == 0) {
+			// 回転が 0°/180°: 行の中で元画像の行が変わらないので、X だけ進める
+			const uint32_t* srow = &src[(uint32_t)(sy >> 16) * srcW];
+			for (int32_t x = (int32_t)lo; x < (int32_t)hi; x++, sx += xf.a) {
+				uint32_t color = srow[(uint32_t)(sx >> 16)];
+				uint32_t nz = 0u - (uint32_t)(color != 0);
+				uint32_t fg = bisReplace ? colorReplace : color;
+				uint32_t bg = isOverlay ? out[x] : 0u;
+				out[x] = (fg & nz) | (bg & ~nz);
+			}
+		} else if (filter == SPRITE_NEAREST) {
+			for (int32_t x = (int32_t)lo; x < (int32_t)hi; x++, sx += xf.a, sy += xf.c) {
+				uint32_t color = src[(uint32_t)(sy >> 16) * srcW + (uint32_t)(sx >> 16)];
+				uint32_t nz = 0u - (uint32_t)(color != 0);
+				uint32_t fg = bisReplace ? colorReplace : color;
+				uint32_t bg = isOverlay ? out[x] : 0u;
+				out[x] = (fg & nz) | (bg & ~nz);
+			}
+		} else {
+			for (int32_t x = (int32_t)lo; x < (int32_t)hi; x++, sx += xf.a, sy += xf.c) {
+				const uint32_t center = src[(uint32_t)(sy >> 16) * srcW + (uint32_t)(sx >> 16)];
+				uint32_t nz = 0u - (uint32_t)(center != 0);
+				uint32_t fg = colorReplace;
+				if (!bisReplace && center != 0) {
+					// 近傍4点（ピクセルの中心を基準）を補間。黒の近傍は中心の色で置き換える
+					const int32_t ux = sx - SPRITE_ONE / 2, uy = sy - SPRITE_ONE / 2;
+					const uint32_t x0 = clamp_index(ux >> 16, srcW), x1 = clamp_index((ux >> 16) + 1, srcW);
+					const uint32_t* r0 = &src[clamp_index(uy >> 16, srcH) * srcW];
+					const uint32_t* r1 = &src[clamp_index((uy >> 16) + 1, srcH) * srcW];
+					const uint32_t p00 = r0[x0] ? r0[x0] : center, p01 = r0[x1] ? r0[x1] : center;
+					const uint32_t p10 = r1[x0] ? r1[x0] : center, p11 = r1[x1] ? r1[x1] : center;
+					const uint32_t wx = ((uint32_t)ux >> 8) & 0xFFu, wy = ((uint32_t)uy >> 8) & 0xFFu;
+					fg = pixelops::px_blend(pixelops::px_blend(p00, p01, wx), pixelops::px_blend(p10, p11, wx), wy);
+				}
+				uint32_t bg = isOverlay ? out[x] : 0u;
+				out[x] = (fg & nz) | (bg & ~nz);
+			}
+		}
+	}
+	return written;
+}
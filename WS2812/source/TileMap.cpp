@@ -0,0 +1,226 @@
+/**
+ * @brief タイルマップ（共有するタイルセット + マスごとの番号）の描画。
+ * @details ハードウェアに依存しない処理のみ（ホストのベンチマークでも同じコードを使います）。
+ */
+#include "TileMap.h"
+
+/** @brief タイル数以上の番号のマスに使う、番号0だけの行（一辺16 * 8bpp まで）。 */
+static const uint8_t kBlankRow[16] = {};
+
+/** @brief 負の数も 0..m-1 に入れる剰余。 @param v 値 @param m 法（正） */
+static inline uint32_t wrap_mod(int64_t v, uint32_t m)
+{
+	int64_t r = v % (int64_t)m;
+	if (r < 0) r += m;
+	return (uint32_t)r;
+}
+
+/**
+ * @brief タイルの1行のうち連続する n 画素を並べます。
+ * @tparam Bpp4 4bpp なら true
+ * @tparam HFlip 左右反転なら true
+ * @param out 描画先
+ * @param src タイルの行の先頭
+ * @param pal パレット
+ * @param fx 最初の画素のタイル内X
+ * @param mask 一辺-1
+ * @param n 画素数
+ * @tparam Overlay 番号0を透明として重ねる
+ */
+template <bool Bpp4, bool HFlip, bool Overlay>
+static inline void put_span(uint32_t* out, const uint8_t* src, const uint32_t* pal, uint32_t fx, uint32_t mask, uint32_t n)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		const uint32_t sx = HFlip ? mask - (fx + i) : fx + i;
+		const uint32_t idx = Bpp4 ? (uint32_t)(src[sx >> 1] >> ((sx & 1u) << 2)) & 0x0Fu : src[sx];
+		if (Overlay && idx == 0) continue;
+		out[i] = pal[idx];
+	}
+}
+
+/** @brief 種類（4bpp/8bpp、左右反転、重ね描き）ごとの put_span。 */
+typedef void (*PutSpanFn)(uint32_t*, const uint8_t*, const uint32_t*, uint32_t, uint32_t, uint32_t);
+static const PutSpanFn kPutSpan[8] = {
+	put_span<false, false, false>, put_span<false, false, true>, put_span<false, true, false>, put_span<false, true, true>,
+	put_span<true, false, false>, put_span<true, false, true>, put_span<true, true, false>, put_span<true, true, true>,
+};
+
+/**
+ * @brief タイルセットの設定が正しいかを確かめます。
+ * @param ts タイルセット
+ * @return 描画できればtrue
+ */
+bool tileset_valid(const TileSet& ts)
+{
+	if (ts.pixels == nullptr || ts.palette == nullptr || ts.tileCount == 0) return false;
+	if (ts.tileSize != 8 && ts.tileSize != 16) return false;
+	if (ts.bitsPerPixel == 8) return true;
+	return ts.bitsPerPixel == 4 && ts.paletteCount >= 1 && ts.paletteCount <= 16;
+}
+
+/**
+ * @brief タイルマップを描画先へ描きます。
+ * @param dst 描画先（0x00GGRRBB）
+ * @param dstW 描画先の幅
+ * @param dstH 描画先の高さ
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @param scrollX 描画先の左端に来るマップのX（一周させる）
+ * @param scrollY 描画先の上端に来るマップのY（一周させる）
+ * @param isOverlay 番号0の画素を透明として重ねる
+ * @param firstRow 描く最初の行
+ * @param rows 描く行数
+ * @return 描いた範囲のピクセル数（透明を含む）
+ */
+size_t tilemap_draw(uint32_t* dst, uint32_t dstW, uint32_t dstH, const TileSet& ts, const TileMap& map, int32_t scrollX, int32_t scrollY,
+                    bool isOverlay, uint32_t firstRow, uint32_t rows)
+{
+	if (dst == nullptr || !tileset_valid(ts) || map.cells == nullptr || map.width == 0 || map.height == 0) return 0;
+	if (firstRow >= dstH || dstW == 0) return 0;
+	const uint32_t endRow = (rows > dstH - firstRow) ? dstH : firstRow + rows;
+
+	const uint32_t shift = ts.tileSize == 16 ? 4u : 3u;
+	const uint32_t mask = ts.tileSize - 1u;
+	const bool bpp4 = ts.bitsPerPixel == 4;
+	const uint32_t rowBytes = bpp4 ? (ts.tileSize >> 1) : ts.tileSize;
+	const uint32_t tileBytes = rowBytes << shift;
+	const uint32_t mapW = (uint32_t)map.width << shift;
+	const uint32_t mapH = (uint32_t)map.height << shift;
+	const uint32_t ox = wrap_mod(scrollX, mapW);
+	uint32_t my = wrap_mod((int64_t)scrollY + firstRow, mapH);
+	const uint32_t kind = (bpp4 ? 4u : 0u) | (isOverlay ? 1u : 0u);
+
+	for (uint32_t y = firstRow; y < endRow; y++) {
+		const uint16_t* cellRow = &map.cells[(size_t)(my >> shift) * map.width];
+		const uint32_t fy = my & mask;
+		uint32_t* out = &dst[(size_t)y * dstW];
+		uint32_t mx = ox;
+		for (uint32_t x = 0; x < dstW;) {
+			const uint32_t fx = mx & mask;
+			uint32_t n = ts.tileSize - fx;
+			if (n > dstW - x) n = dstW - x;
+
+			// マスの切れ目ごとに1回: タイルの行・パレット・反転
+			const uint16_t cell = cellRow[mx >> shift];
+			const uint32_t tile = cell & TILE_INDEX_MASK;
+			const uint32_t r = (cell & TILE_VFLIP) ? mask - fy : fy;
+			const uint8_t* src = (tile < ts.tileCount) ? &ts.pixels[(size_t)tile * tileBytes + r * rowBytes] : kBlankRow;
+			const uint32_t* pal = ts.palette;
+			if (bpp4) {
+				const uint32_t p = (cell & TILE_PALETTE_MASK) >> TILE_PALETTE_SHIFT;
+				if (p < ts.paletteCount) pal += p << 4;
+			}
+			kPutSpan[kind | ((cell & TILE_HFLIP) ? 2u : 0u)](&out[x], src, pal, fx, mask, n);
+
+			x += n;
+			mx += n;
+			if (mx >= mapW) mx -= mapW;
+		}
+		if (++my == mapH) my = 0;
+	}
+	return (size_t)(endRow - firstRow) * dstW;
+}
+
+/**
+ * @brief タイルセットとマップが使うバイト数。
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @return タイルの画素 + パレット + マス のバイト数
+ */
+size_t tilemap_bytes(const TileSet& ts, const TileMap& map)
+{
+	const size_t tileBytes = (size_t)ts.tileSize * ts.tileSize * ts.bitsPerPixel / 8;
+	const size_t colors = ts.bitsPerPixel == 4 ? (size_t)ts.paletteCount * 16 : 256;
+	return tileBytes * ts.tileCount + colors * sizeof(uint32_t) + (size_t)map.width * map.height * sizeof(uint16_t);
+}
+
+/**
+ * @brief 画像の1マスと、作成済みのタイルを（反転込みで）比べます。
+ * @param a 作成済みのタイル（番号）
+ * @param b 画像のマス（番号）
+ * @param size 一辺
+ * @param flags 反転（TILE_HFLIP / TILE_VFLIP）
+ * @return b を flags で反転すると a と同じなら true
+ */
+static bool tile_equal(const uint8_t* a, const uint8_t* b, uint32_t size, uint32_t flags)
+{
+	const uint32_t mask = size - 1;
+	for (uint32_t y = 0; y < size; y++) {
+		const uint32_t sy = (flags & TILE_VFLIP) ? mask - y : y;
+		for (uint32_t x = 0; x < size; x++) {
+			const uint32_t sx = (flags & TILE_HFLIP) ? mask - x : x;
+			if (a[sy * size + sx] != b[y * size + x]) return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief 画像から 8bpp のタイルセットとマップを作ります（PC側のツールやテスト用）。
+ * @return 色が256色以内でタイルが maxTiles に収まればtrue
+ * @details 引数は TileMap.h を参照してください。反転込みの比較はタイル数の2乗に比例するため、実機では使いません。
+ */
+bool tilemap_build(const uint32_t* image, uint32_t width, uint32_t height, uint8_t tileSize, uint8_t* pixels, size_t maxTiles,
+                   uint32_t* palette, uint16_t* cells, TileSet& ts, TileMap& map)
+{
+	if (image == nullptr || pixels == nullptr || palette == nullptr || cells == nullptr) return false;
+	if (tileSize != 8 && tileSize != 16) return false;
+	if (width == 0 || height == 0 || (width % tileSize) != 0 || (height % tileSize) != 0) return false;
+	const uint32_t cols = width / tileSize, rowsN = height / tileSize;
+	if (cols > 0xFFFFu || rowsN > 0xFFFFu) return false;
+	const uint32_t area = (uint32_t)tileSize * tileSize;
+
+	for (uint32_t i = 0; i < 256; i++) palette[i] = 0;
+	uint32_t colors = 1; // 0番は黒（重ねて描くと透明）
+	uint8_t cand[256];
+	size_t tiles = 0;
+	for (uint32_t ty = 0; ty < rowsN; ty++) {
+		for (uint32_t tx = 0; tx < cols; tx++) {
+			// マスを番号にする（新しい色はパレットへ追加）
+			for (uint32_t y = 0; y < tileSize; y++) {
+				for (uint32_t x = 0; x < tileSize; x++) {
+					const uint32_t c = image[(size_t)(ty * tileSize + y) * width + tx * tileSize + x] & 0x00FFFFFFu;
+					uint32_t k = 0;
+					if (c != 0) {
+						for (k = 1; k < colors && palette[k] != c; k++) {}
+						if (k == colors) {
+							if (colors == 256) return false;
+							palette[colors++] = c;
+						}
+					}
+					cand[y * tileSize + x] = (uint8_t)k;
+				}
+			}
+			// 同じタイル（反転込み）を探す
+			static const uint16_t kFlips[4] = {0, TILE_HFLIP, TILE_VFLIP, TILE_HFLIP | TILE_VFLIP};
+			uint16_t cell = 0;
+			bool found = false;
+			for (size_t t = 0; t < tiles && !found; t++) {
+				for (uint16_t f : kFlips) {
+					if (tile_equal(&pixels[t * area], cand, tileSize, f)) {
+						cell = (uint16_t)(t | f);
+						found = true;
+						break;
+					}
+				}
+			}
+			if (!found) {
+				if (tiles >= maxTiles || tiles > TILE_INDEX_MASK) return false;
+				for (uint32_t i = 0; i < area; i++) pixels[tiles * area + i] = cand[i];
+				cell = (uint16_t)tiles++;
+			}
+			cells[(size_t)ty * cols + tx] = cell;
+		}
+	}
+
+	ts.pixels = pixels;
+	ts.palette = palette;
+	ts.tileCount = (uint16_t)tiles;
+	ts.tileSize = tileSize;
+	ts.bitsPerPixel = 8;
+	ts.paletteCount = 1;
+	map.cells = cells;
+	map.width = (uint16_t)cols;
+	map.height = (uint16_t)rowsN;
+	return true;
+}
@@ -0,0 +1,117 @@
+/**
+ * @brief 描画コマンドのトレース。
+ * @details リングバッファへの記録、UART への出力と、その出力の解析（ホストでの再実行用）です。
+ */
+#include <stdio.h>
+#include <string.h>
+#include "TraceRecorder.h"
+
+#if LGM_TRACE_ENABLE
+TraceRecorder g_trace;
+#endif
+
+/**
+ * @brief 1件記録します。
+ * @param op 操作
+ * @param depth スコープの深さ
+ * @param startUs 開始時刻(µs)
+ * @param durUs 所要時間(µs)
+ * @param arg8 引数
+ * @param argA 引数
+ * @param argB 引数
+ * @return なし
+ */
+void TraceRecorder::Record(uint8_t op, uint8_t depth, uint32_t startUs, uint32_t durUs, uint8_t arg8, uint32_t argA, uint32_t argB)
+{
+	TraceRecord& r = m_ring[m_head];
+	r.startUs = startUs;
+	r.dur = EncodeDuration(durUs);
+	r.op = (uint8_t)((op & 0x1Fu) | ((depth > 7 ? 7 : depth) << 5));
+	r.arg8 = arg8;
+	r.argA = argA;
+	r.argB = argB;
+	m_head = (m_head + 1) % TRACE_CAPACITY;
+	if (m_count < TRACE_CAPACITY) {
+		m_count++;
+	} else {
+		m_dropped++;
+	}
+}
+
+/**
+ * @brief 保持している内容を標準出力（UART）へ出力します。
+ * @return なし
+ */
+void TraceRecorder::Dump() const
+{
+	printf(TRACE_DUMP_BEGIN " n=%u dropped=%lu\n", (unsigned)m_count, (unsigned long)m_dropped);
+	for (size_t i = 0; i < m_count; i++) {
+		const TraceRecord& r = At(i);
+		printf(TRACE_DUMP_LINE " %08lx%04x%02x%02x%08lx%08lx\n", (unsigned long)r.startUs, (unsigned)r.dur, (unsigned)r.op,
+		       (unsigned)r.arg8, (unsigned long)r.argA, (unsigned long)r.argB);
+	}
+	printf(TRACE_DUMP_END "\n");
+}
+
+/**
+ * @brief 16進の文字列を数値にします。
+ * @param s 文字列
+ * @param digits 桁数
+ * @param v [out] 値
+ * @return 全て16進数字ならtrue
+ */
+static bool parse_hex(const char* s, int digits, uint32_t& v)
+{
+	v = 0;
+	for (int i = 0; i < digits; i++) {
+		const char c = s[i];
+		uint32_t d;
+		if (c >= '0' && c <= '9') d = (uint32_t)(c - '0');
+		else if (c >= 'a' && c <= 'f') d = (uint32_t)(c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F') d = (uint32_t)(c - 'A' + 10);
+		else return false;
+		v = (v << 4) | d;
+	}
+	return true;
+}
+
+/**
+ * @brief Dump() の1行を解析します。
+ * @param line 1行
+ * @param rec [out] レコード
+ * @return レコード行ならtrue
+ */
+bool TraceRecorder::ParseLine(const char* line, TraceRecord& rec)
+{
+	const size_t tagLen = strlen(TRACE_DUMP_LINE);
+	if (strncmp(line, TRACE_DUMP_LINE, tagLen) != 0 || line[tagLen] != ' ') return false;
+	const char* p = line + tagLen + 1;
+	if (strlen(p) < 32) return false;
+	uint32_t start, dur, op, arg8, argA, argB;
+	if (!parse_hex(p, 8, start) || !parse_hex(p + 8, 4, dur) || !parse_hex(p + 12, 2, op) || !parse_hex(p + 14, 2, arg8) ||
+	    !parse_hex(p + 16, 8, argA) || !parse_hex(p + 24, 8, argB)) {
+		return false;
+	}
+	rec.startUs = start;
+	rec.dur = (uint16_t)dur;
+	rec.op = (uint8_t)op;
+	rec.arg8 = (uint8_t)arg8;
+	rec.argA = argA;
+	rec.argB = argB;
+	return true;
+}
+
+/**
+ * @brief 操作の名前。
+ * @param op 操作
+ * @return 名前
+ */
+const char* TraceRecorder::OpName(uint8_t op)
+{
+	static const char* const names[TRACE_OP_COUNT] = {
+		"?", "state", "wait", "hibernate", "set_char", "stop_frame", "run_frame",
+		"draw_buffer", "scan_buffer", "show_cached", "reset", "clear", "clock",
+		"effect_frame", "film_frame", "draw_tilemap",
+	};
+	return op < TRACE_OP_COUNT ? names[op] : "?";
+}
@@ -2,67 +2,59 @@
  * @brief PIOベースのWS2812送信モジュール。
  * @details
  * - PIOでWS2812(NeoPixel) の1線式プロトコルを生成し、VRAMからフレームを送出します。
- * - PIOプログラムは 1bit=10サイクル設計（T1/T2/T3合算）。SMクロックは 8MHz(=800kHz*10) を目安に分周します。
+ * - PIOプログラムは 1bit=10サイクル設計（T1/T2/T3合算）。SMクロックは 8MHz(=800kHz*10) になるよう clk_sys から分周します。
+ * - 分周は整数部+小数部で正確に計算し、clk_sys を変更したら UpdateClock()（送出停止中なら Resume()）で設定し直します。
  * - データはGRB順の24bit。CPU→PIOはTX FIFOにブロッキング書き込みします。
+ * - SetPackedWire(true) で autopull を32bitにし、GRB のビット列を隙間なく詰めて送ります（4ピクセル = 3語）。
+ * - SetDeltaTransmit(true) で最後に送ったフレームと比べ、送出順で最後に変化したLEDまでだけ送ります（変化がなければ送らない）。
  * - フレーム送出前に Reset()、送出は ScanBuffer()/ScanPanel()、アイドル維持は Keep() を使用します。
  * - VRAMは 0x00GGRRBB 形式。物理配線が千鳥（serpentine）の場合は走査順を調整します。
  * - 高解像・高FPSではDMA化が有効。PIO命令数を改変した場合は分周計算(cycles_per_bit)を合わせてください。
  */
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <new>
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/clocks.h"
+#include "hardware/dma.h"
 #include "WS2812.h"
+#include "WS2812Timing.h"
+#include "TraceRecorder.h"
 #include "ws2812.pio.h" // PIOアセンブリをインクルード（.pio はビルドで .h に生成される想定)
 
-/**
- * @brief WS2812送信用にPIOステートマシンを初期化します。
- *
- * - sideset ピンをデータピンに割り当て
- * - 24bit MSB-first で autopull 有効化
- * - TX FIFO を結合（送信専用）
- * - WS2812の1bitあたりのサイクル数(T1+T2+T3=10)から分周を算出
- *
- * @param pio          使用する PIO (pio0 / pio1)
- * @param sm           使用するステートマシン番号
- * @param offset       プログラムロードオフセット（pico_generate_pio_header 生成ヘッダのオフセット）
- * @param pin          データ出力GPIO番号
- * @param bit_freq_hz  ビットレート(例: 800000.0f)
- */
 /**
  * @brief WS2812送信用にPIOステートマシンを初期化します。
  * @param pio 使用するPIO
  * @param sm ステートマシン番号
  * @param offset プログラムオフセット
  * @param pin データ出力GPIO
- * @param bit_freq_hz ビットレート(例:800kHz)
+ * @param timing 分周設定（ws2812_calc_timing の結果）
+ * @param pullBits autopull のビット数（24: 1ピクセル1語、32: 詰めた送出データ）
  * @return なし
- * @details sidesetピン割当、24bit MSB-first autopull、TX FIFO結合、分周設定を行います。
+ * @details sidesetピン割当、MSB-first autopull、TX FIFO結合、分周設定を行います。
  */
-static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, float bit_freq_hz) {
+static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin, const WS2812Timing& timing, uint pullBits) {
 	// ステートマシン構成:
 	// - sideset: データピンをPIO命令のサイドセットで駆動（タイミングを命令境界で制御）
 	// - set_pins: PIOプログラム内の idle/out0/out1 ループで明示的にレベルを保持するためにも割当
 	// - out_shift: 24bit自動プル（MSBファースト）で、1ピクセル=1回のプルに整合
+	//   32bit自動プルにすると、隙間なく詰めた GRB のビット列をそのまま送れる（プログラムは1bitずつ out するので同じもの）
 	// - FIFO結合: TX側のみ使用し、深いFIFOでCPU側の書き込み負荷を緩和
 	pio_sm_config c = ws2812_program_get_default_config(offset);
 	sm_config_set_sideset_pins(&c, pin);
 	// 'set' 命令経由でもデータピンを直接操作できるようマッピング
 	sm_config_set_set_pins(&c, pin, 1);
-	sm_config_set_out_shift(&c, false, true, 24); // MSB first, autopull 24-bit
+	sm_config_set_out_shift(&c, false, true, pullBits); // MSB first, autopull 24/32-bit
 	sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_TX);
 	pio_gpio_init(pio, pin);
 	pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, true);
 
 	// タイミング設定:
-	// - PIOプログラム側の1bitシーケンスは合計10サイクル設計（例: T1=3, T2=3, T3=4 など）
-	// - 目標ビットレート bit_freq_hz（通常 800kHz）から SMクロック=bit*10 を算出
-	// - clk_sys を分周して SMクロックを生成
-	const float cycles_per_bit = 10.0f;
-	float sm_clk = bit_freq_hz * cycles_per_bit; // 800kHz * 10 = 8MHz
-	float div = (float)clock_get_hz(clk_sys) / sm_clk;
-	sm_config_set_clkdiv(&c, div);
+	// - PIOプログラム側の1bitシーケンスは合計10サイクル設計（T1+T2+T3）
+	// - 分周は clk_sys から整数部+小数部(1/256)で事前に計算済み（clk_sys が変わったら計算し直す）
+	sm_config_set_clkdiv_int_frac(&c, timing.divInt, timing.divFrac);
 
 	pio_sm_init(pio, sm, offset, &c);
 	pio_sm_set_enabled(pio, sm, true);
@@ -88,8 +80,33 @@ static inline void ws2812_program_init(PIO pio, uint sm, uint offset, uint pin,
  * @param a_xPanelCount パネル数(横)
  * @param a_yPanelCount パネル数(縦)
  */
-WS2812::WS2812(uint8_t pin,uint8_t a_xSize, uint8_t a_ySize , uint8_t a_xPanelCount,uint8_t a_yPanelCount) 
-	: m_pin(pin) , xSize(a_xSize), ySize(a_ySize), xPanelCount(a_xPanelCount), yPanelCount(a_yPanelCount)
+WS2812::WS2812(uint8_t pin,uint16_t a_xSize, uint16_t a_ySize , uint16_t a_xPanelCount,uint16_t a_yPanelCount) 
+	: LedCanvas((uint32_t)a_xSize * a_xPanelCount, (uint32_t)a_ySize * a_yPanelCount), m_pin(pin) , m_bitHz(800000), m_wireCache(WS2812_WIRE_CACHE_BYTES), m_tileWire(nullptr), m_tileWireWords(0), m_cal{nullptr, nullptr}, m_packed(false), m_fifoAcc(0), m_fifoBits(0), m_delta(false), m_latchPending(false), m_shownValid(false), m_shownWire(nullptr), m_shownWords(0), m_deltaStats{}, xSize(a_xSize), ySize(a_ySize), xPanelCount(a_xPanelCount), yPanelCount(a_yPanelCount)
+{
+	InitHardware();
+}
+
+/**
+ * @brief コンストラクタ。VRAMに呼び出し側のメモリを使います（WS2812Static 用）。
+ * @param vram VRAM（(a_xSize*a_xPanelCount)*(a_ySize*a_yPanelCount) 要素。所有権は呼び出し側に残り、このオブジェクトより長く保持すること）
+ * @param pin データ出力GPIO
+ * @param a_xSize パネル幅
+ * @param a_ySize パネル高
+ * @param a_xPanelCount パネル数(横)
+ * @param a_yPanelCount パネル数(縦)
+ * @details 差分送出・送出データキャッシュ・行ごとの送出の領域は、もう一方のコンストラクタと同じくヒープに確保します。
+ */
+WS2812::WS2812(uint32_t* vram, uint8_t pin, uint16_t a_xSize, uint16_t a_ySize, uint16_t a_xPanelCount, uint16_t a_yPanelCount)
+	: LedCanvas(vram, (uint32_t)a_xSize * a_xPanelCount, (uint32_t)a_ySize * a_yPanelCount), m_pin(pin) , m_bitHz(800000), m_wireCache(WS2812_WIRE_CACHE_BYTES), m_tileWire(nullptr), m_tileWireWords(0), m_cal{nullptr, nullptr}, m_packed(false), m_fifoAcc(0), m_fifoBits(0), m_delta(false), m_latchPending(false), m_shownValid(false), m_shownWire(nullptr), m_shownWords(0), m_deltaStats{}, xSize(a_xSize), ySize(a_ySize), xPanelCount(a_xPanelCount), yPanelCount(a_yPanelCount)
+{
+	InitHardware();
+}
+
+/**
+ * @brief PIO/SMと送出用DMAを初期化します（コンストラクタ共通）。
+ * @return なし
+ */
+void WS2812::InitHardware()
 {
 	// PIOプログラムのロードとSM確保:
 	// - pio0 を使用。空きSMを強制確保（true指定: 見つからない場合はpanic）。
@@ -98,20 +115,40 @@ WS2812::WS2812(uint8_t pin,uint8_t a_xSize, uint8_t a_ySize , uint8_t a_xPanelCo
 	m_offset = pio_add_program(m_pio, &ws2812_program);
 	m_sm = pio_claim_unused_sm(m_pio, true);
 	// 送信タイミング初期化: 800kHz（T=1.25us）に分周設定
-	ws2812_program_init(m_pio, m_sm, m_offset, m_pin, 800000.0f);
+	ws2812_calc_timing(clock_get_hz(clk_sys), m_bitHz, WS2812_CYCLES_PER_BIT, ws2812_T1, ws2812_T2, m_timing);
+	ws2812_program_init(m_pio, m_sm, m_offset, m_pin, m_timing, 24);
 
-	// VRAM割り当て:
-	// - 総画素数 = (xSize*xPanelCount) * (ySize*yPanelCount)
-	// - 1画素=24bit(実メモリは32bit)のGRB。0x00GGRRBB 形式で保持。
-	// - メモリ使用量は画素数*4バイト。高解像度ではヒープを圧迫する点に注意。
-	xVRam = xSize * xPanelCount; // VRAMのXサイズ
-	yVRam = ySize * yPanelCount; // VRAMのYサイズ
-	pVRam = new uint32_t[xVRam * yVRam];
-	for (uint32_t i = 0; i < xVRam * yVRam; i++) pVRam[i] = 0;
+	// VRAM（(xSize*xPanelCount) * (ySize*yPanelCount) 画素、0x00GGRRBB）は LedCanvas が確保済み
+
+	// 送出用DMA: 32bit単位でメモリ→PIO TX FIFO。FIFOの空き(DREQ)に合わせて転送する
+	m_dmaChan = dma_claim_unused_channel(true);
+	dma_channel_config dc = dma_channel_get_default_config(m_dmaChan);
+	channel_config_set_transfer_data_size(&dc, DMA_SIZE_32);
+	channel_config_set_read_increment(&dc, true);
+	channel_config_set_write_increment(&dc, false);
+	channel_config_set_dreq(&dc, pio_get_dreq(m_pio, m_sm, true));
+	dma_channel_configure(m_dmaChan, &dc, &m_pio->txf[m_sm], NULL, 0, false);
 
 
 }
 
+/**
+ * @brief デストラクタ。送出データの領域とハードウェア資源を返します。
+ * @details DMAが m_tileWire や送出データキャッシュを読んでいる間は解放できないので、先に完了を待ちます。
+ *          VRAM は LedCanvas が解放します（呼び出し側のメモリなら解放しません）。
+ */
+WS2812::~WS2812()
+{
+	WaitTransmit();
+	while (!pio_sm_is_tx_fifo_empty(m_pio, m_sm)) tight_loop_contents();
+	pio_sm_set_enabled(m_pio, m_sm, false);
+	dma_channel_unclaim(m_dmaChan);
+	pio_sm_unclaim(m_pio, m_sm);
+	pio_remove_program(m_pio, &ws2812_program, m_offset);
+	delete[] m_tileWire;
+	delete[] m_shownWire;
+}
+
 
 
 /**
@@ -128,12 +165,29 @@ WS2812::WS2812(uint8_t pin,uint8_t a_xSize, uint8_t a_ySize , uint8_t a_xPanelCo
  * @details SM再起動→out0へJMP→待機→先頭へ復帰の順で実現します。
  */
 void WS2812::Reset() {
+	FlushWire(); // 直接送った詰めた送出データの端数
+	if (m_delta) {
+		m_latchPending = true; // 送らないフレームではラッチしない（LEDは前の色を保持）
+		return;
+	}
+	Latch();
+}
+
+/**
+ * @brief リセットラッチ（>50us Low）を出力します（Reset() の本体）。
+ * @return なし
+ */
+void WS2812::Latch()
+{
+	LGM_TRACE_SCOPE(TRACE_RESET);
 	// 送信前ラッチ手順:
 	// 1) SMを停止→FIFOクリア→リスタートで内部状態を既知化
 	// 2) out0ループへJMPし、ラインをLowで維持（>50us）
 	// 3) プログラム先頭へ戻して通常送信ループに復帰
 	//
 	// WS2812の仕様上、リセットラッチはおおむね 50µs 以上が必要。本実装は80µsを確保。
+	FlushWire(); // 詰めた送出データの端数を書き出す（SMの再起動で次のフレームは語の先頭から）
+	WaitTransmit(); // DMA送出中ならFIFOへ渡し終えるまで待つ
 	sleep_us(500); // 前フレーム終端からの安全マージン
 	pio_sm_set_enabled(m_pio, m_sm, false);
 	pio_sm_clear_fifos(m_pio, m_sm);
@@ -148,6 +202,18 @@ void WS2812::Reset() {
 	pio_sm_set_enabled(m_pio, m_sm, true);
 
 }
+
+/**
+ * @brief 遅らせていたリセットラッチを出力します。
+ * @return なし
+ * @details 呼び出し側の WaitAfterReset() はラッチの前に待たずに戻っているので、ここで安全待ちをします。
+ */
+void WS2812::LatchPending()
+{
+	m_latchPending = false;
+	Latch();
+	sleep_us(100); // リセット直後の安全待ち（WaitAfterReset() の分）
+}
 /**
  * @brief アイドル時の High 出力を維持します。
  *
@@ -164,6 +230,56 @@ void WS2812::Keep()
 	// - SMを無効化するとPIO制御が解けるため、状態保持は保証されない点に注意。
 	pio_sm_exec(m_pio, m_sm, pio_encode_jmp(m_offset + ws2812_offset_idle));
 }
+/**
+ * @brief 休止に備えて送出を停止します。
+ * @return なし
+ * @details
+ * - TX FIFO が空になるまで待ち、最後のピクセル（24bit=30µs）の送出完了分を待ちます。
+ * - out0 ループでラインを Low にしてからSMを停止します（停止中もピンは最後のレベルを保持）。
+ * - クロック変更の前に呼び出してください。
+ */
+void WS2812::Suspend()
+{
+	FlushWire();
+	WaitTransmit();
+	while (!pio_sm_is_tx_fifo_empty(m_pio, m_sm)) tight_loop_contents();
+	sleep_us(50);
+	pio_sm_exec(m_pio, m_sm, pio_encode_jmp(m_offset + ws2812_offset_out0));
+	sleep_us(5);
+	pio_sm_set_enabled(m_pio, m_sm, false);
+}
+/**
+ * @brief 休止から復帰します。
+ * @return 現在の clk_sys から分周を求められたらtrue
+ * @details
+ * - clk_sys の変更後に呼び出してください。SMを初期化し直すことで分周を現在のクロックに合わせます。
+ * - 分周器の範囲外の場合は、最後に求められた分周（GetTiming()）のままSMを再開します。
+ */
+bool WS2812::Resume()
+{
+	WS2812Timing t;
+	const bool ok = ws2812_calc_timing(clock_get_hz(clk_sys), m_bitHz, WS2812_CYCLES_PER_BIT, ws2812_T1, ws2812_T2, t);
+	if (ok) m_timing = t;
+	ws2812_program_init(m_pio, m_sm, m_offset, m_pin, m_timing, m_packed ? 32 : 24);
+	Reset();
+	return ok;
+}
+/**
+ * @brief 現在の clk_sys に合わせてPIOの分周を設定し直します。
+ * @return 分周器の範囲内で、誤差が WS2812_MAX_ERROR_PPM 以内ならtrue
+ * @details
+ * - 送出中に呼ぶとそのピクセルのタイミングが崩れるため、FIFOが空の間（フレーム間）に呼び出してください。
+ * - 範囲外の場合は分周も GetTiming() も変更しません（最後に求められた分周のまま）。設定した分周は GetTiming() で確認できます。
+ */
+bool WS2812::UpdateClock()
+{
+	WS2812Timing t;
+	if (!ws2812_calc_timing(clock_get_hz(clk_sys), m_bitHz, WS2812_CYCLES_PER_BIT, ws2812_T1, ws2812_T2, t)) return false;
+	m_timing = t;
+	pio_sm_set_clkdiv_int_frac(m_pio, m_sm, t.divInt, t.divFrac);
+	pio_sm_clkdiv_restart(m_pio, m_sm);
+	return t.errorPpm <= WS2812_MAX_ERROR_PPM && t.errorPpm >= -WS2812_MAX_ERROR_PPM;
+}
 /**
  * @brief 1ピクセル分の GRB データを即時送信します（ブロッキング）。
  * @param r 赤(0-255)
@@ -184,7 +300,7 @@ void WS2812::setColorDirect(uint8_t r, uint8_t g, uint8_t b) {
 	// - 32bit FIFOの上位24bitに詰めるため <<8 して送る。
 	// - FIFOが満杯の場合は空くまで待つ。
 	uint32_t grb = ((uint32_t)g << 16) | ((uint32_t)r << 8) | b;
-	pio_sm_put_blocking(m_pio, m_sm, grb << 8); // 24bitを左寄せ（PIO側はautopull 24bit）
+	PutWire(grb << 8); // 24bitを左寄せ（PIO側はautopull 24bit。詰める場合は PutWire で32bitにまとめる）
 }
 /**
  * @brief 24bit GRB 値を即時送信します（ブロッキング）。
@@ -198,7 +314,44 @@ void WS2812::setColorDirect(uint8_t r, uint8_t g, uint8_t b) {
 void WS2812::setColorDirect(uint32_t c)
 {
 	// 入力形式: 0x00GGRRBB（上位8bit未使用）。左へ8bitシフトして上位24bitに配置。
-	pio_sm_put_blocking(m_pio, m_sm, c << 8); // 24bitを左寄せ（PIO側はautopull 24bit）
+	PutWire(c << 8); // 24bitを左寄せ（PIO側はautopull 24bit。詰める場合は PutWire で32bitにまとめる）
+}
+
+/**
+ * @brief 送出データ1ピクセル分をFIFOへ書きます（ブロッキング）。
+ * @param w 送出データ（c<<8）
+ * @return なし
+ * @details 詰める場合は WirePacker と同じ並びで、32bit たまるごとに1語書きます。
+ */
+void WS2812::PutWire(uint32_t w)
+{
+	if (m_delta) {
+		if (m_latchPending) LatchPending();
+		m_shownValid = false; // 直接送ったLEDの状態は記録しない
+	}
+	if (!m_packed) {
+		pio_sm_put_blocking(m_pio, m_sm, w);
+		return;
+	}
+	if (m_fifoBits == 0) {
+		m_fifoAcc = w;
+		m_fifoBits = 24;
+		return;
+	}
+	pio_sm_put_blocking(m_pio, m_sm, m_fifoAcc | (w >> m_fifoBits));
+	m_fifoAcc = w << (32u - m_fifoBits);
+	m_fifoBits -= 8;
+}
+
+/**
+ * @brief 詰めた送出データの端数をFIFOへ書きます。
+ * @return なし
+ */
+void WS2812::FlushWire()
+{
+	if (m_fifoBits == 0) return;
+	pio_sm_put_blocking(m_pio, m_sm, m_fifoAcc);
+	m_fifoBits = 0;
 }
 /**
  * @brief テスト用にランダム色を1ピクセル送信します。
@@ -221,39 +374,6 @@ void WS2812::fillRandomColorDirect() {
 	setColorDirect(r, g, b);
 }
 
-/**
- * @brief VRAM全体を指定色で塗りつぶします。
- * @param rgb 24bit GRB カラー
- */
-/**
- * @brief VRAM全体を指定色で塗りつぶします。
- * @param rgb 0x00GGRRBB
- * @return なし
- */
-void WS2812::Clear(uint32_t rgb)
-{
-	// VRAM全体を1色で初期化。描画のベース色や消去に使用。
-	for (uint32_t i = 0; i < xVRam * yVRam; ++i) pVRam[i] = rgb;
-}
-/**
- * @brief 指定座標のピクセルを設定します（VRAMのみ）。
- * @param x X座標（0..xVRam-1）
- * @param y Y座標（0..yVRam-1）
- * @param rgb 24bit GRB カラー
- */
-/**
- * @brief 指定座標のピクセル値を設定します（VRAMのみ）。
- * @param x X座標
- * @param y Y座標
- * @param rgb 0x00GGRRBB
- * @return なし
- */
-void WS2812::SetPixel(uint16_t x, uint16_t y, uint32_t rgb)
-{
-	// 範囲内なら1画素だけ更新（VRAM）。送信は行わない。
-	if (x < xVRam && y < yVRam) pVRam[y * xVRam + x] = rgb;
-}
-
 /**
  * @brief 1パネル分のデータを送信します（VRAM→PIO）。
  * @param posX パネル左上のVRAM X座標
@@ -267,26 +387,43 @@ void WS2812::SetPixel(uint16_t x, uint16_t y, uint32_t rgb)
  * @param leftToRight 偶数行の基準方向
  * @return なし
  */
-void WS2812::ScanPanel(uint8_t posX, uint8_t posY, bool serpentine, bool leftToRight)
+void WS2812::ScanPanel(uint16_t posX, uint16_t posY, bool serpentine, bool leftToRight)
 {
 	// 1パネル走査:
+	// - DMA送出中なら完了を待ってから（FIFOへの書き込み順を保つ）
+	WaitTransmit();
 	// - 左上(posX,posY)原点から行優先でVRAMを読み、24bitピクセルを連続送信。
 	// - 物理が千鳥配線（偶数行/奇数行で左右反転）の場合は、
 	//   yが奇数のとき x の走査方向を反転する。
-	for (uint8_t y = 0; y < ySize; ++y) {
+	// - 色補正が有効なら、パネルの行列とLEDの明るさ（送出順の位置）を掛けてから送る。
+	// - 座標とループは32bit（パネルの幅や VRAM の幅が255を超えてもよい）。
+	if (IsCalibrated()) {
+		const uint32_t panel = (uint32_t)(posY / ySize) * xPanelCount + posX / xSize;
+		const LedColorMatrix* m = m_cal.panelMatrix ? &m_cal.panelMatrix[panel] : nullptr;
+		const uint8_t* gain = m_cal.ledGain ? &m_cal.ledGain[(size_t)panel * xSize * ySize] : nullptr;
+		for (uint32_t y = 0; y < ySize; ++y) {
+			bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+			const uint32_t* row = &pVRam[(size_t)(posY + y) * xVRam + posX];
+			for (uint32_t i = 0; i < xSize; ++i) {
+				uint32_t color = row[l2r ? i : xSize - 1u - i];
+				setColorDirect(ledcal_apply(color, m, gain ? *gain++ : LEDCAL_GAIN_UNITY));
+			}
+		}
+		return;
+	}
+	for (uint32_t y = 0; y < ySize; ++y) {
 		// 偶数行の基準方向: leftToRight
 		bool baseL2R = leftToRight;
 		// 千鳥配線なら奇数行で左右反転
 		bool l2r = serpentine ? ((y & 1u) ? !baseL2R : baseL2R) : baseL2R;
+		const uint32_t* row = &pVRam[(size_t)(posY + y) * xVRam + posX];
 		if (l2r) {
-			for (uint8_t x = 0; x < xSize; ++x) {
-				uint32_t color = pVRam[(posY + y) * xVRam + (posX + x)];
-				setColorDirect(color);
+			for (uint32_t x = 0; x < xSize; ++x) {
+				setColorDirect(row[x]);
 			}
 		} else {
-			for (int8_t x = (int8_t)xSize - 1; x >= 0; --x) {
-				uint32_t color = pVRam[(posY + y) * xVRam + (posX + (uint8_t)x)];
-				setColorDirect(color);
+			for (uint32_t x = xSize; x > 0; --x) {
+				setColorDirect(row[x - 1]);
 			}
 		}
 	}
@@ -305,19 +442,19 @@ void WS2812::ScanPanel(uint8_t posX, uint8_t posY, bool serpentine, bool leftToR
  * @param rgb 0x00GGRRBB
  * @return なし
  */
-void WS2812::DrawPanelBorder(uint8_t panelX, uint8_t panelY, uint32_t rgb)
+void WS2812::DrawPanelBorder(uint16_t panelX, uint16_t panelY, uint32_t rgb)
 {
 	if (panelX >= xPanelCount || panelY >= yPanelCount) return;
-	uint16_t baseX = panelX * xSize;
-	uint16_t baseY = panelY * ySize;
+	uint32_t baseX = (uint32_t)panelX * xSize;
+	uint32_t baseY = (uint32_t)panelY * ySize;
 
 	// 外枠描画: 上下辺（幅xSize）を走査
-	for (uint8_t x = 0; x < xSize; ++x) {
+	for (uint32_t x = 0; x < xSize; ++x) {
 		pVRam[(baseY + 0) * xVRam + (baseX + x)] = rgb;                 // 上
 		pVRam[(baseY + (ySize - 1)) * xVRam + (baseX + x)] = rgb;       // 下
 	}
 	// 外枠描画: 左右辺（高さySize）を走査
-	for (uint8_t y = 0; y < ySize; ++y) {
+	for (uint32_t y = 0; y < ySize; ++y) {
 		pVRam[(baseY + y) * xVRam + (baseX + 0)] = rgb;                 // 左
 		pVRam[(baseY + y) * xVRam + (baseX + (xSize - 1))] = rgb;       // 右
 	}
@@ -339,12 +476,12 @@ void WS2812::DrawRandomBorders()
 	auto rnd = [&]() {
 		s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; };
 
-	for (uint8_t py = 0; py < yPanelCount; ++py) {
+	for (uint32_t py = 0; py < yPanelCount; ++py) {
 		uint8_t r = (uint8_t)(rand() % 2 + 1);
 		uint8_t g = (uint8_t)(rand() % 2 + 1);
 		uint8_t b = (uint8_t)(rand() % 2 + 1);
 
-		for (uint8_t px = 0; px < xPanelCount; ++px) {
+		for (uint32_t px = 0; px < xPanelCount; ++px) {
 			uint32_t grb = ((uint32_t)g << 16) | ((uint32_t)r << 8) | b;
 			DrawPanelBorder(px, py, grb);
 		}
@@ -352,69 +489,426 @@ void WS2812::DrawRandomBorders()
 }
 
 /**
- * @brief 任意のパターン配列をVRAMにブレンド/置換して描画します。
- * @param pattern 0x00GGRRBB配列（width*height）
- * @param width パターン幅
- * @param height パターン高さ
- * @param X VRAM貼り付け先 左上X
- * @param y VRAM貼り付け先 左上Y
- * @param colorReplace 置換色（0で無効）
- * @param isOverlay 黒を透明扱い
+ * @brief 全パネルを走査してフレームを送信します（VRAM→PIO）。
+ *
+ * 左上から右下へパネル順に送信します。
+ *
+ */
+/**
+ * @brief 全パネルを走査してVRAMからフレームを送信します。
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
  * @return なし
- * @details colorReplace!=0 の場合は非0画素を置換色で塗り、0画素は isOverlay に応じて透過/黒上書きします。
  */
-void WS2812::DrawBuffer(const uint32_t pattern[], uint8_t width, uint8_t height, uint8_t X, uint8_t y,uint32_t colorReplace,bool isOverlay)
+void WS2812::ScanBuffer(bool serpentine, bool leftToRight)
 {
-	bool bisReplace = colorReplace != 0x0;
+	// 全パネル走査（行優先）:
+	// - Reset() 直後に呼ぶ想定。安全余裕の待ち時間を確保してから送信開始。
+	// - VRAMが大きい場合と、変化したLEDまでだけ送る場合は、パネルの行単位で送出データへ変換してDMAでFIFOへ連搬する（ScanTiles）。
+	// - 作業領域を確保できなければ、パネルごとにCPUでFIFOへすべて送る。
+	LGM_TRACE_SCOPE(TRACE_SCAN_BUFFER, WireTag(serpentine, leftToRight));
+	if ((m_delta || yPanelCount > TileRows()) && ScanTiles(serpentine, leftToRight)) return;
+	sleep_us(100); // 直前のリセットからの安全待ち（環境に合わせて最適化可）
+	for (uint32_t y = 0; y < yPanelCount; y++) {
+		for (uint32_t x = 0; x < xPanelCount; x++) {
+			ScanPanel((uint16_t)(x * xSize), (uint16_t)(y * ySize), serpentine, leftToRight); // パネルごとにデータを送信
+		}
+	}
+	FlushWire(); // 詰めた送出データの端数
+}
 
-	for (uint8_t py = 0; py < height; ++py) {
-		for (uint8_t px = 0; px < width; ++px) {
-			uint32_t color = pattern[py * width + px];
-			if (bisReplace) {
-				if (color != 0x000000) {
-					SetPixel(X + px, y + py, colorReplace/* 0x0F0001*/);
-				} else {
-					if (isOverlay == false) {
-						SetPixel(X + px, y + py, 0);
+/**
+ * @brief 1回に変換して送るパネルの行数を求めます。
+ * @return パネルの行数（1..yPanelCount）
+ * @details 約 WS2812_TILE_PIXELS ピクセルになる行数です。詰めた送出データで語の境界がそろうよう、ピクセル数を4の倍数にします。
+ */
+uint32_t WS2812::TileRows() const
+{
+	const size_t rowPixels = (size_t)xVRam * ySize;
+	uint32_t rows = (uint32_t)(WS2812_TILE_PIXELS / rowPixels);
+	if (rows == 0) rows = 1;
+	while ((rows * rowPixels) & 3u) rows++; // 多くても4行
+	return rows < yPanelCount ? rows : yPanelCount;
+}
+
+/**
+ * @brief パネルの行の先頭の、送出データでの位置を求めます。
+ * @param panelRow パネルの行（TileRows() の倍数か yPanelCount）
+ * @return 語の位置（詰める場合は WIRE_PACK_WORDS。区画の境界は4ピクセルの倍数なので割り切れる）
+ */
+size_t WS2812::TileOffset(uint32_t panelRow) const
+{
+	const size_t pixels = (size_t)panelRow * xVRam * ySize;
+	return m_packed ? WIRE_PACK_WORDS(pixels) : pixels;
+}
+
+/**
+ * @brief パネルの行ごとの送出データの領域を返します（初回に確保）。
+ * @return 領域（確保できなければ nullptr）
+ * @details 区画が1つなら1区画分、2つ以上なら2区画分です（詰めない場合の大きさ）。
+ */
+uint32_t* WS2812::TileWire()
+{
+	if (m_tileWire != nullptr) return m_tileWire;
+	const uint32_t rows = TileRows();
+	const size_t words = (size_t)rows * xVRam * ySize * (yPanelCount > rows ? 2u : 1u);
+	m_tileWire = new (std::nothrow) uint32_t[words];
+	m_tileWireWords = m_tileWire ? words : 0;
+	return m_tileWire;
+}
+
+/**
+ * @brief パネルの行をいくつかずつ送出データへ変換し、DMAで送ります。
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return 作業領域を確保できず、送らなかった場合は false
+ * @details
+ * - 送出データの領域は2つ（TileRows() 行分ずつ）だけで、VRAMの大きさによりません。
+ * - 一方をDMAで送っている間に、もう一方へ次の行を変換します（変換と送出が重なる）。
+ * - 送る語列は EncodeWire() と同じです。最後の行のDMAは待たずに戻ります。
+ * - 変化したLEDまでだけ送る場合は、DeltaTiles() で送る語数を決めてから、先頭からその語数だけを送ります。
+ */
+bool WS2812::ScanTiles(bool serpentine, bool leftToRight)
+{
+	const uint32_t rows = TileRows();
+	const size_t tileWords = (size_t)rows * xVRam * ySize; // 詰めない場合の大きさ
+	WaitTransmit(); // 送出中の領域を書き換えない
+	uint32_t* const wire = TileWire();
+	if (wire == nullptr) return false;
+	size_t send = WireWords();
+	bool firstEncoded = false; // 先頭の区画を1つ目の領域に変換済み
+	if (m_delta) {
+		send = DeltaTiles(wire, rows, serpentine, leftToRight, firstEncoded);
+		if (send == 0) return true; // 変化なし: リセットラッチも送出もしない
+	}
+	WaitAfterReset();
+	if (m_latchPending) LatchPending();
+	size_t sent = 0;
+	for (uint32_t py = 0, k = 0; py < yPanelCount && sent < send; py += rows, k ^= 1u) {
+		uint32_t* tile = wire + k * tileWords;
+		const uint32_t n = yPanelCount - py < rows ? yPanelCount - py : rows;
+		size_t words = TileOffset(py + n) - sent;
+		if (py != 0 || !firstEncoded) EncodeWireRows(tile, serpentine, leftToRight, py, n);
+		if (words > send - sent) words = send - sent;
+		if (m_delta) memcpy(m_shownWire + sent, tile, words * sizeof(uint32_t)); // LEDが受け取る語を記録
+		WaitTransmit(); // 前の行（もう一方の領域）のDMA
+		dma_channel_transfer_from_buffer_now(m_dmaChan, tile, words);
+		sent += words;
+	}
+	return true;
+}
+
+/**
+ * @brief 最後に送ったフレームと比べ、ScanTiles() で送る語数を決めます。
+ * @param tile 1つ目の区画の領域
+ * @param rows 1区画のパネルの行数
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @param firstEncoded [out] 先頭の区画を tile に変換したまま残していれば true
+ * @return 送る語数（0なら送らない）
+ * @details DeltaWords() と同じく後ろから比べます。後ろの区画から1つずつ変換し、変化した語が見つかった区画で止めます。
+ */
+size_t WS2812::DeltaTiles(uint32_t* tile, uint32_t rows, bool serpentine, bool leftToRight, bool& firstEncoded)
+{
+	const size_t full = WireWords();
+	m_deltaStats.frames++;
+	m_deltaStats.wordsFull += full;
+	size_t n = full;
+	if (m_shownValid) {
+		n = 0;
+		for (uint32_t py = (yPanelCount - 1) / rows * rows;; py -= rows) {
+			const uint32_t cnt = yPanelCount - py < rows ? yPanelCount - py : rows;
+			const size_t offset = TileOffset(py);
+			size_t i = EncodeWireRows(tile, serpentine, leftToRight, py, cnt);
+			firstEncoded = py == 0;
+			while (i > 0 && tile[i - 1] == m_shownWire[offset + i - 1]) i--;
+			if (i > 0) {
+				n = offset + i;
+				break;
+			}
+			if (py == 0) break;
+		}
+		if (n == 0) {
+			m_deltaStats.skipped++;
+			return 0;
+		}
+		if (m_packed) {
+			n = (n + 2) / 3 * 3;
+			if (n > full) n = full;
+		}
+		if (n < full) m_deltaStats.partial++;
+	}
+	m_shownValid = true; // ScanTiles() が送る語を m_shownWire へ記録する（後ろは前のフレームと同じ）
+	m_deltaStats.wordsSent += n;
+	return n;
+}
+
+/**
+ * @brief VRAMを送出順の語列に変換します。
+ * @param dst 出力（xVRam*yVRam 語）
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return なし
+ */
+void WS2812::EncodeWire(uint32_t* dst, bool serpentine, bool leftToRight) const
+{
+	EncodeWireRows(dst, serpentine, leftToRight, 0, yPanelCount);
+}
+
+/**
+ * @brief VRAMのパネルの行を送出順の語列に変換します。
+ * @param dst 出力
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @param firstPanelRow 最初のパネルの行
+ * @param panelRows パネルの行数
+ * @return 出力した語数
+ * @details ScanBuffer() と同じ順（パネルは左上→右下、パネル内は行優先）で、FIFOへ書く値（c<<8）を並べます。
+ *          色補正が有効なら、並べるときに行ごとに掛けます（VRAMを別に走査しない）。
+ *          詰める場合は行を小分けに変換しながら WirePacker で詰めます（1ピクセル1語の語列は作らない）。
+ */
+size_t WS2812::EncodeWireRows(uint32_t* dst, bool serpentine, bool leftToRight, uint32_t firstPanelRow, uint32_t panelRows) const
+{
+	uint32_t* const begin = dst;
+	const uint32_t endRow = firstPanelRow + panelRows;
+	if (IsCalibrated() || m_packed) {
+		const uint8_t* gain = m_cal.ledGain ? m_cal.ledGain + (size_t)firstPanelRow * xVRam * ySize : nullptr;
+		WirePacker pk;
+		pk.begin(dst);
+		for (uint32_t py = firstPanelRow; py < endRow; py++) {
+			for (uint32_t px = 0; px < xPanelCount; px++) {
+				const LedColorMatrix* m = m_cal.panelMatrix ? &m_cal.panelMatrix[py * xPanelCount + px] : nullptr;
+				for (uint32_t y = 0; y < ySize; ++y) {
+					bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+					const uint32_t* row = &pVRam[(size_t)(py * ySize + y) * xVRam + px * xSize];
+					const int step = l2r ? 1 : -1;
+					const uint32_t* src = l2r ? row : row + xSize - 1;
+					if (!m_packed) {
+						ledcal_encode_row(src, step, dst, xSize, m, gain);
+						dst += xSize;
+					} else if (!IsCalibrated() && (xSize & 3u) == 0) {
+						pk.dst = wire_pack_pixels(pk.dst, src, step, xSize); // 行ごとに語の境界がそろう
+					} else {
+						uint32_t chunk[32]; // スタックを使いすぎないよう、32ピクセルずつ
+						for (uint32_t i = 0; i < xSize; i += 32) {
+							const uint32_t n = xSize - i < 32u ? xSize - i : 32u;
+							ledcal_encode_row(src + step * (int)i, step, chunk, n, m, gain ? gain + i : nullptr);
+							pk.putRow(chunk, n);
+						}
 					}
+					if (gain) gain += xSize;
 				}
-			} else {
-				if (isOverlay== false) {
-					SetPixel(X + px, y + py, color);
+			}
+		}
+		if (m_packed) dst = pk.finish();
+		return (size_t)(dst - begin);
+	}
+	for (uint32_t py = firstPanelRow; py < endRow; py++) {
+		for (uint32_t px = 0; px < xPanelCount; px++) {
+			const uint32_t posX = px * xSize;
+			const uint32_t posY = py * ySize;
+			for (uint32_t y = 0; y < ySize; ++y) {
+				bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+				const uint32_t* row = &pVRam[(size_t)(posY + y) * xVRam + posX];
+				if (l2r) {
+					for (uint32_t x = 0; x < xSize; ++x) *dst++ = row[x] << 8;
 				} else {
-					if (color != 0x000000) {
-						SetPixel(X + px, y + py, color);
-					} else {
-					}
+					for (uint32_t x = xSize; x > 0; --x) *dst++ = row[x - 1] << 8;
 				}
 			}
 		}
 	}
+	return (size_t)(dst - begin);
 }
 
 /**
- * @brief 全パネルを走査してフレームを送信します（VRAM→PIO）。
- *
- * 左上から右下へパネル順に送信します。
- *
+ * @brief 語列をDMAで送出します（待たない）。
+ * @param words 語列
+ * @param count 語数
+ * @return なし
  */
+void WS2812::TransmitWire(const uint32_t* words, size_t count)
+{
+	if (m_delta) {
+		count = DeltaWords(words, count);
+		if (count == 0) return; // 変化なし: リセットラッチも送出もしない
+		if (m_latchPending) LatchPending();
+	}
+	WaitTransmit();
+	dma_channel_transfer_from_buffer_now(m_dmaChan, words, count);
+}
+
 /**
- * @brief 全パネルを走査してVRAMからフレームを送信します。
+ * @brief 最後に送ったフレームと比べ、送る語数を決めます。
+ * @param words 送出データ
+ * @param count 語数
+ * @return 送る語数（0なら送らない）
+ * @details
+ * - 後ろから比べ、最後に変化した語までを送ります。LEDは先頭から順にデータを受け取り、後ろのLEDは前の色を保持します。
+ * - 詰めた送出データでは3語（4ピクセル）単位に切り上げます（語の途中で止めると、余りのビットが次のLEDに入る）。
+ * - 1フレーム分でない語列を送った後は、LEDの状態が分からないので次のフレームをすべて送ります。
+ */
+size_t WS2812::DeltaWords(const uint32_t* words, size_t count)
+{
+	const size_t full = WireWords();
+	m_deltaStats.frames++;
+	m_deltaStats.wordsFull += full;
+	if (count != full || m_shownWire == nullptr) {
+		m_shownValid = false;
+		m_deltaStats.wordsSent += count;
+		return count;
+	}
+	size_t n = full;
+	if (m_shownValid) {
+		while (n > 0 && words[n - 1] == m_shownWire[n - 1]) n--;
+		if (n == 0) {
+			m_deltaStats.skipped++;
+			return 0;
+		}
+		if (m_packed) {
+			n = (n + 2) / 3 * 3;
+			if (n > full) n = full;
+		}
+		if (n < full) m_deltaStats.partial++;
+	}
+	memcpy(m_shownWire, words, n * sizeof(uint32_t));
+	m_shownValid = true;
+	m_deltaStats.wordsSent += n;
+	return n;
+}
+
+/**
+ * @brief 最後に送ったフレームと比べ、変化したLEDまでだけ送るかを切り替えます。
+ * @param enable true で有効
+ * @return なし
+ */
+void WS2812::SetDeltaTransmit(bool enable)
+{
+	if (enable == m_delta) return;
+	if (enable && m_shownWire == nullptr) {
+		// LEDの状態の領域（詰めない場合の大きさ）。大きなVRAMと確保できない場合は、有効にせずすべて送る
+		const size_t words = (size_t)xVRam * yVRam;
+		if (words > WS2812_DELTA_MAX_LEDS) return;
+		m_shownWire = new (std::nothrow) uint32_t[words];
+		if (m_shownWire == nullptr) return;
+		m_shownWords = words;
+	}
+	if (!enable && m_latchPending) {
+		m_latchPending = false;
+		Latch(); // 遅らせていたラッチ（この後の送出は Reset() 済みのつもりで呼ばれる）
+	}
+	if (!enable) {
+		// LEDの状態は無効の間は使わないので返す（次に有効にしたとき確保し直す）
+		delete[] m_shownWire;
+		m_shownWire = nullptr;
+		m_shownWords = 0;
+	}
+	m_delta = enable;
+	m_shownValid = false; // 無効の間に送ったフレームは記録していない
+}
+
+/**
+ * @brief DMA送出の完了を待ちます。
+ * @return なし
+ * @details DMAがFIFOへ渡し終えるまで待ちます（FIFO内の最後の数ピクセルは送出中の場合があります）。
+ */
+void WS2812::WaitTransmit()
+{
+	dma_channel_wait_for_finish_blocking(m_dmaChan);
+}
+
+/**
+ * @brief キャッシュ済みのフレームを送出します。
+ * @param key フレームID
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @return キャッシュにあり、送出を開始したらtrue
+ */
+bool WS2812::ShowCached(uint64_t key, bool serpentine, bool leftToRight)
+{
+	LGM_TRACE_SCOPE_NAMED(trace, TRACE_SHOW_CACHED, 0, (uint32_t)key, (uint32_t)(key >> 32));
+	size_t words;
+	const uint32_t* wire = m_wireCache.Find(key, WireTag(serpentine, leftToRight), words);
+	if (wire == nullptr) return false;
+	LGM_TRACE_SET_ARGS(trace, 1, (uint32_t)key, (uint32_t)(key >> 32));
+	Reset();
+	WaitAfterReset(); // ScanBuffer() と同じく、リセット直後の安全待ち
+	TransmitWire(wire, words);
+	return true;
+}
+
+/**
+ * @brief VRAMを送出順の語列に変換してキャッシュに登録し、DMAで送出します。
+ * @param key フレームID
  * @param serpentine 千鳥配線
  * @param leftToRight 偶数行の基準方向
  * @return なし
  */
-void WS2812::ScanBuffer(bool serpentine, bool leftToRight)
+void WS2812::ScanBufferCached(uint64_t key, bool serpentine, bool leftToRight)
 {
-	// 全パネル走査（行優先）:
-	// - Reset() 直後に呼ぶ想定。安全余裕の待ち時間を確保してから送信開始。
-	// - 高速化が必要なら: パネル/行単位でDMAを使ってFIFOへ連搬する。
-	sleep_us(100); // 直前のリセットからの安全待ち（環境に合わせて最適化可）
-	for (int y = 0; y < yPanelCount; y++) {
-		for (int x = 0; x < xPanelCount; x++) {
-			ScanPanel(x * xSize, y * ySize, serpentine, leftToRight); // パネルごとにデータを送信
-		}
+	LGM_TRACE_SCOPE(TRACE_SCAN_BUFFER, WireTag(serpentine, leftToRight), (uint32_t)key, (uint32_t)(key >> 32));
+	const size_t words = WireWords();
+	WaitTransmit(); // 送出中のデータ（キャッシュ/作業領域）を書き換えない
+	uint32_t* wire = m_wireCache.Insert(key, WireTag(serpentine, leftToRight), words);
+	if (wire == nullptr) {
+		// 登録できない: パネルの行ごとに送る（VRAM全体の作業領域は使わない。確保できなければCPUで送る）
+		if (!ScanTiles(serpentine, leftToRight)) ScanBuffer(serpentine, leftToRight);
+		return;
 	}
+	EncodeWire(wire, serpentine, leftToRight);
+	WaitAfterReset(); // 直前のリセットからの安全待ち
+	TransmitWire(wire, words);
 }
 
+/**
+ * @brief 送出データキャッシュの上限を変更します。
+ * @param bytes 上限（バイト）
+ * @return なし
+ */
+void WS2812::SetWireCacheBudget(size_t bytes)
+{
+	WaitTransmit();
+	m_wireCache.SetBudget(bytes);
+}
 
+/**
+ * @brief 送出データキャッシュを空にします。
+ * @return なし
+ */
+void WS2812::ClearWireCache()
+{
+	WaitTransmit();
+	m_wireCache.Clear();
+}
+
+/**
+ * @brief パネルごとの色補正行列とLEDごとの明るさを設定します。
+ * @param panelMatrix パネルごとの行列（nullptr で無効）
+ * @param ledGain LEDごとの明るさ（nullptr で無効）
+ * @return なし
+ */
+void WS2812::SetCalibration(const LedColorMatrix* panelMatrix, const uint8_t* ledGain)
+{
+	WaitTransmit(); // 送出中のデータは補正前のまま
+	m_cal.panelMatrix = panelMatrix;
+	m_cal.ledGain = ledGain;
+	m_wireCache.Clear(); // キャッシュ済みの送出データは古い補正で作られている
+}
+
+/**
+ * @brief 送出データを詰めるかを切り替えます。
+ * @param packed true で 4ピクセル = 3語
+ * @return なし
+ */
+void WS2812::SetPackedWire(bool packed)
+{
+	if (packed == m_packed) return;
+	FlushWire();
+	WaitTransmit();
+	while (!pio_sm_is_tx_fifo_empty(m_pio, m_sm)) tight_loop_contents();
+	sleep_us(50); // FIFOから取り出した最後の語の送出完了
+	m_packed = packed;
+	ws2812_program_init(m_pio, m_sm, m_offset, m_pin, m_timing, m_packed ? 32 : 24);
+	m_wireCache.Clear(); // キャッシュ済みの送出データは前の形式
+	m_shownValid = false; // LEDの状態の記録も前の形式
+}
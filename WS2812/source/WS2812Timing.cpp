@@ -0,0 +1,44 @@
+/**
+ * @brief WS2812 のPIO分周計算。
+ * @details ハードウェアに依存しない整数演算のみで、clk_sys ごとの分周とビットタイミング誤差を求めます。
+ */
+#include "WS2812Timing.h"
+
+/**
+ * @brief clk_sys と目標ビットレートから、PIOの分周（整数部+小数部）を求めます。
+ * @param sysHz clk_sys(Hz)
+ * @param bitHz 目標ビットレート(Hz)
+ * @param cyclesPerBit 1bitあたりのサイクル数
+ * @param t1 T1 サイクル数
+ * @param t2 T2 サイクル数
+ * @param out [out] 分周設定と実際のタイミング
+ * @return 分周器の範囲内ならtrue
+ */
+bool ws2812_calc_timing(uint32_t sysHz, uint32_t bitHz, uint32_t cyclesPerBit, uint32_t t1, uint32_t t2, WS2812Timing& out)
+{
+	out = WS2812Timing {};
+	out.sysHz = sysHz;
+	if (sysHz == 0 || bitHz == 0 || cyclesPerBit == 0) return false;
+
+	// 分周(1/256単位) = sysHz * 256 / smHz を四捨五入
+	const uint64_t smHz = (uint64_t)bitHz * cyclesPerBit;
+	const uint64_t div256 = ((uint64_t)sysHz * 256u + smHz / 2) / smHz;
+	if (div256 < 256u || div256 > 0xFFFFFFu) return false; // 1.0 未満、または整数部が16bitを超える
+
+	out.divInt = (uint16_t)(div256 >> 8);
+	out.divFrac = (uint8_t)(div256 & 0xFFu);
+
+	// 実際のSMクロック = sysHz * 256 / div256、1bit = cyclesPerBit サイクル
+	const uint64_t bitPeriodPs = div256 * cyclesPerBit * 1000000000000ull / 256u / sysHz; ///< 1bitの周期(ps)
+	out.bitNs = (uint32_t)((bitPeriodPs + 500u) / 1000u);
+	out.bitHz = (uint32_t)(((uint64_t)sysHz * 256u + (div256 * cyclesPerBit) / 2) / (div256 * cyclesPerBit));
+	const int64_t targetPs = 1000000000000ll / bitHz;
+	out.errorPpm = (int32_t)(((int64_t)bitPeriodPs - targetPs) * 1000000 / targetPs);
+
+	const uint64_t cyclePs = bitPeriodPs / cyclesPerBit;
+	out.t0HighNs = (uint32_t)((cyclePs * t1 + 500u) / 1000u);
+	out.t1HighNs = (uint32_t)((cyclePs * (t1 + t2) + 500u) / 1000u);
+	// 小数分周では平均周期は正確だが、各サイクルは clk_sys 1周期分だけ前後する
+	out.jitterNs = out.divFrac ? (uint32_t)((1000000000ull + sysHz / 2) / sysHz) : 0u;
+	return true;
+}
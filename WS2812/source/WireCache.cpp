@@ -0,0 +1,125 @@
+/**
+ * @brief 送出データ（FIFO用の語列）キャッシュ。
+ * @details ハードウェアに依存しない LRU キャッシュです。WS2812 から DMA 送出の元データとして使います。
+ */
+#include <new>
+#include "WireCache.h"
+
+/**
+ * @brief フレームを探します。
+ * @param key フレームID
+ * @param tag 走査方法などの付加情報
+ * @param words [out] 語数
+ * @return 語列（なければ nullptr）
+ */
+const uint32_t* WireCache::Find(uint64_t key, uint8_t tag, size_t& words)
+{
+	for (int i = 0; i < WIRECACHE_MAX_ENTRIES; i++) {
+		Entry& e = m_entries[i];
+		if (e.used && e.key == key && e.tag == tag) {
+			e.lastUse = ++m_useCounter;
+			words = e.words;
+			m_stats.hits++;
+			return e.data;
+		}
+	}
+	m_stats.misses++;
+	words = 0;
+	return nullptr;
+}
+
+/**
+ * @brief エントリを解放します。
+ * @param idx エントリ番号
+ * @return なし
+ */
+void WireCache::Release(int idx)
+{
+	Entry& e = m_entries[idx];
+	if (!e.used) return;
+	delete[] e.data;
+	m_stats.usedBytes -= e.words * sizeof(uint32_t);
+	m_stats.entries--;
+	e = Entry {};
+}
+
+/**
+ * @brief 最も古いエントリを解放します。
+ * @param keep 解放しないエントリ（-1 なら指定なし）
+ * @return 解放したらtrue
+ */
+bool WireCache::EvictOldest(int keep)
+{
+	int lru = -1;
+	for (int i = 0; i < WIRECACHE_MAX_ENTRIES; i++) {
+		if (!m_entries[i].used || i == keep) continue;
+		if (lru < 0 || m_entries[i].lastUse < m_entries[lru].lastUse) lru = i;
+	}
+	if (lru < 0) return false;
+	Release(lru);
+	m_stats.evictions++;
+	return true;
+}
+
+/**
+ * @brief フレームの領域を確保します。
+ * @param key フレームID
+ * @param tag 走査方法などの付加情報
+ * @param words 語数
+ * @return 書き込み先（上限に収まらない/確保できない場合は nullptr）
+ */
+uint32_t* WireCache::Insert(uint64_t key, uint8_t tag, size_t words)
+{
+	const size_t bytes = words * sizeof(uint32_t);
+	if (words == 0 || bytes > m_budget) return nullptr;
+
+	// 同じキーは置き換え
+	for (int i = 0; i < WIRECACHE_MAX_ENTRIES; i++) {
+		if (m_entries[i].used && m_entries[i].key == key && m_entries[i].tag == tag) Release(i);
+	}
+
+	int freeIdx = -1;
+	for (;;) {
+		freeIdx = -1;
+		for (int i = 0; i < WIRECACHE_MAX_ENTRIES; i++) {
+			if (!m_entries[i].used) { freeIdx = i; break; }
+		}
+		if (freeIdx >= 0 && m_stats.usedBytes + bytes <= m_budget) break;
+		if (!EvictOldest(-1)) return nullptr;
+	}
+
+	uint32_t* data = new (std::nothrow) uint32_t[words];
+	if (data == nullptr) return nullptr;
+
+	Entry& e = m_entries[freeIdx];
+	e.key = key;
+	e.tag = tag;
+	e.used = true;
+	e.lastUse = ++m_useCounter;
+	e.words = words;
+	e.data = data;
+	m_stats.usedBytes += bytes;
+	m_stats.entries++;
+	if (m_stats.usedBytes > m_stats.peakBytes) m_stats.peakBytes = m_stats.usedBytes;
+	return data;
+}
+
+/**
+ * @brief 上限を変更します。
+ * @param budgetBytes 合計の上限（バイト）
+ * @return なし
+ */
+void WireCache::SetBudget(size_t budgetBytes)
+{
+	m_budget = budgetBytes;
+	while (m_stats.usedBytes > m_budget && EvictOldest(-1)) {}
+}
+
+/**
+ * @brief すべて解放します。
+ * @return なし
+ */
+void WireCache::Clear()
+{
+	for (int i = 0; i < WIRECACHE_MAX_ENTRIES; i++) Release(i);
+}
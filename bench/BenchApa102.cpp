@@ -0,0 +1,33 @@
+/**
+ * @file BenchApa102.cpp
+ * @brief APA102/SK9822 の送出フレーム作成の計測
+ * @details
+ * - 計測: VRAM 一辺 16..maxSize の送出フレーム作成（1ピクセルごとに 5bit 輝度を選んで 8bit へ割り戻す）。
+ */
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "BenchApa102.h"
+#include "APA102Frame.h"
+
+/**
+ * @brief 送出フレームの作成を計測します。
+ * @param r 計測
+ */
+void benchApa102(BenchRunner& r)
+{
+    std::uint16_t lut[256];
+    apa102_build_lut(2.2f, 256, lut);
+    for (int s = 16; s <= r.config().maxSize && s <= 256; s *= 2) {
+        const std::size_t pixels = (std::size_t)s * s;
+        std::mt19937 rng(9);
+        std::vector<std::uint32_t> px(pixels);
+        for (auto& p : px) p = rng() & 0xFFFFFFu;
+        std::vector<std::uint8_t> frame(apa102_frame_bytes(pixels));
+        r.run("apa102.encode_frame", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            std::uint8_t* p = apa102_write_start(frame.data());
+            p = apa102_encode_pixels(px.data(), pixels, 1, lut, p);
+            apa102_write_end(p, pixels);
+        });
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file BenchApa102.h
+ * @brief APA102/SK9822 の送出フレーム作成の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 送出フレームの作成（apa102_encode_pixels）を計測します。
+ * @param r 計測
+ */
+void benchApa102(BenchRunner& r);
@@ -0,0 +1,39 @@
+/**
+ * @file BenchBoot.cpp
+ * @brief 起動直後の表示（BootFrame.h のフラッシュ上の語列）の計測
+ * @details
+ * - 計測: boot.first_frame/flash（Reset + フラッシュの語列をDMA送出）と、
+ *   boot.first_frame/process（パターン一式の取得 + 停止表示の描画・変換・送出。キャッシュは毎回空）。
+ */
+#include <cstdint>
+#include <memory>
+#include "BenchBoot.h"
+#include "BenchChars.h"
+#include "BootFrame.h"
+#include "BootTimeline.h"
+#include "FrameRender.h"
+#include "HostShims.h"
+#include "PatCache.h"
+#include "PatSignal.h"
+#include "WS2812.h"
+
+/**
+ * @brief 起動から最初の表示までの処理を計測します。
+ * @param r 計測
+ */
+void benchBoot(BenchRunner& r)
+{
+    const Patterns& ch = g_benchCharsBaked[0];
+    std::unique_ptr<WS2812> led(new WS2812(22, BOOT_FRAME_WIDTH, BOOT_FRAME_HEIGHT));
+    r.run("boot.first_frame/flash", {{"w", BOOT_FRAME_WIDTH}, {"h", BOOT_FRAME_HEIGHT}}, (double)LGMBootWireWords, [&] {
+        led->Reset();
+        led->TransmitWire(LGMBootWire, LGMBootWireWords);
+    });
+    PatCache cache;
+    r.run("boot.first_frame/process", {{"w", BOOT_FRAME_WIDTH}, {"h", BOOT_FRAME_HEIGHT}}, (double)LGMBootWireWords, [&] {
+        cache.clear();
+        led->ClearWireCache();
+        PatSet* set = cache.acquire(ch);
+        if (set) drawStopFrame(*led, ch, set->stay, frameKey(0, FRAME_KEY_STOP, 0, 0, false, false));
+    });
+}
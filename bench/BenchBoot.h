@@ -0,0 +1,13 @@
+/**
+ * @file BenchBoot.h
+ * @brief 起動直後の表示（BootFrame.h のフラッシュ上の語列）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 起動から最初の表示までの処理を、フラッシュの語列を送る場合とパターンを処理して描く場合で計測します。
+ * @param r 計測
+ */
+void benchBoot(BenchRunner& r);
@@ -0,0 +1,92 @@
+/**
+ * @file BenchCalibration.cpp
+ * @brief 送出データへの変換時に掛ける色補正（LedCalibration.h）の計測
+ * @details
+ * - 計測: 16x16 パネルを並べた一辺 16..maxSize の VRAM で、ledcal.encode_wire/{none,gain,matrix,matrix_gain} と、
+ *   補正を別パス（VRAM の写しに掛けてから EncodeWire）で掛けた場合の ledcal.two_pass を記録します。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchCalibration.h"
+#include "LedCalibration.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/** @brief パネルごとに少しずつ違う実数の行列（対角 0.8..1.0、他のチャネルからの混入 -0.1..+0.1）。 */
+std::vector<float> makeMatrixF(std::size_t panels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> diag(0.8f, 1.0f), mix(-0.1f, 0.1f);
+    std::vector<float> v(panels * 9);
+    for (std::size_t p = 0; p < panels; p++)
+        for (int i = 0; i < 9; i++) v[p * 9 + i] = (i % 4 == 0) ? diag(rng) : mix(rng);
+    return v;
+}
+
+std::vector<LedColorMatrix> toFixed(const std::vector<float>& f)
+{
+    std::vector<LedColorMatrix> m(f.size() / 9);
+    for (std::size_t p = 0; p < m.size(); p++) ledcal_matrix_from_float(&f[p * 9], m[p]);
+    return m;
+}
+
+std::vector<std::uint8_t> makeGain(std::size_t leds, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint8_t> v(leds);
+    for (auto& g : v) g = (std::uint8_t)(160 + rng() % 96);
+    return v;
+}
+
+} // namespace
+
+/**
+ * @brief 色補正ありの送出データ作成を計測します。
+ * @param r 計測
+ */
+void benchCalibration(BenchRunner& r)
+{
+    for (int s = 16; s <= r.config().maxSize && s <= 256; s *= 2) {
+        const uint8_t panels = (uint8_t)(s / 16);
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, panels, panels));
+        const std::size_t pixels = (std::size_t)s * s;
+        const auto data = makeData(pixels, 3);
+        std::copy(data.begin(), data.end(), led->pVRam);
+        const auto m = toFixed(makeMatrixF((std::size_t)panels * panels, 4));
+        const auto gain = makeGain(pixels, 5);
+        std::vector<std::uint32_t> wire(pixels);
+
+        struct Mode { const char* name; const LedColorMatrix* m; const uint8_t* gain; };
+        const Mode modes[] = {{"none", nullptr, nullptr}, {"gain", nullptr, gain.data()}, {"matrix", m.data(), nullptr}, {"matrix_gain", m.data(), gain.data()}};
+        for (const Mode& mode : modes) {
+            led->SetCalibration(mode.m, mode.gain);
+            r.run(std::string("ledcal.encode_wire/") + mode.name, {{"w", s}, {"h", s}}, (double)pixels,
+                  [&] { led->EncodeWire(wire.data(), true, false); });
+        }
+
+        // 比較用: 補正を VRAM の写しに別パスで掛けてから、補正なしで EncodeWire する
+        led->SetCalibration(nullptr, nullptr);
+        std::unique_ptr<WS2812> tmp(new WS2812(22, 16, 16, panels, panels));
+        r.run("ledcal.two_pass", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t y = 0; y < (std::size_t)s; y++)
+                for (std::size_t x = 0; x < (std::size_t)s; x++) {
+                    const std::size_t i = y * s + x;
+                    tmp->pVRam[i] = ledcal_apply(led->pVRam[i], &m[(y / 16) * panels + x / 16], gain[i]);
+                }
+            tmp->EncodeWire(wire.data(), true, false);
+        });
+    }
+}
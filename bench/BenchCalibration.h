@@ -0,0 +1,13 @@
+/**
+ * @file BenchCalibration.h
+ * @brief 送出データへの変換時に掛ける色補正（LedCalibration.h）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 色補正なし/明るさのみ/行列のみ/両方で EncodeWire を計測します（補正を別パスで掛ける場合と比べる）。
+ * @param r 計測
+ */
+void benchCalibration(BenchRunner& r);
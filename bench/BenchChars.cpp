@@ -0,0 +1,29 @@
+/**
+ * @file BenchChars.cpp
+ * @brief ベンチマーク用のキャラクタ一覧
+ * @details ファームウェアの CharInfo と同じ内容（焼き込み済み）と、同じ補正を実行時に行う版の2通りを用意します。
+ */
+#include "BenchChars.h"
+#include "PatSignal.h"
+#include "PatMario.h"
+#include "PatZelda.h"
+#include "PatKirby.h"
+#include "PatDQ3.h"
+
+/** @brief ファームウェアの CharInfo と同じ（補正はビルド時に焼き込み済み）。 */
+Patterns g_benchCharsBaked[BENCH_CHAR_COUNT] = {
+    {LGMRed, {&LGMPat[0][0], NULL, NULL, NULL}, LGMPatCount, PATTERNS_CORRECTION(LGMCorrection), true, true, iWaitLGMWalk, iWaitLGMRun, true},
+    {MROStayBaked, {MRORunBaked, NULL, NULL, NULL}, MROPatCount, PATTERNS_CORRECTION(MROCorrection), false, false, iWaitMarioWalk, iWaitMarioRun, true},
+    {ZELDAStayBaked, {ZELDARightBaked, ZELDAFrontBaked, ZELDALeftBaked, ZELDABackBaked}, ZELDARightCount, PATTERNS_CORRECTION(ZELDACorrection), false, false, iWaitZeldaWalk, iWaitZeldaRun, true},
+    {KirbyStayBaked, {KirbyWalkBaked, KirbyRollBaked, NULL, NULL}, KirbyWalkCount, PATTERNS_CORRECTION(KirbyCorrection), false, false, iWaitKirbyWalk, iWaitKirbyRun, true},
+    {DQ3StayBaked, {DQ3RightBaked, DQ3FrontBaked, DQ3LeftBaked, DQ3BackBaked}, DQ3RightCount, PATTERNS_CORRECTION(DQ3Correction), false, false, iWaitDQ3Walk, iWaitDQ3Run, true},
+};
+
+/** @brief 元のパターンに同じ補正を実行時（PatManager）で適用する版。 */
+Patterns g_benchCharsRuntime[BENCH_CHAR_COUNT] = {
+    {LGMRed, {&LGMPat[0][0], NULL, NULL, NULL}, LGMPatCount, PATTERNS_CORRECTION(LGMCorrection), true, true, iWaitLGMWalk, iWaitLGMRun, false},
+    {MROStay, {&MRORun[0][0], NULL, NULL, NULL}, MROPatCount, PATTERNS_CORRECTION(MROCorrection), false, false, iWaitMarioWalk, iWaitMarioRun, false},
+    {ZELDAStay, {&ZELDARight[0][0], &ZELDAFront[0][0], &ZELDALeft[0][0], &ZELDABack[0][0]}, ZELDARightCount, PATTERNS_CORRECTION(ZELDACorrection), false, false, iWaitZeldaWalk, iWaitZeldaRun, false},
+    {KirbyStay, {&KirbyWalk[0][0], &KirbyRoll[0][0], NULL, NULL}, KirbyWalkCount, PATTERNS_CORRECTION(KirbyCorrection), false, false, iWaitKirbyWalk, iWaitKirbyRun, false},
+    {DQ3Stay, {&DQ3Right[0][0], &DQ3Front[0][0], &DQ3Left[0][0], &DQ3Back[0][0]}, DQ3RightCount, PATTERNS_CORRECTION(DQ3Correction), false, false, iWaitDQ3Walk, iWaitDQ3Run, false},
+};
@@ -0,0 +1,12 @@
+/**
+ * @file BenchChars.h
+ * @brief ベンチマーク用のキャラクタ一覧
+ */
+#pragma once
+
+#include "Patterns.h"
+
+#define BENCH_CHAR_COUNT 5 ///< キャラクタ数（ファームウェアの CharInfo と同じ）
+
+extern Patterns g_benchCharsBaked[BENCH_CHAR_COUNT];   ///< 焼き込み済み（ファームウェアと同じ）
+extern Patterns g_benchCharsRuntime[BENCH_CHAR_COUNT]; ///< 実行時に補正する版
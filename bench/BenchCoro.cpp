@@ -0,0 +1,54 @@
+/**
+ * @file BenchCoro.cpp
+ * @brief コルーチンの協調スケジューラ（CoroScheduler.h）の計測
+ * @details
+ * - 計測: coro.resume（次のフレームを待つスクリプトを N 本、1フレームずつ進める）と、coro.spawn（生成→実行→終了→破棄）。
+ */
+#include <cstdint>
+#include "BenchCoro.h"
+#include "CoroScheduler.h"
+
+namespace {
+
+/** @brief 何もせずに終わる。 */
+CoroTask empty(std::uint32_t& count)
+{
+    count++;
+    co_return;
+}
+
+/** @brief 次のフレームを待ち続ける。 */
+CoroTask frameLoop(std::uint32_t& count)
+{
+    while (true) {
+        count++;
+        co_await coro_next_frame();
+    }
+}
+
+} // namespace
+
+/**
+ * @brief スクリプトの再開と、生成から終了までを計測します。
+ * @param r 計測
+ */
+void benchCoro(BenchRunner& r)
+{
+    for (int n : {1, 4, CORO_MAX_TASKS}) {
+        CoroScheduler s;
+        std::uint32_t count = 0, t = 0;
+        s.setFramePeriod(1, t);
+        for (int i = 0; i < n; i++) s.spawn(frameLoop(count));
+        r.run("coro.resume", {{"tasks", n}}, (double)n, [&] { s.run(++t); });
+        benchEscape(&count);
+    }
+    {
+        CoroScheduler s;
+        std::uint32_t count = 0, t = 0;
+        r.run("coro.spawn", {{"tasks", 1}}, 1.0, [&] {
+            s.spawn(empty(count));
+            s.run(++t);
+        });
+        benchEscape(&count);
+    }
+}
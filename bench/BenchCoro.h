@@ -0,0 +1,13 @@
+/**
+ * @file BenchCoro.h
+ * @brief コルーチンの協調スケジューラ（CoroScheduler.h）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief スクリプトの再開と、生成から終了までを計測します。
+ * @param r 計測
+ */
+void benchCoro(BenchRunner& r);
@@ -0,0 +1,38 @@
+/**
+ * @file BenchDelta.cpp
+ * @brief 変化したLEDまでだけ送る送出（WS2812::SetDeltaTransmit）の計測
+ * @details
+ * - 計測: 16x16 パネルを並べた一辺 16..maxSize（WS2812_DELTA_MAX_LEDS 以下）の VRAM で、ws2812.scan_buffer/delta_same（変化なし）と
+ *   ws2812.scan_buffer/delta_first_panel（最初のパネルの1ピクセルだけ変わる）。比べる相手は ws2812.scan_buffer です。
+ */
+#include <cstdint>
+#include <memory>
+#include "BenchDelta.h"
+#include "WS2812.h"
+
+/**
+ * @brief 変化したLEDまでだけ送る送出を計測します。
+ * @param r 計測
+ */
+void benchDelta(BenchRunner& r)
+{
+    for (int s = 16; s <= r.config().maxSize && (std::size_t)s * s <= WS2812_DELTA_MAX_LEDS; s *= 2) {
+        const std::uint8_t panels = (std::uint8_t)(s / 16);
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, panels, panels));
+        const std::size_t pixels = (std::size_t)s * s;
+        for (std::size_t i = 0; i < pixels; i++) led->pVRam[i] = (std::uint32_t)(i * 2654435761u) & 0x0F0F0Fu;
+        led->SetDeltaTransmit(true);
+        led->Reset();
+        led->ScanBuffer(true, false);
+        r.run("ws2812.scan_buffer/delta_same", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            led->Reset();
+            led->ScanBuffer(true, false);
+        });
+        std::uint32_t c = 0;
+        r.run("ws2812.scan_buffer/delta_first_panel", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            led->Reset();
+            led->pVRam[0] = ++c & 0x0F0F0Fu;
+            led->ScanBuffer(true, false);
+        });
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file BenchDelta.h
+ * @brief 変化したLEDまでだけ送る送出（WS2812::SetDeltaTransmit）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 変化がないフレームと、先頭の行だけが変わるフレームの送出を計測します。
+ * @param r 計測
+ */
+void benchDelta(BenchRunner& r);
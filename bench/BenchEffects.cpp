@@ -0,0 +1,33 @@
+/**
+ * @file BenchEffects.cpp
+ * @brief エフェクト（Effects.h）の描画の計測
+ * @details 一辺 16..maxSize の VRAM へ、各エフェクトの1フレームを描画する時間を effect.<名前> として記録します。
+ *          時刻は1回ごとに 16ms（約60FPS）進めます。炎は前のフレームから計算するので、続けて描画した状態を計測します。
+ */
+#include <cstdint>
+#include <vector>
+#include "BenchEffects.h"
+#include "Effects.h"
+
+/**
+ * @brief 各エフェクトの1フレームの描画を計測します。
+ * @param r 計測
+ */
+void benchEffects(BenchRunner& r)
+{
+    for (int s = 16; s <= r.config().maxSize && s <= EFFECT_MAX_WIDTH; s *= 2) {
+        const std::size_t pixels = (std::size_t)s * s;
+        std::vector<std::uint32_t> vram(pixels);
+        EffectEngine fx;
+        fx.begin((std::uint16_t)s, (std::uint16_t)s);
+        for (int k = 0; k < EFFECT_COUNT; k++) {
+            fx.select((EFFECT_KIND)k);
+            std::uint32_t t = 0;
+            r.run(std::string("effect.") + EffectEngine::name((EFFECT_KIND)k), {{"w", s}, {"h", s}}, (double)pixels, [&] {
+                fx.render(vram.data(), t);
+                t += 16;
+                benchEscape(vram.data());
+            });
+        }
+    }
+}
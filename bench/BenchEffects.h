@@ -0,0 +1,13 @@
+/**
+ * @file BenchEffects.h
+ * @brief エフェクト（Effects.h）の描画の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 各エフェクトの1フレームの描画を計測します（処理量はピクセル数。表の Mitem/s がピクセル/秒）。
+ * @param r 計測
+ */
+void benchEffects(BenchRunner& r);
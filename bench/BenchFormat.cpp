@@ -0,0 +1,142 @@
+/**
+ * @file BenchFormat.cpp
+ * @brief 実機ベンチマークの結果行の作成と解析の実装
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "BenchFormat.h"
+#include "BenchReport.h"
+
+/**
+ * @brief サンプルの統計を求めます。
+ * @param samples サンプル（並べ替えます）
+ * @param n サンプル数
+ * @return 統計
+ */
+BenchStats benchStats(std::uint32_t* samples, std::size_t n)
+{
+    BenchStats s {};
+    if (n == 0) return s;
+    std::sort(samples, samples + n);
+    double sum = 0;
+    for (std::size_t i = 0; i < n; i++) sum += samples[i];
+    s.count = (std::uint32_t)n;
+    s.min = samples[0];
+    s.median = samples[n / 2];
+    s.max = samples[n - 1];
+    s.mean = sum / (double)n;
+    double var = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const double d = samples[i] - s.mean;
+        var += d * d;
+    }
+    s.stddev = n > 1 ? std::sqrt(var / (double)(n - 1)) : 0.0;
+    return s;
+}
+
+/**
+ * @brief 結果行を作成します。
+ * @return snprintf と同じ
+ */
+int formatBenchLine(char* buf, std::size_t size, const char* key, const BenchStats& s, std::uint32_t hz, std::uint32_t items)
+{
+    const double us = hz ? (double)s.min * 1e6 / (double)hz : 0.0;
+    return std::snprintf(buf, size, BENCH_LINE_TAG " %s n=%lu min=%lu med=%lu mean=%.1f sd=%.1f max=%lu hz=%lu items=%lu us=%.3f",
+                         key, (unsigned long)s.count, (unsigned long)s.min, (unsigned long)s.median, s.mean, s.stddev,
+                         (unsigned long)s.max, (unsigned long)hz, (unsigned long)items, us);
+}
+
+namespace {
+
+/** @brief キー（name[a=1,b=2]）を名前とパラメータに分けます。 */
+bool splitKey(const std::string& key, BenchResult& out)
+{
+    const std::size_t open = key.find('[');
+    out.name = key.substr(0, open);
+    out.params.clear();
+    if (out.name.empty()) return false;
+    if (open == std::string::npos) return true;
+    if (key.back() != ']') return false;
+    const std::string body = key.substr(open + 1, key.size() - open - 2);
+    std::size_t pos = 0;
+    while (pos < body.size()) {
+        std::size_t end = body.find(',', pos);
+        if (end == std::string::npos) end = body.size();
+        const std::string kv = body.substr(pos, end - pos);
+        const std::size_t eq = kv.find('=');
+        if (eq == std::string::npos || eq == 0) return false;
+        char* tail = nullptr;
+        const long v = std::strtol(kv.c_str() + eq + 1, &tail, 10);
+        if (*tail != '\0') return false;
+        out.params.emplace_back(kv.substr(0, eq), v);
+        pos = end + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 結果行を解析します。
+ * @return 解析できたらtrue
+ */
+bool parseBenchLine(const char* line, BenchResult& out)
+{
+    while (*line == ' ' || *line == '\t') line++;
+    const std::size_t tagLen = std::strlen(BENCH_LINE_TAG);
+    if (std::strncmp(line, BENCH_LINE_TAG, tagLen) != 0 || line[tagLen] != ' ') return false;
+
+    std::string rest(line + tagLen + 1);
+    while (!rest.empty() && (rest.back() == '\n' || rest.back() == '\r' || rest.back() == ' ')) rest.pop_back();
+    const std::size_t sp = rest.find(' ');
+    if (!splitKey(rest.substr(0, sp), out)) return false;
+
+    double n = -1, minC = -1, med = -1, sd = 0, hz = 0, items = 0;
+    std::size_t pos = sp;
+    while (pos != std::string::npos && pos < rest.size()) {
+        const std::size_t start = pos + 1;
+        pos = rest.find(' ', start);
+        const std::string kv = rest.substr(start, pos == std::string::npos ? std::string::npos : pos - start);
+        const std::size_t eq = kv.find('=');
+        if (eq == std::string::npos) continue;
+        const std::string k = kv.substr(0, eq);
+        const double v = std::strtod(kv.c_str() + eq + 1, nullptr);
+        if (k == "n") n = v;
+        else if (k == "min") minC = v;
+        else if (k == "med") med = v;
+        else if (k == "sd") sd = v;
+        else if (k == "hz") hz = v;
+        else if (k == "items") items = v;
+    }
+    if (n < 0 || minC < 0 || med < 0 || hz <= 0) return false;
+
+    out.iterations = (std::uint64_t)n;
+    out.nsPerIter = minC * 1e9 / hz;
+    out.nsMedian = med * 1e9 / hz;
+    out.items = items;
+    out.cyclesMin = minC;
+    out.cyclesMedian = med;
+    out.cyclesStddev = sd;
+    return true;
+}
+
+/**
+ * @brief ログ全体から結果行を拾って追加します。
+ * @return 追加した件数
+ */
+std::size_t parseBenchLog(std::FILE* in, BenchReport& report)
+{
+    std::size_t count = 0;
+    char line[512];
+    while (std::fgets(line, sizeof(line), in) != nullptr) {
+        BenchResult r;
+        if (parseBenchLine(line, r)) {
+            report.add(r);
+            count++;
+        }
+    }
+    return count;
+}
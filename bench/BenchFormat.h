@@ -0,0 +1,69 @@
+/**
+ * @file BenchFormat.h
+ * @brief 実機ベンチマークの結果行（UART出力）の作成と解析
+ * @details
+ * 実機（LGMSerialLED_bench）とホストの両方でビルドします。実機は1件ごとに次の形式の行を出力し、
+ * ホストはログからこの行を拾って BenchReport に変換します（他の行は無視します）。
+ *
+ *     @bench ws2812.scan_buffer[w=16,h=16] n=32 min=1234 med=1240 mean=1241.5 sd=3.2 max=1500 hz=150000000 items=256 us=8.227
+ *
+ * サイクル数は DWT のサイクルカウンタの値で、us は min を clk_sys で換算した値です。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+struct BenchResult;
+class BenchReport;
+
+#define BENCH_LINE_TAG "@bench"         ///< 結果行の先頭
+#define BENCH_BEGIN_TAG "@bench-begin"  ///< 実行開始行の先頭
+#define BENCH_END_TAG "@bench-end"      ///< 実行終了行の先頭
+
+/** @brief サンプル（サイクル数）の統計。 */
+struct BenchStats {
+    std::uint32_t count;  ///< サンプル数
+    std::uint32_t min;    ///< 最小
+    std::uint32_t median; ///< 中央値
+    std::uint32_t max;    ///< 最大（初回の XIP キャッシュミスなどを含む）
+    double mean;          ///< 平均
+    double stddev;        ///< 標準偏差
+};
+
+/**
+ * @brief サンプルの統計を求めます。
+ * @param samples サンプル（並べ替えます）
+ * @param n サンプル数
+ * @return 統計（n==0 なら全て0）
+ */
+BenchStats benchStats(std::uint32_t* samples, std::size_t n);
+
+/**
+ * @brief 結果行を作成します（改行は含みません）。
+ * @param buf 出力先
+ * @param size 出力先のサイズ
+ * @param key 名前とパラメータ（例: ws2812.clear[w=16,h=16]）
+ * @param s 統計
+ * @param hz サイクルカウンタの周波数（clk_sys）
+ * @param items 1回あたりの処理量（ピクセル数など、0なら無し）
+ * @return snprintf と同じ（書き込もうとした文字数）
+ */
+int formatBenchLine(char* buf, std::size_t size, const char* key, const BenchStats& s, std::uint32_t hz, std::uint32_t items);
+
+/**
+ * @brief 結果行を解析します。
+ * @param line 1行（前後の空白と改行は無視）
+ * @param out 結果（ns はサイクル数を hz で換算、iterations はサンプル数）
+ * @return 結果行として解析できたらtrue
+ */
+bool parseBenchLine(const char* line, BenchResult& out);
+
+/**
+ * @brief ログ全体から結果行を拾って追加します。
+ * @param in ログ
+ * @param report 追加先
+ * @return 追加した件数
+ */
+std::size_t parseBenchLog(std::FILE* in, BenchReport& report);
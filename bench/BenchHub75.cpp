@@ -0,0 +1,51 @@
+/**
+ * @file BenchHub75.cpp
+ * @brief HUB75 のビットプレーン生成の計測
+ */
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "BenchHub75.h"
+#include "HUB75Planes.h"
+
+namespace {
+
+/** @brief 計測するパネルの大きさとビット深度。 */
+const Hub75Geometry kGeometries[] = {
+    {32, 32, 8}, {64, 32, 8}, {64, 64, 8}, {64, 64, 10}, {128, 64, 8}, {128, 64, 10},
+};
+
+/** @brief ランダムな VRAM（グラデーションとノイズ）。 */
+std::vector<std::uint32_t> makeVram(const Hub75Geometry& g, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v((std::size_t)g.width * g.height);
+    for (std::uint32_t y = 0; y < g.height; y++) {
+        for (std::uint32_t x = 0; x < g.width; x++) {
+            const std::uint32_t r = (x * 255u) / (g.width - 1u);
+            const std::uint32_t gr = (y * 255u) / (g.height - 1u);
+            const std::uint32_t b = rng() & 0xFFu;
+            v[y * g.width + x] = (gr << 16) | (r << 8) | b;
+        }
+    }
+    return v;
+}
+
+} // namespace
+
+/**
+ * @brief ビットプレーン生成を計測します。
+ * @param r 計測
+ */
+void benchHub75(BenchRunner& r)
+{
+    for (const Hub75Geometry& g : kGeometries) {
+        const auto vram = makeVram(g, 7);
+        std::uint16_t lut[256];
+        hub75_build_lut(g.depth, 1.0f, lut);
+        std::vector<std::uint32_t> planes(hub75_plane_words(g));
+        r.run("hub75.encode_planes", {{"w", g.width}, {"h", g.height}, {"depth", g.depth}}, (double)g.width * g.height, [&] {
+            hub75_encode_planes(vram.data(), g.width, g, lut, planes.data());
+        });
+    }
+}
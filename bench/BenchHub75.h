@@ -0,0 +1,13 @@
+/**
+ * @file BenchHub75.h
+ * @brief HUB75 のビットプレーン生成の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief ビットプレーン生成（hub75_encode_planes）を計測します。
+ * @param r 計測
+ */
+void benchHub75(BenchRunner& r);
@@ -0,0 +1,64 @@
+/**
+ * @file BenchLarge.cpp
+ * @brief 大きなVRAM（一辺255超、数万ピクセル）と任意の大きさのパターンの計測
+ * @details
+ * - 計測: 16x16 パネルを並べた横長の VRAM（64x32 .. 2*maxSize x maxSize）で、large.scan_buffer（パネルの行ごとの送出）、
+ *   large.scan_buffer/packed、large.encode_wire、large.draw_buffer/clip（四隅からはみ出すパターン）を記録します。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchLarge.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief 約1/4が黒のテストデータ。 */
+std::vector<std::uint32_t> makePattern(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 4 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+} // namespace
+
+/**
+ * @brief 大きなVRAMの送出と描画を計測します。
+ * @param r 計測
+ */
+void benchLarge(BenchRunner& r)
+{
+    for (int h = 32; h <= r.config().maxSize; h *= 2) {
+        const int w = 2 * h;
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, (std::uint16_t)(w / 16), (std::uint16_t)(h / 16)));
+        const std::size_t pixels = (std::size_t)w * h;
+        const std::vector<std::uint32_t> data = makePattern(pixels, 3);
+        std::copy(data.begin(), data.end(), led->pVRam);
+        r.run("large.scan_buffer", {{"w", w}, {"h", h}}, (double)pixels, [&] {
+            led->Reset();
+            led->ScanBuffer(true, false);
+        });
+        led->SetPackedWire(true);
+        r.run("large.scan_buffer/packed", {{"w", w}, {"h", h}}, (double)pixels, [&] {
+            led->Reset();
+            led->ScanBuffer(true, false);
+        });
+        led->SetPackedWire(false);
+        std::vector<std::uint32_t> wire(pixels);
+        r.run("large.encode_wire", {{"w", w}, {"h", h}}, (double)pixels, [&] { led->EncodeWire(wire.data(), true, false); });
+
+        // VRAMの半分の大きさのパターンを、四隅から1/4ずつはみ出させて描く（描くのは VRAM の1/4）
+        const std::vector<std::uint32_t> spr = makePattern(pixels / 4, 5);
+        const std::uint16_t sw = (std::uint16_t)(w / 2), sh = (std::uint16_t)(h / 2);
+        r.run("large.draw_buffer/clip", {{"w", w}, {"h", h}}, (double)pixels / 4, [&] {
+            led->DrawBuffer(spr.data(), sw, sh, -w / 4, -h / 4, 0, true);
+            led->DrawBuffer(spr.data(), sw, sh, w - w / 4, -h / 4, 0, true);
+            led->DrawBuffer(spr.data(), sw, sh, -w / 4, h - h / 4, 0, true);
+            led->DrawBuffer(spr.data(), sw, sh, w - w / 4, h - h / 4, 0, true);
+        });
+    }
+}
@@ -0,0 +1,14 @@
+/**
+ * @file BenchLarge.h
+ * @brief 大きなVRAM（一辺255超、数万ピクセル）と任意の大きさのパターンの計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 横長のVRAM（64x32 .. 512x256）で、パネルの行ごとの送出・送出データの作成・はみ出すパターンの描画を計測します。
+ * @param r 計測
+ * @details ピクセルあたりの時間（us/items）がVRAMの大きさによらず一定なら、線形に伸びています。
+ */
+void benchLarge(BenchRunner& r);
@@ -0,0 +1,90 @@
+/**
+ * @file BenchMain.cpp
+ * @brief ホスト用ベンチマークのエントリポイント
+ * @details
+ * 使い方: LGMSerialLED_hostbench [--filter 文字列] [--json ファイル] [--quick] [--max-size N] [--frames N] [--from-log ファイル]
+ * - --filter   名前にこの文字列を含むものだけ実行
+ * - --json     結果を JSON で出力（"-" なら標準出力）
+ * - --quick    計測時間を短くする（動作確認用）
+ * - --max-size VRAM/パターンの一辺の最大（16..256、既定 256）
+ * - --frames   PatManager のパターン数（既定 8）
+ * - --from-log 計測せず、実機（LGMSerialLED_bench）の UART ログを読み込んで表/JSON にする（"-" なら標準入力）
+ *
+ * 結果を期待値と比べる確認は LGMSerialLED_hosttest（bench/tests、ctest で実行）にあります。
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "BenchFormat.h"
+#include "BenchReport.h"
+#include "BenchRunner.h"
+#include "BenchScenarios.h"
+#include "HostShims.h"
+
+int main(int argc, char** argv)
+{
+    BenchConfig cfg;
+    const char* jsonPath = nullptr;
+    const char* logPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const bool hasNext = i + 1 < argc;
+        if (std::strcmp(a, "--filter") == 0 && hasNext) {
+            cfg.filter = argv[++i];
+        } else if (std::strcmp(a, "--json") == 0 && hasNext) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(a, "--from-log") == 0 && hasNext) {
+            logPath = argv[++i];
+        } else if (std::strcmp(a, "--quick") == 0) {
+            cfg.targetMs = 2.0;
+            cfg.repeats = 3;
+        } else if (std::strcmp(a, "--max-size") == 0 && hasNext) {
+            cfg.maxSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(a, "--frames") == 0 && hasNext) {
+            cfg.frames = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter S] [--json FILE|-] [--quick] [--max-size N] [--frames N] [--from-log FILE|-]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.maxSize < 16 || cfg.maxSize > 256 || cfg.frames < 1) {
+        std::fprintf(stderr, "--max-size must be 16..256 and --frames >= 1\n");
+        return 2;
+    }
+
+    BenchReport report;
+    const char* suite = "LGMSerialLED host bench";
+    if (logPath != nullptr) {
+        std::FILE* in = std::strcmp(logPath, "-") == 0 ? stdin : std::fopen(logPath, "r");
+        if (in == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", logPath);
+            return 1;
+        }
+        const std::size_t n = parseBenchLog(in, report);
+        if (in != stdin) std::fclose(in);
+        if (n == 0) {
+            std::fprintf(stderr, "no " BENCH_LINE_TAG " lines in %s\n", logPath);
+            return 1;
+        }
+        suite = "LGMSerialLED device bench";
+    } else {
+        BenchRunner runner(report, cfg);
+        runAllBenchmarks(runner);
+    }
+
+    const bool jsonToStdout = jsonPath != nullptr && std::strcmp(jsonPath, "-") == 0;
+    if (!jsonToStdout) report.printTable(stdout);
+    if (jsonPath != nullptr) {
+        std::FILE* out = jsonToStdout ? stdout : std::fopen(jsonPath, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", jsonPath);
+            return 1;
+        }
+        report.writeJson(out, suite);
+        if (!jsonToStdout) std::fclose(out);
+    }
+    // 送出内容のハッシュ（最適化で処理が消えていないことの確認用）
+    if (logPath == nullptr) std::fprintf(stderr, "sink: fifo=%llu dma=%llu hash=%08x\n",
+                 (unsigned long long)g_benchSink.fifoWords, (unsigned long long)g_benchSink.dmaWords, (unsigned)g_benchSink.hash);
+    return 0;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file BenchReport.cpp
+ * @brief ベンチマーク結果の出力（表/JSON）の実装
+ */
+#include "BenchReport.h"
+
+/**
+ * @brief 名前とパラメータを連結したキー。
+ * @return キー
+ */
+std::string BenchResult::key() const
+{
+    std::string k = name;
+    if (!params.empty()) {
+        k += '[';
+        for (std::size_t i = 0; i < params.size(); i++) {
+            if (i) k += ',';
+            k += params[i].first + '=' + std::to_string(params[i].second);
+        }
+        k += ']';
+    }
+    return k;
+}
+
+/**
+ * @brief 表形式で出力します。
+ * @param out 出力先
+ */
+void BenchReport::printTable(std::FILE* out) const
+{
+    bool hasCycles = false;
+    for (const BenchResult& r : results_) hasCycles |= r.cyclesMin > 0;
+
+    std::fprintf(out, "%-56s %12s %12s %10s %10s", "benchmark", "ns/iter", "median", "ns/item", "Mitem/s");
+    if (hasCycles) std::fprintf(out, " %10s %10s", "cycles", "sd");
+    std::fputc('\n', out);
+    for (const BenchResult& r : results_) {
+        const double perItem = r.items > 0 ? r.nsPerIter / r.items : 0;
+        const double mItemsPerSec = perItem > 0 ? 1000.0 / perItem : 0;
+        std::fprintf(out, "%-56s %12.1f %12.1f %10.3f %10.2f", r.key().c_str(), r.nsPerIter, r.nsMedian, perItem, mItemsPerSec);
+        if (hasCycles) std::fprintf(out, " %10.0f %10.1f", r.cyclesMin, r.cyclesStddev);
+        std::fputc('\n', out);
+    }
+}
+
+/**
+ * @brief JSON で出力します。
+ * @param out 出力先
+ * @param suite スイート名
+ */
+void BenchReport::writeJson(std::FILE* out, const char* suite) const
+{
+    std::fprintf(out, "{\n  \"suite\": \"%s\",\n  \"results\": [\n", suite);
+    for (std::size_t i = 0; i < results_.size(); i++) {
+        const BenchResult& r = results_[i];
+        std::fprintf(out, "    {\"name\": \"%s\", \"params\": {", r.name.c_str());
+        for (std::size_t p = 0; p < r.params.size(); p++) {
+            std::fprintf(out, "%s\"%s\": %ld", p ? ", " : "", r.params[p].first.c_str(), r.params[p].second);
+        }
+        std::fprintf(out, "}, \"iterations\": %llu, \"ns_per_iter\": %.3f, \"ns_median\": %.3f, \"items\": %.0f",
+                     (unsigned long long)r.iterations, r.nsPerIter, r.nsMedian, r.items);
+        if (r.items > 0 && r.nsPerIter > 0) std::fprintf(out, ", \"items_per_sec\": %.0f", r.items * 1e9 / r.nsPerIter);
+        if (r.cyclesMin > 0) {
+            std::fprintf(out, ", \"cycles_min\": %.0f, \"cycles_median\": %.0f, \"cycles_stddev\": %.1f",
+                         r.cyclesMin, r.cyclesMedian, r.cyclesStddev);
+        }
+        std::fprintf(out, "}%s\n", i + 1 < results_.size() ? "," : "");
+    }
+    std::fprintf(out, "  ]\n}\n");
+}
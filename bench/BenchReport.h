@@ -0,0 +1,56 @@
+/**
+ * @file BenchReport.h
+ * @brief ベンチマーク結果の保持と出力（表/JSON）
+ * @details 回帰比較のため、結果は名前とパラメータをキーにした JSON で出力します。
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility>
+
+/** @brief ベンチマーク1件の結果。 */
+struct BenchResult {
+    std::string name;                                  ///< 名前（例: ws2812.draw_buffer/opaque）
+    std::vector<std::pair<std::string, long>> params;  ///< パラメータ（例: w=16, h=16）
+    std::uint64_t iterations { 0 };                    ///< 1回の計測での繰り返し回数
+    double nsPerIter { 0 };                            ///< 1回あたりの時間(ns)。計測を繰り返した中の最小
+    double nsMedian { 0 };                             ///< 1回あたりの時間(ns)。計測を繰り返した中の中央値
+    double items { 0 };                                ///< 1回あたりの処理量（ピクセル数など、0なら無し）
+    double cyclesMin { 0 };                            ///< 実機のみ: サイクル数の最小（ホストは0）
+    double cyclesMedian { 0 };                         ///< 実機のみ: サイクル数の中央値
+    double cyclesStddev { 0 };                         ///< 実機のみ: サイクル数の標準偏差
+
+    /** @brief 名前とパラメータを連結したキー（例: ws2812.clear[w=16,h=16]）。 */
+    std::string key() const;
+};
+
+/** @brief ベンチマーク結果の一覧。 */
+class BenchReport {
+public:
+    /** @brief 結果を追加します。@param r 結果 */
+    void add(const BenchResult& r) { results_.push_back(r); }
+
+    /** @brief 結果の一覧。 */
+    const std::vector<BenchResult>& results() const { return results_; }
+
+    /**
+     * @brief 表形式で出力します。
+     * @param out 出力先
+     */
+    void printTable(std::FILE* out) const;
+
+    /**
+     * @brief JSON で出力します。
+     * @param out 出力先
+     * @param suite スイート名
+     * @details {"suite":..., "results":[{"name":..., "params":{...}, "iterations":..., "ns_per_iter":..., "ns_median":..., "items":..., "items_per_sec":...}]}
+     *          実機の結果には "cycles_min", "cycles_median", "cycles_stddev" も出力します。
+     */
+    void writeJson(std::FILE* out, const char* suite) const;
+
+private:
+    std::vector<BenchResult> results_;
+};
@@ -0,0 +1,105 @@
+/**
+ * @file BenchRunner.h
+ * @brief ベンチマークの計測（繰り返し回数の自動調整と複数回計測）
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BenchReport.h"
+
+/** @brief ベンチマークの設定。 */
+struct BenchConfig {
+    const char* filter { nullptr }; ///< 名前にこの文字列を含むものだけ実行（nullptr なら全て）
+    double targetMs { 20.0 };       ///< 1回の計測の目標時間(ms)
+    int repeats { 5 };              ///< 計測の繰り返し数（最小と中央値を記録）
+    int maxSize { 256 };            ///< VRAM/パターンの一辺の最大（16..256）
+    int frames { 8 };               ///< パターン数
+};
+
+/**
+ * @brief p の指す先が読み書きされたものとしてコンパイラに扱わせます。
+ * @param p 計測対象のメモリ
+ * @details ループ回数が定数で全体がインライン展開される処理（WS2812Static など）で、繰り返しの書き込みがまとめて消されないようにします。
+ */
+inline void benchEscape(const void* p)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
+
+/**
+ * @brief ベンチマークを計測して BenchReport へ記録するクラス。
+ * @details 1回の計測が targetMs 程度になるよう繰り返し回数を決め、repeats 回計測します。
+ */
+class BenchRunner {
+public:
+    BenchRunner(BenchReport& report, const BenchConfig& config) : report_(report), config_(config) {}
+
+    /** @brief 設定。 */
+    const BenchConfig& config() const { return config_; }
+
+    /** @brief フィルタに一致するならtrue。@param name 名前 */
+    bool enabled(const std::string& name) const
+    {
+        return config_.filter == nullptr || name.find(config_.filter) != std::string::npos;
+    }
+
+    /**
+     * @brief 計測して記録します。
+     * @param name 名前
+     * @param params パラメータ
+     * @param items 1回あたりの処理量（ピクセル数など）
+     * @param fn 計測する処理（1回分）
+     */
+    template <class F>
+    void run(const std::string& name, std::initializer_list<std::pair<const char*, long>> params, double items, F&& fn)
+    {
+        if (!enabled(name)) return;
+        using clock = std::chrono::steady_clock;
+
+        // 回数の調整: 目標時間の 1/4 を超えるまで倍にする
+        fn();
+        std::uint64_t iters = 1;
+        for (;;) {
+            const auto t0 = clock::now();
+            for (std::uint64_t i = 0; i < iters; i++) fn();
+            const double ms = std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+            if (ms >= config_.targetMs / 4 || iters >= (1ull << 30)) {
+                if (ms > 0) iters = std::max<std::uint64_t>(1, (std::uint64_t)(iters * config_.targetMs / ms));
+                break;
+            }
+            iters *= 2;
+        }
+
+        std::vector<double> samples;
+        for (int r = 0; r < config_.repeats; r++) {
+            const auto t0 = clock::now();
+            for (std::uint64_t i = 0; i < iters; i++) fn();
+            samples.push_back(std::chrono::duration<double, std::nano>(clock::now() - t0).count() / (double)iters);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        BenchResult res;
+        res.name = name;
+        for (const auto& p : params) res.params.emplace_back(p.first, p.second);
+        res.iterations = iters;
+        res.nsPerIter = samples.front();
+        res.nsMedian = samples[samples.size() / 2];
+        res.items = items;
+        report_.add(res);
+    }
+
+private:
+    BenchReport& report_;
+    BenchConfig config_;
+};
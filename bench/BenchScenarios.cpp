@@ -0,0 +1,344 @@
+/**
+ * @file BenchScenarios.cpp
+ * @brief 描画パイプラインのベンチマーク（マイクロ/シナリオ）
+ * @details
+ * - パターン補正（PatManager::init と各 set*）、GammaCorrector、WS2812 の VRAM 操作と送出データの作成、
+ *   パック済みピクセル演算、送出データキャッシュ、キャラクタ切替と歩行フレームのシナリオ、HUB75 のビットプレーン生成、APA102 の送出フレーム作成、
+ *   パネル構成をコンパイル時に決めた WS2812Static（ws2812.* と同じ処理）を計測します。
+ * - VRAM/パターンの一辺は 16 から BenchConfig::maxSize（最大256）まで倍々で変えます。
+ * - FIFO/DMA はホスト代替（bench/host）で、送出内容のハッシュだけを取ります。待ち時間（sleep_us）は含みません。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "BenchScenarios.h"
+#include "BenchChars.h"
+#include "BenchApa102.h"
+#include "BenchHub75.h"
+#include "BenchWs2812Static.h"
+#include "BenchEffects.h"
+#include "BenchSprite.h"
+#include "BenchCalibration.h"
+#include "BenchWirePack.h"
+#include "BenchBoot.h"
+#include "BenchCoro.h"
+#include "BenchStream.h"
+#include "BenchDelta.h"
+#include "BenchLarge.h"
+#include "BenchTileMap.h"
+#include "WS2812.h"
+#include "PixelOps.h"
+#include "GammaCorrector.h"
+#include "PatManager.h"
+#include "PatCache.h"
+#include "Patterns.h"
+#include "AnimSequencer.h"
+#include "FrameRender.h"
+
+namespace {
+
+/** @brief 一辺のサイズ（16..maxSize を倍々）。 */
+std::vector<int> sizes(const BenchConfig& cfg)
+{
+    std::vector<int> v;
+    for (int s = 16; s <= cfg.maxSize && s <= 256; s *= 2) v.push_back(s);
+    return v;
+}
+
+/** @brief パターンらしいテストデータ（約1/3が黒、それ以外は少数の色）。 */
+std::vector<std::uint32_t> makePattern(std::size_t pixels, std::uint32_t seed)
+{
+    static const std::uint32_t palette[] = {0xA4FF40, 0x203010, 0x08F008, 0xF1CF28, 0x10FC20, 0x020404, 0xFFFFFF};
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) {
+        const std::uint32_t r = rng() % 10;
+        px = r < 3 ? 0u : palette[r % (sizeof(palette) / sizeof(palette[0]))];
+    }
+    return v;
+}
+
+/** @brief 一辺 s の VRAM を持つドライバ（16x16 パネルを並べる）。 */
+std::unique_ptr<WS2812> makeLed(int s)
+{
+    return std::unique_ptr<WS2812>(new WS2812(22, 16, 16, (uint8_t)(s / 16), (uint8_t)(s / 16)));
+}
+
+/** @brief PatManager::init と各補正パス。 */
+void benchPatManager(BenchRunner& r)
+{
+    const int frames = r.config().frames;
+    for (int s : sizes(r.config())) {
+        const std::size_t pixels = (std::size_t)s * s * frames;
+        const auto src = makePattern(pixels, 1);
+        PatManager pm;
+        r.run("patmanager.init", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.init(src.data(), frames, (uint16_t)s, (uint16_t)s); });
+        pm.init(src.data(), frames, (uint16_t)s, (uint16_t)s);
+        r.run("patmanager.set_green_range", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.setGreenRange(0, 16); });
+        r.run("patmanager.set_red_range", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.setRedRange(0, 16); });
+        r.run("patmanager.set_blue_range", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.setBlueRange(0, 16); });
+        r.run("patmanager.set_gamma", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.setGamma(2.2f); });
+        r.run("patmanager.set_brightness_contrast", {{"w", s}, {"h", s}, {"frames", frames}}, (double)pixels,
+              [&] { pm.setBrightnessContrast(10, 20); });
+    }
+}
+
+/** @brief GammaCorrector::correct（キャッシュ付き、パターンの色は少数）。 */
+void benchGammaCorrector(BenchRunner& r)
+{
+    for (int s : sizes(r.config())) {
+        const std::size_t pixels = (std::size_t)s * s;
+        const auto src = makePattern(pixels, 2);
+        GammaCorrector gc(2.2f);
+        volatile std::uint32_t sink = 0;
+        r.run("gamma_corrector.correct", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            std::uint32_t acc = 0;
+            for (std::uint32_t c : src) acc ^= gc.correct(c);
+            sink = acc;
+        });
+    }
+}
+
+/** @brief WS2812 の VRAM 操作と送出データの作成。 */
+void benchWs2812(BenchRunner& r)
+{
+    for (int s : sizes(r.config())) {
+        auto led = makeLed(s);
+        const std::size_t pixels = (std::size_t)s * s;
+        const auto sprite = makePattern(16 * 16, 3);
+        const auto frame = makePattern(pixels, 4);
+        std::vector<std::uint32_t> wire(pixels);
+
+        r.run("ws2812.clear", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->Clear(0x010203); });
+        r.run("ws2812.set_pixel", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (int y = 0; y < s; y++)
+                for (int x = 0; x < s; x++) led->SetPixel((uint16_t)x, (uint16_t)y, (uint32_t)(x ^ y));
+        });
+        // 16x16 のパターンを VRAM 全体に敷き詰める
+        auto tile = [&](uint32_t colorReplace, bool isOverlay) {
+            for (int y = 0; y < s; y += 16)
+                for (int x = 0; x < s; x += 16) led->DrawBuffer(sprite.data(), 16, 16, (uint8_t)x, (uint8_t)y, colorReplace, isOverlay);
+        };
+        r.run("ws2812.draw_buffer/opaque", {{"w", s}, {"h", s}}, (double)pixels, [&] { tile(0, false); });
+        r.run("ws2812.draw_buffer/overlay", {{"w", s}, {"h", s}}, (double)pixels, [&] { tile(0, true); });
+        r.run("ws2812.draw_buffer/replace", {{"w", s}, {"h", s}}, (double)pixels, [&] { tile(0x070000, true); });
+        r.run("ws2812.scan_panel", {{"w", s}, {"h", s}}, 256.0, [&] { led->ScanPanel(0, 0, true, false); });
+        r.run("ws2812.scan_buffer", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->ScanBuffer(true, false); });
+        r.run("ws2812.encode_wire", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->EncodeWire(wire.data(), true, false); });
+        r.run("ws2812.scale", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->Scale(200); });
+        r.run("ws2812.blend", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->Blend(frame.data(), 64); });
+        r.run("ws2812.limit_power", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            led->Clear(0x404040);
+            led->LimitPower((uint32_t)(pixels * 60));
+        });
+    }
+}
+
+/** @brief パック済みピクセル演算（SWAR/DSP）と、チャネルごとの基準実装の比較。 */
+void benchPixelOps(BenchRunner& r)
+{
+    using namespace pixelops;
+    for (int s : sizes(r.config())) {
+        const std::size_t pixels = (std::size_t)s * s;
+        auto a = makePattern(pixels, 5);
+        const auto b = makePattern(pixels, 6);
+        std::vector<std::uint32_t> dst(pixels);
+        volatile std::uint32_t sink = 0;
+
+        r.run("pixelops.scale/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] { px_scale_buffer(dst.data(), a.data(), pixels, 200); });
+        r.run("pixelops.scale/ref", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = ref::scale(a[i], 200);
+        });
+        r.run("pixelops.blend/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] { px_blend_buffer(dst.data(), a.data(), b.data(), pixels, 100); });
+        r.run("pixelops.blend/ref", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = ref::blend(a[i], b[i], 100);
+        });
+        r.run("pixelops.add_sat/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = px_add_sat(a[i], b[i]);
+        });
+        r.run("pixelops.add_sat/ref", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = ref::add_sat(a[i], b[i]);
+        });
+        r.run("pixelops.max/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = px_max(a[i], b[i]);
+        });
+        r.run("pixelops.max/ref", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            for (std::size_t i = 0; i < pixels; i++) dst[i] = ref::max(a[i], b[i]);
+        });
+        r.run("pixelops.sum/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] { sink = px_sum_buffer(a.data(), pixels); });
+        r.run("pixelops.sum/ref", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            std::uint32_t acc = 0;
+            for (std::size_t i = 0; i < pixels; i++) acc += ref::sum(a[i]);
+            sink = acc;
+        });
+    }
+}
+
+/** @brief 送出データキャッシュ（ヒット時とミス時）。 */
+void benchWireCache(BenchRunner& r)
+{
+    for (int s : sizes(r.config())) {
+        auto led = makeLed(s);
+        const std::size_t pixels = (std::size_t)s * s;
+        led->SetWireCacheBudget(pixels * sizeof(std::uint32_t) * 4);
+        led->ScanBufferCached(1, true, false);
+        r.run("wire_cache.hit", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->ShowCached(1, true, false); });
+        std::uint32_t key = 100;
+        r.run("wire_cache.miss", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->ScanBufferCached(key++, true, false); });
+    }
+}
+
+/**
+ * @brief キャラクタ切替の待ち時間のうち、PatCache::acquire() の分（描画・送出は含まない）。
+ * @details
+ * - miss: 毎回キャッシュを空にして補正する（切替1回の最悪値）
+ * - hit: 2キャラクタを交互に取得する（どちらもキャッシュにある）
+ * - evict: スロット数より1つ多いキャラクタを順に取得する（LRU で毎回追い出して補正し直す）
+ * - baked: 焼き込み済み（補正せずフラッシュ上のテーブルを参照する）
+ */
+void benchPatCache(BenchRunner& r)
+{
+    struct Variant { const char* name; Patterns* chars; int count; bool clear; };
+    const Variant variants[] = {
+        {"patcache.acquire/miss", g_benchCharsRuntime, BENCH_CHAR_COUNT, true},
+        {"patcache.acquire/hit", g_benchCharsRuntime, 2, false},
+        {"patcache.acquire/evict", g_benchCharsRuntime, PATCACHE_SLOTS + 1 < BENCH_CHAR_COUNT ? PATCACHE_SLOTS + 1 : BENCH_CHAR_COUNT, false},
+        {"patcache.acquire/baked", g_benchCharsBaked, BENCH_CHAR_COUNT, true},
+    };
+    for (const Variant& v : variants) {
+        PatCache cache(PATCACHE_MAX_BYTES * 4); // スロット数だけで追い出しが決まるように
+        int charNo = 0;
+        r.run(v.name, {{"chars", v.count}, {"slots", PATCACHE_SLOTS}}, 1.0, [&] {
+            charNo = (charNo + 1) % v.count;
+            if (v.clear) cache.clear();
+            benchEscape(cache.acquire(v.chars[charNo]));
+        });
+    }
+}
+
+/**
+ * @brief キャラクタ切替（SET ボタン）: パターン一式の取得と停止表示の送出。
+ * @details
+ * - runtime/uncached: 毎回補正をやり直す（キャッシュ導入前と同じ処理量）
+ * - runtime/uncached_arena: 同上、バッファはアリーナ（PatCache::reserveArena）から切り出す
+ * - runtime/cached: 補正済み一式のキャッシュあり（送出データキャッシュは毎回空）
+ * - baked: 焼き込み済み（送出データキャッシュは毎回空）
+ * - baked/wire_cached: 焼き込み済み + 送出データキャッシュあり（定常状態）
+ */
+void benchCharSwitch(BenchRunner& r)
+{
+    auto led = makeLed(16);
+    struct Variant { const char* name; Patterns* chars; bool clearPatCache; bool clearWire; bool arena; };
+    const Variant variants[] = {
+        {"scenario.char_switch/runtime/uncached", g_benchCharsRuntime, true, true, false},
+        {"scenario.char_switch/runtime/uncached_arena", g_benchCharsRuntime, true, true, true},
+        {"scenario.char_switch/runtime/cached", g_benchCharsRuntime, false, true, false},
+        {"scenario.char_switch/baked", g_benchCharsBaked, false, true, false},
+        {"scenario.char_switch/baked/wire_cached", g_benchCharsBaked, false, false, false},
+    };
+    std::size_t maxSetBytes = 0;
+    for (int i = 0; i < BENCH_CHAR_COUNT; i++) maxSetBytes = std::max(maxSetBytes, g_benchCharsRuntime[i].processedBytes());
+    for (const Variant& v : variants) {
+        PatCache cache;
+        if (v.arena) cache.reserveArena(maxSetBytes);
+        int charNo = 0;
+        r.run(v.name, {{"w", 16}, {"h", 16}, {"chars", BENCH_CHAR_COUNT}}, 256.0, [&] {
+            charNo = (charNo + 1) % BENCH_CHAR_COUNT;
+            if (v.clearPatCache) cache.clear();
+            if (v.clearWire) led->ClearWireCache();
+            PatSet* set = cache.acquire(v.chars[charNo]);
+            if (set) drawStopFrame(*led, v.chars[charNo], set->stay, frameKey(charNo, FRAME_KEY_STOP, 0, 0, false, false));
+            cache.prefetch(v.chars[(charNo + 1) % BENCH_CHAR_COUNT]);
+        });
+    }
+}
+
+/**
+ * @brief 歩行フレームの進行: 5ms ごとに再生位置を更新し、変化したら合成して送出する（ファームウェアの WALKING と同じ）。
+ * @details 1回 = steps 回の更新。wire_cached は送出データキャッシュあり、uncached は毎回合成して送出。
+ */
+void benchFrameStep(BenchRunner& r)
+{
+    const int steps = 2000; // 5ms * 2000 = 10秒分
+    for (int useWire = 0; useWire < 2; useWire++) {
+        for (int charNo = 0; charNo < BENCH_CHAR_COUNT; charNo++) {
+            auto led = makeLed(16);
+            if (!useWire) led->SetWireCacheBudget(0);
+            const Patterns& ch = g_benchCharsBaked[charNo];
+            PatCache cache;
+            PatSet* set = cache.acquire(ch);
+            SeqTempo tempos[2];
+            ch.makeTempos(tempos);
+            std::size_t stepCount;
+            const SeqStep* tl = ch.timeline(stepCount);
+            AnimSequencer seq;
+            std::uint32_t nowMs = 0;
+            seq.begin(tl, stepCount, tempos, ch.PatWalkCount, nowMs);
+
+            const std::string name = std::string("scenario.frame_step/") + (useWire ? "wire_cached" : "uncached");
+            r.run(name, {{"char", charNo}, {"steps", steps}}, (double)steps, [&] {
+                bool isShown = false;
+                std::size_t shownPatNo = 0;
+                std::uint8_t shownGrpNo = 0;
+                bool shownBlend = false;
+                for (int i = 0; i < steps; i++) {
+                    nowMs += 5;
+                    SeqPosition pos = seq.update(nowMs);
+                    if (pos.finished) {
+                        seq.begin(tl, stepCount, tempos, ch.PatWalkCount, nowMs);
+                        continue;
+                    }
+                    std::uint8_t grp = pos.group;
+                    if (grp >= 4 || !set->run[grp].isInitialized) grp = 0;
+                    if (!isShown || pos.frame != shownPatNo || pos.isBlend != shownBlend || grp != shownGrpNo) {
+                        const std::uint64_t key = frameKey(charNo, grp, pos.prevFrame, pos.frame, pos.isBlend || ch.isOverlay, pos.isBlend);
+                        drawRunFrame(*led, ch, set->run[grp], pos.prevFrame, pos.frame, pos.isBlend, key);
+                        shownPatNo = pos.frame;
+                        shownGrpNo = grp;
+                        shownBlend = pos.isBlend;
+                        isShown = true;
+                    }
+                }
+            });
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief すべてのベンチマークを実行します。
+ * @param r 計測
+ */
+void runAllBenchmarks(BenchRunner& r)
+{
+    benchPatManager(r);
+    benchGammaCorrector(r);
+    benchWs2812(r);
+    benchWs2812Static(r);
+    benchPixelOps(r);
+    benchWireCache(r);
+    benchPatCache(r);
+    benchCharSwitch(r);
+    benchFrameStep(r);
+    benchHub75(r);
+    benchApa102(r);
+    benchEffects(r);
+    benchSprite(r);
+    benchCalibration(r);
+    benchWirePack(r);
+    benchBoot(r);
+    benchCoro(r);
+    benchStream(r);
+    benchDelta(r);
+    benchLarge(r);
+    benchTileMap(r);
+}
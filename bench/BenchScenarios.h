@@ -0,0 +1,13 @@
+/**
+ * @file BenchScenarios.h
+ * @brief 描画パイプラインのベンチマーク一覧
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief すべてのベンチマークを実行します（フィルタに一致するもののみ）。
+ * @param r 計測
+ */
+void runAllBenchmarks(BenchRunner& r);
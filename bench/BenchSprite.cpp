@@ -0,0 +1,90 @@
+/**
+ * @file BenchSprite.cpp
+ * @brief パターンの拡大・縮小・回転描画（SpriteBlit.h）の計測
+ * @details
+ * - 計測: 16x16 のパターンを 64x64 へ描く sprite.blit/<補間>/scale4（整数倍）と sprite.blit/<補間>/rotate（小数倍+回転）と、
+ *   64x64 のパネルで歩行フレームを拡大して描画・送出する scenario.scaled_walk。
+ */
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchSprite.h"
+#include "BenchChars.h"
+#include "SpriteBlit.h"
+#include "WS2812.h"
+#include "PatCache.h"
+#include "FrameRender.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストパターン。 */
+std::vector<std::uint32_t> makeSprite(std::uint32_t w, std::uint32_t h, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(w * h);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu) | 1u;
+    return v;
+}
+
+/** @brief 左上 (left, top) に倍率 k で置く変換。 */
+SpriteXform placeScaled(std::uint32_t sw, std::uint32_t sh, std::int32_t left, std::int32_t top, std::int32_t k, std::uint8_t angle)
+{
+    SpriteXform xf;
+    sprite_xform_make(sw, sh, left * SPRITE_ONE + (std::int32_t)(sw * k) * SPRITE_ONE / 2,
+                      top * SPRITE_ONE + (std::int32_t)(sh * k) * SPRITE_ONE / 2, k * SPRITE_ONE, k * SPRITE_ONE, angle, xf);
+    return xf;
+}
+
+} // namespace
+
+/**
+ * @brief 変形描画と、拡大した歩行フレームを計測します。
+ * @param r 計測
+ */
+void benchSprite(BenchRunner& r)
+{
+    const std::uint32_t dw = 64, dh = 64;
+    const auto sprite = makeSprite(16, 16, 1);
+    std::vector<std::uint32_t> vram(dw * dh);
+    const SpriteFilter filters[] = {SPRITE_NEAREST, SPRITE_BILINEAR};
+    for (SpriteFilter f : filters) {
+        const char* fname = f == SPRITE_NEAREST ? "nearest" : "bilinear";
+        // 整数倍で全面（16x16 → 64x64）
+        const SpriteXform x4 = placeScaled(16, 16, 0, 0, 4, 0);
+        r.run(std::string("sprite.blit/") + fname + "/scale4", {{"w", dw}, {"h", dh}}, (double)(dw * dh), [&] {
+            sprite_blit(vram.data(), dw, dh, sprite.data(), 16, 16, x4, f, 0, true);
+            benchEscape(vram.data());
+        });
+        // 小数倍 + 回転（1回ごとに角度を変える）。処理量は描いたピクセル数の平均
+        std::size_t written = 0;
+        for (int a = 0; a < 256; a++) {
+            SpriteXform xf;
+            sprite_xform_make(16, 16, 32 * SPRITE_ONE, 32 * SPRITE_ONE, 3 * SPRITE_ONE + SPRITE_ONE / 2, 3 * SPRITE_ONE + SPRITE_ONE / 2, (std::uint8_t)a, xf);
+            written += sprite_blit(vram.data(), dw, dh, sprite.data(), 16, 16, xf, f, 0, true);
+        }
+        std::uint8_t angle = 0;
+        r.run(std::string("sprite.blit/") + fname + "/rotate", {{"w", dw}, {"h", dh}}, (double)written / 256.0, [&] {
+            SpriteXform xf;
+            sprite_xform_make(16, 16, 32 * SPRITE_ONE, 32 * SPRITE_ONE, 3 * SPRITE_ONE + SPRITE_ONE / 2, 3 * SPRITE_ONE + SPRITE_ONE / 2, angle++, xf);
+            sprite_blit(vram.data(), dw, dh, sprite.data(), 16, 16, xf, f, 0, true);
+            benchEscape(vram.data());
+        });
+    }
+
+    // 64x64 のパネル（16x16 を 4x4 枚）で、歩行フレームを4倍に拡大して描画・送出（キャッシュなし）
+    for (int charNo = 0; charNo < BENCH_CHAR_COUNT; charNo++) {
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, 4, 4));
+        led->SetWireCacheBudget(0);
+        const Patterns& ch = g_benchCharsBaked[charNo];
+        PatCache cache;
+        PatSet* set = cache.acquire(ch);
+        if (!set) continue;
+        std::size_t frame = 0;
+        r.run("scenario.scaled_walk", {{"char", charNo}, {"w", dw}, {"h", dh}}, (double)(dw * dh), [&] {
+            const std::size_t n = ch.PatWalkCount;
+            drawRunFrame(*led, ch, set->run[0], frame % n, (frame + 1) % n, (frame & 1) != 0, 0);
+            frame++;
+        });
+    }
+}
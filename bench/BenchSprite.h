@@ -0,0 +1,13 @@
+/**
+ * @file BenchSprite.h
+ * @brief パターンの拡大・縮小・回転描画（SpriteBlit.h）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 変形描画（最近傍/双線形）と、拡大した歩行フレームの描画・送出を計測します。
+ * @param r 計測
+ */
+void benchSprite(BenchRunner& r);
@@ -0,0 +1,130 @@
+/**
+ * @file BenchStream.cpp
+ * @brief フラッシュ上のフィルム（FrameStream.h）の再生の計測
+ * @details
+ * - フラッシュの代わりに、フィルムを一時ファイルへ書き出し、読み取り専用でメモリへ割り付けたもの（mmap）を使います。
+ *   ホストの DMA の代わりは開始した時点でコピーを終えるので、先読みは常に間に合います（stats().waits は0）。
+ * - 計測: stream.frame/raw, stream.frame/rle（炎のエフェクトを焼き込んだフィルムを順に取り出す。RLE は展開を含む）。
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "BenchStream.h"
+#include "Effects.h"
+#include "FrameStream.h"
+
+namespace {
+
+/**
+ * @brief ファイルへ書き出し、読み取り専用でメモリへ割り付けたフィルム（フラッシュの代わり）。
+ * @details mmap のない環境では、書き出したファイルを読み戻したものを使います。
+ */
+class MappedFilm {
+public:
+    explicit MappedFilm(const std::vector<std::uint32_t>& words)
+        : bytes_(words.size() * sizeof(std::uint32_t))
+    {
+#if defined(_WIN32)
+        std::FILE* f = std::tmpfile();
+        if (f == nullptr) return;
+        copy_.resize(words.size());
+        const bool written = std::fwrite(words.data(), 1, bytes_, f) == bytes_;
+        std::rewind(f);
+        if (written && std::fread(copy_.data(), 1, bytes_, f) == bytes_) data_ = copy_.data();
+        std::fclose(f);
+#else
+        const char* dir = std::getenv("TMPDIR");
+        std::string path = std::string(dir && *dir ? dir : "/tmp") + "/lgmfilmXXXXXX";
+        const int fd = mkstemp(&path[0]);
+        if (fd < 0) return;
+        unlink(path.c_str()); // 割り付けを解けば消える
+        std::FILE* f = fdopen(fd, "wb");
+        const bool written = f != nullptr && std::fwrite(words.data(), 1, bytes_, f) == bytes_ && std::fflush(f) == 0;
+        if (written) {
+            void* p = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) data_ = p;
+        }
+        if (f) {
+            std::fclose(f);
+        } else {
+            close(fd);
+        }
+#endif
+    }
+    ~MappedFilm()
+    {
+#if !defined(_WIN32)
+        if (data_) munmap(data_, bytes_);
+#endif
+    }
+    MappedFilm(const MappedFilm&) = delete;
+    MappedFilm& operator=(const MappedFilm&) = delete;
+
+    /** @brief 先頭（割り付けられなければ nullptr）。 */
+    const void* data() const { return data_; }
+    /** @brief 大きさ（バイト）。 */
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    void* data_ { nullptr };
+    std::size_t bytes_ { 0 };
+#if defined(_WIN32)
+    std::vector<std::uint32_t> copy_;
+#endif
+};
+
+/** @brief フレームの列からフィルムを作ります。 */
+std::vector<std::uint32_t> buildFilm(const std::vector<std::uint32_t>& frames, std::size_t count, std::uint16_t w, std::uint16_t h,
+                                     FILM_CODEC codec)
+{
+    std::vector<std::uint32_t> film(film_build(frames.data(), count, w, h, codec, nullptr, 0));
+    film_build(frames.data(), count, w, h, codec, film.data(), film.size());
+    return film;
+}
+
+/** @brief 炎のエフェクトを count フレーム焼き込みます（16ms 間隔）。 */
+std::vector<std::uint32_t> fireFrames(std::uint16_t w, std::uint16_t h, std::size_t count)
+{
+    const std::size_t n = (std::size_t)w * h;
+    std::vector<std::uint32_t> frames(count * n);
+    EffectEngine fx;
+    fx.begin(w, h);
+    fx.select(EFFECT_FIRE);
+    for (std::size_t f = 0; f < count; f++) fx.render(&frames[f * n], (std::uint32_t)(f * 16));
+    return frames;
+}
+
+} // namespace
+
+/**
+ * @brief フィルムの1フレームの取り出しを計測します。
+ * @param r 計測
+ */
+void benchStream(BenchRunner& r)
+{
+    const std::size_t count = 60;
+    for (int s = 16; s <= r.config().maxSize && s <= 128; s *= 2) {
+        const std::size_t pixels = (std::size_t)s * s;
+        const std::vector<std::uint32_t> frames = fireFrames((std::uint16_t)s, (std::uint16_t)s, count);
+        for (FILM_CODEC codec : {FILM_RAW, FILM_RLE}) {
+            const std::vector<std::uint32_t> film = buildFilm(frames, count, (std::uint16_t)s, (std::uint16_t)s, codec);
+            MappedFilm flash(film);
+            if (flash.data() == nullptr) continue;
+            FilmHeader hdr;
+            std::memcpy(&hdr, flash.data(), sizeof(hdr));
+            std::vector<std::uint32_t> ring(FrameStream::ringWords(hdr));
+            FrameStream fs;
+            if (!fs.open(flash.data(), flash.bytes(), ring.data(), ring.size())) continue;
+            std::size_t i = 0;
+            r.run(codec == FILM_RLE ? "stream.frame/rle" : "stream.frame/raw", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+                benchEscape(fs.frame(i++));
+            });
+        }
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file BenchStream.h
+ * @brief フラッシュ上のフィルム（FrameStream.h）の再生の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief フィルムの1フレームの取り出し（先読み + RLE の展開）を、無圧縮とランレングスで計測します。
+ * @param r 計測
+ */
+void benchStream(BenchRunner& r);
@@ -0,0 +1,88 @@
+/**
+ * @file BenchTileMap.cpp
+ * @brief タイルマップ（TileMap.h）の描画の計測
+ * @details
+ * - 計測: 16x16 パネルを並べた一辺 16..maxSize の VRAM で、tilemap.draw/8x8_4bpp、tilemap.draw/16x16_8bpp、
+ *   tilemap.draw/scroll（毎回スクロール位置を変える）、tilemap.draw/overlay を記録します。
+ *   比べる相手は、VRAMと同じ大きさの画像を DrawBuffer で描く tilemap.full_frame です。
+ */
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchTileMap.h"
+#include "TileMap.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief タイルセットとマップ（とその中身）。 */
+struct TileFixture {
+    std::vector<std::uint8_t> pixels;
+    std::vector<std::uint32_t> palette;
+    std::vector<std::uint16_t> cells;
+    TileSet ts {};
+    TileMap map {};
+};
+
+/**
+ * @brief 乱数でタイルセットとマップを作ります。
+ * @param tileSize タイルの一辺
+ * @param bpp 4 または 8
+ * @param tileCount タイル数
+ * @param paletteCount パレット数（4bpp）
+ * @param mapW 横のマス数
+ * @param mapH 縦のマス数
+ * @param invalid 範囲外のタイル番号/パレット番号も使う
+ * @param seed 乱数の種
+ */
+std::unique_ptr<TileFixture> makeFixture(std::uint8_t tileSize, std::uint8_t bpp, std::uint16_t tileCount, std::uint8_t paletteCount,
+                                         std::uint16_t mapW, std::uint16_t mapH, bool invalid, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::unique_ptr<TileFixture> f(new TileFixture);
+    f->pixels.resize((std::size_t)tileCount * tileSize * tileSize * bpp / 8);
+    for (auto& b : f->pixels) b = (std::uint8_t)rng();
+    f->palette.resize(bpp == 4 ? (std::size_t)paletteCount * 16 : 256);
+    for (auto& c : f->palette) c = rng() & 0xFFFFFFu;
+    f->cells.resize((std::size_t)mapW * mapH);
+    for (auto& c : f->cells) {
+        const std::uint32_t tile = rng() % (tileCount + (invalid ? 3u : 0u));
+        const std::uint32_t pal = rng() % (paletteCount + (invalid ? 1u : 0u));
+        c = TILE_CELL(tile, pal, rng() & (TILE_HFLIP | TILE_VFLIP));
+    }
+    f->ts = {f->pixels.data(), f->palette.data(), tileCount, tileSize, bpp, paletteCount};
+    f->map = {f->cells.data(), mapW, mapH};
+    return f;
+}
+
+} // namespace
+
+/**
+ * @brief タイルマップの描画を計測します。
+ * @param r 計測
+ */
+void benchTileMap(BenchRunner& r)
+{
+    // 512x256 ピクセルのマップ（8x8: 64x32マス、16x16: 32x16マス）
+    const auto f8 = makeFixture(8, 4, 128, 4, 64, 32, false, 11);
+    const auto f16 = makeFixture(16, 8, 64, 1, 32, 16, false, 12);
+    for (int s = 16; s <= r.config().maxSize; s *= 2) {
+        const std::uint16_t panels = (std::uint16_t)(s / 16);
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, panels, panels));
+        const std::size_t pixels = (std::size_t)s * s;
+        std::vector<std::uint32_t> frame(pixels);
+        for (std::size_t i = 0; i < pixels; i++) frame[i] = (std::uint32_t)(i * 2654435761u) & 0xFFFFFFu;
+
+        r.run("tilemap.full_frame", {{"w", s}, {"h", s}}, (double)pixels,
+              [&] { led->DrawBuffer(frame.data(), (std::uint16_t)s, (std::uint16_t)s, 0, 0, 0, false); });
+        r.run("tilemap.draw/8x8_4bpp", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->DrawTileMap(f8->ts, f8->map, 0, 0); });
+        r.run("tilemap.draw/16x16_8bpp", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->DrawTileMap(f16->ts, f16->map, 0, 0); });
+        std::int32_t sc = 0;
+        r.run("tilemap.draw/scroll", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            sc += 3;
+            led->DrawTileMap(f8->ts, f8->map, sc, -sc / 2);
+        });
+        r.run("tilemap.draw/overlay", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->DrawTileMap(f8->ts, f8->map, 5, 3, true); });
+    }
+}
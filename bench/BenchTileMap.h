@@ -0,0 +1,14 @@
+/**
+ * @file BenchTileMap.h
+ * @brief タイルマップ（TileMap.h）の描画の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief タイルマップの描画を、一辺 16..maxSize の VRAM で計測します。
+ * @param r 計測
+ * @details 比べる相手は、同じ大きさの1ピクセル4バイトの画像を DrawBuffer で描く tilemap.full_frame です。
+ */
+void benchTileMap(BenchRunner& r);
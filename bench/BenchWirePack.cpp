@@ -0,0 +1,54 @@
+/**
+ * @file BenchWirePack.cpp
+ * @brief 送出データを 4ピクセル = 3語 に詰める形式（WirePack.h、WS2812::SetPackedWire）の計測
+ * @details
+ * - 計測: 16x16 パネルを並べた一辺 16..maxSize の VRAM で、ws2812.encode_wire/packed と ws2812.scan_buffer/packed、
+ *   キャッシュ済みの語列を詰め直す wire_pack.inplace を記録します（比べる相手は ws2812.encode_wire と ws2812.scan_buffer）。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchWirePack.h"
+#include "WirePack.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+} // namespace
+
+/**
+ * @brief 詰める形式の送出データ作成と送出を計測します。
+ * @param r 計測
+ */
+void benchWirePack(BenchRunner& r)
+{
+    for (int s = 16; s <= r.config().maxSize && s <= 256; s *= 2) {
+        const uint8_t panels = (uint8_t)(s / 16);
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, panels, panels));
+        const std::size_t pixels = (std::size_t)s * s;
+        const auto data = makeData(pixels, 3);
+        std::copy(data.begin(), data.end(), led->pVRam);
+        std::vector<std::uint32_t> wire(pixels);
+        led->SetPackedWire(true);
+        r.run("ws2812.encode_wire/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->EncodeWire(wire.data(), true, false); });
+        r.run("ws2812.scan_buffer/packed", {{"w", s}, {"h", s}}, (double)pixels, [&] { led->ScanBuffer(true, false); });
+        led->SetPackedWire(false);
+        led->EncodeWire(wire.data(), true, false);
+        std::vector<std::uint32_t> work(pixels);
+        r.run("wire_pack.inplace", {{"w", s}, {"h", s}}, (double)pixels, [&] {
+            std::copy(wire.begin(), wire.end(), work.begin());
+            wire_pack(work.data(), work.data(), pixels);
+        });
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file BenchWirePack.h
+ * @brief 送出データを 4ピクセル = 3語 に詰める形式（WirePack.h、WS2812::SetPackedWire）の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief 詰める形式の送出データ作成と FIFO 送出を計測します（1ピクセル1語の ws2812.* と比べる）。
+ * @param r 計測
+ */
+void benchWirePack(BenchRunner& r);
@@ -0,0 +1,82 @@
+/**
+ * @file BenchWs2812Static.cpp
+ * @brief パネル構成をコンパイル時に決めた WS2812Static の計測
+ * @details
+ * - 計測: 16x16 パネルを並べた一辺 16..maxSize の VRAM で、benchWs2812（BenchScenarios.cpp）と同じ処理を ws2812_static.* として記録します。
+ *   配線は LGMSerialLED.cpp と同じ千鳥・右→左（WS2812SerpentineRL）です。
+ */
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "BenchWs2812Static.h"
+#include "WS2812Static.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/** @brief 一辺 S の VRAM を計測します（16x16 パネルを (S/16)x(S/16) 枚）。 */
+template <int S>
+void benchSize(BenchRunner& r)
+{
+    if (S > r.config().maxSize) return;
+    typedef WS2812Static<16, 16, S / 16, S / 16, WS2812SerpentineRL> Led;
+    std::unique_ptr<Led> led(new Led(22)); // 一辺256で2MB。ホストのスタックに置かない
+    const std::size_t pixels = Led::kPixels;
+    const auto sprite = makeData(16 * 16, 3);
+    std::vector<std::uint32_t> wire(pixels);
+
+    // 定数回のループは全体がインライン展開されるので、1回ごとに VRAM を読み書きしたものとして扱わせる
+    r.run("ws2812_static.clear", {{"w", S}, {"h", S}}, (double)pixels, [&] {
+        led->Clear(0x010203);
+        benchEscape(led.get());
+    });
+    r.run("ws2812_static.set_pixel", {{"w", S}, {"h", S}}, (double)pixels, [&] {
+        for (int y = 0; y < S; y++)
+            for (int x = 0; x < S; x++) led->SetPixel((uint16_t)x, (uint16_t)y, (uint32_t)(x ^ y));
+        benchEscape(led.get());
+    });
+    auto tile = [&](uint32_t colorReplace, bool isOverlay) {
+        for (int y = 0; y < S; y += 16)
+            for (int x = 0; x < S; x += 16) led->DrawBuffer(sprite.data(), 16, 16, (uint8_t)x, (uint8_t)y, colorReplace, isOverlay);
+        benchEscape(led.get());
+    };
+    auto tileSprite = [&](uint32_t colorReplace, bool isOverlay) {
+        for (int y = 0; y < S; y += 16)
+            for (int x = 0; x < S; x += 16) led->template DrawSprite<16, 16>(sprite.data(), (uint8_t)x, (uint8_t)y, colorReplace, isOverlay);
+        benchEscape(led.get());
+    };
+    r.run("ws2812_static.draw_buffer/opaque", {{"w", S}, {"h", S}}, (double)pixels, [&] { tile(0, false); });
+    r.run("ws2812_static.draw_buffer/overlay", {{"w", S}, {"h", S}}, (double)pixels, [&] { tile(0, true); });
+    r.run("ws2812_static.draw_buffer/replace", {{"w", S}, {"h", S}}, (double)pixels, [&] { tile(0x070000, true); });
+    r.run("ws2812_static.draw_sprite/opaque", {{"w", S}, {"h", S}}, (double)pixels, [&] { tileSprite(0, false); });
+    r.run("ws2812_static.draw_sprite/overlay", {{"w", S}, {"h", S}}, (double)pixels, [&] { tileSprite(0, true); });
+    r.run("ws2812_static.scan_buffer", {{"w", S}, {"h", S}}, (double)pixels, [&] { led->ScanBuffer(); });
+    r.run("ws2812_static.encode_wire", {{"w", S}, {"h", S}}, (double)pixels, [&] {
+        led->EncodeWire(wire.data());
+        benchEscape(wire.data());
+    });
+}
+
+} // namespace
+
+/**
+ * @brief WS2812Static の VRAM 操作と送出データの作成を計測します。
+ * @param r 計測
+ */
+void benchWs2812Static(BenchRunner& r)
+{
+    benchSize<16>(r);
+    benchSize<32>(r);
+    benchSize<64>(r);
+    benchSize<128>(r);
+    benchSize<256>(r);
+}
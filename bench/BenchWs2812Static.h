@@ -0,0 +1,13 @@
+/**
+ * @file BenchWs2812Static.h
+ * @brief パネル構成をコンパイル時に決めた WS2812Static の計測
+ */
+#pragma once
+
+#include "BenchRunner.h"
+
+/**
+ * @brief WS2812Static の VRAM 操作と送出データの作成を計測します（ws2812.* と同じ処理を ws2812_static.* として記録）。
+ * @param r 計測
+ */
+void benchWs2812Static(BenchRunner& r);
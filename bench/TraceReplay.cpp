@@ -0,0 +1,332 @@
+/**
+ * @file TraceReplay.cpp
+ * @brief 実機のトレース（TraceRecorder::Dump() の出力）の集計と再実行
+ * @details
+ * 使い方: LGMSerialLED_tracereplay ログ [--folded ファイル] [--json ファイル] [--overhead]
+ * - 実機の記録から、操作ごとの回数/合計/自身の時間/最大を集計します（入れ子は時刻の包含関係から求めます）。
+ * - --folded には flamegraph.pl などで読める "状態;操作;操作 自身の時間(µs)" の形式で出力します。
+ * - 記録された操作（キャラクタの取得、停止/歩行フレーム、Reset/Clear/ScanBuffer）を同じ順に実際のドライバで再実行し、
+ *   操作ごとの CPU 時間と、sleep_us で待つはずだった時間（仮想時計）を出力します。待ち/休止は実行しません。
+ * - --overhead はトレースを無効/有効にしたときの描画のコストを比較します。
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TraceRecorder.h"
+#include "BenchChars.h"
+#include "BenchReport.h"
+#include "HostShims.h"
+#include "WS2812.h"
+#include "PatCache.h"
+#include "FrameRender.h"
+
+namespace {
+
+/** @brief 包含関係から求めた入れ子の1ノード。 */
+struct Node {
+    TraceRecord rec;
+    std::uint64_t start { 0 }; ///< 一周を補正した開始時刻(µs)
+    std::uint32_t durUs { 0 }; ///< 所要時間(µs)
+    int parent { -1 };
+    std::vector<int> children;
+    std::uint64_t childUs { 0 };
+    std::uint64_t end() const { return start + durUs; }
+};
+
+/** @brief 操作ごとの集計。 */
+struct OpStats {
+    std::uint64_t count { 0 };
+    std::uint64_t totalUs { 0 };
+    std::uint64_t selfUs { 0 };
+    std::uint32_t maxUs { 0 };
+    std::uint64_t replayed { 0 };
+    double hostNs { 0 };
+    std::uint64_t hostSleepUs { 0 };
+};
+
+const char* stateName(std::uint8_t s)
+{
+    static const char* const names[] = {"hiber", "stop", "start", "walking", "running", "effect"};
+    return s < sizeof(names) / sizeof(names[0]) ? names[s] : "?";
+}
+
+/** @brief ノードの表示名（状態は状態名つき）。 */
+std::string label(const TraceRecord& r)
+{
+    std::string s = TraceRecorder::OpName(TraceRecorder::OpOf(r));
+    if (TraceRecorder::OpOf(r) == TRACE_STATE) s += std::string(":") + stateName(r.arg8);
+    if (TraceRecorder::OpOf(r) == TRACE_SHOW_CACHED) s += r.arg8 ? ":hit" : ":miss";
+    if (TraceRecorder::OpOf(r) == TRACE_SET_CHAR && r.argA) s += ":prefetch";
+    return s;
+}
+
+/**
+ * @brief 記録から入れ子を作ります。
+ * @details 記録はスコープの終了順なので、あるレコードの子は、それより前に記録されてまだ親が決まっていないもののうち
+ *          深さがそのレコードより大きいものです。親の記録が残っていないもの（出力中の状態など）は最上位になります。
+ *          32ビットの時刻の一周は、先頭のレコードからの差分で補正します（1回の出力が約71分以内であること）。
+ */
+std::vector<Node> buildTree(const std::vector<TraceRecord>& recs)
+{
+    std::vector<Node> nodes(recs.size());
+    const std::uint32_t first = recs.empty() ? 0 : recs[0].startUs;
+    std::vector<int> pending;
+    for (std::size_t i = 0; i < recs.size(); i++) {
+        Node& n = nodes[i];
+        n.rec = recs[i];
+        n.durUs = TraceRecorder::DecodeDuration(recs[i].dur);
+        // 先頭は内側のスコープのことがあるので、差を符号付きで扱う
+        n.start = (std::uint64_t)((std::int64_t)0x100000000ll + (std::int32_t)(recs[i].startUs - first));
+        const std::uint8_t depth = TraceRecorder::DepthOf(n.rec);
+        while (!pending.empty() && TraceRecorder::DepthOf(nodes[pending.back()].rec) > depth) {
+            const int child = pending.back();
+            pending.pop_back();
+            nodes[child].parent = (int)i;
+            n.children.push_back(child);
+            n.childUs += nodes[child].durUs;
+        }
+        pending.push_back((int)i);
+    }
+    for (Node& n : nodes) {
+        std::sort(n.children.begin(), n.children.end(), [&](int a, int b) { return nodes[a].start < nodes[b].start; });
+    }
+    return nodes;
+}
+
+/** @brief 実際のドライバで記録を再実行するクラス。 */
+class Replayer {
+public:
+    Replayer() : led_(new WS2812(22, 16, 16)) {}
+
+    /**
+     * @brief ノードを再実行します（再実行できない操作は子を再実行）。
+     * @param nodes 入れ子
+     * @param idx ノード
+     * @param stats 集計先
+     */
+    void run(const std::vector<Node>& nodes, int idx, std::map<std::string, OpStats>& stats)
+    {
+        const TraceRecord& r = nodes[idx].rec;
+        const std::uint64_t sleep0 = g_benchSink.sleptUs;
+        const auto t0 = std::chrono::steady_clock::now();
+        if (!execute(r)) {
+            for (int c : nodes[idx].children) run(nodes, c, stats);
+            return;
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        OpStats& s = stats[label(r)];
+        s.replayed++;
+        s.hostNs += ns;
+        s.hostSleepUs += g_benchSink.sleptUs - sleep0;
+    }
+
+    /** @brief 再実行できなかった DrawBuffer の数（パターンの内容が記録にないもの）。 */
+    std::uint64_t skipped() const { return skipped_; }
+
+private:
+    /** @brief 1件を実行します。@return 実行したらtrue（子は実行しない） */
+    bool execute(const TraceRecord& r)
+    {
+        switch (TraceRecorder::OpOf(r)) {
+        case TRACE_SET_CHAR:
+            if (r.arg8 >= BENCH_CHAR_COUNT) return false;
+            if (r.argA) cache_.prefetch(g_benchCharsBaked[r.arg8]);
+            else cache_.acquire(g_benchCharsBaked[r.arg8]);
+            return true;
+        case TRACE_STOP_FRAME: {
+            if (r.arg8 >= BENCH_CHAR_COUNT) return false;
+            PatSet* set = cache_.acquire(g_benchCharsBaked[r.arg8]);
+            if (set) drawStopFrame(*led_, g_benchCharsBaked[r.arg8], set->stay, (std::uint64_t)r.argB << 32 | r.argA);
+            return true;
+        }
+        case TRACE_RUN_FRAME: {
+            if (r.arg8 >= BENCH_CHAR_COUNT) return false;
+            const std::uint8_t grp = r.argA & 0x7F;
+            const bool isBlend = ((r.argA >> 7) & 1) != 0;
+            const std::size_t prev = r.argA >> 8, curr = r.argB;
+            const Patterns& ch = g_benchCharsBaked[r.arg8];
+            PatSet* set = cache_.acquire(ch);
+            if (set && grp < 4) {
+                drawRunFrame(*led_, ch, set->run[grp], prev, curr, isBlend, frameKey(r.arg8, grp, prev, curr, isBlend || ch.isOverlay, isBlend));
+            }
+            return true;
+        }
+        case TRACE_RESET:
+            led_->Reset();
+            return true;
+        case TRACE_CLEAR:
+            led_->Clear(r.argA);
+            return true;
+        case TRACE_SCAN_BUFFER:
+            led_->ScanBuffer((r.arg8 & 1) != 0, (r.arg8 & 2) != 0);
+            return true;
+        case TRACE_DRAW_BUFFER:
+            skipped_++;
+            return true;
+        default:
+            return false; // 状態/待ち/休止/クロック: 子だけ再実行（待ちは仮想時計で扱うので実行しない）
+        }
+    }
+
+    std::unique_ptr<WS2812> led_;
+    PatCache cache_;
+    std::uint64_t skipped_ { 0 };
+};
+
+/** @brief flamegraph 用の "a;b;c 値" を出力します（値は自身の時間）。 */
+void writeFolded(std::FILE* out, const std::vector<Node>& nodes)
+{
+    std::map<std::string, std::uint64_t> folded;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        std::string path = label(nodes[i].rec);
+        for (int p = nodes[i].parent; p >= 0; p = nodes[p].parent) path = label(nodes[p].rec) + ";" + path;
+        const std::uint64_t self = nodes[i].durUs > nodes[i].childUs ? nodes[i].durUs - nodes[i].childUs : 0;
+        folded[path] += self;
+    }
+    for (const auto& f : folded) {
+        if (f.second) std::fprintf(out, "%s %llu\n", f.first.c_str(), (unsigned long long)f.second);
+    }
+}
+
+/** @brief トレースの無効/有効による描画コストの比較。 */
+void measureOverhead()
+{
+    WS2812 led(22, 16, 16);
+    PatCache cache;
+    PatSet* set = cache.acquire(g_benchCharsBaked[1]);
+    led.SetWireCacheBudget(0); // 毎回描画する
+    const int n = 20000;
+    auto once = [&] {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; i++) {
+            drawRunFrame(led, g_benchCharsBaked[1], set->run[0], i % 3, (i + 1) % 3, (i & 1) != 0, 0);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+    };
+    double off = 1e30, on = 1e30;
+    for (int rep = 0; rep < 5; rep++) {
+        g_trace.Enable(false);
+        off = std::min(off, once());
+        g_trace.Enable(true);
+        on = std::min(on, once());
+        g_trace.Clear();
+    }
+    g_trace.Enable(false);
+    std::printf("overhead: run_frame %.1f ns (trace disabled), %.1f ns (enabled), %+.1f%%\n", off, on, (on - off) * 100.0 / off);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char* logPath = nullptr;
+    const char* foldedPath = nullptr;
+    const char* jsonPath = nullptr;
+    bool overhead = false;
+    for (int i = 1; i < argc; i++) {
+        const bool hasNext = i + 1 < argc;
+        if (std::strcmp(argv[i], "--folded") == 0 && hasNext) foldedPath = argv[++i];
+        else if (std::strcmp(argv[i], "--json") == 0 && hasNext) jsonPath = argv[++i];
+        else if (std::strcmp(argv[i], "--overhead") == 0) overhead = true;
+        else if (argv[i][0] != '-' && logPath == nullptr) logPath = argv[i];
+        else {
+            std::fprintf(stderr, "usage: %s LOG|- [--folded FILE] [--json FILE] [--overhead]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (overhead) {
+        measureOverhead();
+        if (logPath == nullptr) return 0;
+    }
+    if (logPath == nullptr) {
+        std::fprintf(stderr, "usage: %s LOG|- [--folded FILE] [--json FILE] [--overhead]\n", argv[0]);
+        return 2;
+    }
+
+    std::FILE* in = std::strcmp(logPath, "-") == 0 ? stdin : std::fopen(logPath, "r");
+    if (in == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", logPath);
+        return 1;
+    }
+    std::vector<TraceRecord> recs;
+    char line[256];
+    while (std::fgets(line, sizeof(line), in) != nullptr) {
+        TraceRecord r;
+        if (TraceRecorder::ParseLine(line, r)) recs.push_back(r);
+    }
+    if (in != stdin) std::fclose(in);
+    if (recs.empty()) {
+        std::fprintf(stderr, "no " TRACE_DUMP_LINE " lines in %s\n", logPath);
+        return 1;
+    }
+
+    const std::vector<Node> nodes = buildTree(recs);
+    std::map<std::string, OpStats> stats;
+    for (const Node& n : nodes) {
+        OpStats& s = stats[label(n.rec)];
+        s.count++;
+        s.totalUs += n.durUs;
+        s.selfUs += n.durUs > n.childUs ? n.durUs - n.childUs : 0;
+        s.maxUs = std::max<std::uint32_t>(s.maxUs, n.durUs);
+    }
+
+    // 最上位（親なし）から時刻順に再実行
+    Replayer replayer;
+    std::vector<int> roots;
+    for (std::size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].parent < 0) roots.push_back((int)i);
+    }
+    std::sort(roots.begin(), roots.end(), [&](int a, int b) { return nodes[a].start < nodes[b].start; });
+    for (int r : roots) replayer.run(nodes, r, stats);
+
+    std::printf("%-24s %8s %12s %12s %10s | %8s %12s %12s\n", "op", "count", "dev total", "dev self", "dev max", "replayed",
+                "host cpu/op", "host sleep");
+    std::printf("%-24s %8s %12s %12s %10s | %8s %12s %12s\n", "", "", "(us)", "(us)", "(us)", "", "(ns)", "(us/op)");
+    BenchReport report;
+    for (const auto& e : stats) {
+        const OpStats& s = e.second;
+        const double hostPer = s.replayed ? s.hostNs / (double)s.replayed : 0;
+        const double sleepPer = s.replayed ? (double)s.hostSleepUs / (double)s.replayed : 0;
+        std::printf("%-24s %8llu %12llu %12llu %10u | %8llu %12.1f %12.1f\n", e.first.c_str(), (unsigned long long)s.count,
+                    (unsigned long long)s.totalUs, (unsigned long long)s.selfUs, (unsigned)s.maxUs, (unsigned long long)s.replayed,
+                    hostPer, sleepPer);
+        if (s.replayed) {
+            BenchResult r;
+            r.name = "replay." + e.first;
+            r.params.emplace_back("count", (long)s.replayed);
+            r.iterations = s.replayed;
+            r.nsPerIter = hostPer;
+            r.nsMedian = hostPer;
+            report.add(r);
+        }
+    }
+    if (replayer.skipped()) {
+        std::printf("(%llu draw_buffer records outside a frame were not replayed: pattern data is not in the trace)\n",
+                    (unsigned long long)replayer.skipped());
+    }
+
+    if (foldedPath != nullptr) {
+        std::FILE* out = std::fopen(foldedPath, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", foldedPath);
+            return 1;
+        }
+        writeFolded(out, nodes);
+        std::fclose(out);
+    }
+    if (jsonPath != nullptr) {
+        std::FILE* out = std::fopen(jsonPath, "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", jsonPath);
+            return 1;
+        }
+        report.writeJson(out, "LGMSerialLED trace replay");
+        std::fclose(out);
+    }
+    return 0;
+}
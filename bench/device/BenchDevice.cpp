@@ -0,0 +1,295 @@
+/**
+ * @file BenchDevice.cpp
+ * @brief 実機用ベンチマーク（LGMSerialLED_bench）のエントリーポイント
+ * @details
+ * - 本体（LGMSerialLED）と同じ処理（PatManager の補正、DrawBuffer、実際の PIO への ScanBuffer、Reset など）を
+ *   サイクルカウンタで計測し、起動直後に UART へ結果行（BenchFormat.h の形式）を出力します。
+ * - 各処理は割り込みを止めて BENCH_SAMPLES 回計測します。最初の1回も含めるので、max には XIP キャッシュミスが現れます。
+ * - ホストでは LGMSerialLED_hostbench --from-log でログを表/JSON に変換できます。
+ */
+#include <stdio.h>
+#include <cstdint>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include "WS2812.h"
+#include "GammaCorrector.h"
+#include "PixelOps.h"
+#include "PatManager.h"
+#include "PatCache.h"
+#include "Patterns.h"
+#include "FrameRender.h"
+#include "HUB75Planes.h"
+#include "APA102Frame.h"
+#include "SpriteBlit.h"
+#include "LedCalibration.h"
+#include "Effects.h"
+#include "CoroScheduler.h"
+#include "FrameStream.h"
+#include "PatMario.h"
+#include "BenchChars.h"
+#include "BenchFormat.h"
+#include "Checks.h"
+#include "CycleCounter.h"
+
+#define PIN_WS2812_1 22             ///< GPIO 22（本体と同じ）
+#define SYS_CLOCK_KHZ_BENCH 150000  ///< 計測時の clk_sys（本体の描画時と同じ）
+#define BENCH_SAMPLES 32            ///< 1件あたりの計測回数
+
+static uint32_t samples[BENCH_SAMPLES];
+
+/**
+ * @brief 処理を計測して結果行を出力します。
+ * @param key 名前とパラメータ
+ * @param items 1回あたりの処理量
+ * @param fn 計測する処理
+ * @return なし
+ */
+template <class F>
+static void measure(const char* key, uint32_t items, F&& fn)
+{
+	// カウンタを読み出すだけの時間を差し引く
+	static uint32_t overhead = 0xFFFFFFFFu;
+	if (overhead == 0xFFFFFFFFu) {
+		uint32_t t0 = cycle_counter_read();
+		uint32_t t1 = cycle_counter_read();
+		overhead = t1 - t0;
+	}
+	for (int i = 0; i < BENCH_SAMPLES; i++) {
+		uint32_t irq = save_and_disable_interrupts();
+		uint32_t t0 = cycle_counter_read();
+		fn();
+		uint32_t t1 = cycle_counter_read();
+		restore_interrupts(irq);
+		samples[i] = (t1 - t0) > overhead ? (t1 - t0) - overhead : 0;
+	}
+
+	BenchStats s = benchStats(samples, BENCH_SAMPLES);
+	char line[200];
+	formatBenchLine(line, sizeof(line), key, s, clock_get_hz(clk_sys), items);
+	puts(line);
+}
+
+/**
+ * @brief 次のフレームを待ち続けるスクリプト（coro.resume の計測用）。
+ * @param count 再開の回数
+ * @return スクリプト
+ */
+static CoroTask frameLoop(uint32_t& count)
+{
+	while (true) {
+		count++;
+		co_await coro_next_frame();
+	}
+}
+
+/**
+ * @brief エントリーポイント。
+ * @return 実行ステータス
+ */
+int main()
+{
+	set_sys_clock_khz(SYS_CLOCK_KHZ_BENCH, true);
+	stdio_init_all();
+	sleep_ms(500); // UART の受信側の準備を待つ
+	cycle_counter_enable();
+
+	WS2812 led_matrix(PIN_WS2812_1, 16, 16);
+	led_matrix.Reset();
+	led_matrix.Clear(0);
+	led_matrix.ScanBuffer();
+
+	printf(BENCH_BEGIN_TAG " suite=LGMSerialLED_bench clk_sys=%lu samples=%d\n", (unsigned long)clock_get_hz(clk_sys), BENCH_SAMPLES);
+
+	// パターンの補正（マリオ: 16x16 x MROPatCount）
+	const uint32_t patPixels = (uint32_t)(16 * 16 * MROPatCount);
+	PatManager pm;
+	measure("patmanager.init[w=16,h=16]", patPixels, [&] { pm.init(&MRORun[0][0], MROPatCount, 16, 16); });
+	measure("patmanager.set_green_range[w=16,h=16]", patPixels, [&] { pm.setGreenRange(0, 16); });
+	measure("patmanager.set_red_range[w=16,h=16]", patPixels, [&] { pm.setRedRange(0, 16); });
+	measure("patmanager.set_blue_range[w=16,h=16]", patPixels, [&] { pm.setBlueRange(0, 16); });
+	measure("patmanager.set_gamma[w=16,h=16]", patPixels, [&] { pm.setGamma(2.2f); });
+	measure("patmanager.set_brightness_contrast[w=16,h=16]", patPixels, [&] { pm.setBrightnessContrast(10, 20); });
+
+	GammaCorrector gc(2.2f);
+	volatile uint32_t sink = 0;
+	measure("gamma_corrector.correct[w=16,h=16]", 256, [&] {
+		uint32_t acc = 0;
+		for (int i = 0; i < 256; i++) acc ^= gc.correct(MROStay[i]);
+		sink = acc;
+	});
+
+	// VRAM の操作
+	measure("ws2812.clear[w=16,h=16]", 256, [&] { led_matrix.Clear(0x010203); });
+	measure("ws2812.set_pixel[w=16,h=16]", 256, [&] {
+		for (uint16_t y = 0; y < 16; y++)
+			for (uint16_t x = 0; x < 16; x++) led_matrix.SetPixel(x, y, (uint32_t)(x ^ y));
+	});
+	measure("ws2812.draw_buffer/opaque[w=16,h=16]", 256, [&] { led_matrix.DrawBuffer(MROStay, 16, 16, 0, 0, 0, false); });
+	measure("ws2812.draw_buffer/overlay[w=16,h=16]", 256, [&] { led_matrix.DrawBuffer(MROStay, 16, 16, 0, 0, 0, true); });
+	measure("ws2812.scale[w=16,h=16]", 256, [&] { led_matrix.Scale(200); });
+	measure("ws2812.blend[w=16,h=16]", 256, [&] { led_matrix.Blend(&MRORun[0][0], 64); });
+	measure("ws2812.limit_power[w=16,h=16]", 256, [&] { led_matrix.LimitPower(256 * 60); });
+
+	// 実際の PIO への送出（FIFO の詰まりとリセット期間を含む）
+	static uint32_t wire[256];
+	measure("ws2812.encode_wire[w=16,h=16]", 256, [&] { led_matrix.EncodeWire(wire, true, false); });
+	measure("ws2812.scan_buffer[w=16,h=16]", 256, [&] { led_matrix.ScanBuffer(true, false); });
+	measure("ws2812.reset[w=16,h=16]", 0, [&] { led_matrix.Reset(); });
+	// 4ピクセル = 3語 に詰めた送出（autopull 32bit）
+	led_matrix.SetPackedWire(true);
+	measure("ws2812.encode_wire/packed[w=16,h=16]", 256, [&] { led_matrix.EncodeWire(wire, true, false); });
+	measure("ws2812.scan_buffer/packed[w=16,h=16]", 256, [&] { led_matrix.ScanBuffer(true, false); });
+	led_matrix.SetPackedWire(false);
+	// 色補正（送出データへの変換時に掛ける）
+	{
+		static const float kMix[9] = {0.95f, 0.03f, 0.0f, 0.02f, 0.9f, -0.04f, 0.0f, 0.05f, 0.85f};
+		static LedColorMatrix mat;
+		static uint8_t gain[256];
+		ledcal_matrix_from_float(kMix, mat);
+		for (int i = 0; i < 256; i++) gain[i] = (uint8_t)(192 + (i * 37) % 64);
+		led_matrix.SetCalibration(nullptr, gain);
+		measure("ledcal.encode_wire/gain[w=16,h=16]", 256, [&] { led_matrix.EncodeWire(wire, true, false); });
+		led_matrix.SetCalibration(&mat, nullptr);
+		measure("ledcal.encode_wire/matrix[w=16,h=16]", 256, [&] { led_matrix.EncodeWire(wire, true, false); });
+		led_matrix.SetCalibration(&mat, gain);
+		measure("ledcal.encode_wire/matrix_gain[w=16,h=16]", 256, [&] { led_matrix.EncodeWire(wire, true, false); });
+		measure("ledcal.scan_buffer/matrix_gain[w=16,h=16]", 256, [&] { led_matrix.ScanBuffer(true, false); });
+		led_matrix.SetCalibration(nullptr, nullptr);
+	}
+	led_matrix.ScanBufferCached(1, true, false);
+	measure("wire_cache.hit[w=16,h=16]", 256, [&] {
+		led_matrix.ShowCached(1, true, false);
+		led_matrix.WaitTransmit();
+	});
+
+	static uint32_t px[256];
+	measure("pixelops.blend/packed[w=16,h=16]", 256, [&] { pixelops::px_blend_buffer(px, MROStay, &MRORun[0][0], 256, 100); });
+	measure("pixelops.blend/ref[w=16,h=16]", 256, [&] {
+		for (int i = 0; i < 256; i++) px[i] = pixelops::ref::blend(MROStay[i], MRORun[0][i], 100);
+	});
+	measure("pixelops.add_sat/packed[w=16,h=16]", 256, [&] {
+		for (int i = 0; i < 256; i++) px[i] = MROStay[i];
+		pixelops::px_add_buffer(px, &MRORun[0][0], 256);
+	});
+	measure("pixelops.add_sat/ref[w=16,h=16]", 256, [&] {
+		for (int i = 0; i < 256; i++) px[i] = pixelops::ref::add_sat(MROStay[i], MRORun[0][i]);
+	});
+	measure("pixelops.max/packed[w=16,h=16]", 256, [&] {
+		for (int i = 0; i < 256; i++) px[i] = MROStay[i];
+		pixelops::px_max_buffer(px, &MRORun[0][0], 256);
+	});
+	measure("pixelops.max/ref[w=16,h=16]", 256, [&] {
+		for (int i = 0; i < 256; i++) px[i] = pixelops::ref::max(MROStay[i], MRORun[0][i]);
+	});
+	measure("pixelops.sum/packed[w=16,h=16]", 256, [&] { px[0] = pixelops::px_sum_buffer(MROStay, 256); });
+	measure("pixelops.sum/ref[w=16,h=16]", 256, [&] {
+		uint32_t acc = 0;
+		for (int i = 0; i < 256; i++) acc += pixelops::ref::sum(MROStay[i]);
+		px[0] = acc;
+	});
+
+	// キャラクタ切替（パターン一式の取得と停止表示の送出）
+	{
+		PatCache cache;
+		int charNo = 0;
+		measure("scenario.char_switch/runtime/uncached[w=16,h=16]", 256, [&] {
+			charNo = (charNo + 1) % BENCH_CHAR_COUNT;
+			cache.clear();
+			led_matrix.ClearWireCache();
+			PatSet* set = cache.acquire(g_benchCharsRuntime[charNo]);
+			if (set) drawStopFrame(led_matrix, g_benchCharsRuntime[charNo], set->stay, frameKey(charNo, FRAME_KEY_STOP, 0, 0, false, false));
+		});
+	}
+	{
+		PatCache cache;
+		int charNo = 0;
+		measure("scenario.char_switch/baked[w=16,h=16]", 256, [&] {
+			charNo = (charNo + 1) % BENCH_CHAR_COUNT;
+			PatSet* set = cache.acquire(g_benchCharsBaked[charNo]);
+			if (set) drawStopFrame(led_matrix, g_benchCharsBaked[charNo], set->stay, frameKey(charNo, FRAME_KEY_STOP, 0, 0, false, false));
+			led_matrix.WaitTransmit();
+		});
+	}
+	// HUB75: VRAM→ビットプレーンの変換（Show() のCPU時間。走査自体はCPUを使わない）
+	{
+		static uint32_t vram[64 * 64];
+		static uint32_t planes[64 / 2 * HUB75_MAX_DEPTH * 64 / 4];
+		static uint16_t lut[256];
+		for (uint32_t i = 0; i < 64 * 64; i++) vram[i] = MRORun[0][i % 256];
+		const Hub75Geometry g8 = {64, 64, 8};
+		const Hub75Geometry g10 = {64, 64, 10};
+		hub75_build_lut(8, 1.0f, lut);
+		measure("hub75.encode_planes[w=64,h=64,depth=8]", 64 * 64, [&] { hub75_encode_planes(vram, 64, g8, lut, planes); });
+		hub75_build_lut(10, 1.0f, lut);
+		measure("hub75.encode_planes[w=64,h=64,depth=10]", 64 * 64, [&] { hub75_encode_planes(vram, 64, g10, lut, planes); });
+	}
+	// APA102: VRAM→送出フレーム（16x16、ピクセルごとに5bit輝度を選ぶ）
+	{
+		static uint8_t frame[APA102_START_BYTES + 256 * APA102_LED_BYTES + 4 + 16];
+		static uint16_t lut[256];
+		apa102_build_lut(2.2f, 256, lut);
+		measure("apa102.encode_frame[w=16,h=16]", 256, [&] {
+			uint8_t* p = apa102_write_start(frame);
+			p = apa102_encode_pixels(MROStay, 256, 1, lut, p);
+			apa102_write_end(p, 256);
+		});
+	}
+	// 変形描画: 16x16 → 64x64（4倍、任意角）
+	{
+		static uint32_t vram[64 * 64];
+		SpriteXform x4, rot;
+		sprite_xform_make(16, 16, 32 * SPRITE_ONE, 32 * SPRITE_ONE, 4 * SPRITE_ONE, 4 * SPRITE_ONE, 0, x4);
+		sprite_xform_make(16, 16, 32 * SPRITE_ONE, 32 * SPRITE_ONE, 3 * SPRITE_ONE + SPRITE_ONE / 2, 3 * SPRITE_ONE + SPRITE_ONE / 2, 37, rot);
+		measure("sprite.blit/nearest/scale4[w=64,h=64]", 64 * 64, [&] { sprite_blit(vram, 64, 64, MROStay, 16, 16, x4, SPRITE_NEAREST, 0, true); });
+		measure("sprite.blit/bilinear/scale4[w=64,h=64]", 64 * 64, [&] { sprite_blit(vram, 64, 64, MROStay, 16, 16, x4, SPRITE_BILINEAR, 0, true); });
+		measure("sprite.blit/nearest/rotate[w=64,h=64]", 64 * 64, [&] { sprite_blit(vram, 64, 64, MROStay, 16, 16, rot, SPRITE_NEAREST, 0, true); });
+		measure("sprite.blit/bilinear/rotate[w=64,h=64]", 64 * 64, [&] { sprite_blit(vram, 64, 64, MROStay, 16, 16, rot, SPRITE_BILINEAR, 0, true); });
+	}
+	// エフェクト: 64x64 の1フレーム（60FPS なら 16.6ms = clk_sys 150MHz で 2.5M サイクル以内）
+	{
+		static uint32_t vram[64 * 64];
+		static EffectEngine fx;
+		fx.begin(64, 64);
+		for (int k = 0; k < EFFECT_COUNT; k++) {
+			char key[48];
+			snprintf(key, sizeof(key), "effect.%s[w=64,h=64]", EffectEngine::name((EFFECT_KIND)k));
+			fx.select((EFFECT_KIND)k);
+			uint32_t t = 0;
+			measure(key, 64 * 64, [&] {
+				fx.render(vram, t);
+				t += 16;
+			});
+		}
+	}
+	// スクリプトの再開: 次のフレームを待つ N 本を1フレーム進める（フレームはプールから確保）
+	{
+		static CoroScheduler sched;
+		static uint32_t count = 0;
+		uint32_t t = 0;
+		sched.setFramePeriod(1, t);
+		for (int i = 0; i < CORO_MAX_TASKS; i++) sched.spawn(frameLoop(count));
+		measure("coro.resume[tasks=8]", CORO_MAX_TASKS, [&] { sched.run(++t); });
+	}
+	// フラッシュ上の焼き込み済みパターンを先読みしながら取り出す（DMA の完了待ちを含む）
+	{
+		static uint32_t ring[FRAME_STREAM_SLOTS * 16 * 16];
+		static FrameStream film;
+		if (film.openRaw(MRORunBaked, MROPatCount, 16, 16, ring, sizeof(ring) / sizeof(ring[0]))) {
+			size_t i = 0;
+			measure("stream.frame/raw[w=16,h=16]", 16 * 16, [&] { sink = film.frame(i++)[0]; });
+			film.close();
+		}
+	}
+	(void)sink;
+
+	// DSP 命令の経路（px_*）と基準実装のビット単位の比較（結果行ではないので --from-log では読み飛ばされる）
+	runPixelOpsCheck(stdout);
+
+	printf(BENCH_END_TAG "\n");
+	led_matrix.Clear(0);
+	led_matrix.ScanBuffer();
+	while (true) {
+		__wfi();
+	}
+}
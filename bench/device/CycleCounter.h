@@ -0,0 +1,44 @@
+/**
+ * @file CycleCounter.h
+ * @brief サイクルカウンタ（Cortex-M33 の DWT_CYCCNT）
+ * @details
+ * - clk_sys の1サイクルごとに1増える32ビットのカウンタです。150MHz で約28秒で一周するため、
+ *   差分は uint32_t の引き算で求めます（1回の計測は一周より十分短いこと）。
+ * - RISC-V（Hazard3）でビルドした場合は mcycle を使います。
+ */
+#pragma once
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#if PICO_RISCV
+#include "hardware/riscv.h"
+#else
+#include "hardware/structs/m33.h"
+#endif
+
+/**
+ * @brief サイクルカウンタを有効にします。
+ * @return なし
+ */
+static inline void cycle_counter_enable(void)
+{
+#if !PICO_RISCV
+	// PPB のレジスタには原子的なセットのエイリアスがないため読み書きで（volatile への |= は C++20 で非推奨）
+	m33_hw->demcr = m33_hw->demcr | M33_DEMCR_TRCENA_BITS;
+	m33_hw->dwt_cyccnt = 0;
+	m33_hw->dwt_ctrl = m33_hw->dwt_ctrl | M33_DWT_CTRL_CYCCNTENA_BITS;
+#endif
+}
+
+/**
+ * @brief サイクルカウンタの現在値。
+ * @return サイクル数（32ビットで一周）
+ */
+static inline uint32_t cycle_counter_read(void)
+{
+#if PICO_RISCV
+	return (uint32_t)riscv_read_csr(mcycle);
+#else
+	return m33_hw->dwt_cyccnt;
+#endif
+}
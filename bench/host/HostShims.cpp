@@ -0,0 +1,232 @@
+/**
+ * @file HostShims.cpp
+ * @brief ホスト代替ヘッダ（bench/host）の実装
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "HostShims.h"
+
+pio_hw_t bench_pio0;
+pll_hw_t bench_pll_sys;
+
+BenchSink g_benchSink;
+BenchWireLog g_benchWireLog;
+
+namespace {
+    /** @brief 予定済みのアラーム。 */
+    struct BenchAlarm {
+        alarm_id_t id;
+        uint64_t atUs;
+        alarm_callback_t callback;
+        void* user;
+    };
+
+    const size_t kAlarmMax = 16;       ///< SDK の既定のアラームプールと同じ数
+    const uint32_t kGpioCount = 48;
+
+    bool s_virtual = false;            ///< 仮想時計を使う
+    uint64_t s_nowUs = 0;              ///< 仮想時刻(µs)
+    std::vector<BenchAlarm> s_alarms;  ///< 予定済みのアラーム
+    alarm_id_t s_lastAlarmId = 0;
+    bool s_eventReg = false;           ///< __sev() で立つイベントレジスタ
+    bool s_gpioLow[kGpioCount] {};     ///< Low のピン（既定はプルアップで High）
+    uint32_t s_gpioIrq[kGpioCount] {}; ///< 有効なエッジ
+    gpio_irq_callback_t s_gpioCallback = nullptr;
+    uint32_t s_clkSysHz = 150000000u;  ///< clk_sys（RP2350 の既定）
+    bool s_pllSysRunning = true;       ///< PLL_SYS が動いている
+
+    /** @brief 最も早いアラームの位置（無ければ s_alarms.size()）。 */
+    size_t earliest_alarm()
+    {
+        size_t best = s_alarms.size();
+        for (size_t i = 0; i < s_alarms.size(); i++) {
+            if (best == s_alarms.size() || s_alarms[i].atUs < s_alarms[best].atUs) best = i;
+        }
+        return best;
+    }
+}
+
+/** @brief 起動からの時間(µs)。 */
+uint64_t time_us_64(void)
+{
+    if (s_virtual) return s_nowUs;
+    static const auto t0 = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/** @brief 待ち時間の記録（待たない）。仮想時計なら、その間のアラームを実行して時刻を進める。 */
+void bench_sleep_us(uint64_t us)
+{
+    g_benchSink.sleptUs += us;
+    if (!s_virtual) return;
+    const uint64_t end = s_nowUs + us;
+    for (size_t i = earliest_alarm(); i < s_alarms.size() && s_alarms[i].atUs <= end; i = earliest_alarm()) {
+        bench_alarm_run_next();
+    }
+    s_nowUs = end;
+}
+
+/** @brief 仮想時計への切り替え。 */
+void bench_clock_virtual(bool on, uint64_t startUs)
+{
+    s_virtual = on;
+    s_nowUs = startUs;
+    s_alarms.clear();
+    s_eventReg = false;
+}
+
+/** @brief アラームの登録（満杯なら -1）。 */
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void* user_data, bool fire_if_past)
+{
+    (void)fire_if_past;
+    if (s_alarms.size() >= kAlarmMax) return -1;
+    s_alarms.push_back(BenchAlarm { ++s_lastAlarmId, time_us_64() + us, callback, user_data });
+    return s_lastAlarmId;
+}
+
+/** @brief アラームの取り消し。 */
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    for (size_t i = 0; i < s_alarms.size(); i++) {
+        if (s_alarms[i].id != alarm_id) continue;
+        s_alarms.erase(s_alarms.begin() + (ptrdiff_t)i);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 最も早いアラームの実行。
+ * @details コールバックの戻り値が正なら予定時刻から、負なら現在時刻から、その時間(µs)後に同じ番号で再実行します。
+ */
+bool bench_alarm_run_next()
+{
+    const size_t i = earliest_alarm();
+    if (i == s_alarms.size()) return false;
+    BenchAlarm a = s_alarms[i];
+    s_alarms.erase(s_alarms.begin() + (ptrdiff_t)i);
+    if (a.atUs > s_nowUs) s_nowUs = a.atUs;
+    const int64_t r = a.callback(a.id, a.user);
+    if (r != 0) {
+        a.atUs = r > 0 ? a.atUs + (uint64_t)r : s_nowUs + (uint64_t)-r;
+        s_alarms.push_back(a);
+    }
+    return true;
+}
+
+/** @brief 予定済みのアラームの数。 */
+size_t bench_alarm_pending()
+{
+    return s_alarms.size();
+}
+
+/** @brief イベントレジスタを立てる。 */
+void __sev(void)
+{
+    s_eventReg = true;
+}
+
+/** @brief イベントレジスタが立つまで、アラームを実行しながら待つ（待つものが無ければ終了）。 */
+void __wfe(void)
+{
+    if (!s_eventReg && !bench_alarm_run_next()) {
+        std::fprintf(stderr, "__wfe: no event and no alarm to wait for\n");
+        std::abort();
+    }
+    s_eventReg = false;
+}
+
+/** @brief ピンのレベル。 */
+bool gpio_get(uint gpio)
+{
+    return gpio < kGpioCount && !s_gpioLow[gpio];
+}
+
+/** @brief エッジ割り込みの設定（コールバックは全ピンで共通）。 */
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback)
+{
+    if (gpio >= kGpioCount) return;
+    s_gpioIrq[gpio] = enabled ? (s_gpioIrq[gpio] | event_mask) : (s_gpioIrq[gpio] & ~event_mask);
+    s_gpioCallback = callback;
+}
+
+/** @brief ピンのレベルを変え、有効なエッジならコールバックを呼ぶ。 */
+void bench_gpio_set(uint32_t pin, bool level)
+{
+    if (pin >= kGpioCount || gpio_get(pin) == level) return;
+    s_gpioLow[pin] = !level;
+    const uint32_t edge = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if ((s_gpioIrq[pin] & edge) && s_gpioCallback) s_gpioCallback(pin, edge);
+}
+
+/** @brief TX FIFO への書き込み（1語）。 */
+void bench_fifo_put(uint32_t v)
+{
+    g_benchSink.fifoWords++;
+    g_benchSink.hash = (g_benchSink.hash ^ v) * 16777619u;
+    if (g_benchWireLog.enabled) g_benchWireLog.words.push_back(v);
+}
+
+/** @brief TX FIFO のクリア（WS2812 のリセットラッチの開始）。 */
+void bench_pio_clear_fifos()
+{
+    if (g_benchWireLog.enabled) g_benchWireLog.latches.push_back(g_benchWireLog.words.size());
+}
+
+/** @brief DMA 転送の開始（語数だけ記録）。 */
+void bench_dma_transfer(const volatile void* src, uint32_t count)
+{
+    g_benchSink.dmaWords += count;
+    if (count) g_benchSink.hash = (g_benchSink.hash ^ *(const volatile uint32_t*)src) * 16777619u;
+    if (g_benchWireLog.enabled) {
+        const uint32_t* p = (const uint32_t*)src;
+        g_benchWireLog.words.insert(g_benchWireLog.words.end(), p, p + count);
+    }
+}
+
+/** @brief クロックの周波数（clk_ref は XOSC、clk_peri は 150MHz のまま）。 */
+uint32_t clock_get_hz(enum clock_index clk)
+{
+    if (clk == clk_sys) return s_clkSysHz;
+    return clk == clk_ref ? XOSC_HZ : 150000000u;
+}
+
+/** @brief クロックの切り替え（clk_sys の周波数だけを記録）。 */
+bool clock_configure(enum clock_index clk, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq)
+{
+    (void)src;
+    (void)auxsrc;
+    if (freq > src_freq) return false;
+    if (clk == clk_sys) s_clkSysHz = freq;
+    return true;
+}
+
+/** @brief PLL_SYS から clk_sys を設定（PLL_SYS を動かす）。 */
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    (void)required;
+    s_clkSysHz = freq_khz * 1000u;
+    s_pllSysRunning = true;
+    return true;
+}
+
+/** @brief PLL の停止。 */
+void pll_deinit(PLL pll)
+{
+    if (pll == pll_sys) s_pllSysRunning = false;
+}
+
+/** @brief PLL_SYS が動いているか。 */
+bool bench_pll_sys_running()
+{
+    return s_pllSysRunning;
+}
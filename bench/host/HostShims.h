@@ -0,0 +1,59 @@
+/**
+ * @file HostShims.h
+ * @brief ホスト代替の FIFO/DMA が記録する値
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/** @brief FIFO/DMA への送出の記録。 */
+struct BenchSink {
+    uint64_t fifoWords; ///< CPU が FIFO へ書いた語数
+    uint64_t dmaWords;  ///< DMA で送った語数
+    uint32_t hash;      ///< 送出内容のハッシュ（最適化で処理が消されないように）
+    uint64_t sleptUs;   ///< sleep_us/sleep_ms で待つはずだった時間の合計(µs)
+};
+
+extern BenchSink g_benchSink;
+
+/**
+ * @brief LEDへの送出の記録（送った語を期待値と比べる確認用）。
+ * @details enabled の間だけ、FIFO/DMA へ送った語と、リセットラッチ（pio_sm_clear_fifos）の位置を順に記録します。
+ */
+struct BenchWireLog {
+    bool enabled;
+    std::vector<uint32_t> words;  ///< 送った語（FIFO と DMA を送った順に）
+    std::vector<size_t> latches;  ///< リセットラッチの位置（その時点の words の語数）
+};
+
+extern BenchWireLog g_benchWireLog;
+
+/**
+ * @brief 仮想時計に切り替えます（テスト events の確認用）。
+ * @param on true の間は time_us_64() が仮想時刻を返し、sleep_us/sleep_ms はその間に予定されたアラームを実行しながら仮想時刻を進めます
+ * @param startUs 仮想時刻の初期値(µs)
+ * @details 予定済みのアラームと、__sev() のイベントレジスタは破棄します。
+ */
+void bench_clock_virtual(bool on, uint64_t startUs);
+
+/**
+ * @brief 最も早いアラームまで仮想時刻を進めて実行します（同じ時刻なら登録順）。
+ * @return 実行したら true、予定が無ければ false
+ */
+bool bench_alarm_run_next();
+
+/** @brief 予定済みのアラームの数。 */
+size_t bench_alarm_pending();
+
+/**
+ * @brief ピンのレベルを変えます。
+ * @param pin GPIO
+ * @param level レベル
+ * @details レベルが変わり、そのエッジの割り込みが有効なら、gpio_set_irq_enabled_with_callback() のコールバックを呼びます。
+ */
+void bench_gpio_set(uint32_t pin, bool level);
+
+/** @brief PLL_SYS が動いていれば true（pll_deinit() で止め、set_sys_clock_khz() で動かす）。 */
+bool bench_pll_sys_running();
@@ -0,0 +1,16 @@
+/**
+ * @file clocks.h
+ * @brief ホストでベンチマークを動かすための hardware/clocks.h の代替
+ * @details clk_sys は 150MHz（RP2350 の既定）から始まり、clock_configure()/set_sys_clock_khz() で変えた値を返します（テスト power・timing の確認用）。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define XOSC_HZ 12000000u
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF 0x0u
+
+enum clock_index { clk_ref = 4, clk_sys = 5, clk_peri = 6 };
+uint32_t clock_get_hz(enum clock_index clk);
+bool clock_configure(enum clock_index clk, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
@@ -0,0 +1,39 @@
+/**
+ * @file dma.h
+ * @brief ホストでベンチマークを動かすための hardware/dma.h の代替
+ * @details FIFO への DMA 転送はCPUを使わないため、転送語数だけを記録します（bench_dma_transfer()）。
+ *          書き込み先を進めるメモリ間の転送（FrameStream の先読み）は、開始した時点でその場でコピーします（常に完了済み）。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+#include <string.h>
+
+typedef struct { uint32_t ctrl; } dma_channel_config;
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+#define BENCH_DMA_SIZE_MASK 3u   ///< ctrl: 転送の大きさ（dma_channel_transfer_size）
+#define BENCH_DMA_INCR_WRITE 4u  ///< ctrl: 書き込み先を進める
+
+void bench_dma_transfer(const volatile void* src, uint32_t count);
+
+static inline int dma_claim_unused_channel(bool) { return 0; }
+static inline void dma_channel_unclaim(uint) {}
+static inline dma_channel_config dma_channel_get_default_config(uint) { dma_channel_config c = {DMA_SIZE_32}; return c; }
+static inline void channel_config_set_transfer_data_size(dma_channel_config* c, enum dma_channel_transfer_size size)
+{
+    c->ctrl = (c->ctrl & ~BENCH_DMA_SIZE_MASK) | (uint32_t)size;
+}
+static inline void channel_config_set_read_increment(dma_channel_config*, bool) {}
+static inline void channel_config_set_write_increment(dma_channel_config* c, bool incr)
+{
+    c->ctrl = incr ? (c->ctrl | BENCH_DMA_INCR_WRITE) : (c->ctrl & ~BENCH_DMA_INCR_WRITE);
+}
+static inline void channel_config_set_dreq(dma_channel_config*, uint) {}
+static inline void dma_channel_configure(uint, const dma_channel_config* c, volatile void* dst, const volatile void* src, uint count, bool trigger)
+{
+    if (trigger && (c->ctrl & BENCH_DMA_INCR_WRITE)) memcpy((void*)dst, (const void*)src, (size_t)count << (c->ctrl & BENCH_DMA_SIZE_MASK));
+}
+static inline bool dma_channel_is_busy(uint) { return false; }
+static inline void dma_channel_transfer_from_buffer_now(uint, const volatile void* src, uint32_t count) { bench_dma_transfer(src, count); }
+static inline void dma_channel_wait_for_finish_blocking(uint) {}
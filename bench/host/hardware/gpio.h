@@ -0,0 +1,20 @@
+/**
+ * @file gpio.h
+ * @brief ホストでベンチマークを動かすための hardware/gpio.h の代替
+ * @details ピンのレベルは bench_gpio_set()（HostShims.h）で変え、エッジで割り込みのコールバックを呼びます。未設定のピンは High（プルアップ）です。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+enum gpio_irq_level {
+    GPIO_IRQ_LEVEL_LOW = 0x1u,
+    GPIO_IRQ_LEVEL_HIGH = 0x2u,
+    GPIO_IRQ_EDGE_FALL = 0x4u,
+    GPIO_IRQ_EDGE_RISE = 0x8u,
+};
+
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+bool gpio_get(uint gpio);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
@@ -0,0 +1,44 @@
+/**
+ * @file pio.h
+ * @brief ホストでベンチマークを動かすための hardware/pio.h の代替
+ * @details TX FIFO への書き込みは bench_fifo_put() で数と内容のハッシュだけを記録します（最適化で消されないように）。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+typedef struct pio_hw { volatile uint32_t txf[4]; } pio_hw_t;
+typedef pio_hw_t* PIO;
+extern pio_hw_t bench_pio0;
+#define pio0 (&bench_pio0)
+#define pio1 (&bench_pio0)
+
+typedef struct { uint32_t clkdiv; } pio_sm_config;
+typedef struct pio_program { const uint16_t* instructions; uint8_t length; int8_t origin; } pio_program_t;
+#define PIO_FIFO_JOIN_TX 1
+
+void bench_fifo_put(uint32_t v);
+void bench_pio_clear_fifos();
+
+static inline int pio_add_program(PIO, const pio_program_t*) { return 0; }
+static inline void pio_remove_program(PIO, const pio_program_t*, uint) {}
+static inline int pio_claim_unused_sm(PIO, bool) { return 0; }
+static inline void pio_sm_unclaim(PIO, uint) {}
+static inline void sm_config_set_sideset_pins(pio_sm_config*, uint) {}
+static inline void sm_config_set_set_pins(pio_sm_config*, uint, uint) {}
+static inline void sm_config_set_out_shift(pio_sm_config*, bool, bool, uint) {}
+static inline void sm_config_set_fifo_join(pio_sm_config*, int) {}
+static inline void sm_config_set_clkdiv_int_frac(pio_sm_config*, uint16_t, uint8_t) {}
+static inline void pio_gpio_init(PIO, uint) {}
+static inline void pio_sm_set_consecutive_pindirs(PIO, uint, uint, uint, bool) {}
+static inline int pio_sm_init(PIO, uint, uint, const pio_sm_config*) { return 0; }
+static inline void pio_sm_set_enabled(PIO, uint, bool) {}
+static inline void pio_sm_clear_fifos(PIO, uint) { bench_pio_clear_fifos(); }
+static inline void pio_sm_restart(PIO, uint) {}
+static inline void pio_sm_exec(PIO, uint, uint) {}
+static inline uint pio_encode_jmp(uint addr) { return addr; }
+static inline void pio_sm_put_blocking(PIO, uint, uint32_t v) { bench_fifo_put(v); }
+static inline bool pio_sm_is_tx_fifo_empty(PIO, uint) { return true; }
+static inline void pio_sm_set_clkdiv_int_frac(PIO, uint, uint16_t, uint8_t) {}
+static inline void pio_sm_clkdiv_restart(PIO, uint) {}
+static inline uint pio_get_dreq(PIO, uint, bool) { return 0; }
@@ -0,0 +1,15 @@
+/**
+ * @file pll.h
+ * @brief ホストでベンチマークを動かすための hardware/pll.h の代替
+ * @details PLL_SYS を止めたかどうかだけを記録します（bench_pll_sys_running()）。
+ */
+#pragma once
+
+#include "pico/stdlib.h"
+
+typedef struct pll_hw { uint32_t cs; } pll_hw_t;
+typedef pll_hw_t* PLL;
+extern pll_hw_t bench_pll_sys;
+#define pll_sys (&bench_pll_sys)
+
+void pll_deinit(PLL pll);
@@ -0,0 +1,9 @@
+/**
+ * @file sync.h
+ * @brief ホストでベンチマークを動かすための hardware/sync.h の代替
+ * @details __wfe() はイベントレジスタが立っていなければ、仮想時計で次のアラームまで進めて実行します（HostShims.h）。
+ */
+#pragma once
+
+void __sev(void);
+void __wfe(void);
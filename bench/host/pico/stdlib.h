@@ -0,0 +1,36 @@
+/**
+ * @file stdlib.h
+ * @brief ホストでベンチマークを動かすための pico/stdlib.h の代替
+ * @details ベンチマーク対象のソースが使う関数だけを用意します。待ち（sleep_*）は待たずに合計時間だけを記録し（仮想時計）、CPU処理だけを計測します。
+ *          アラームは bench_clock_virtual() の仮想時計で、予定時刻の順に実行されます（HostShims.h）。
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+void bench_sleep_us(uint64_t us);
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000u); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+
+static inline void sleep_us(uint64_t us) { bench_sleep_us(us); }
+static inline void sleep_ms(uint32_t ms) { bench_sleep_us((uint64_t)ms * 1000u); }
+static inline void tight_loop_contents(void) {}
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void* user_data);
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void* user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+static inline alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void* user_data, bool fire_if_past)
+{
+    return add_alarm_in_us((uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
@@ -0,0 +1,7 @@
+/**
+ * @file time.h
+ * @brief ホストでベンチマークを動かすための pico/time.h の代替
+ */
+#pragma once
+
+#include "pico/stdlib.h"
@@ -0,0 +1,20 @@
+/**
+ * @file ws2812.pio.h
+ * @brief ホストでベンチマークを動かすための ws2812.pio の生成ヘッダの代替
+ * @details 定数は WS2812/source/ws2812.pio と同じです。
+ */
+#pragma once
+
+#include "hardware/pio.h"
+
+#define ws2812_wrap_target 0
+#define ws2812_wrap 3
+#define ws2812_offset_idle 4u
+#define ws2812_offset_out0 5u
+#define ws2812_offset_out1 6u
+#define ws2812_T1 3
+#define ws2812_T2 3
+#define ws2812_T3 4
+
+static const pio_program_t ws2812_program = { 0, 7, -1 };
+static inline pio_sm_config ws2812_program_get_default_config(uint) { pio_sm_config c = {0}; return c; }
@@ -0,0 +1,116 @@
+/**
+ * @file CheckApa102.cpp
+ * @brief APA102/SK9822 の送出フレーム作成の確認
+ * @details
+ * - 確認: スタート/エンドフレームの長さと値、LEDフレームの先頭3bit、16bit 値すべてについての変換誤差、
+ *   暗い範囲で表せる階調数（5bit輝度あり/なし）。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+#include "Checks.h"
+#include "APA102Frame.h"
+
+namespace {
+
+/** @brief LED 4バイトから、表している 16bit の値（チャネル 0..2 = R,G,B）を求めます。 */
+std::uint32_t decode16(const std::uint8_t* led, int ch)
+{
+    const std::uint32_t bri = led[0] & 0x1Fu;
+    const std::uint32_t v8 = ch == 0 ? led[3] : ch == 1 ? led[2] : led[1];
+    return (v8 * bri * 257u * 2u + APA102_MAX_GLOBAL) / (APA102_MAX_GLOBAL * 2u); // 四捨五入
+}
+
+/** @brief 5bit輝度を使わない（常に31）場合の 8bit 値。 */
+std::uint32_t plain8(std::uint32_t v16) { return (v16 + 128u) / 257u; }
+
+/** @brief フレームの形を確かめます。 */
+bool checkFrame(std::FILE* out, std::size_t leds)
+{
+    std::mt19937 rng((std::uint32_t)leds);
+    std::vector<std::uint32_t> px(leds);
+    for (auto& p : px) p = rng() & 0xFFFFFFu;
+    std::uint16_t lut[256];
+    apa102_build_lut(1.0f, 256, lut);
+
+    const std::size_t bytes = apa102_frame_bytes(leds);
+    std::vector<std::uint8_t> frame(bytes + 8, 0xA5); // 後ろの 0xA5 は書き過ぎの検出用
+    std::uint8_t* p = apa102_write_start(frame.data());
+    p = apa102_encode_pixels(px.data(), leds, 1, lut, p);
+    p = apa102_write_end(p, leds);
+
+    bool ok = (std::size_t)(p - frame.data()) == bytes;
+    for (int i = 0; i < APA102_START_BYTES; i++) ok = ok && frame[i] == 0x00;
+    for (std::size_t i = 0; i < leds; i++) ok = ok && (frame[APA102_START_BYTES + i * APA102_LED_BYTES] & 0xE0u) == 0xE0u;
+    const std::size_t endAt = APA102_START_BYTES + leds * APA102_LED_BYTES;
+    for (std::size_t i = endAt; i < bytes; i++) ok = ok && frame[i] == 0x00;
+    for (std::size_t i = bytes; i < frame.size(); i++) ok = ok && frame[i] == 0xA5;
+    ok = ok && bytes - endAt >= 4 + leds / 16; // SK9822 の 32bit + LED数/2 クロック
+
+    std::fprintf(out, "frame leds=%-5zu bytes=%-6zu end=%-3zu %s\n", leds, bytes, bytes - endAt, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 送出フレームの形と変換の誤差/階調数を確かめて出力します。
+ * @param out 出力先
+ * @return すべて期待どおりならtrue
+ */
+bool runApa102Check(std::FILE* out)
+{
+    bool ok = true;
+    for (std::size_t leds : {1u, 15u, 16u, 17u, 256u, 1000u}) ok = checkFrame(out, leds) && ok;
+
+    // 16bit の値すべて: 誤差は選んだ輝度での 8bit の半分（+丸め）以内、輝度は最大チャネルが収まる最小
+    std::uint32_t worst = 0, worstPlain = 0, worstLow = 0, worstLowPlain = 0;
+    for (std::uint32_t v = 0; v < 65536; v++) {
+        const std::uint32_t w = apa102_pack_hdr(v, v / 2, v / 7);
+        const std::uint8_t led[4] = {(std::uint8_t)w, (std::uint8_t)(w >> 8), (std::uint8_t)(w >> 16), (std::uint8_t)(w >> 24)};
+        const std::uint32_t bri = led[0] & 0x1Fu;
+        if ((led[0] & 0xE0u) != 0xE0u || (v != 0 && (bri == 0 || (bri > 1 && (v * APA102_MAX_GLOBAL) <= (bri - 1) * 65535u)))) {
+            std::fprintf(out, "pack v=%u: header %02x\n", v, led[0]);
+            ok = false;
+            break;
+        }
+        const std::uint32_t chans[3] = {v, v / 2, v / 7};
+        for (int ch = 0; ch < 3; ch++) {
+            const std::uint32_t got = decode16(led, ch);
+            const std::uint32_t err = got > chans[ch] ? got - chans[ch] : chans[ch] - got;
+            const std::uint32_t plainErr = (std::uint32_t)std::abs((int)(plain8(chans[ch]) * 257u) - (int)chans[ch]);
+            const std::uint32_t bound = (bri * 257u + APA102_MAX_GLOBAL - 1) / (APA102_MAX_GLOBAL * 2u) + 1u;
+            if (err > bound) {
+                std::fprintf(out, "pack v=%u ch=%d: %u, error %u > %u\n", v, ch, got, err, bound);
+                ok = false;
+            }
+            worst = std::max(worst, err);
+            worstPlain = std::max(worstPlain, plainErr);
+            if (v < 2048) {
+                worstLow = std::max(worstLow, err);
+                worstLowPlain = std::max(worstLowPlain, plainErr);
+            }
+        }
+    }
+    std::fprintf(out, "error (16bit units)  all: hdr=%u 8bit=%u   v<2048: hdr=%u 8bit=%u\n", worst, worstPlain, worstLow, worstLowPlain);
+
+    // 暗くした（SetBrightness）ときに表せる階調数: 0 以外の異なる出力の数
+    for (std::uint16_t level : {256, 64, 16}) {
+        std::uint16_t lut[256];
+        apa102_build_lut(2.2f, level, lut);
+        std::set<std::uint32_t> hdr, plain;
+        for (int v = 0; v < 256; v++) {
+            const std::uint32_t w = apa102_pack_hdr(lut[v], 0, 0);
+            const std::uint8_t led[4] = {(std::uint8_t)w, 0, 0, (std::uint8_t)(w >> 24)};
+            if (decode16(led, 0) != 0) hdr.insert(decode16(led, 0));
+            if (plain8(lut[v]) != 0) plain.insert(plain8(lut[v]));
+        }
+        const bool better = hdr.size() >= plain.size();
+        ok = ok && better;
+        std::fprintf(out, "levels gamma=2.2 brightness=%3u/256: hdr=%zu 8bit=%zu %s\n", level, hdr.size(), plain.size(), better ? "ok" : "WORSE");
+    }
+    return ok;
+}
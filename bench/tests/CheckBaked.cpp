@@ -0,0 +1,222 @@
+/**
+ * @file CheckBaked.cpp
+ * @brief 焼き込み済みパターン（ColorPipeline.h）と、以前の浮動小数点の補正（PatManager）の比較
+ * @details 以前の補正は、整数のLUT（ColorPipeline.h）へ置き換える前の PatManager.cpp の式をそのまま写したものです。
+ */
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Checks.h"
+#include "BenchChars.h"
+#include "ColorPipeline.h"
+#include "PatManager.h"
+#include "Patterns.h"
+
+namespace {
+
+/** @brief 以前の PatManager.cpp の補正（浮動小数点のLUT）。 */
+namespace legacy {
+
+/** @brief ガンマ補正のLUT。 */
+void build_gamma_lut(float gamma, std::uint8_t lut[256])
+{
+    if (gamma <= 0.0f) gamma = 1.0f;
+    const float inv = 1.0f / 255.0f;
+    for (int i = 0; i < 256; ++i) {
+        float n = static_cast<float>(i) * inv;
+        float g = std::pow(n, gamma);
+        int v = static_cast<int>(g * 255.0f + 0.5f);
+        if (v < 0) v = 0; else if (v > 255) v = 255;
+        lut[i] = static_cast<std::uint8_t>(v);
+    }
+}
+
+/**
+ * @brief 明度/コントラストの合成LUT。
+ * @param fused true なら (v-128)*c+128 を FMA で1回の丸めにする（Cortex-M33 の FPU で融合された場合）
+ */
+void build_bc_lut(int brightnessPercent, int contrastPercent, std::uint8_t lut[256], bool fused)
+{
+    if (brightnessPercent < -100) brightnessPercent = -100;
+    if (brightnessPercent > 100)  brightnessPercent = 100;
+    if (contrastPercent < -100)   contrastPercent = -100;
+    if (contrastPercent > 100)    contrastPercent = 100;
+
+    const float c = 1.0f + static_cast<float>(contrastPercent) / 100.0f;
+    const float b = static_cast<float>(brightnessPercent) / 100.0f;
+    const int add = static_cast<int>(std::round(255.0f * b));
+    for (int v = 0; v <= 255; ++v) {
+        volatile float d = static_cast<float>(v) - 128.0f;
+        volatile float prod = d * c; // 融合させない（1回ずつ丸める）
+        const float v1 = fused ? std::fma(static_cast<float>(d), c, 128.0f) : prod + 128.0f;
+        int v2 = static_cast<int>(std::round(v1)) + add;
+        lut[v] = v2 < 0 ? 0 : (v2 > 255 ? 255 : static_cast<std::uint8_t>(v2));
+    }
+}
+
+/** @brief レンジ圧縮のLUT。 */
+void build_range_lut(std::uint8_t minV, std::uint8_t maxV, std::uint8_t lut[256])
+{
+    const int minI = minV, span = static_cast<int>(maxV) - minI;
+    lut[0] = 0;
+    for (int v = 1; v <= 255; ++v) {
+        int mapped = minI + static_cast<int>(std::lround((span * v) / 255.0));
+        if (mapped < 0) mapped = 0; else if (mapped > 255) mapped = 255;
+        lut[v] = static_cast<std::uint8_t>(mapped);
+    }
+}
+
+/** @brief 1チャネル（シフト量）に LUT を適用します。 */
+inline std::uint32_t apply_channel(std::uint32_t px, const std::uint8_t lut[256], int shift)
+{
+    const std::uint32_t v = lut[(px >> shift) & 0xFFu];
+    return (px & ~(0xFFu << shift)) | (v << shift);
+}
+
+/**
+ * @brief 以前の setPatManager と同じ順（緑→赤→青レンジ→ガンマ→明度/コントラスト）で補正します。
+ * @param px [in,out] ピクセル
+ * @param ch 補正設定
+ */
+void process(std::vector<std::uint32_t>& px, const Patterns& ch)
+{
+    std::uint8_t lut[256];
+    const COLOR_RANGE* ranges[3] = {&ch.GreenRange, &ch.RedRange, &ch.BlueRange};
+    const int shifts[3] = {16, 8, 0};
+    for (int k = 0; k < 3; k++) {
+        if (ranges[k]->min == 0 && ranges[k]->max == 0) continue;
+        build_range_lut(ranges[k]->min, ranges[k]->max, lut);
+        for (auto& p : px) p = apply_channel(p, lut, shifts[k]);
+    }
+    if (ch.Gamma > 0.0f) {
+        build_gamma_lut(ch.Gamma, lut);
+        for (auto& p : px) p = apply_channel(apply_channel(apply_channel(p, lut, 16), lut, 8), lut, 0);
+    }
+    if (ch.BrightnessPercent != 0 || ch.ContrastPercent != 0) {
+        build_bc_lut(ch.BrightnessPercent, ch.ContrastPercent, lut, false);
+        for (auto& p : px) p = apply_channel(apply_channel(apply_channel(p, lut, 16), lut, 8), lut, 0);
+    }
+}
+
+} // namespace legacy
+
+/**
+ * @brief 1つのパターン群（停止 or 1グループ）を3通りで比べます。
+ * @return 一致しないピクセル数
+ */
+std::size_t compareGroup(const std::uint32_t* raw, const PatManager& baked, const PatManager& runtime, std::size_t count,
+                         const Patterns& ch)
+{
+    const std::size_t pixels = static_cast<std::size_t>(ch.PatWidth) * ch.PatHeight;
+    std::vector<std::uint32_t> ref(raw, raw + count * pixels);
+    legacy::process(ref, ch);
+    std::size_t diff = 0;
+    for (std::size_t f = 0; f < count; f++) {
+        const std::uint32_t* b = baked.getBufferPtr(f);
+        const std::uint32_t* r = runtime.getBufferPtr(f);
+        for (std::size_t i = 0; i < pixels; i++) {
+            const std::uint32_t e = ref[f * pixels + i];
+            if (!b || !r || b[i] != e || r[i] != e) diff++;
+        }
+    }
+    return diff;
+}
+
+/** @brief LUT の違い。 */
+struct LutDiff {
+    std::uint32_t luts = 0;    ///< 違う LUT の数
+    std::uint32_t entries = 0; ///< 違う要素の数
+    int maxAbs = 0;            ///< 最大の差
+};
+
+/** @brief 2つの LUT の違いを加えます。 */
+void addDiff(LutDiff& d, const std::uint8_t* a, const std::uint8_t* b)
+{
+    bool any = false;
+    for (int v = 0; v < 256; v++) {
+        const int e = std::abs(static_cast<int>(a[v]) - static_cast<int>(b[v]));
+        if (e == 0) continue;
+        any = true;
+        d.entries++;
+        if (e > d.maxAbs) d.maxAbs = e;
+    }
+    if (any) d.luts++;
+}
+
+} // namespace
+
+/**
+ * @brief 焼き込み済み・実行時・以前の浮動小数点の補正を比べて出力します。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool runBakedCheck(std::FILE* out)
+{
+    bool ok = true;
+
+    // キャラクタ: 停止と全グループのフレーム
+    for (int c = 0; c < BENCH_CHAR_COUNT; c++) {
+        const Patterns& raw = g_benchCharsRuntime[c];
+        PatManager bStay, bRun[4], rStay, rRun[4];
+        g_benchCharsBaked[c].setPatManager(bStay, bRun);
+        raw.setPatManager(rStay, rRun);
+        std::size_t pixels = 0;
+        std::size_t diff = compareGroup(raw.PatStopFlat, bStay, rStay, 1, raw);
+        pixels += static_cast<std::size_t>(raw.PatWidth) * raw.PatHeight;
+        for (int g = 0; g < 4 && raw.PatWalkFlat[g]; g++) {
+            diff += compareGroup(raw.PatWalkFlat[g], bRun[g], rRun[g], raw.PatWalkCount, raw);
+            pixels += raw.PatWalkCount * raw.PatWidth * raw.PatHeight;
+        }
+        ok = diff == 0 && ok;
+        std::fprintf(out, "char %d: %zu pixels, baked/runtime vs float path: %zu differ %s\n", c, pixels, diff, diff == 0 ? "ok" : "MISMATCH");
+    }
+
+    // レンジ: すべての min/max で一致する（.5 になる入力がないため）
+    {
+        LutDiff d;
+        std::uint8_t a[256];
+        for (int mn = 0; mn < 256; mn++) {
+            for (int mx = 0; mx < 256; mx++) {
+                legacy::build_range_lut(static_cast<std::uint8_t>(mn), static_cast<std::uint8_t>(mx), a);
+                addDiff(d, colorpipe::range_lut(static_cast<std::uint8_t>(mn), static_cast<std::uint8_t>(mx)).v, a);
+            }
+        }
+        ok = d.entries == 0 && ok;
+        std::fprintf(out, "range LUT (65536 min/max pairs): %u differ %s\n", (unsigned)d.luts, d.entries == 0 ? "ok" : "MISMATCH");
+    }
+    // ガンマ 1.0: 以前のLUTも素通し（焼き込み・実行時は処理を省く）
+    {
+        std::uint8_t a[256];
+        legacy::build_gamma_lut(1.0f, a);
+        bool identity = true;
+        for (int v = 0; v < 256; v++) identity = a[v] == v && identity;
+        ok = identity && ok;
+        std::fprintf(out, "gamma 1.0 LUT is identity: %s\n", identity ? "ok" : "MISMATCH");
+    }
+    // 明度/コントラスト: 違いは、厳密にはちょうど .5 の値の丸めだけ（差は1）
+    for (int fused = 0; fused < 2; fused++) {
+        LutDiff d;
+        std::uint32_t tiesOnly = 0;
+        std::uint8_t a[256];
+        for (int b = -100; b <= 100; b++) {
+            for (int c = -100; c <= 100; c++) {
+                legacy::build_bc_lut(b, c, a, fused != 0);
+                const colorpipe::Lut n = colorpipe::bc_lut(b, c);
+                addDiff(d, n.v, a);
+                for (int v = 0; v < 256; v++) {
+                    if (a[v] == n.v[v]) continue;
+                    // (v-128)*(100+c) が 50 の奇数倍（厳密に .5）でなければ、記録した違いではない
+                    const int num = (v - 128) * (100 + c);
+                    if (num % 100 == 50 || num % 100 == -50) tiesOnly++;
+                }
+            }
+        }
+        const bool expected = d.maxAbs <= 1 && tiesOnly == d.entries;
+        ok = expected && ok;
+        std::fprintf(out, "brightness/contrast LUT (%s, 40401 pairs): %u LUTs differ, %u entries, max %d, all at exact .5 %s\n",
+                     fused ? "fused multiply-add" : "separate multiply/add", (unsigned)d.luts, (unsigned)d.entries, d.maxAbs,
+                     expected ? "ok" : "MISMATCH");
+    }
+    return ok;
+}
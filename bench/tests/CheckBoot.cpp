@@ -0,0 +1,78 @@
+/**
+ * @file CheckBoot.cpp
+ * @brief 起動直後の表示（BootFrame.h のフラッシュ上の語列）の確認
+ * @details
+ * - 確認: LGMBootWire と、ファームウェアと同じ手順（PatCache + drawStopFrame）で作った送出データをビット単位で比べます。
+ */
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Checks.h"
+#include "BenchChars.h"
+#include "BootFrame.h"
+#include "BootTimeline.h"
+#include "FrameRender.h"
+#include "HostShims.h"
+#include "PatCache.h"
+#include "PatSignal.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief CPU 時間と待ち時間（sleep_us の合計）を足した見積もりの時計(µs)。 */
+struct ModelClock {
+    std::chrono::steady_clock::time_point t0 { std::chrono::steady_clock::now() };
+    std::uint64_t slept0 { g_benchSink.sleptUs };
+    std::uint64_t now() const
+    {
+        const auto cpu = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count();
+        return (std::uint64_t)cpu + (g_benchSink.sleptUs - slept0);
+    }
+};
+
+} // namespace
+
+/**
+ * @brief 起動フレームを確かめ、起動の各段階の時刻の見積もりを出力します。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool runBootCheck(std::FILE* out)
+{
+    const Patterns& ch = g_benchCharsBaked[0];
+    ModelClock clock;
+    BootTimeline timeline;
+    timeline.mark("main", clock.now());
+    std::unique_ptr<WS2812> led(new WS2812(22, BOOT_FRAME_WIDTH, BOOT_FRAME_HEIGHT));
+    timeline.mark("ws2812", clock.now());
+    bool ok = led->WireWords() == LGMBootWireWords;
+    led->Reset();
+    led->TransmitWire(LGMBootWire, LGMBootWireWords);
+    timeline.mark("boot frame", clock.now());
+
+    // ファームウェアの最初の STATE_STOP と同じ手順
+    PatCache cache;
+    PatSet* set = cache.acquire(ch);
+    ok = set != nullptr && ok;
+    if (set) drawStopFrame(*led, ch, set->stay, frameKey(0, FRAME_KEY_STOP, 0, 0, false, false));
+    timeline.mark("first character", clock.now());
+
+    std::vector<std::uint32_t> wire(led->WireWords());
+    led->EncodeWire(wire.data(), BOOT_FRAME_SERPENTINE, BOOT_FRAME_LEFT_TO_RIGHT);
+    std::size_t diff = 0;
+    for (std::size_t i = 0; i < wire.size() && i < LGMBootWireWords; i++) diff += wire[i] != LGMBootWire[i];
+    ok = diff == 0 && ok;
+    std::fprintf(out, "boot frame (flash, %zu words) vs first STATE_STOP frame: %zu differing words %s\n", LGMBootWireWords, diff,
+                 diff == 0 ? "ok" : "MISMATCH");
+
+    std::uint64_t bootUs = 0, firstUs = 0;
+    timeline.find("boot frame", bootUs);
+    timeline.find("first character", firstUs);
+    ok = bootUs <= firstUs && ok;
+    std::fflush(out);
+    timeline.print();
+    std::fprintf(out, "(host estimate: CPU time + sleep_us waits; the frame itself takes %zu us on the wire at 800 kHz)\n",
+                 LGMBootWireWords * 30);
+    return ok;
+}
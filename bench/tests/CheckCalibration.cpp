@@ -0,0 +1,212 @@
+/**
+ * @file CheckCalibration.cpp
+ * @brief 送出データへの変換時に掛ける色補正（LedCalibration.h）の確認
+ * @details
+ * - 確認: 倍精度の基準との誤差、素通し、LEDの物理順（パネルと千鳥配線）、FIFO 送出と WS2812Static との一致。
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "HostShims.h"
+#include "LedCalibration.h"
+#include "WS2812.h"
+#include "WS2812Static.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/** @brief パネルごとに少しずつ違う実数の行列（対角 0.8..1.0、他のチャネルからの混入 -0.1..+0.1）。 */
+std::vector<float> makeMatrixF(std::size_t panels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> diag(0.8f, 1.0f), mix(-0.1f, 0.1f);
+    std::vector<float> v(panels * 9);
+    for (std::size_t p = 0; p < panels; p++)
+        for (int i = 0; i < 9; i++) v[p * 9 + i] = (i % 4 == 0) ? diag(rng) : mix(rng);
+    return v;
+}
+
+std::vector<LedColorMatrix> toFixed(const std::vector<float>& f)
+{
+    std::vector<LedColorMatrix> m(f.size() / 9);
+    for (std::size_t p = 0; p < m.size(); p++) ledcal_matrix_from_float(&f[p * 9], m[p]);
+    return m;
+}
+
+std::vector<std::uint8_t> makeGain(std::size_t leds, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint8_t> v(leds);
+    for (auto& g : v) g = (std::uint8_t)(160 + rng() % 96);
+    return v;
+}
+
+/** @brief 倍精度の基準（実数の行列、明るさ gain/255）。 @param ch [out] R,G,B */
+void refApply(std::uint32_t c, const float* m, int gain, double ch[3])
+{
+    const double in[3] = {(double)((c >> 8) & 0xFF), (double)((c >> 16) & 0xFF), (double)(c & 0xFF)};
+    for (int i = 0; i < 3; i++) {
+        double v = in[i];
+        if (m) v = m[i * 3] * in[0] + m[i * 3 + 1] * in[1] + m[i * 3 + 2] * in[2];
+        v = v < 0 ? 0 : v > 255 ? 255 : v;
+        ch[i] = v * gain / 255.0;
+    }
+}
+
+/** @brief 全色（上位ビットを間引いた 2^18 色）× 明るさで、固定小数点と倍精度の基準の差を求めます。 */
+bool checkAccuracy(std::FILE* out, const char* name, const float* mf, bool useGain)
+{
+    LedColorMatrix m;
+    if (mf) ledcal_matrix_from_float(mf, m);
+    double maxErr = 0, sumErr = 0;
+    std::size_t n = 0;
+    const int gains[] = {255, 254, 200, 128, 64, 1, 0};
+    for (int gain : gains) {
+        if (!useGain && gain != 255) continue;
+        for (std::uint32_t c = 0; c < 0x1000000u; c += 0x40404u / 4 + 1) { // 各チャネルをほぼ均等に
+            double want[3];
+            refApply(c, mf, gain, want);
+            const std::uint32_t got = ledcal_apply(c, mf ? &m : nullptr, (std::uint32_t)gain);
+            const double g[3] = {(double)((got >> 8) & 0xFF), (double)((got >> 16) & 0xFF), (double)(got & 0xFF)};
+            for (int i = 0; i < 3; i++) {
+                const double e = std::fabs(g[i] - want[i]);
+                if (e > maxErr) maxErr = e;
+                sumErr += e;
+                n++;
+            }
+        }
+    }
+    const bool ok = maxErr <= 1.0;
+    std::fprintf(out, "accuracy %-12s max=%.3f mean=%.3f %s\n", name, maxErr, sumErr / (double)n, ok ? "ok" : "TOO LARGE");
+    return ok;
+}
+
+/** @brief 単位行列・等倍の明るさでは送出データが補正なしと一致するか。 */
+bool checkPassThrough(std::FILE* out)
+{
+    WS2812 a(22, 8, 5, 3, 2), b(22, 8, 5, 3, 2);
+    const auto data = makeData(a.xVRam * a.yVRam, 11);
+    std::copy(data.begin(), data.end(), a.pVRam);
+    std::copy(data.begin(), data.end(), b.pVRam);
+    std::vector<LedColorMatrix> m(6);
+    for (auto& x : m) ledcal_matrix_identity(x);
+    std::vector<std::uint8_t> gain(data.size(), LEDCAL_GAIN_UNITY);
+    b.SetCalibration(m.data(), gain.data());
+    std::vector<std::uint32_t> wa(data.size()), wb(data.size());
+    a.EncodeWire(wa.data(), true, false);
+    b.EncodeWire(wb.data(), true, false);
+    const bool ok = wa == wb;
+    std::fprintf(out, "identity matrix + unity gain passes through %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief ScanBuffer（FIFO）で送った内容のハッシュ。 */
+std::uint32_t fifoHash(WS2812& led, bool serpentine, bool leftToRight)
+{
+    g_benchSink.hash = 2166136261u;
+    led.ScanBuffer(serpentine, leftToRight);
+    return g_benchSink.hash;
+}
+
+/** @brief 語列を FIFO へ書いた場合のハッシュ（HostShims と同じ計算）。 */
+std::uint32_t wireHash(const std::vector<std::uint32_t>& wire)
+{
+    std::uint32_t h = 2166136261u;
+    for (std::uint32_t v : wire) h = (h ^ v) * 16777619u;
+    return h;
+}
+
+/**
+ * @brief パネル構成と配線を変えて、送出データの各LEDに正しいパネルの行列と明るさが掛かるか。
+ * @details 基準はパネル・行・向きをたどって LED の物理番号を数え、その番号の明るさとパネルの行列を ledcal_apply で掛けたもの。
+ */
+bool checkMapping(std::FILE* out, uint8_t xs, uint8_t ys, uint8_t xp, uint8_t yp, bool serpentine, bool leftToRight)
+{
+    WS2812 led(22, xs, ys, xp, yp);
+    const std::size_t pixels = (std::size_t)led.xVRam * led.yVRam;
+    const auto data = makeData(pixels, xs * 7u + yp);
+    std::copy(data.begin(), data.end(), led.pVRam);
+    const auto m = toFixed(makeMatrixF((std::size_t)xp * yp, xs + ys));
+    const auto gain = makeGain(pixels, xp * 3u + ys);
+    led.SetCalibration(m.data(), gain.data());
+
+    std::vector<std::uint32_t> want(pixels), got(pixels);
+    std::size_t led_i = 0;
+    for (uint32_t py = 0; py < yp; py++)
+        for (uint32_t px = 0; px < xp; px++)
+            for (uint32_t y = 0; y < ys; y++) {
+                const bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+                for (uint32_t i = 0; i < xs; i++, led_i++) {
+                    const uint32_t x = px * xs + (l2r ? i : xs - 1u - i);
+                    want[led_i] = ledcal_apply(data[(py * ys + y) * led.xVRam + x], &m[py * xp + px], gain[led_i]) << 8;
+                }
+            }
+    led.EncodeWire(got.data(), serpentine, leftToRight);
+    bool ok = got == want;
+    ok = fifoHash(led, serpentine, leftToRight) == wireHash(want) && ok;
+    std::fprintf(out, "mapping %2ux%-2u panels %ux%u serpentine=%d leftToRight=%d %s\n", xs, ys, xp, yp, serpentine, leftToRight, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief WS2812Static でも基底と同じ補正が掛かるか（送出データとキャッシュのクリア）。 */
+bool checkStatic(std::FILE* out)
+{
+    typedef WS2812Static<16, 16, 2, 2, WS2812SerpentineRL> Led;
+    std::unique_ptr<Led> s(new Led(22));
+    WS2812 d(22, 16, 16, 2, 2);
+    const auto data = makeData(Led::kPixels, 21);
+    std::copy(data.begin(), data.end(), s->pVRam);
+    std::copy(data.begin(), data.end(), d.pVRam);
+    const auto m = toFixed(makeMatrixF(4, 5));
+    const auto gain = makeGain(Led::kPixels, 6);
+    std::vector<std::uint32_t> ws(Led::kPixels), wd(Led::kPixels);
+    s->SetWireCacheBudget(Led::kPixels * 8);
+    s->ScanBufferCached(1); // 補正前のデータをキャッシュに入れる
+    s->SetCalibration(m.data(), gain.data());
+    d.SetCalibration(m.data(), gain.data());
+    s->EncodeWire(ws.data());
+    d.EncodeWire(wd.data(), true, false);
+    bool ok = ws == wd;
+    ok = !s->ShowCached(1) && ok; // 補正を変えたらキャッシュは使わない
+    std::fprintf(out, "WS2812Static matches WS2812 and drops cached frames %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 色補正の精度と物理順への対応を確かめます。
+ * @param out 出力先
+ * @return すべて許容範囲なら true
+ */
+bool runCalibrationCheck(std::FILE* out)
+{
+    bool ok = true;
+    const auto mf = makeMatrixF(3, 1);
+    static const float warm[9] = {1.0f, 0.0f, 0.0f, 0.0f, 0.85f, 0.0f, 0.0f, 0.0f, 0.7f};
+    static const float strong[9] = {1.2f, -0.15f, -0.05f, -0.1f, 1.1f, -0.1f, 0.05f, -0.2f, 1.3f}; // 範囲外への飽和を含む
+    ok = checkAccuracy(out, "gain", nullptr, true) && ok;
+    ok = checkAccuracy(out, "warm", warm, false) && ok;
+    ok = checkAccuracy(out, "random", &mf[0], false) && ok;
+    ok = checkAccuracy(out, "strong+gain", strong, true) && ok;
+    ok = checkPassThrough(out) && ok;
+    ok = checkMapping(out, 16, 16, 1, 1, false, true) && ok;
+    ok = checkMapping(out, 16, 16, 2, 2, true, false) && ok;
+    ok = checkMapping(out, 8, 5, 3, 2, true, true) && ok;
+    ok = checkMapping(out, 7, 3, 2, 3, true, false) && ok;
+    ok = checkMapping(out, 8, 8, 4, 1, false, false) && ok;
+    ok = checkStatic(out) && ok;
+    return ok;
+}
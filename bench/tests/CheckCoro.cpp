@@ -0,0 +1,235 @@
+/**
+ * @file CheckCoro.cpp
+ * @brief コルーチンの協調スケジューラ（CoroScheduler.h）の、仮想時計での動作の確認
+ * @details
+ * - 確認: 2本のアニメーション（遅延/フレーム）、入力（タイムアウト付きのイベント待ち）、入れ子の待ちを同時に動かし、
+ *   記録した (時刻, 印) の列を期待値と比べます。時刻は仮想時計なので、結果は実行環境によらず決まります。
+ */
+#include <cstdint>
+#include <vector>
+#include "Checks.h"
+#include "CoroScheduler.h"
+
+namespace {
+
+/** @brief スクリプトが残す記録。 */
+struct CoroLog {
+    struct Entry {
+        char tag;          ///< 印
+        std::uint32_t ms;  ///< 時刻（シナリオ開始からの ms）
+    };
+    Entry e[64] {};
+    std::size_t n { 0 };
+    std::uint32_t base { 0 }; ///< シナリオ開始の時刻
+
+    void push(char tag)
+    {
+        if (n < 64) e[n++] = Entry { tag, CoroScheduler::current()->now() - base };
+    }
+};
+
+/** @brief 30ms ごとに5回。 */
+CoroTask animDelay(CoroLog& log)
+{
+    for (int i = 0; i < 5; i++) {
+        log.push('A');
+        co_await coro_delay(30);
+    }
+}
+
+/** @brief 1フレームごとに3回。 */
+CoroTask animFrame(CoroLog& log)
+{
+    for (int i = 0; i < 3; i++) {
+        log.push('B');
+        co_await coro_next_frame();
+    }
+}
+
+/** @brief ボタンを2回待つ（100ms でタイムアウト）。 */
+CoroTask input(CoroLog& log)
+{
+    for (int i = 0; i < 2; i++) {
+        AppEvent ev = co_await coro_wait_event(EVT_BUTTON, 100);
+        log.push(ev.type == EVT_BUTTON ? 'I' : 'T');
+    }
+}
+
+/** @brief 入れ子の子: 10ms ごとに2回。 */
+CoroTask child(CoroLog& log)
+{
+    co_await coro_delay(10);
+    log.push('c');
+    co_await coro_delay(10);
+    log.push('c');
+}
+
+/** @brief 子を最後まで待ってから記録する。 */
+CoroTask parent(CoroLog& log)
+{
+    co_await child(log);
+    log.push('P');
+}
+
+/** @brief イベントを待ち続ける。 */
+CoroTask waitForever()
+{
+    while (true) co_await coro_wait_event(EVT_NONE);
+}
+
+/** @brief 子がイベントを待ち続ける。 */
+CoroTask parentForever()
+{
+    co_await waitForever();
+}
+
+/** @brief 自分を止める。 */
+CoroTask selfCancel(CoroScheduler& s, const std::uint8_t& id, CoroLog& log)
+{
+    log.push('S');
+    s.cancel(id);
+    co_await coro_delay(1);
+    log.push('X'); // ここへは来ない
+}
+
+/** @brief 何もせずに終わる。 */
+CoroTask empty(std::uint32_t& count)
+{
+    count++;
+    co_return;
+}
+
+/**
+ * @brief シナリオを動かします。
+ * @param base 開始時刻(ms)
+ * @param jump true なら nextWake() の時刻とイベントの時刻だけ run()、false なら 1ms ごとに run()
+ * @param log [out] 記録
+ * @param runs [out] run() の回数
+ */
+void drive(std::uint32_t base, bool jump, CoroLog& log, std::uint32_t& runs)
+{
+    CoroScheduler s;
+    log = CoroLog {};
+    log.base = base;
+    runs = 0;
+    s.setFramePeriod(16, base);
+    s.spawn(animDelay(log));
+    s.spawn(animFrame(log));
+    s.spawn(input(log));
+    s.spawn(parent(log));
+    const std::uint32_t buttonAt = 40;
+    bool posted = false;
+    std::uint32_t t = 0;
+    while (t <= 300 && s.active() > 0) {
+        if (!posted && t == buttonAt) {
+            s.post(AppEvent { EVT_BUTTON, 28, 0, base + t });
+            posted = true;
+        }
+        s.run(base + t);
+        runs++;
+        std::uint32_t next = t + 1;
+        if (jump) {
+            std::uint32_t waitMs;
+            next = s.nextWake(base + t, waitMs) ? t + (waitMs == 0 ? 1 : waitMs) : 301;
+            if (!posted && buttonAt < next) next = buttonAt;
+        }
+        t = next;
+    }
+}
+
+/** @brief 記録が期待値と一致するか。 */
+bool sameLog(const CoroLog& log, const CoroLog::Entry* expect, std::size_t n)
+{
+    if (log.n != n) return false;
+    for (std::size_t i = 0; i < n; i++) {
+        if (log.e[i].tag != expect[i].tag || log.e[i].ms != expect[i].ms) return false;
+    }
+    return true;
+}
+
+/** @brief 記録を1行で出力します。 */
+void printLog(std::FILE* out, const CoroLog& log)
+{
+    for (std::size_t i = 0; i < log.n; i++) std::fprintf(out, " %c@%u", log.e[i].tag, (unsigned)log.e[i].ms);
+    std::fprintf(out, "\n");
+}
+
+} // namespace
+
+/**
+ * @brief 仮想時計でスクリプトを動かし、再開の順序と時刻を期待値と比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runCoroCheck(std::FILE* out)
+{
+    bool ok = true;
+    // 同じ時刻はスロット順（A, B, 入力, 入れ子）。B は 16ms のフレーム、ボタンは 40ms、2回目の待ちは 140ms でタイムアウト
+    static const CoroLog::Entry kExpect[] = {
+        {'A', 0}, {'B', 0}, {'c', 10}, {'B', 16}, {'c', 20}, {'P', 20}, {'A', 30}, {'B', 32},
+        {'I', 40}, {'A', 60}, {'A', 90}, {'A', 120}, {'T', 140},
+    };
+    const std::size_t nExpect = sizeof(kExpect) / sizeof(kExpect[0]);
+    struct Mode {
+        const char* name;
+        std::uint32_t base;
+        bool jump;
+    };
+    const Mode modes[] = {
+        {"1ms ticks", 0, false},
+        {"nextWake", 0, true},
+        {"nextWake, ms wraps", 0xFFFFFFC0u, true},
+    };
+    for (const Mode& m : modes) {
+        CoroLog log;
+        std::uint32_t runs;
+        drive(m.base, m.jump, log, runs);
+        const bool same = sameLog(log, kExpect, nExpect);
+        ok = same && ok;
+        std::fprintf(out, "interleave (%s, %u runs): %s\n", m.name, (unsigned)runs, same ? "ok" : "MISMATCH");
+        printLog(out, log);
+    }
+    ok = coro_pool_stats().used == 0 && ok;
+
+    // cancel(): イベント待ちのスクリプトと、子が待っているスクリプトを止めるとフレームがプールへ戻る
+    {
+        CoroScheduler s;
+        CoroLog log;
+        std::uint8_t a = 0, b = 0, c = 0;
+        s.spawn(waitForever(), &a);
+        s.spawn(parentForever(), &b);
+        s.spawn(selfCancel(s, c, log), &c);
+        s.run(0);
+        const std::uint32_t used = coro_pool_stats().used; // waitForever + parentForever + その子
+        s.cancel(a);
+        s.cancel(b);
+        s.run(5);
+        const bool cancelled = used == 3 && coro_pool_stats().used == 0 && !s.alive(a) && !s.alive(b) && !s.alive(c) &&
+                               s.active() == 0 && log.n == 1 && log.e[0].tag == 'S';
+        ok = cancelled && ok;
+        std::fprintf(out, "cancel (waiting, nested, self): frames %u -> %u %s\n", (unsigned)used, (unsigned)coro_pool_stats().used,
+                     cancelled ? "ok" : "MISMATCH");
+    }
+
+    // プールの枯渇: ヒープへは行かず、生成に失敗する（空のスクリプトは spawn() に失敗する）
+    {
+        const std::uint32_t failures = coro_pool_stats().failures;
+        std::vector<CoroTask> tasks;
+        tasks.reserve(CORO_FRAME_COUNT + 1);
+        std::uint32_t count = 0;
+        for (int i = 0; i < CORO_FRAME_COUNT + 1; i++) tasks.push_back(empty(count));
+        CoroScheduler s;
+        const bool lastEmpty = !tasks.back().valid() && tasks[CORO_FRAME_COUNT - 1].valid();
+        const bool spawnFails = !s.spawn(std::move(tasks.back()));
+        const bool exhausted = lastEmpty && spawnFails && coro_pool_stats().failures == failures + 1;
+        tasks.clear();
+        ok = exhausted && coro_pool_stats().used == 0 && ok;
+        std::fprintf(out, "pool exhausted at %d frames: %s\n", CORO_FRAME_COUNT, exhausted ? "ok" : "MISMATCH");
+    }
+
+    const CoroPoolStats& st = coro_pool_stats();
+    ok = st.maxBytes <= CORO_FRAME_BYTES && ok;
+    std::fprintf(out, "frame pool: %d x %d bytes, peak %u, largest frame %u bytes\n", CORO_FRAME_COUNT, CORO_FRAME_BYTES,
+                 (unsigned)st.peak, (unsigned)st.maxBytes);
+    return ok;
+}
@@ -0,0 +1,352 @@
+/**
+ * @file CheckDelta.cpp
+ * @brief 変化したLEDまでだけ送る送出（WS2812::SetDeltaTransmit）の確認
+ * @details
+ * - 確認: 横に4枚並べた千鳥配線のパネルで、同じ描画を SetDeltaTransmit(true) のドライバとすべて送るドライバで行い、
+ *   送った語とリセットラッチの記録から求めたLEDの状態を1フレームごとに比べます（1ピクセル1語、詰めた形式、色補正あり）。
+ *   64x64（パネルの行ごとに4区画）でも同じように比べ、VRAMの高さごとに送出用の作業領域の大きさを確かめます。
+ */
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Checks.h"
+#include "HostShims.h"
+#include "PatMario.h"
+#include "WS2812.h"
+
+namespace {
+
+/**
+ * @brief LEDのチェーンの模擬。
+ * @details リセットラッチで先頭に戻り、LEDは送られたビット列を先頭から24bitずつ受け取ります（チェーンより後ろは捨てる）。
+ */
+struct LedChain {
+    std::vector<std::uint32_t> led; ///< 各LEDの色（0x00GGRRBB。受け取っていなければ 0xFFFFFFFF）
+    std::size_t next { 0 };         ///< 次に受け取るLED
+    std::uint32_t acc { 0 };        ///< 受け取り中のビット
+    std::uint32_t bits { 0 };       ///< acc のビット数
+
+    explicit LedChain(std::size_t n) : led(n, 0xFFFFFFFFu) {}
+
+    /** @brief 送った語とラッチの記録を順に受け取ります。 @param log 記録 @param wordBits 1語のビット数（24: 1ピクセル1語、32: 詰めた形式） */
+    void apply(const BenchWireLog& log, std::uint32_t wordBits)
+    {
+        std::size_t l = 0;
+        for (std::size_t i = 0; i <= log.words.size(); i++) {
+            for (; l < log.latches.size() && log.latches[l] == i; l++) {
+                next = 0;
+                acc = 0;
+                bits = 0;
+            }
+            if (i == log.words.size()) break;
+            const std::uint32_t w = log.words[i];
+            for (std::uint32_t b = 0; b < wordBits; b++) {
+                acc = (acc << 1) | ((w >> (31 - b)) & 1u);
+                if (++bits == 24) {
+                    if (next < led.size()) led[next] = acc;
+                    next++;
+                    acc = 0;
+                    bits = 0;
+                }
+            }
+        }
+    }
+};
+
+/** @brief 比べる2台（変化したLEDまでだけ送る/すべて送る）とそれぞれのLED。 */
+struct DeltaRig {
+    std::unique_ptr<WS2812> led;
+    LedChain chain;
+    std::uint64_t words { 0 }; ///< 送った語数の合計
+    DeltaRig(WS2812* l) : led(l), chain((std::size_t)l->xVRam * l->yVRam) {}
+};
+
+/** @brief 変化したLEDまでだけ送るドライバが送るはずの量。 */
+enum DeltaExpect {
+    EXPECT_NONE,    ///< 送らない（ラッチもしない）
+    EXPECT_PARTIAL, ///< 先頭の一部だけ
+    EXPECT_FULL,    ///< すべて
+    EXPECT_ANY      ///< 決めない（直接送る場合）
+};
+
+/**
+ * @brief 同じ操作を2台で行い、LEDの状態と送った量を比べます。
+ * @param out 出力先
+ * @param name 名前
+ * @param delta 変化したLEDまでだけ送るドライバ
+ * @param full すべて送るドライバ
+ * @param op 操作（描画と送出）
+ * @param expect 送るはずの量
+ * @return 一致すれば true
+ */
+bool deltaStep(std::FILE* out, const char* name, DeltaRig& delta, DeltaRig& full, const std::function<void(WS2812&)>& op,
+               DeltaExpect expect)
+{
+    std::size_t sent[2], latches[2];
+    DeltaRig* rigs[2] = {&delta, &full};
+    for (int k = 0; k < 2; k++) {
+        g_benchWireLog.words.clear();
+        g_benchWireLog.latches.clear();
+        g_benchWireLog.enabled = true;
+        op(*rigs[k]->led);
+        rigs[k]->led->WaitTransmit();
+        g_benchWireLog.enabled = false;
+        rigs[k]->chain.apply(g_benchWireLog, rigs[k]->led->IsPackedWire() ? 32 : 24);
+        sent[k] = g_benchWireLog.words.size();
+        latches[k] = g_benchWireLog.latches.size();
+        rigs[k]->words += sent[k];
+    }
+    const bool same = delta.chain.led == full.chain.led;
+    bool as = true;
+    switch (expect) {
+    case EXPECT_NONE: as = sent[0] == 0 && latches[0] == 0; break;
+    case EXPECT_PARTIAL: as = sent[0] > 0 && sent[0] < sent[1] && latches[0] == 1; break;
+    case EXPECT_FULL: as = sent[0] == sent[1] && latches[0] == 1; break;
+    case EXPECT_ANY: break;
+    }
+    std::fprintf(out, "  %-26s full %5zu words, delta %5zu words %zu latch%s %s\n", name, sent[1], sent[0], latches[0],
+                 latches[0] == 1 ? " " : "es", same && as ? "ok" : (same ? "UNEXPECTED" : "MISMATCH"));
+    return same && as;
+}
+
+/**
+ * @brief 1つの形式で、描画と送出の列を2台で行って比べます。
+ * @param out 出力先
+ * @param name 形式の名前
+ * @param packed 詰めた形式
+ * @param calibrated 色補正（LEDごとの明るさ）
+ * @return すべて一致すれば true
+ */
+bool runDeltaScenario(std::FILE* out, const char* name, bool packed, bool calibrated)
+{
+    // 16x16 を横に4枚（1024 LED）、千鳥配線、偶数行は右から左
+    DeltaRig delta(new WS2812(22, 16, 16, 4, 1));
+    DeltaRig full(new WS2812(22, 16, 16, 4, 1));
+    const std::size_t n = (std::size_t)delta.led->xVRam * delta.led->yVRam;
+    std::vector<std::uint8_t> gain(n);
+    for (std::size_t i = 0; i < n; i++) gain[i] = (std::uint8_t)(128 + (i * 37) % 128);
+    for (DeltaRig* rig : {&delta, &full}) {
+        rig->led->SetPackedWire(packed);
+        if (calibrated) rig->led->SetCalibration(nullptr, gain.data());
+    }
+    delta.led->SetDeltaTransmit(true);
+    std::fprintf(out, "%s (1024 LEDs, serpentine):\n", name);
+
+    const std::uint32_t* walk = MRORunBaked;
+    std::vector<std::uint32_t> wire(n);
+    bool ok = true;
+    auto step = [&](const char* stepName, DeltaExpect expect, const std::function<void(WS2812&)>& op) {
+        ok = deltaStep(out, stepName, delta, full, op, expect) && ok;
+    };
+    step("first frame", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.Clear(0);
+        l.DrawBuffer(walk, 16, 16, 0, 0, 0, false);
+        l.DrawBuffer(walk, 16, 16, 48, 0, 0x070000, false);
+        l.ScanBuffer(true, false);
+    });
+    step("same frame", EXPECT_NONE, [&](WS2812& l) {
+        l.Reset();
+        l.ScanBuffer(true, false);
+    });
+    for (std::size_t k = 1; k <= 6; k++) {
+        step("walk in the first panel", EXPECT_PARTIAL, [&](WS2812& l) {
+            l.Reset();
+            l.DrawBuffer(walk + (k % MROPatCount) * 256, 16, 16, 0, 0, 0, false);
+            l.ScanBuffer(true, false);
+        });
+    }
+    step("last LED", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.SetPixel((std::uint16_t)(l.xVRam - 1), (std::uint16_t)(l.yVRam - 1), 0x102030);
+        l.ScanBuffer(true, false);
+    });
+    step("cached: new frame", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.Clear(0x080808);
+        l.ScanBufferCached(1, true, false);
+    });
+    step("cached: first panel", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk, 16, 16, 0, 0, 0, false);
+        l.ScanBufferCached(2, true, false);
+    });
+    step("cached: show previous", EXPECT_PARTIAL, [&](WS2812& l) { l.ShowCached(1, true, false); });
+    step("cached: show same", EXPECT_NONE, [&](WS2812& l) { l.ShowCached(1, true, false); });
+    step("direct ScanPanel", EXPECT_ANY, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk + 256, 16, 16, 16, 0, 0, false);
+        l.ScanPanel(0, 0, true, false);
+    });
+    step("after direct", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.ScanBuffer(true, false);
+    });
+    step("TransmitWire same frame", EXPECT_NONE, [&](WS2812& l) {
+        l.EncodeWire(wire.data(), true, false);
+        l.Reset();
+        l.TransmitWire(wire.data(), l.WireWords());
+    });
+    step("clear", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.Clear(0);
+        l.ScanBuffer(true, false);
+    });
+    step("clear again", EXPECT_NONE, [&](WS2812& l) {
+        l.Reset();
+        l.ScanBuffer(true, false);
+    });
+
+    const WireDeltaStats& st = delta.led->GetDeltaStats();
+    std::fprintf(out, "  total: full %llu words, delta %llu words (%.1f%%), %u frames, %u skipped, %u partial\n",
+                 (unsigned long long)full.words, (unsigned long long)delta.words,
+                 full.words ? 100.0 * (double)delta.words / (double)full.words : 0.0, (unsigned)st.frames, (unsigned)st.skipped,
+                 (unsigned)st.partial);
+    return ok;
+}
+
+/**
+ * @brief 区画が4つの VRAM（64x64、パネルの行ごとに送る）で、描画と送出の列を2台で行って比べます。
+ * @param out 出力先
+ * @param name 形式の名前
+ * @param packed 詰めた形式
+ * @return すべて一致すれば true
+ * @details 後ろの区画から比べるので、変化した最後の区画より後ろは変換も送出もしません。
+ */
+bool runTiledDeltaScenario(std::FILE* out, const char* name, bool packed)
+{
+    DeltaRig delta(new WS2812(22, 16, 16, 4, 4));
+    DeltaRig full(new WS2812(22, 16, 16, 4, 4));
+    for (DeltaRig* rig : {&delta, &full}) rig->led->SetPackedWire(packed);
+    delta.led->SetDeltaTransmit(true);
+    std::fprintf(out, "%s (64x64 = 4 tiles of 16 rows, serpentine):\n", name);
+
+    const std::uint32_t* walk = MRORunBaked;
+    bool ok = delta.led->IsDeltaTransmit();
+    auto step = [&](const char* stepName, DeltaExpect expect, const std::function<void(WS2812&)>& op) {
+        ok = deltaStep(out, stepName, delta, full, op, expect) && ok;
+    };
+    step("first frame", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.Clear(0);
+        l.DrawBuffer(walk, 16, 16, 0, 0, 0, false);
+        l.DrawBuffer(walk, 16, 16, 48, 48, 0x070000, false);
+        l.ScanBuffer(true, false);
+    });
+    step("same frame", EXPECT_NONE, [&](WS2812& l) {
+        l.Reset();
+        l.ScanBuffer(true, false);
+    });
+    step("walk in tile 0", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk + 256, 16, 16, 0, 0, 0, false);
+        l.ScanBuffer(true, false);
+    });
+    step("tile 2 and tile 0", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk + 512, 16, 16, 0, 0, 0, false);
+        l.DrawBuffer(walk, 16, 16, 24, 32, 0, false);
+        l.ScanBuffer(true, false);
+    });
+    step("first LED of tile 1", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.SetPixel(0, 16, 0x010203);
+        l.ScanBuffer(true, false);
+    });
+    step("last LED (tile 3)", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.SetPixel(63, 63, 0x102030);
+        l.ScanBuffer(true, false);
+    });
+    step("cached: new frame", EXPECT_FULL, [&](WS2812& l) {
+        l.Reset();
+        l.Clear(0x080808);
+        l.ScanBufferCached(1, true, false);
+    });
+    step("same frame after cached", EXPECT_NONE, [&](WS2812& l) {
+        l.Reset();
+        l.ScanBuffer(true, false);
+    });
+    step("cached: tile 1", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk, 16, 16, 16, 16, 0, false);
+        l.ScanBufferCached(2, true, false);
+    });
+    step("tile 0 after cached", EXPECT_PARTIAL, [&](WS2812& l) {
+        l.Reset();
+        l.DrawBuffer(walk + 256, 16, 16, 0, 0, 0, false);
+        l.ScanBuffer(true, false);
+    });
+
+    const WireDeltaStats& st = delta.led->GetDeltaStats();
+    std::fprintf(out, "  total: full %llu words, delta %llu words (%.1f%%), %u frames, %u skipped, %u partial\n",
+                 (unsigned long long)full.words, (unsigned long long)delta.words,
+                 full.words ? 100.0 * (double)delta.words / (double)full.words : 0.0, (unsigned)st.frames, (unsigned)st.skipped,
+                 (unsigned)st.partial);
+    return ok;
+}
+
+/**
+ * @brief 変化したLEDまでだけ送る設定で、VRAMの大きさごとに送出用の作業領域（WS2812::WireBufferBytes）を比べます。
+ * @param out 出力先
+ * @return どの大きさでも上限以内で、上限を超えるVRAMで大きさによらず同じなら true
+ * @details
+ * - 幅64（パネルの行 = 1024 ピクセル = 1区画）で高さを変えます。描画・ScanBuffer・ScanBufferCached（上限0で登録しない）を行った後の値です。
+ * - 以前の作り（VRAM全体の送出データ + LEDの状態）の大きさも並べます。
+ */
+bool runDeltaRamCheck(std::FILE* out)
+{
+    std::fprintf(out, "wire RAM with SetDeltaTransmit(true) (tile %u px, delta up to %u LEDs):\n", (unsigned)WS2812_TILE_PIXELS,
+                 (unsigned)WS2812_DELTA_MAX_LEDS);
+    const std::size_t bound = (2 * (std::size_t)WS2812_TILE_PIXELS + WS2812_DELTA_MAX_LEDS) * sizeof(std::uint32_t);
+    static const std::uint16_t kPanelRows[] = {1, 4, 16, 64, 256};
+    bool ok = true;
+    std::size_t largeBytes = 0;
+    for (std::uint16_t rows : kPanelRows) {
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, 4, rows));
+        const std::size_t pixels = (std::size_t)led->xVRam * led->yVRam;
+        led->SetDeltaTransmit(true);
+        led->SetWireCacheBudget(0);
+        for (int f = 0; f < 3; f++) {
+            led->Reset();
+            led->DrawBuffer(MRORunBaked + (std::size_t)f * 256, 16, 16, 0, 0, 0, false);
+            led->ScanBuffer(true, false);
+        }
+        led->Reset();
+        led->ScanBufferCached(1, true, false);
+        led->WaitTransmit();
+        const std::size_t bytes = led->WireBufferBytes();
+        bool row = bytes <= bound;
+        if (pixels > WS2812_DELTA_MAX_LEDS) {
+            if (largeBytes == 0) largeBytes = bytes;
+            row = row && bytes == largeBytes && !led->IsDeltaTransmit();
+        } else {
+            row = row && led->IsDeltaTransmit();
+        }
+        ok = row && ok;
+        std::fprintf(out, "  64x%-5u delta %-3s wire RAM %6zu bytes (whole-frame buffers: %8zu bytes) %s\n", (unsigned)led->yVRam,
+                     led->IsDeltaTransmit() ? "on" : "off", bytes, 2 * pixels * sizeof(std::uint32_t), row ? "ok" : "MISMATCH");
+    }
+    std::fprintf(out, "  peak wire RAM is at most %zu bytes for any height: %s\n", bound, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 変化したLEDまでだけ送るドライバと、すべて送るドライバのLEDの状態を比べます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runDeltaCheck(std::FILE* out)
+{
+    bool ok = runDeltaScenario(out, "per-pixel words", false, false);
+    ok = runDeltaScenario(out, "packed (4 pixels = 3 words)", true, false) && ok;
+    ok = runDeltaScenario(out, "calibrated (per-LED gain)", false, true) && ok;
+    ok = runTiledDeltaScenario(out, "tiled, per-pixel words", false) && ok;
+    ok = runTiledDeltaScenario(out, "tiled, packed", true) && ok;
+    ok = runDeltaRamCheck(out) && ok;
+    std::fprintf(out, "LED state after every frame matches full transmission: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,267 @@
+/**
+ * @file CheckEvents.cpp
+ * @brief 割り込み→メインループのイベント（EventQueue.h / Debouncer.h / AppEvents.h）の確認
+ * @details
+ * - EventQueue: 満杯で失敗して破棄数が増えること、リングの境界をまたいでも順序と個数が保たれること。
+ * - Debouncer: エッジ→タイマーの手順を時刻つきの表で与え、待ち直しの残り時間と押下の判定を期待値と比べます。
+ * - AppEvents: ボタンのエッジ（チャタリングを含む）から押下のイベントまで、タイマーの再始動/停止/合流と古い世代のイベントの破棄。
+ */
+#include <cstdint>
+#include "Checks.h"
+#include "EventQueue.h"
+#include "Debouncer.h"
+#include "AppEvents.h"
+#include "HostShims.h"
+
+namespace {
+
+/** @brief 連番のイベント。 */
+AppEvent seqEvent(std::uint32_t n)
+{
+    return AppEvent { EVT_TIMER, static_cast<std::uint8_t>(n), 0, n };
+}
+
+/**
+ * @brief EventQueue<4> の満杯と一周を確かめます。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool checkQueue(std::FILE* out)
+{
+    EventQueue<4> q;
+    AppEvent ev;
+    bool ok = q.empty() && !q.pop(ev);
+
+    // 満杯: 5個目は失敗し、破棄数が増え、先の4個は順に取り出せる
+    bool full = true;
+    for (std::uint32_t i = 0; i < 4; i++) full = q.push(seqEvent(i)) && full;
+    full = !q.push(seqEvent(4)) && q.size() == 4 && q.dropped() == 1 && full;
+    for (std::uint32_t i = 0; i < 4; i++) full = q.pop(ev) && ev.timeMs == i && full;
+    full = q.empty() && !q.pop(ev) && full;
+    ok = full && ok;
+    std::fprintf(out, "queue full (4 slots): dropped %u %s\n", (unsigned)q.dropped(), full ? "ok" : "MISMATCH");
+
+    // 一周: 1..4個ずつ積んで取り出すことを繰り返し、境界をまたいで連番が途切れないこと
+    bool wrap = true;
+    std::uint32_t pushed = 0, popped = 0;
+    for (std::uint32_t round = 0; round < 40; round++) {
+        const std::uint32_t n = 1 + round % 4;
+        for (std::uint32_t i = 0; i < n; i++) wrap = q.push(seqEvent(pushed++)) && wrap;
+        wrap = q.size() == n && wrap;
+        // 途中で満杯にしても、境界の位置によらず5個目は失敗する
+        if (n == 4) wrap = !q.push(seqEvent(pushed)) && wrap;
+        for (std::uint32_t i = 0; i < n; i++) wrap = q.pop(ev) && ev.timeMs == popped++ && wrap;
+        wrap = q.empty() && wrap;
+    }
+    ok = wrap && q.dropped() == 11 && ok;
+    std::fprintf(out, "queue wrap (%u events, %u laps): %s\n", (unsigned)pushed, (unsigned)(pushed / 4),
+                 wrap && q.dropped() == 11 ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief Debouncer への1回の呼び出しと期待値。 */
+struct DebStep {
+    char op;               ///< 'E' = onEdge、'T' = onTimer
+    bool level;            ///< onTimer のレベル
+    std::uint32_t ms;      ///< 時刻
+    bool expect;           ///< 戻り値（onEdge はタイマーの起動、onTimer は押下）
+    std::uint32_t retryMs; ///< onTimer の待ち直しの残り時間
+};
+
+/**
+ * @brief 表の手順で Debouncer を動かします。
+ * @return 全手順が期待値どおりなら true
+ */
+bool runDebounce(const char* name, std::uint32_t startMs, const DebStep* steps, std::size_t n, std::FILE* out)
+{
+    Debouncer d(30);
+    d.reset(true);
+    bool ok = true;
+    std::uint32_t presses = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const DebStep& s = steps[i];
+        const std::uint32_t now = startMs + s.ms;
+        if (s.op == 'E') {
+            ok = d.onEdge(now) == s.expect && ok;
+        } else {
+            std::uint32_t retry = 0xFFFFFFFFu;
+            const bool pressed = d.onTimer(s.level, now, retry);
+            presses += pressed ? 1 : 0;
+            ok = pressed == s.expect && retry == s.retryMs && ok;
+        }
+    }
+    std::fprintf(out, "debounce %s: %u press %s\n", name, (unsigned)presses, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/**
+ * @brief Debouncer の判定を確かめます。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool checkDebouncer(std::FILE* out)
+{
+    // チャタリング: 待機中のエッジはタイマーを起動せず、満了時に最後のエッジからの残り時間で待ち直す
+    static const DebStep kBounce[] = {
+        {'E', false, 0, true, 0}, {'E', false, 4, false, 0}, {'E', false, 8, false, 0},
+        {'T', false, 30, false, 8}, {'T', false, 38, true, 0},
+        // 押したまま（Low の確定が続く）は押下ではない
+        {'E', false, 60, true, 0}, {'T', false, 90, false, 0},
+    };
+    // 解放 → High へ戻るグリッチ（確定値は High のまま）→ 押下
+    static const DebStep kGlitch[] = {
+        {'E', false, 0, true, 0}, {'T', false, 30, true, 0},
+        {'E', false, 100, true, 0}, {'T', true, 130, false, 0},
+        {'E', false, 200, true, 0}, {'E', false, 203, false, 0}, {'T', true, 230, false, 3}, {'T', true, 233, false, 0},
+        {'E', false, 300, true, 0}, {'T', false, 330, true, 0},
+    };
+    bool ok = runDebounce("bounce", 1000, kBounce, sizeof(kBounce) / sizeof(kBounce[0]), out);
+    ok = runDebounce("glitch+release", 1000, kGlitch, sizeof(kGlitch) / sizeof(kGlitch[0]), out) && ok;
+    // ms のカウンタが一周する前後
+    ok = runDebounce("ms wraps", 0xFFFFFFF0u, kBounce, sizeof(kBounce) / sizeof(kBounce[0]), out) && ok;
+    return ok;
+}
+
+/** @brief キューに残っているイベントをすべて取り出します。 */
+std::uint32_t drainEvents(std::uint8_t type, AppEvent* last)
+{
+    std::uint32_t n = 0;
+    AppEvent ev;
+    while (events_poll(ev)) {
+        if (ev.type != type) continue;
+        n++;
+        if (last) *last = ev;
+    }
+    return n;
+}
+
+/** @brief 仮想時刻(ms)。 */
+inline std::uint32_t nowMs()
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+const uint kPin = 14; ///< 確認に使うボタンのGPIO
+
+/** @brief events_wait() の間に押すボタン（テスト用アラームのコールバック）。 */
+int64_t pressLater(alarm_id_t, void*)
+{
+    bench_gpio_set(kPin, false);
+    return 0;
+}
+
+/**
+ * @brief AppEvents のボタンとタイマーを、仮想時計で確かめます。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool checkAppEvents(std::FILE* out)
+{
+    bool ok = true;
+    bench_clock_virtual(true, 1000000);
+    events_flush();
+    ok = events_add_button(kPin) && ok;
+    AppEvent ev {};
+
+    // チャタリングつきの押下: 最後のエッジ（8ms）から 30ms で1回だけ。押下のエッジの時刻は最初のエッジ
+    {
+        const std::uint32_t t0 = nowMs();
+        const std::uint64_t t0Us = time_us_64();
+        bench_gpio_set(kPin, false);
+        sleep_ms(4);
+        bench_gpio_set(kPin, true);
+        sleep_ms(4);
+        bench_gpio_set(kPin, false);
+        sleep_ms(100);
+        const std::uint32_t n = drainEvents(EVT_BUTTON, &ev);
+        const bool same = n == 1 && ev.id == kPin && ev.timeMs == t0 + 38 && bench_alarm_pending() == 0 && events_button_edge_us(kPin) == t0Us;
+        ok = same && ok;
+        std::fprintf(out, "button bounce: %u event at +%u ms, edge at +%llu us %s\n", (unsigned)n, (unsigned)(ev.timeMs - t0),
+                     (unsigned long long)(events_button_edge_us(kPin) - t0Us), same ? "ok" : "MISMATCH");
+    }
+    // 解放と、High へ戻るグリッチはイベントにならない
+    {
+        const std::uint64_t edgeUs = events_button_edge_us(kPin);
+        bench_gpio_set(kPin, true);
+        sleep_ms(100);
+        bench_gpio_set(kPin, false);
+        sleep_ms(3);
+        bench_gpio_set(kPin, true);
+        sleep_ms(100);
+        const std::uint32_t n = drainEvents(EVT_BUTTON, nullptr);
+        const bool same = n == 0 && events_button_edge_us(kPin) == edgeUs; // 押下が確定しなければエッジの時刻も変わらない
+        ok = same && ok;
+        std::fprintf(out, "button release+glitch: %u events %s\n", (unsigned)n, same ? "ok" : "MISMATCH");
+    }
+
+    // 再始動: 満了したイベントがキューに残っていても、再始動後は古い世代として読み捨てる
+    {
+        ok = events_start_timer(TIMER_CORO, 10, false) && ok;
+        sleep_ms(10);
+        const bool queued = bench_alarm_pending() == 0;
+        const std::uint32_t t0 = nowMs();
+        ok = events_start_timer(TIMER_CORO, 20, false) && ok;
+        const bool stale = !events_poll(ev);
+        sleep_ms(20);
+        const bool fresh = events_poll(ev) && ev.type == EVT_TIMER && ev.timeMs == t0 + 20 && !events_poll(ev);
+        const bool same = queued && stale && fresh;
+        ok = same && ok;
+        std::fprintf(out, "timer restart drops stale generation: %s\n", same ? "ok" : "MISMATCH");
+    }
+    // 停止: 満了済みのイベントも読み捨て、アラームは残らない
+    {
+        ok = events_start_timer(TIMER_CORO, 10, false) && ok;
+        sleep_ms(10);
+        events_cancel_timer(TIMER_CORO);
+        const bool same = !events_poll(ev) && bench_alarm_pending() == 0;
+        ok = same && ok;
+        std::fprintf(out, "timer cancel drops queued event: %s\n", same ? "ok" : "MISMATCH");
+    }
+    // 繰り返し: 取り出す前の満了は1件に合流し、取り出した後の満了はまた積まれる
+    {
+        ok = events_start_timer(TIMER_CORO, 5, true) && ok;
+        sleep_ms(50);
+        const std::uint32_t merged = drainEvents(EVT_TIMER, nullptr);
+        sleep_ms(5);
+        const std::uint32_t next = drainEvents(EVT_TIMER, nullptr);
+        // events_flush() は合流の印も戻すため、次の満了は積まれる
+        sleep_ms(5);
+        events_flush();
+        sleep_ms(5);
+        const std::uint32_t afterFlush = drainEvents(EVT_TIMER, nullptr);
+        events_cancel_timer(TIMER_CORO);
+        const bool same = merged == 1 && next == 1 && afterFlush == 1 && bench_alarm_pending() == 0;
+        ok = same && ok;
+        std::fprintf(out, "repeating timer: 10 expiries -> %u event, then %u, after flush %u %s\n", (unsigned)merged,
+                     (unsigned)next, (unsigned)afterFlush, same ? "ok" : "MISMATCH");
+    }
+    // events_wait(): WFE の間にアラームでボタンが押され、デバウンス後の押下で戻る
+    {
+        const std::uint32_t t0 = nowMs();
+        add_alarm_in_ms(15, pressLater, nullptr, true);
+        events_wait(ev);
+        const bool same = ev.type == EVT_BUTTON && ev.id == kPin && nowMs() == t0 + 45;
+        ok = same && ok;
+        std::fprintf(out, "events_wait wakes on debounced press at +%u ms: %s\n", (unsigned)(nowMs() - t0), same ? "ok" : "MISMATCH");
+        bench_gpio_set(kPin, true);
+        sleep_ms(100);
+    }
+
+    bench_clock_virtual(false, 0);
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief イベントキュー、デバウンス、タイマーの世代番号を確かめて出力します。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runEventsCheck(std::FILE* out)
+{
+    bool ok = checkQueue(out);
+    ok = checkDebouncer(out) && ok;
+    ok = checkAppEvents(out) && ok;
+    return ok;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file CheckHub75.cpp
+ * @brief HUB75 のリフレッシュレート/CPU負荷の見積もりと、ビットプレーンの模擬走査による確認
+ * @details
+ * - 走査（PIO+DMA）はCPUを使わないため、CPU負荷は VRAM をビットプレーンへ変換する Show() の時間だけです。
+ *   ここではホストでの変換時間から 30fps で更新したときの負荷を出します（実機の値は LGMSerialLED_bench の hub75.*）。
+ * - 模擬走査は PIO のプログラム（hub75.pio）の動作をサイクル単位でなぞります。
+ */
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "HUB75Planes.h"
+
+namespace {
+
+/** @brief 計測するパネルの大きさとビット深度。 */
+const Hub75Geometry kGeometries[] = {
+    {32, 32, 8}, {64, 32, 8}, {64, 64, 8}, {64, 64, 10}, {128, 64, 8}, {128, 64, 10},
+};
+
+const std::uint32_t kPanelClkHz = 20000000; ///< HUB75_DEFAULT_PANEL_CLK_HZ と同じ
+const std::uint32_t kRefreshHz = 240;       ///< HUB75_DEFAULT_REFRESH_HZ と同じ
+const std::uint32_t kUpdateFps = 30;        ///< CPU負荷の見積もりに使う更新頻度
+
+/** @brief ランダムな VRAM（グラデーションとノイズ）。 */
+std::vector<std::uint32_t> makeVram(const Hub75Geometry& g, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v((std::size_t)g.width * g.height);
+    for (std::uint32_t y = 0; y < g.height; y++) {
+        for (std::uint32_t x = 0; x < g.width; x++) {
+            const std::uint32_t r = (x * 255u) / (g.width - 1u);
+            const std::uint32_t gr = (y * 255u) / (g.height - 1u);
+            const std::uint32_t b = rng() & 0xFFu;
+            v[y * g.width + x] = (gr << 16) | (r << 8) | b;
+        }
+    }
+    return v;
+}
+
+/** @brief 模擬走査の結果。 */
+struct SimResult {
+    bool ok { true };            ///< 点灯時間がすべて VRAM と一致
+    std::uint64_t frameCycles { 0 }; ///< 2フレーム目の長さ（clk_sys サイクル）
+    char why[160] { 0 };         ///< 不一致の内容
+};
+
+/**
+ * @brief PIO と同じ順で制御語とビットプレーンを読み、点灯時間とフレーム長を求めます。
+ * @details
+ * - データSM: mov(1) + 1語ごとに9 + irq(1) で1行をシフトし、irq 5（行SMのラッチ完了）を待って次の行へ。
+ * - 行SM: out 2回、irq 4 を待ち、ラッチ3 + irq 1 の後に制御語のサイクル数だけ点灯。
+ * - データSMのサイクルは分周（1/256単位）で clk_sys へ換算します。DMA は常に間に合う（FIFOが空にならない）とします。
+ */
+SimResult simulate(const Hub75Geometry& g, const Hub75Timing& t, const std::uint32_t* vram, const std::uint16_t* lut,
+                   const std::uint32_t* planes, const std::uint32_t* ctrl)
+{
+    SimResult res;
+    const std::uint32_t rows = g.height / 2u;
+    const std::uint32_t words = g.width / 4u;
+    const std::uint32_t steps = rows * g.depth;
+    const std::uint64_t div256 = ((std::uint64_t)t.dataDivInt << 8) | t.dataDivFrac;
+    auto dataCycles = [&](std::uint64_t smCycles) { return (smCycles * div256 + 255u) / 256u; };
+
+    // 点灯時間の合計 [行ペア][x][R0 G0 B0 R1 G1 B1]
+    std::vector<std::uint64_t> lit((std::size_t)rows * g.width * 6, 0);
+    std::uint64_t dataFree = 0;  // データSMが次の行を始められる時刻
+    std::uint64_t rowFree = 0;   // 行SMが次の制御語を読める時刻
+    std::uint64_t frameStart[3] = {0, 0, 0};
+    for (std::uint32_t frame = 0; frame < 3; frame++) {
+        for (std::uint32_t k = 0; k < steps; k++) {
+            if (k == 0) frameStart[frame] = rowFree;
+            const std::uint32_t c = ctrl[k];
+            const std::uint32_t addr = c & 0x1Fu;
+            const std::uint64_t oe = (std::uint64_t)(c >> 5) + 1u;
+            const std::uint64_t shifted = dataFree + dataCycles(1u + words * HUB75_DATA_CYCLES_PER_WORD + 1u); // irq set 4
+            const std::uint64_t latch = std::max(rowFree + 2u, shifted) + 1u; // wait 1 irq 4
+            const std::uint64_t release = latch + 3u + 1u;                 // nop [2] + irq set 5
+            dataFree = release + dataCycles(1u);                           // wait 1 irq 5
+            rowFree = release + oe;                                        // jmp x-- lit
+
+            if (frame != 0) continue;
+            const std::uint32_t plane = k % g.depth;
+            if (addr != k / g.depth) {
+                std::snprintf(res.why, sizeof(res.why), "step %u: address %u, expected %u", k, addr, k / g.depth);
+                res.ok = false;
+                return res;
+            }
+            if (oe != ((std::uint64_t)t.oeBaseCycles << plane)) {
+                std::snprintf(res.why, sizeof(res.why), "step %u: oe %llu, expected %u<<%u", k, (unsigned long long)oe, t.oeBaseCycles, plane);
+                res.ok = false;
+                return res;
+            }
+            // out pins, 6 / out null, 2 をLSBから: 1語=4ピクセル
+            const std::uint32_t* row = &planes[(std::size_t)k * words];
+            for (std::uint32_t x = 0; x < g.width; x++) {
+                const std::uint32_t bits = (row[x / 4u] >> ((x % 4u) * 8u)) & 0x3Fu;
+                for (std::uint32_t ch = 0; ch < 6; ch++) {
+                    if (bits & (1u << ch)) lit[((std::size_t)addr * g.width + x) * 6 + ch] += oe;
+                }
+            }
+        }
+    }
+    res.frameCycles = frameStart[2] - frameStart[1];
+
+    // 期待値: lut[チャネル値] * oeBaseCycles（プレーン b の点灯は base<<b）
+    for (std::uint32_t r = 0; r < rows && res.ok; r++) {
+        for (std::uint32_t x = 0; x < g.width; x++) {
+            const std::uint32_t top = vram[r * g.width + x];
+            const std::uint32_t bottom = vram[(r + rows) * g.width + x];
+            const std::uint32_t want[6] = {
+                lut[(top >> 8) & 0xFFu], lut[(top >> 16) & 0xFFu], lut[top & 0xFFu],
+                lut[(bottom >> 8) & 0xFFu], lut[(bottom >> 16) & 0xFFu], lut[bottom & 0xFFu],
+            };
+            for (std::uint32_t ch = 0; ch < 6; ch++) {
+                const std::uint64_t got = lit[((std::size_t)r * g.width + x) * 6 + ch];
+                if (got != (std::uint64_t)want[ch] * t.oeBaseCycles) {
+                    std::snprintf(res.why, sizeof(res.why), "row %u x %u ch %u: lit %llu, expected %u*%u", r, x, ch,
+                                  (unsigned long long)got, want[ch], t.oeBaseCycles);
+                    res.ok = false;
+                    break;
+                }
+            }
+            if (!res.ok) break;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+/**
+ * @brief パネルの大きさ/ビット深度ごとのリフレッシュレートとCPU負荷を出力し、模擬走査で確かめます。
+ * @param out 出力先
+ * @param sysHz clk_sys(Hz)
+ * @return すべての模擬走査が一致すればtrue
+ */
+bool runHub75Report(std::FILE* out, std::uint32_t sysHz)
+{
+    using clock = std::chrono::steady_clock;
+    bool allOk = true;
+    std::fprintf(out, "HUB75: clk_sys %.1fMHz, shift clock %.1fMHz, target %uHz, update %ufps\n",
+                 sysHz / 1e6, kPanelClkHz / 1e6, kRefreshHz, kUpdateFps);
+    std::fprintf(out, "%-8s %5s %9s %9s %8s %6s %9s %9s %11s %10s  %s\n", "panel", "depth", "refresh", "sim", "oe_base",
+                 "lit%", "shift_us", "planes_KB", "encode_us", "cpu@fps", "check");
+    for (const Hub75Geometry& g : kGeometries) {
+        Hub75Timing t;
+        const bool reach = hub75_calc_timing(sysHz, g, kPanelClkHz, kRefreshHz, t);
+        const auto vram = makeVram(g, 11);
+        std::uint16_t lut[256];
+        hub75_build_lut(g.depth, 2.2f, lut);
+        std::vector<std::uint32_t> planes(hub75_plane_words(g));
+        std::vector<std::uint32_t> ctrl((std::size_t)(g.height / 2u) * g.depth);
+        hub75_build_control(g, t, ctrl.data());
+
+        // 変換時間: 数回の最小
+        double bestUs = 1e30;
+        for (int i = 0; i < 20; i++) {
+            const auto t0 = clock::now();
+            hub75_encode_planes(vram.data(), g.width, g, lut, planes.data());
+            bestUs = std::min(bestUs, std::chrono::duration<double, std::micro>(clock::now() - t0).count());
+        }
+
+        const SimResult sim = simulate(g, t, vram.data(), lut, planes.data(), ctrl.data());
+        const double simHz = sim.frameCycles ? (double)sysHz / (double)sim.frameCycles : 0.0;
+        // 模擬走査のフレーム長は見積もり（hub75_calc_timing）と 0.5% 以内で一致すること
+        const bool timingOk = sim.frameCycles != 0 && std::abs((double)sim.frameCycles - (double)t.frameCycles) <= t.frameCycles / 200.0;
+        const bool ok = sim.ok && timingOk;
+        allOk = allOk && ok;
+
+        char panel[16];
+        std::snprintf(panel, sizeof(panel), "%ux%u", g.width, g.height);
+        std::fprintf(out, "%-8s %5u %7uHz %7.0fHz %8u %5.1f%% %9.2f %9.1f %11.1f %9.2f%%  %s%s\n", panel, g.depth, t.refreshHz,
+                     simHz, t.oeBaseCycles, t.oePermille / 10.0, t.shiftCycles * 1e6 / sysHz,
+                     planes.size() * 2 * sizeof(std::uint32_t) / 1024.0, bestUs, bestUs * kUpdateFps / 1e4,
+                     ok ? "ok" : "MISMATCH", reach ? "" : " (below target)");
+        if (!sim.ok) std::fprintf(out, "  %s\n", sim.why);
+        if (!timingOk) std::fprintf(out, "  frame %llu cycles, expected %u\n", (unsigned long long)sim.frameCycles, t.frameCycles);
+    }
+    std::fprintf(out, "refresh itself uses no CPU (PIO + self-restarting DMA); cpu@fps = encode_us * fps (host)\n");
+    return allOk;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file CheckLarge.cpp
+ * @brief 大きなVRAM（一辺255超、数万ピクセル）と任意の大きさのパターンの確認
+ * @details
+ * - 確認: 128x64 と 256x64 のパネル列、幅300のパネル、4ピクセルにそろわないパネルの行で、ScanBuffer() が送った語を基準と比べます。
+ *   VRAMからはみ出すパターン（負の位置を含む）の描画、WS2812Static の DrawSprite/DrawBuffer、
+ *   24x32 のキャラクタを 128x64 へ拡大した停止/歩行表示と、20x20 のVRAMへ切り詰めた表示も確かめます。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "FrameRender.h"
+#include "HostShims.h"
+#include "LedCalibration.h"
+#include "PatCache.h"
+#include "Patterns.h"
+#include "WirePack.h"
+#include "WS2812.h"
+#include "WS2812Static.h"
+
+namespace {
+
+/** @brief 約1/4が黒のテストデータ。 */
+std::vector<std::uint32_t> makePattern(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 4 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/**
+ * @brief 基準: VRAMを1ピクセルずつ送出順に並べます（パネルは左上→右下、パネル内は行優先）。
+ * @param l ドライバ
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @param gain LEDごとの明るさ（nullptr で無効）
+ * @return 送出データ（1ピクセル1語、詰めるなら wire_pack で詰めたもの）
+ */
+std::vector<std::uint32_t> refWire(const WS2812& l, bool serpentine, bool leftToRight, const std::uint8_t* gain)
+{
+    std::vector<std::uint32_t> wire;
+    wire.reserve((std::size_t)l.xVRam * l.yVRam);
+    for (std::uint32_t py = 0; py < l.yPanelCount; py++) {
+        for (std::uint32_t px = 0; px < l.xPanelCount; px++) {
+            for (std::uint32_t y = 0; y < l.ySize; y++) {
+                const bool l2r = serpentine ? ((y & 1u) ? !leftToRight : leftToRight) : leftToRight;
+                for (std::uint32_t i = 0; i < l.xSize; i++) {
+                    const std::uint32_t x = l2r ? i : l.xSize - 1u - i;
+                    std::uint32_t c = l.pVRam[(std::size_t)(py * l.ySize + y) * l.xVRam + px * l.xSize + x];
+                    if (gain) c = ledcal_apply(c, nullptr, gain[wire.size()]);
+                    wire.push_back(c << 8);
+                }
+            }
+        }
+    }
+    if (l.IsPackedWire()) wire.resize(wire_pack(wire.data(), wire.data(), wire.size()));
+    return wire;
+}
+
+/**
+ * @brief 1つのパネル構成で、ScanBuffer() が送った語を基準と比べます。
+ * @param out 出力先
+ * @param name 名前
+ * @param xSize パネルの幅
+ * @param ySize パネルの高さ
+ * @param xPanels パネル数(横)
+ * @param yPanels パネル数(縦)
+ * @param serpentine 千鳥配線
+ * @param leftToRight 偶数行の基準方向
+ * @param packed 詰めた形式
+ * @param calibrated LEDごとの明るさ
+ * @return 一致すれば true
+ */
+bool checkScan(std::FILE* out, const char* name, std::uint16_t xSize, std::uint16_t ySize, std::uint16_t xPanels, std::uint16_t yPanels,
+               bool serpentine, bool leftToRight, bool packed, bool calibrated)
+{
+    std::unique_ptr<WS2812> led(new WS2812(22, xSize, ySize, xPanels, yPanels));
+    const std::size_t n = (std::size_t)led->xVRam * led->yVRam;
+    const std::vector<std::uint32_t> data = makePattern(n, (std::uint32_t)n);
+    for (std::size_t i = 0; i < n; i++) led->pVRam[i] = data[i];
+    std::vector<std::uint8_t> gain(n);
+    for (std::size_t i = 0; i < n; i++) gain[i] = (std::uint8_t)(96 + (i * 53) % 160);
+    led->SetPackedWire(packed);
+    if (calibrated) led->SetCalibration(nullptr, gain.data());
+
+    g_benchWireLog.words.clear();
+    g_benchWireLog.latches.clear();
+    g_benchWireLog.enabled = true;
+    led->Reset();
+    led->ScanBuffer(serpentine, leftToRight);
+    led->WaitTransmit();
+    g_benchWireLog.enabled = false;
+
+    const std::vector<std::uint32_t> ref = refWire(*led, serpentine, leftToRight, calibrated ? gain.data() : nullptr);
+    const bool ok = g_benchWireLog.words == ref && led->WireWords() == ref.size();
+    std::fprintf(out, "scan %-32s %4ux%-4u %6zu px %6zu words %s\n", name, (unsigned)led->xVRam, (unsigned)led->yVRam, n,
+                 g_benchWireLog.words.size(), ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/**
+ * @brief 基準: パターンを1ピクセルずつVRAMへ描きます（LedCanvas::DrawBuffer と同じ規則、はみ出す部分は描かない）。
+ */
+void refDraw(std::vector<std::uint32_t>& vram, std::uint32_t vw, std::uint32_t vh, const std::uint32_t* pat, std::uint32_t w,
+             std::uint32_t h, std::int32_t X, std::int32_t Y, std::uint32_t colorReplace, bool isOverlay)
+{
+    for (std::uint32_t py = 0; py < h; py++) {
+        for (std::uint32_t px = 0; px < w; px++) {
+            const std::int64_t x = (std::int64_t)X + px, y = (std::int64_t)Y + py;
+            if (x < 0 || y < 0 || x >= vw || y >= vh) continue;
+            const std::uint32_t c = pat[py * w + px];
+            std::uint32_t& d = vram[(std::size_t)y * vw + (std::size_t)x];
+            if (c != 0) d = colorReplace ? colorReplace : c;
+            else if (!isOverlay) d = 0;
+        }
+    }
+}
+
+/** @brief VRAMからはみ出すパターン（負の位置、幅255超）の描画を基準と比べます。 */
+bool checkDraw(std::FILE* out)
+{
+    std::unique_ptr<WS2812> led(new WS2812(22, 32, 16, 8, 4)); // 256x64
+    const std::uint32_t vw = led->xVRam, vh = led->yVRam;
+    std::vector<std::uint32_t> ref(vw * vh, 0);
+    const std::vector<std::uint32_t> pat = makePattern(300 * 40, 7);
+    struct Op {
+        std::int32_t x, y;
+        std::uint32_t colorReplace;
+        bool isOverlay;
+    };
+    const Op ops[] = {
+        {-17, -5, 0, false}, {200, 30, 0, true}, {-299, 63, 0, false}, {256, 0, 0, false}, {10, 10, 0x070000, true}, {-40, 50, 0, true},
+    };
+    bool ok = true;
+    for (const Op& op : ops) {
+        led->DrawBuffer(pat.data(), 300, 40, op.x, op.y, op.colorReplace, op.isOverlay);
+        refDraw(ref, vw, vh, pat.data(), 300, 40, op.x, op.y, op.colorReplace, op.isOverlay);
+        const bool same = std::equal(ref.begin(), ref.end(), led->pVRam);
+        std::fprintf(out, "draw_buffer 300x40 at (%4d,%3d) %s %s\n", (int)op.x, (int)op.y,
+                     op.colorReplace ? "replace" : (op.isOverlay ? "overlay" : "opaque "), same ? "ok" : "MISMATCH");
+        ok = same && ok;
+    }
+
+    // WS2812Static（128x64）は収まる場合は定数ループ、はみ出す場合は LedCanvas::DrawBuffer
+    std::unique_ptr<WS2812Static<16, 16, 8, 4>> st(new WS2812Static<16, 16, 8, 4>(22));
+    std::unique_ptr<WS2812> dyn(new WS2812(22, 16, 16, 8, 4));
+    const std::vector<std::uint32_t> spr = makePattern(40 * 24, 11);
+    st->DrawSprite<40, 24>(spr.data(), -7, 50, 0, false);
+    dyn->DrawBuffer(spr.data(), 40, 24, -7, 50, 0, false);
+    st->DrawSprite<40, 24>(spr.data(), 60, 20, 0, true);
+    dyn->DrawBuffer(spr.data(), 40, 24, 60, 20, 0, true);
+    st->DrawBuffer(spr.data(), 40, 24, 100, -3, 0x000700, false);
+    dyn->DrawBuffer(spr.data(), 40, 24, 100, -3, 0x000700, false);
+    const bool same = std::equal(st->pVRam, st->pVRam + st->kPixels, dyn->pVRam);
+    std::fprintf(out, "WS2812Static<16,16,8,4> DrawSprite<40,24>/DrawBuffer outside the VRAM %s\n", same ? "ok" : "MISMATCH");
+    return same && ok;
+}
+
+/**
+ * @brief 16x16 でないキャラクタ（24x32）を、拡大する 128x64 と切り詰める 20x20 のVRAMへ表示して基準と比べます。
+ */
+bool checkCharacter(std::FILE* out)
+{
+    constexpr std::uint16_t W = 24, H = 32;
+    constexpr std::size_t kWalk = 3;
+    const std::vector<std::uint32_t> stay = makePattern(W * H, 21);
+    const std::vector<std::uint32_t> walk = makePattern(W * H * kWalk, 22);
+    // 補正は等倍（レンジ 0..255、ガンマ/明度/コントラストなし）
+    Patterns ch = {stay.data(), {walk.data(), NULL, NULL, NULL}, kWalk, {0, 255}, {0, 255}, {0, 255}, 0.0f, 0, 0, false, false, 100, 50,
+                   false, W, H};
+    PatCache cache;
+    PatSet* set = cache.acquire(ch);
+    bool ok = set != nullptr && set->stay.width() == W && set->stay.height() == H && set->run[0].width() == W &&
+              set->run[0].count() == kWalk && ch.processedBytes() == (std::size_t)W * H * 4 * (1 + kWalk);
+    std::fprintf(out, "character %ux%u: pattern sets %ux%u, %zu bytes %s\n", (unsigned)W, (unsigned)H,
+                 set ? (unsigned)set->stay.width() : 0u, set ? (unsigned)set->stay.height() : 0u, ch.processedBytes(), ok ? "ok" : "MISMATCH");
+    if (set == nullptr) return false;
+
+    // 128x64: 2倍（縦で決まる）に拡大して中央（左端 40）へ
+    std::unique_ptr<WS2812> wall(new WS2812(22, 16, 16, 8, 4));
+    auto scaled = [&](const std::uint32_t* pat) {
+        std::vector<std::uint32_t> ref(wall->xVRam * wall->yVRam, 0);
+        for (std::uint32_t y = 0; y < 2u * H; y++) {
+            for (std::uint32_t x = 0; x < 2u * W; x++) ref[y * wall->xVRam + 40 + x] = pat[(y / 2) * W + x / 2];
+        }
+        return std::equal(ref.begin(), ref.end(), wall->pVRam);
+    };
+    drawStopFrame(*wall, ch, set->stay, 1);
+    bool same = scaled(stay.data());
+    drawRunFrame(*wall, ch, set->run[0], 1, 2, false, 2);
+    same = scaled(walk.data() + 2 * W * H) && same;
+    std::fprintf(out, "character on 128x64: stop/walk scaled x2 and centred %s\n", same ? "ok" : "MISMATCH");
+    ok = same && ok;
+
+    // 20x20: 等倍で中央へ（左上 (-2,-6)、はみ出す部分は描かない）
+    std::unique_ptr<WS2812> small(new WS2812(22, 20, 20));
+    drawStopFrame(*small, ch, set->stay, 1);
+    std::vector<std::uint32_t> ref(20 * 20, 0);
+    refDraw(ref, 20, 20, stay.data(), W, H, -2, -6, 0, false);
+    same = std::equal(ref.begin(), ref.end(), small->pVRam);
+    std::fprintf(out, "character on 20x20: stop clipped and centred %s\n", same ? "ok" : "MISMATCH");
+    return same && ok;
+}
+
+} // namespace
+
+/**
+ * @brief 大きなVRAMと任意の大きさのパターンを基準と比べます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runLargeCheck(std::FILE* out)
+{
+    bool ok = checkScan(out, "16x16 x 8x4 serpentine", 16, 16, 8, 4, true, false, false, false);
+    ok = checkScan(out, "16x16 x 8x4 packed", 16, 16, 8, 4, true, false, true, false) && ok;
+    ok = checkScan(out, "16x16 x 8x4 calibrated", 16, 16, 8, 4, true, false, false, true) && ok;
+    ok = checkScan(out, "16x16 x 8x4 packed + calibrated", 16, 16, 8, 4, true, true, true, true) && ok;
+    ok = checkScan(out, "32x16 x 8x4 (256 wide)", 32, 16, 8, 4, false, true, false, false) && ok;
+    ok = checkScan(out, "300x3 panel (right to left)", 300, 3, 1, 1, true, false, false, false) && ok;
+    ok = checkScan(out, "300x3 panel packed", 300, 3, 1, 1, true, false, true, false) && ok;
+    ok = checkScan(out, "5x3 x 41x30 packed (odd rows)", 5, 3, 41, 30, true, false, true, false) && ok;
+    ok = checkScan(out, "5x3 x 41x30 packed + calibrated", 5, 3, 41, 30, true, true, true, true) && ok;
+    ok = checkDraw(out) && ok;
+    ok = checkCharacter(out) && ok;
+    std::fprintf(out, "large canvases and sprite sizes: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file CheckMain.cpp
+ * @brief ホスト用テスト（LGMSerialLED_hosttest）のエントリポイント
+ * @details
+ * 使い方: LGMSerialLED_hosttest 名前 | soak N
+ * - 名前の確認を1つ実行し、結果を標準出力へ出します。すべて期待どおりなら終了コード0、そうでなければ1です。
+ * - soak だけは N（キャラクタの切り替え回数）を取ります。
+ * - ctest では確認ごとに1つのテストとして登録しています（bench/CMakeLists.txt）。
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Checks.h"
+
+namespace {
+
+/** @brief 名前と確認の対応。 */
+struct CheckEntry {
+    const char* name;            ///< コマンドラインで指定する名前
+    bool (*run)(std::FILE* out); ///< 確認
+};
+
+bool runHub75Check(std::FILE* out) { return runHub75Report(out, 150000000u); }
+
+const CheckEntry kChecks[] = {
+    {"hub75", runHub75Check},
+    {"apa102", runApa102Check},
+    {"ws2812-static", runWs2812StaticCheck},
+    {"sprite", runSpriteCheck},
+    {"calibration", runCalibrationCheck},
+    {"packed", runWirePackCheck},
+    {"boot", runBootCheck},
+    {"coro", runCoroCheck},
+    {"stream", runStreamCheck},
+    {"delta", runDeltaCheck},
+    {"large", runLargeCheck},
+    {"tilemap", runTileMapCheck},
+    {"sequencer", runSequencerCheck},
+    {"events", runEventsCheck},
+    {"power", runPowerCheck},
+    {"timing", runTimingCheck},
+    {"baked", runBakedCheck},
+    {"pixelops", runPixelOpsCheck},
+    {"wire-cache", runWireCacheCheck},
+};
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && std::strcmp(argv[1], "soak") == 0) return runPatSoak(stdout, std::strtoul(argv[2], nullptr, 10)) ? 0 : 1;
+    if (argc == 2) {
+        for (const CheckEntry& c : kChecks) {
+            if (std::strcmp(argv[1], c.name) == 0) return c.run(stdout) ? 0 : 1;
+        }
+    }
+    std::fprintf(stderr, "usage: %s NAME | soak N\nNAME:", argv[0]);
+    for (const CheckEntry& c : kChecks) std::fprintf(stderr, " %s", c.name);
+    std::fprintf(stderr, "\n");
+    return 2;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file CheckPixelOps.cpp
+ * @brief パック済みピクセル演算（PixelOps.h）と、チャネルごとの基準実装（pixelops::ref）のビット単位の比較
+ * @details
+ * - px_*（RP2350 では DSP 命令、それ以外では SWAR）と swar:: の両方を ref:: と比べます。
+ * - 実機用ベンチマーク（bench/device/BenchDevice.cpp）からも呼ぶため、標準ライブラリは cstdio/cstdint だけを使い、配列は静的に持ちます。
+ */
+#include <cstddef>
+#include <cstdint>
+#include "Checks.h"
+#include "PixelOps.h"
+
+namespace {
+
+using namespace pixelops;
+
+/** @brief 再現できる乱数（xorshift32）。 */
+struct Rng {
+    std::uint32_t s = 0x12345678u;
+    std::uint32_t next()
+    {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return s;
+    }
+};
+
+/** @brief 1つの演算の比較結果。 */
+struct Tally {
+    std::uint32_t cases = 0;  ///< 比べた数
+    std::uint32_t px = 0;     ///< px_* の不一致
+    std::uint32_t swar = 0;   ///< swar:: の不一致
+    std::uint32_t first = 0;  ///< 最初の不一致の入力（a）
+    std::uint32_t firstB = 0; ///< 最初の不一致の入力（b / アルファ）
+
+    void add(std::uint32_t a, std::uint32_t b, std::uint32_t expect, std::uint32_t gotPx, std::uint32_t gotSwar)
+    {
+        if ((gotPx != expect || gotSwar != expect) && px == 0 && swar == 0) {
+            first = a;
+            firstB = b;
+        }
+        cases++;
+        if (gotPx != expect) px++;
+        if (gotSwar != expect) swar++;
+    }
+};
+
+/**
+ * @brief 結果を1行出力します。
+ * @return 不一致がなければ true
+ */
+bool report(std::FILE* out, const char* name, const Tally& t)
+{
+    const bool ok = t.px == 0 && t.swar == 0;
+    if (ok) {
+        std::fprintf(out, "%-10s %8u cases: ok\n", name, (unsigned)t.cases);
+    } else {
+        std::fprintf(out, "%-10s %8u cases: px %u / swar %u differ (first a=%08X b=%08X) MISMATCH\n", name, (unsigned)t.cases,
+                     (unsigned)t.px, (unsigned)t.swar, (unsigned)t.first, (unsigned)t.firstB);
+    }
+    return ok;
+}
+
+/** @brief w のレーン lane を v に置き換えます。 */
+std::uint32_t setLane(std::uint32_t w, int lane, std::uint32_t v)
+{
+    const int sh = lane * 8;
+    return (w & ~(0xFFu << sh)) | (v << sh);
+}
+
+/**
+ * @brief 2入力の演算を、各レーンの全組と乱数の語で比べます。
+ * @param refFn 基準
+ * @param pxFn px_*
+ * @param swarFn swar::
+ */
+template <class R, class P, class S>
+Tally checkBinary(R refFn, P pxFn, S swarFn, Rng& rng, std::uint32_t randomCases)
+{
+    Tally t;
+    for (int lane = 0; lane < 4; lane++) {
+        for (std::uint32_t x = 0; x < 256; x++) {
+            for (std::uint32_t y = 0; y < 256; y++) {
+                const std::uint32_t a = setLane(rng.next(), lane, x);
+                const std::uint32_t b = setLane(rng.next(), lane, y);
+                t.add(a, b, refFn(a, b), pxFn(a, b), swarFn(a, b));
+            }
+        }
+    }
+    for (std::uint32_t i = 0; i < randomCases; i++) {
+        const std::uint32_t a = rng.next(), b = rng.next();
+        t.add(a, b, refFn(a, b), pxFn(a, b), swarFn(a, b));
+    }
+    return t;
+}
+
+/** @brief ブレンドで全組を比べるアルファ（両端、1、16刻み、255）。 */
+const std::uint32_t kBlendAlphas[] = {0, 1, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 255, 256};
+
+/**
+ * @brief バッファ版を ref のループと比べます。
+ * @return 一致すれば true
+ */
+bool checkBuffers(std::FILE* out, Rng& rng)
+{
+    constexpr std::size_t kN = 256;
+    static std::uint32_t a[kN], b[kN], dst[kN], expect[kN];
+    for (std::size_t i = 0; i < kN; i++) {
+        a[i] = rng.next();
+        b[i] = rng.next();
+    }
+    std::uint32_t bad = 0;
+
+    // アルファ倍（256 は複写、src と同じ dst も）
+    static const std::uint32_t kScaleAlphas[] = {0, 1, 100, 255, 256};
+    for (std::uint32_t alpha : kScaleAlphas) {
+        px_scale_buffer(dst, a, kN, alpha);
+        for (std::size_t i = 0; i < kN; i++) bad += dst[i] != ref::scale(a[i], alpha);
+        for (std::size_t i = 0; i < kN; i++) dst[i] = a[i];
+        px_scale_buffer(dst, dst, kN, alpha);
+        for (std::size_t i = 0; i < kN; i++) bad += dst[i] != ref::scale(a[i], alpha);
+    }
+    static const std::uint32_t kBufferBlendAlphas[] = {0, 100, 256};
+    for (std::uint32_t alpha : kBufferBlendAlphas) {
+        px_blend_buffer(dst, a, b, kN, alpha);
+        for (std::size_t i = 0; i < kN; i++) bad += dst[i] != ref::blend(a[i], b[i], alpha);
+    }
+    for (std::size_t i = 0; i < kN; i++) {
+        dst[i] = a[i];
+        expect[i] = ref::add_sat(a[i], b[i]);
+    }
+    px_add_buffer(dst, b, kN);
+    for (std::size_t i = 0; i < kN; i++) bad += dst[i] != expect[i];
+    for (std::size_t i = 0; i < kN; i++) {
+        dst[i] = a[i];
+        expect[i] = ref::max(a[i], b[i]);
+    }
+    px_max_buffer(dst, b, kN);
+    for (std::size_t i = 0; i < kN; i++) bad += dst[i] != expect[i];
+    std::uint32_t sum = 0;
+    for (std::size_t i = 0; i < kN; i++) sum += ref::sum(a[i]);
+    bad += px_sum_buffer(a, kN) != sum;
+
+    std::fprintf(out, "buffers    scale/blend/add/max/sum x %u px: %s\n", (unsigned)kN, bad == 0 ? "ok" : "MISMATCH");
+    return bad == 0;
+}
+
+} // namespace
+
+bool runPixelOpsCheck(std::FILE* out)
+{
+    std::fprintf(out, "path: %s\n", PIXELOPS_USE_DSP ? "DSP (UQADD8/UQSUB8/UHADD8/USUB8+SEL/USADA8)" : "SWAR");
+    Rng rng;
+    bool ok = true;
+    constexpr std::uint32_t kRandom = 200000;
+
+    ok = report(out, "add_sat", checkBinary([](std::uint32_t a, std::uint32_t b) { return ref::add_sat(a, b); },
+                                             [](std::uint32_t a, std::uint32_t b) { return px_add_sat(a, b); },
+                                             [](std::uint32_t a, std::uint32_t b) { return swar::add_sat(a, b); }, rng, kRandom)) && ok;
+    ok = report(out, "sub_sat", checkBinary([](std::uint32_t a, std::uint32_t b) { return ref::sub_sat(a, b); },
+                                             [](std::uint32_t a, std::uint32_t b) { return px_sub_sat(a, b); },
+                                             [](std::uint32_t a, std::uint32_t b) { return swar::sub_sat(a, b); }, rng, kRandom)) && ok;
+    ok = report(out, "avg", checkBinary([](std::uint32_t a, std::uint32_t b) { return ref::avg(a, b); },
+                                         [](std::uint32_t a, std::uint32_t b) { return px_avg(a, b); },
+                                         [](std::uint32_t a, std::uint32_t b) { return swar::avg(a, b); }, rng, kRandom)) && ok;
+    ok = report(out, "max", checkBinary([](std::uint32_t a, std::uint32_t b) { return ref::max(a, b); },
+                                         [](std::uint32_t a, std::uint32_t b) { return px_max(a, b); },
+                                         [](std::uint32_t a, std::uint32_t b) { return swar::max(a, b); }, rng, kRandom)) && ok;
+
+    // アルファ倍: 各レーンの全値 x 全アルファ
+    Tally scale;
+    for (int lane = 0; lane < 4; lane++) {
+        for (std::uint32_t v = 0; v < 256; v++) {
+            for (std::uint32_t alpha = 0; alpha <= 256; alpha++) {
+                const std::uint32_t c = setLane(rng.next(), lane, v);
+                scale.add(c, alpha, ref::scale(c, alpha), px_scale(c, alpha), swar::scale(c, alpha));
+            }
+        }
+    }
+    for (std::uint32_t i = 0; i < kRandom; i++) {
+        const std::uint32_t c = rng.next(), alpha = rng.next() % 257u;
+        scale.add(c, alpha, ref::scale(c, alpha), px_scale(c, alpha), swar::scale(c, alpha));
+    }
+    ok = report(out, "scale", scale) && ok;
+
+    // ブレンド: 各レーンの全組 x 代表的なアルファ
+    Tally blend;
+    for (int lane = 0; lane < 4; lane++) {
+        for (std::uint32_t x = 0; x < 256; x++) {
+            for (std::uint32_t y = 0; y < 256; y++) {
+                const std::uint32_t a = setLane(rng.next(), lane, x);
+                const std::uint32_t b = setLane(rng.next(), lane, y);
+                for (std::uint32_t alpha : kBlendAlphas) {
+                    blend.add(a, alpha, ref::blend(a, b, alpha), px_blend(a, b, alpha), swar::blend(a, b, alpha));
+                }
+            }
+        }
+    }
+    for (std::uint32_t i = 0; i < kRandom; i++) {
+        const std::uint32_t a = rng.next(), b = rng.next(), alpha = rng.next() % 257u;
+        blend.add(a, alpha, ref::blend(a, b, alpha), px_blend(a, b, alpha), swar::blend(a, b, alpha));
+    }
+    ok = report(out, "blend", blend) && ok;
+
+    // 合計: 各レーンの全値
+    Tally sum;
+    for (int lane = 0; lane < 4; lane++) {
+        for (std::uint32_t v = 0; v < 256; v++) {
+            for (std::uint32_t i = 0; i < 64; i++) {
+                const std::uint32_t c = setLane(rng.next(), lane, v);
+                sum.add(c, 0, ref::sum(c), px_sum(c), swar::sum(c));
+            }
+        }
+    }
+    for (std::uint32_t i = 0; i < kRandom; i++) {
+        const std::uint32_t c = rng.next();
+        sum.add(c, 0, ref::sum(c), px_sum(c), swar::sum(c));
+    }
+    ok = report(out, "sum", sum) && ok;
+
+    ok = checkBuffers(out, rng) && ok;
+    return ok;
+}
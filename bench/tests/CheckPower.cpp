@@ -0,0 +1,150 @@
+/**
+ * @file CheckPower.cpp
+ * @brief 休止（PowerState.h / PowerManager.h）の状態遷移の確認
+ * @details
+ * - PowerStateMachine: 順序に反する呼び出しが状態を変えないこと、休止回数・休止時間・起床レイテンシ（最大値）の記録。
+ * - PowerManager: 休止中は clk_sys が XOSC で PLL_SYS が止まっていること、タイマーのイベントでは起きずボタンで起きること、
+ *   起床後にクロックと WS2812 の分周が戻り、最初のフレームでだけレイテンシ（押下のエッジから）を記録すること。
+ */
+#include <cstdint>
+#include "Checks.h"
+#include "PowerManager.h"
+#include "PowerState.h"
+#include "AppEvents.h"
+#include "WS2812.h"
+#include "hardware/clocks.h"
+#include "HostShims.h"
+
+namespace {
+
+/** @brief 状態機械への1回の呼び出しと期待値。 */
+struct PwrStep {
+    char op;            ///< 'R' = requestSleep、'S' = sleepEntered、'W' = wake、'F' = frameShown
+    std::uint64_t us;   ///< 時刻
+    bool expect;        ///< 戻り値
+    POWER_STATE after;  ///< 呼び出し後の状態
+};
+
+/**
+ * @brief PowerStateMachine の遷移と統計を確かめます。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool checkStateMachine(std::FILE* out)
+{
+    // 順序に反する呼び出しは false で状態を変えない。2回休止し、起床レイテンシは 700 → 300us
+    static const PwrStep kSteps[] = {
+        {'F', 0, false, PWR_ACTIVE}, {'S', 0, false, PWR_ACTIVE}, {'W', 0, false, PWR_ACTIVE},
+        {'R', 1000, true, PWR_SUSPENDING}, {'R', 1100, false, PWR_SUSPENDING}, {'W', 1100, false, PWR_SUSPENDING},
+        {'F', 1100, false, PWR_SUSPENDING},
+        {'S', 2000, true, PWR_SLEEPING}, {'S', 2100, false, PWR_SLEEPING}, {'F', 2100, false, PWR_SLEEPING},
+        {'W', 12000, true, PWR_RESUMING}, {'W', 12100, false, PWR_RESUMING}, {'R', 12100, false, PWR_RESUMING},
+        {'F', 12700, true, PWR_ACTIVE}, {'F', 12800, false, PWR_ACTIVE},
+        {'R', 20000, true, PWR_SUSPENDING}, {'S', 20000, true, PWR_SLEEPING}, {'W', 50000, true, PWR_RESUMING},
+        {'F', 50300, true, PWR_ACTIVE},
+    };
+    PowerStateMachine fsm;
+    bool ok = true;
+    for (const PwrStep& s : kSteps) {
+        bool r = false;
+        switch (s.op) {
+        case 'R': r = fsm.requestSleep(s.us); break;
+        case 'S': r = fsm.sleepEntered(s.us); break;
+        case 'W': r = fsm.wake(static_cast<std::uint8_t>(20 + fsm.stats().sleepCount), s.us); break;
+        default: r = fsm.frameShown(s.us); break;
+        }
+        ok = r == s.expect && fsm.state() == s.after && ok;
+    }
+    const PowerStats& st = fsm.stats();
+    const bool stats = st.sleepCount == 2 && st.totalSleepUs == 10000 + 30000 && st.lastWakeLatencyUs == 300 &&
+                       st.maxWakeLatencyUs == 700 && st.lastWakePin == 22;
+    ok = stats && ok;
+    std::fprintf(out, "state machine (%u steps): sleeps %u, slept %llu us, latency %u us (max %u) %s\n",
+                 (unsigned)(sizeof(kSteps) / sizeof(kSteps[0])), (unsigned)st.sleepCount, (unsigned long long)st.totalSleepUs,
+                 (unsigned)st.lastWakeLatencyUs, (unsigned)st.maxWakeLatencyUs, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+const uint kPinEnter = 14; ///< 起床用のボタン（LGMSerialLED の ENTER/SET と同じ）
+const uint kPinSet = 15;
+
+/** @brief 休止中に確かめた値。 */
+struct SleepProbe {
+    std::uint32_t clkSysHz;
+    bool pllRunning;
+    POWER_STATE state;
+};
+SleepProbe s_probe {};
+PowerManager* s_power = nullptr;
+
+/** @brief 休止中に SET を押す（テスト用アラームのコールバック）。 */
+int64_t pressSet(alarm_id_t, void*)
+{
+    s_probe = SleepProbe { clock_get_hz(clk_sys), bench_pll_sys_running(), s_power->fsm().state() };
+    bench_gpio_set(kPinSet, false);
+    return 0;
+}
+
+/**
+ * @brief PowerManager::hibernate() を仮想時計で動かします。
+ * @param out 出力先
+ * @return 一致すれば true
+ */
+bool checkHibernate(std::FILE* out)
+{
+    bench_clock_virtual(true, 5000000);
+    PowerManager power;
+    s_power = &power;
+    WS2812 led(22, 16, 16);
+    bool ok = events_add_button(kPinEnter) && events_add_button(kPinSet);
+    ok = power.addWakePin(kPinEnter) && power.addWakePin(kPinSet) && !power.addWakePin(16) && ok;
+
+    // 休止中: 100ms でタイマーが満了（起きない）、500ms で SET を押す（30ms のデバウンス後に起きる）
+    const std::uint32_t activeHz = clock_get_hz(clk_sys);
+    events_start_timer(TIMER_CORO, 100, false);
+    add_alarm_in_ms(500, pressSet, nullptr, true);
+    const std::uint64_t t0 = time_us_64();
+    const uint pin = power.hibernate(led);
+    const std::uint64_t wokeUs = time_us_64() - t0;
+
+    const bool asleep = s_probe.clkSysHz == XOSC_HZ && !s_probe.pllRunning && s_probe.state == PWR_SLEEPING;
+    const bool woke = pin == kPinSet && power.fsm().state() == PWR_RESUMING && wokeUs >= 530000 && wokeUs < 531000;
+    const bool restored = clock_get_hz(clk_sys) == activeHz && bench_pll_sys_running() && led.GetTiming().sysHz == activeHz;
+    std::fprintf(out, "hibernate (XOSC+WFE): asleep at %u Hz, PLL_SYS %s %s\n", (unsigned)s_probe.clkSysHz,
+                 s_probe.pllRunning ? "running" : "stopped", asleep ? "ok" : "MISMATCH");
+    std::fprintf(out, "wake on GPIO%u after %llu us (timer expiry ignored) %s\n", (unsigned)pin, (unsigned long long)wokeUs,
+                 woke ? "ok" : "MISMATCH");
+    std::fprintf(out, "clk_sys and WS2812 divider restored to %u Hz %s\n", (unsigned)clock_get_hz(clk_sys), restored ? "ok" : "MISMATCH");
+    ok = asleep && woke && restored && ok;
+
+    // 最初のフレームでだけレイテンシを記録する（起床時刻は押下のエッジ。デバウンスの 30ms と Resume() のリセットラッチの待ちを含む）
+    const std::uint64_t expectUs = t0 + 500000;
+    sleep_us(2500);
+    const bool first = power.frameShown();
+    const bool second = power.frameShown();
+    const PowerStats& st = power.fsm().stats();
+    const bool latency = first && !second && st.lastWakeLatencyUs == time_us_64() - expectUs && st.sleepCount == 1 && power.fsm().state() == PWR_ACTIVE;
+    ok = latency && ok;
+    std::fprintf(out, "first frame latency %u us, recorded once %s\n", (unsigned)st.lastWakeLatencyUs, latency ? "ok" : "MISMATCH");
+
+    bench_gpio_set(kPinSet, true);
+    sleep_ms(100);
+    s_power = nullptr;
+    bench_clock_virtual(false, 0);
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 休止の状態遷移を確かめて出力します。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runPowerCheck(std::FILE* out)
+{
+    bool ok = checkStateMachine(out);
+    ok = checkHibernate(out) && ok;
+    std::fprintf(out, "note: DORMANT (LGM_HAVE_PICO_SLEEP) is not simulated; the default build stays in WFE at XOSC\n");
+    return ok;
+}
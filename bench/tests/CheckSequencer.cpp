@@ -0,0 +1,278 @@
+/**
+ * @file CheckSequencer.cpp
+ * @brief 歩行タイムライン（AnimSequencer）のフレーム選択の確認
+ * @details
+ * 5キャラクタそれぞれについて、タイムラインを1ms刻みの仮想時計で最後まで再生し、以前の実装（10秒タイマー + sleep_ms のループ）の模擬と比べます。
+ * - グループの順序、フレームの順序（0から1ずつ進む）が同じ
+ * - 歩き/走りのフレームの長さと、前のパターンと重ねた表示の長さが同じ（重ねた表示は 1/256 周期の丸めまで）
+ * - グループと歩き/走りの切り替え・終了の時刻: 以前の実装はフレームの先頭でしか切り替えないため、その遅れ（1フレーム未満）だけ違う
+ * - 2回目の歩行: 以前の実装は前回の続きのグループ/フレームから始まり、AnimSequencer は毎回グループ0・フレーム0から始まる（意図した変更）
+ * - 時間倍率 50% で、同じフレームの並びのまま長さが2倍になる
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "AnimSequencer.h"
+#include "BenchChars.h"
+#include "Checks.h"
+
+namespace {
+
+/** @brief 同じ内容を表示していた区間。 */
+struct Shown {
+    std::uint32_t start; ///< 開始時刻(ms)
+    std::uint32_t end;   ///< 終了時刻(ms、含まない)
+    std::uint8_t group;  ///< グループ
+    std::uint8_t tempo;  ///< TEMPO_WALK / TEMPO_RUN
+    std::size_t frame;   ///< フレーム
+    bool blend;          ///< 前のパターンと重ねた表示
+
+    bool operator==(const Shown& o) const
+    {
+        return start == o.start && end == o.end && group == o.group && tempo == o.tempo && frame == o.frame && blend == o.blend;
+    }
+};
+
+/** @brief 以前の実装で、歩行をまたいで残る状態（main のローカル変数とタイマーのフラグ）。 */
+struct LegacyState {
+    std::uint8_t group { 0 };  ///< patGrpNo
+    std::size_t curr { 0 };    ///< currPatNo
+    bool timerChange { false }; ///< timer_change
+};
+
+/**
+ * @brief 以前の実装の歩行（ボタンを押した時刻を0とする）を模擬します。
+ * @param ch キャラクタ
+ * @param st [in,out] 歩行をまたいで残る状態
+ * @param endMs [out] 停止状態へ戻った時刻
+ * @return 表示した区間
+ * @details 10秒ごとのタイマーで回数を数え（6回で停止）、フレームの先頭で回数を見てテンポを、フラグを見てグループを決めます。
+ *          1フレームは「前のパターンと重ねた表示（待ちの1/4、走りは1/6）」+「パターン表示（待ち）」です。
+ */
+std::vector<Shown> legacyWalk(const Patterns& ch, LegacyState& st, std::uint32_t& endMs)
+{
+    const int groups = ch.groupCount();
+    std::vector<Shown> v;
+    std::uint32_t t = 0, nextTick = 10000;
+    int count = 0;
+    bool stop = false;
+    while (true) {
+        while (!stop && nextTick <= t) {
+            count++;
+            st.timerChange = true;
+            nextTick += 10000;
+            if (count >= 6) stop = true;
+        }
+        if (stop) break;
+        const bool walk = count < 5;
+        const std::uint32_t wait = walk ? ch.iWaitWalk : ch.iWaitRun;
+        const std::uint32_t trans = walk ? wait / 4 : wait / 6;
+        if (st.timerChange) {
+            st.timerChange = false;
+            if (++st.group >= 4) st.group = 0;
+            if (st.group >= groups) st.group = 0;
+        }
+        const std::uint8_t tempo = walk ? TEMPO_WALK : TEMPO_RUN;
+        if (trans > 0) v.push_back({t, t + trans, st.group, tempo, st.curr, true});
+        v.push_back({t + trans, t + trans + wait, st.group, tempo, st.curr, false});
+        t += trans + wait;
+        if (++st.curr >= ch.PatWalkCount) st.curr = 0;
+    }
+    endMs = t;
+    return v;
+}
+
+/**
+ * @brief AnimSequencer で歩行を再生します（ファームウェアの walkScript と同じ使い方、1ms ごとに更新）。
+ * @param ch キャラクタ
+ * @param timeScale 時間倍率(%)
+ * @param endMs [out] 終端に達した時刻
+ * @return 表示した区間
+ */
+std::vector<Shown> sequencerWalk(const Patterns& ch, std::uint16_t timeScale, std::uint32_t& endMs)
+{
+    const int groups = ch.groupCount();
+    SeqTempo tempos[2];
+    ch.makeTempos(tempos);
+    std::size_t stepCount;
+    const SeqStep* tl = ch.timeline(stepCount);
+    AnimSequencer seq;
+    seq.setTimeScale(timeScale);
+    seq.begin(tl, stepCount, tempos, ch.PatWalkCount, 0);
+    std::vector<Shown> v;
+    for (std::uint32_t t = 0;; t++) {
+        const SeqPosition pos = seq.update(t);
+        if (pos.finished) {
+            endMs = t;
+            break;
+        }
+        const std::uint8_t group = pos.group < groups ? pos.group : 0;
+        const Shown s {t, t + 1, group, pos.tempo, pos.frame, pos.isBlend};
+        if (!v.empty() && v.back().group == s.group && v.back().tempo == s.tempo && v.back().frame == s.frame && v.back().blend == s.blend) {
+            v.back().end = t + 1;
+        } else {
+            v.push_back(s);
+        }
+    }
+    return v;
+}
+
+/** @brief グループ/テンポが変わった時刻と、変わった後のグループ/テンポ。 */
+struct Switch {
+    std::uint32_t at;
+    std::uint8_t group;
+    std::uint8_t tempo;
+};
+
+/** @brief グループかテンポが変わった時刻の一覧。 */
+std::vector<Switch> switches(const std::vector<Shown>& v)
+{
+    std::vector<Switch> s;
+    for (std::size_t i = 1; i < v.size(); i++) {
+        if (v[i].group != v[i - 1].group || v[i].tempo != v[i - 1].tempo) s.push_back({v[i].start, v[i].group, v[i].tempo});
+    }
+    return s;
+}
+
+/** @brief フレームの並び（連続する同じフレームは1つ）。 */
+std::vector<std::size_t> frameOrder(const std::vector<Shown>& v)
+{
+    std::vector<std::size_t> f;
+    for (const Shown& s : v)
+        if (f.empty() || f.back() != s.frame) f.push_back(s.frame);
+    return f;
+}
+
+/**
+ * @brief フレームの並びが0から1ずつ進むかを確かめます。
+ * @param f フレームの並び
+ * @param count フレーム数
+ */
+bool contiguous(const std::vector<std::size_t>& f, std::size_t count)
+{
+    if (f.empty() || f.front() != 0) return false;
+    for (std::size_t i = 1; i < f.size(); i++)
+        if (f[i] != (f[i - 1] + 1) % count) return false;
+    return true;
+}
+
+/** @brief テンポごとの、以前の実装の1フレームの長さと重ねた表示の長さ。 */
+struct LegacyTiming {
+    std::uint32_t period[2] {};
+    std::uint32_t blend[2] {};
+};
+
+/**
+ * @brief 1つのキャラクタを比べます。
+ * @param out 出力先
+ * @param charNo キャラクタ番号
+ * @return 一致（許容範囲内）すれば true
+ */
+bool checkChar(std::FILE* out, int charNo)
+{
+    const Patterns& ch = g_benchCharsBaked[charNo];
+    bool ok = true;
+    auto expect = [&](bool cond, const char* what) {
+        if (!cond) std::fprintf(out, "  char %d: %s MISMATCH\n", charNo, what);
+        ok = ok && cond;
+    };
+
+    LegacyState legacy;
+    std::uint32_t legacyEnd = 0, seqEnd = 0;
+    const std::vector<Shown> lw = legacyWalk(ch, legacy, legacyEnd);
+    const std::vector<Shown> sw = sequencerWalk(ch, 100, seqEnd);
+
+    // 以前の実装のフレームの長さ（テンポごと）
+    LegacyTiming lt;
+    std::uint32_t wait[2] {};
+    for (const Shown& s : lw) (s.blend ? lt.blend : wait)[s.tempo] = s.end - s.start;
+    for (int k = 0; k < 2; k++) lt.period[k] = wait[k] + lt.blend[k];
+
+    // グループ/テンポの切り替え: 順序は同じ、以前の実装は1フレーム未満だけ遅れる
+    const std::vector<Switch> ls = switches(lw), ss = switches(sw);
+    bool sameSwitches = ls.size() == ss.size();
+    std::uint32_t maxLag = 0;
+    long lagFrames = 0; // 遅れの間に、速いテンポで進むフレーム数の上限
+    for (std::size_t i = 0; sameSwitches && i < ls.size(); i++) {
+        sameSwitches = ls[i].group == ss[i].group && ls[i].tempo == ss[i].tempo;
+        const std::uint32_t before = i > 0 ? ls[i - 1].tempo : static_cast<std::uint32_t>(TEMPO_WALK);
+        sameSwitches = sameSwitches && ls[i].at >= ss[i].at && ls[i].at - ss[i].at < lt.period[before];
+        if (!sameSwitches) break;
+        const std::uint32_t lag = ls[i].at - ss[i].at;
+        if (lag > maxLag) maxLag = lag;
+        lagFrames += (long)((lag + lt.period[TEMPO_RUN] - 1) / lt.period[TEMPO_RUN]);
+    }
+    expect(sameSwitches, "group/tempo switches");
+    expect(seqEnd == 60000 && legacyEnd >= seqEnd && legacyEnd - seqEnd < lt.period[TEMPO_RUN], "end of the timeline");
+
+    // フレームの並び
+    const std::vector<std::size_t> lf = frameOrder(lw), sf = frameOrder(sw);
+    const long frameDiff = (long)lf.size() - (long)sf.size();
+    expect(contiguous(lf, ch.PatWalkCount) && contiguous(sf, ch.PatWalkCount), "frame order");
+    // フレーム数の差は、切り替えと終了の遅れの間に進むフレーム数まで
+    lagFrames += 1 + (long)((legacyEnd - seqEnd + lt.period[TEMPO_RUN] - 1) / lt.period[TEMPO_RUN]);
+    expect(std::labs(frameDiff) <= lagFrames, "frame count");
+
+    // 切り替えをまたがないフレームの長さと重ねた表示の長さ
+    std::size_t checked = 0;
+    bool sameTiming = true;
+    for (std::size_t i = 0; i < sw.size();) {
+        std::size_t j = i;
+        while (j + 1 < sw.size() && sw[j + 1].frame == sw[i].frame && sw[j + 1].group == sw[i].group && sw[j + 1].tempo == sw[i].tempo) j++;
+        const bool first = i == 0 || sw[i - 1].group != sw[i].group || sw[i - 1].tempo != sw[i].tempo;
+        const bool last = j + 1 >= sw.size() || sw[j + 1].group != sw[j].group || sw[j + 1].tempo != sw[j].tempo;
+        if (!first && !last) {
+            const std::uint8_t tempo = sw[i].tempo;
+            std::uint32_t blendMs = 0;
+            for (std::size_t k = i; k <= j; k++)
+                if (sw[k].blend) blendMs += sw[k].end - sw[k].start;
+            const std::uint32_t period = sw[j].end - sw[i].start;
+            const std::uint32_t tol = 1 + lt.period[tempo] / 256;
+            sameTiming = sameTiming && period == lt.period[tempo] &&
+                         (blendMs + tol >= lt.blend[tempo] && blendMs <= lt.blend[tempo] + tol);
+            checked++;
+        }
+        i = j + 1;
+    }
+    expect(sameTiming && checked > 0, "frame and blend lengths");
+
+    // 2回目の歩行: 以前の実装は続きから、AnimSequencer は毎回グループ0・フレーム0から
+    std::uint32_t legacyEnd2 = 0, seqEnd2 = 0;
+    const std::vector<Shown> lw2 = legacyWalk(ch, legacy, legacyEnd2);
+    const std::vector<Shown> sw2 = sequencerWalk(ch, 100, seqEnd2);
+    expect(sw2 == sw && seqEnd2 == seqEnd && sw2.front().group == 0 && sw2.front().frame == 0, "second walk restarts at group 0");
+
+    // 時間倍率 50%: 同じ並びで2倍の長さ
+    std::uint32_t slowEnd = 0;
+    const std::vector<Shown> slow = sequencerWalk(ch, 50, slowEnd);
+    bool slowSame = slowEnd == 2 * seqEnd && frameOrder(slow) == sf && switches(slow).size() == ss.size();
+    for (std::size_t i = 0; slowSame && i < ss.size(); i++) slowSame = switches(slow)[i].at == 2 * ss[i].at;
+    expect(slowSame, "time scale 50%");
+
+    std::fprintf(out, "char %d: %d group(s), %zu frames, walk %u ms (blend %u), run %u ms (blend %u)\n", charNo, ch.groupCount(),
+                 ch.PatWalkCount, (unsigned)lt.period[TEMPO_WALK], (unsigned)lt.blend[TEMPO_WALK], (unsigned)lt.period[TEMPO_RUN],
+                 (unsigned)lt.blend[TEMPO_RUN]);
+    std::fprintf(out, "  groups:");
+    std::fprintf(out, " %u", (unsigned)sw.front().group);
+    for (const Switch& s : ss) std::fprintf(out, " %s%u@%u", s.tempo == TEMPO_RUN ? "run:" : "", (unsigned)s.group, (unsigned)s.at);
+    std::fprintf(out, "\n  baseline lags switches by <= %u ms, ends at %u ms (sequencer %u ms), frames %zu vs %zu, %zu whole frames timed\n",
+                 (unsigned)maxLag, (unsigned)legacyEnd, (unsigned)seqEnd, lf.size(), sf.size(), checked);
+    std::fprintf(out, "  second walk: baseline starts at group %u frame %zu, sequencer at group %u frame %zu %s\n", (unsigned)lw2.front().group,
+                 lw2.front().frame, (unsigned)sw2.front().group, sw2.front().frame, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 仮想時計で AnimSequencer を動かし、以前の実装の模擬と比べます。
+ * @param out 出力先
+ * @return すべて一致（許容範囲内）すれば true
+ */
+bool runSequencerCheck(std::FILE* out)
+{
+    bool ok = true;
+    for (int c = 0; c < BENCH_CHAR_COUNT; c++) ok = checkChar(out, c) && ok;
+    std::fprintf(out, "sequencer frame selection matches the timer-driven loop: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file CheckSoak.cpp
+ * @brief キャラクタ切り替えを長時間繰り返したときのヒープの使い方の確認（ソーク）
+ * @details
+ * - 実行時に補正するキャラクタ（大きさがそれぞれ違う）を乱数の順で切り替え、ファームウェアと同じく次のキャラクタを prefetch() します。
+ *   キャッシュの上限を超えるので、追い出しと再処理が続きます。
+ * - グローバルの operator new/delete を置き換えて回数を数えます（このプログラム全体に効きますが、数えるだけです）。
+ * - パターンのバッファが置かれたアドレスの範囲（最小〜最大）も記録します。ヒープではこの範囲が広がりうる（断片化）のに対し、
+ *   アリーナでは起動時に確保した領域の中に収まります。
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include "Checks.h"
+#include "BenchChars.h"
+#include "PatCache.h"
+
+namespace {
+
+unsigned long g_heapNews = 0;    ///< operator new の回数
+unsigned long g_heapDeletes = 0; ///< operator delete の回数（nullptr を除く）
+
+void* countedNew(std::size_t n)
+{
+    g_heapNews++;
+    return std::malloc(n ? n : 1);
+}
+
+void countedDelete(void* p)
+{
+    if (p == nullptr) return;
+    g_heapDeletes++;
+    std::free(p);
+}
+
+/** @brief 1回分の結果。 */
+struct SoakResult {
+    unsigned long news;        ///< 切り替え中の operator new の回数
+    long liveDelta;            ///< 開始前と clear() 後の、解放されていないブロック数の差
+    std::uintptr_t lo, hi;     ///< パターンのバッファのアドレスの範囲 [lo, hi)
+    unsigned long mismatches;  ///< 内容が基準と違った回数
+    std::size_t peakBytes;     ///< PatCacheStats::peakBytes
+};
+
+/** @brief PatSet のバッファの範囲を広げます。 */
+void extend(SoakResult& r, const PatManager& pm)
+{
+    if (!pm.isInitialized || pm.isAttached()) return;
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(pm.getBufferPtr(0));
+    const std::uintptr_t b = a + pm.count() * pm.width() * pm.height() * sizeof(std::uint32_t);
+    if (r.lo == 0 || a < r.lo) r.lo = a;
+    if (b > r.hi) r.hi = b;
+}
+
+/** @brief 乱数の順で切り替えます。 */
+SoakResult soak(PatCache& cache, unsigned long switches, const PatManager reference[BENCH_CHAR_COUNT])
+{
+    SoakResult r {};
+    const long live0 = (long)(g_heapNews - g_heapDeletes);
+    const unsigned long news0 = g_heapNews;
+    std::mt19937 rng(2024);
+    int next = 0;
+    for (unsigned long i = 0; i < switches; i++) {
+        const int charNo = next;
+        next = (int)(rng() % BENCH_CHAR_COUNT);
+        PatSet* set = cache.acquire(g_benchCharsRuntime[charNo]);
+        if (set == nullptr) {
+            r.mismatches++;
+            continue;
+        }
+        const std::size_t bytes = reference[charNo].width() * reference[charNo].height() * sizeof(std::uint32_t);
+        if (std::memcmp(set->stay.getBufferPtr(0), reference[charNo].getBufferPtr(0), bytes) != 0) r.mismatches++;
+        extend(r, set->stay);
+        for (const PatManager& pm : set->run) extend(r, pm);
+        cache.prefetch(g_benchCharsRuntime[next]);
+    }
+    r.news = g_heapNews - news0;
+    r.peakBytes = cache.stats().peakBytes;
+    cache.clear();
+    r.liveDelta = (long)(g_heapNews - g_heapDeletes) - live0;
+    return r;
+}
+
+void print(std::FILE* out, const char* name, const SoakResult& r, std::size_t arenaBytes)
+{
+    std::fprintf(out, "%-6s heap_allocs=%-8lu live_blocks_delta=%-4ld addr_span=%-8zu peak_bytes=%-6zu arena_bytes=%-6zu mismatches=%lu\n",
+                 name, r.news, r.liveDelta, (std::size_t)(r.hi - r.lo), r.peakBytes, arenaBytes, r.mismatches);
+}
+
+} // namespace
+
+void* operator new(std::size_t n) { void* p = countedNew(n); if (!p) throw std::bad_alloc(); return p; }
+void* operator new[](std::size_t n) { void* p = countedNew(n); if (!p) throw std::bad_alloc(); return p; }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedNew(n); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedNew(n); }
+void operator delete(void* p) noexcept { countedDelete(p); }
+void operator delete[](void* p) noexcept { countedDelete(p); }
+void operator delete(void* p, std::size_t) noexcept { countedDelete(p); }
+void operator delete[](void* p, std::size_t) noexcept { countedDelete(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedDelete(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedDelete(p); }
+
+/**
+ * @brief キャラクタ切り替えを繰り返し、ヒープとアリーナの結果を出力します。
+ * @param out 出力先
+ * @param switches 切り替え回数
+ * @return アリーナ使用時の結果が期待どおりならtrue
+ */
+bool runPatSoak(std::FILE* out, unsigned long switches)
+{
+    // 基準: 各キャラクタをヒープで1回だけ処理したもの
+    PatManager reference[BENCH_CHAR_COUNT];
+    PatManager refRun[BENCH_CHAR_COUNT][4];
+    std::size_t maxSetBytes = 0;
+    for (int i = 0; i < BENCH_CHAR_COUNT; i++) {
+        g_benchCharsRuntime[i].setPatManager(reference[i], refRun[i]);
+        if (g_benchCharsRuntime[i].processedBytes() > maxSetBytes) maxSetBytes = g_benchCharsRuntime[i].processedBytes();
+    }
+    std::fprintf(out, "switches=%lu chars=%d largest_set=%zu bytes cache_limit=%d bytes\n", switches, BENCH_CHAR_COUNT, maxSetBytes, PATCACHE_MAX_BYTES);
+
+    PatCache heapCache;
+    const SoakResult heap = soak(heapCache, switches, reference);
+    print(out, "heap", heap, 0);
+
+    PatCache arenaCache;
+    if (!arenaCache.reserveArena(maxSetBytes)) {
+        std::fprintf(out, "arena: reserveArena(%zu) failed\n", maxSetBytes);
+        return false;
+    }
+    const SoakResult arena = soak(arenaCache, switches, reference);
+    print(out, "arena", arena, arenaCache.arenaBytes());
+    std::fprintf(out, "arena slots=%d slot_peak=%zu bytes\n", arenaCache.arenaSlots(), arenaCache.arenaPeakBytes());
+
+    const bool ok = arena.news == 0 && arena.liveDelta == 0 && arena.mismatches == 0 && heap.mismatches == 0 &&
+                    (std::size_t)(arena.hi - arena.lo) <= arenaCache.arenaBytes() && arenaCache.arenaPeakBytes() <= maxSetBytes;
+    std::fprintf(out, "%s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
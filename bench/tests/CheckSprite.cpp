@@ -0,0 +1,213 @@
+/**
+ * @file CheckSprite.cpp
+ * @brief パターンの拡大・縮小・回転描画（SpriteBlit.h）の確認
+ * @details
+ * - 確認: 等倍・整数倍・90°単位の回転はビット単位、小数倍・任意角は倍精度の基準と比べます。
+ */
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "SpriteBlit.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストパターン。 */
+std::vector<std::uint32_t> makeSprite(std::uint32_t w, std::uint32_t h, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(w * h);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu) | 1u;
+    return v;
+}
+
+/** @brief DrawBuffer と同じ規則で1ピクセルを書きます（基準画像用）。 */
+void put(std::vector<std::uint32_t>& dst, std::size_t i, std::uint32_t color, std::uint32_t colorReplace, bool isOverlay)
+{
+    if (color != 0) dst[i] = colorReplace ? colorReplace : color;
+    else if (!isOverlay) dst[i] = 0;
+}
+
+/** @brief 描画先の初期値（重ねる場合に元の内容が残るかを見るため、黒以外で埋める）。 */
+std::vector<std::uint32_t> makeCanvas(std::uint32_t w, std::uint32_t h) { return std::vector<std::uint32_t>(w * h, 0x030201u); }
+
+/** @brief 左上 (left, top) に倍率 k で置く変換。 */
+SpriteXform placeScaled(std::uint32_t sw, std::uint32_t sh, std::int32_t left, std::int32_t top, std::int32_t k, std::uint8_t angle)
+{
+    SpriteXform xf;
+    sprite_xform_make(sw, sh, left * SPRITE_ONE + (std::int32_t)(sw * k) * SPRITE_ONE / 2,
+                      top * SPRITE_ONE + (std::int32_t)(sh * k) * SPRITE_ONE / 2, k * SPRITE_ONE, k * SPRITE_ONE, angle, xf);
+    return xf;
+}
+
+/** @brief 整数倍（と等倍）: 各ピクセルを k x k に複製した基準と比べます。 */
+bool checkScaled(std::FILE* out, std::int32_t k, std::int32_t left, std::int32_t top, std::uint32_t colorReplace, bool isOverlay)
+{
+    const std::uint32_t sw = 16, sh = 16, dw = 64, dh = 48;
+    const auto sprite = makeSprite(sw, sh, (std::uint32_t)(k * 31 + left));
+    auto got = makeCanvas(dw, dh), want = makeCanvas(dw, dh);
+    const SpriteXform xf = placeScaled(sw, sh, left, top, k, 0);
+    sprite_blit(got.data(), dw, dh, sprite.data(), sw, sh, xf, SPRITE_NEAREST, colorReplace, isOverlay);
+    for (std::int32_t y = 0; y < (std::int32_t)(sh * k); y++) {
+        for (std::int32_t x = 0; x < (std::int32_t)(sw * k); x++) {
+            const std::int32_t dx = left + x, dy = top + y;
+            if (dx < 0 || dy < 0 || dx >= (std::int32_t)dw || dy >= (std::int32_t)dh) continue;
+            put(want, (std::size_t)dy * dw + dx, sprite[(y / k) * sw + x / k], colorReplace, isOverlay);
+        }
+    }
+    const bool ok = got == want;
+    std::fprintf(out, "scale=%d    at (%3d,%3d) replace=%d overlay=%d %s\n", k, left, top, colorReplace != 0, isOverlay, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief 等倍は DrawBuffer と同じ結果か（VRAMに収まる位置と右下へのはみ出し）。 */
+bool checkDrawBuffer(std::FILE* out)
+{
+    bool ok = true;
+    const auto sprite = makeSprite(16, 16, 5);
+    const std::uint8_t pos[][2] = {{0, 0}, {3, 5}, {40, 20}, {60, 44}};
+    for (const auto& p : pos) {
+        for (int mode = 0; mode < 3; mode++) {
+            WS2812 a(22, 16, 16, 4, 3), b(22, 16, 16, 4, 3);
+            a.Clear(0x030201);
+            b.Clear(0x030201);
+            const std::uint32_t replace = mode == 2 ? 0x070000u : 0u;
+            const bool overlay = mode >= 1;
+            a.DrawBuffer(sprite.data(), 16, 16, p[0], p[1], replace, overlay);
+            b.DrawTransformed(sprite.data(), 16, 16, placeScaled(16, 16, p[0], p[1], 1, 0), replace, overlay);
+            bool same = true;
+            for (std::uint32_t i = 0; i < 64 * 48; i++) same = same && a.pVRam[i] == b.pVRam[i];
+            ok = ok && same;
+        }
+        std::fprintf(out, "draw_buffer at (%3u,%3u) opaque/overlay/replace %s\n", p[0], p[1], ok ? "ok" : "MISMATCH");
+    }
+    return ok;
+}
+
+/** @brief 90°単位の回転: 並べ替えた基準と比べます（時計回り）。 */
+bool checkQuarterTurns(std::FILE* out)
+{
+    bool ok = true;
+    const std::uint32_t sw = 12, sh = 7, dw = 40, dh = 40;
+    const auto sprite = makeSprite(sw, sh, 11);
+    for (int q = 0; q < 4; q++) {
+        for (std::int32_t k = 1; k <= 2; k++) {
+            // 回転後の大きさ（q が奇数なら縦横が入れ替わる）で左上 (left, top) に置く
+            const std::uint32_t rw = (q & 1) ? sh : sw, rh = (q & 1) ? sw : sh;
+            const std::int32_t left = 14, top = 15;
+            auto got = makeCanvas(dw, dh), want = makeCanvas(dw, dh);
+            SpriteXform xf;
+            sprite_xform_make(sw, sh, left * SPRITE_ONE + (std::int32_t)(rw * k) * SPRITE_ONE / 2, top * SPRITE_ONE + (std::int32_t)(rh * k) * SPRITE_ONE / 2,
+                              k * SPRITE_ONE, k * SPRITE_ONE, (std::uint8_t)(q * 64), xf);
+            sprite_blit(got.data(), dw, dh, sprite.data(), sw, sh, xf, SPRITE_NEAREST, 0, true);
+            for (std::uint32_t y = 0; y < rh * k; y++) {
+                for (std::uint32_t x = 0; x < rw * k; x++) {
+                    const std::uint32_t u = x / k, v = y / k; // 回転後の画像での位置
+                    std::uint32_t sx, sy;
+                    switch (q) {
+                    case 0: sx = u; sy = v; break;
+                    case 1: sx = v; sy = sh - 1 - u; break;
+                    case 2: sx = sw - 1 - u; sy = sh - 1 - v; break;
+                    default: sx = sw - 1 - v; sy = u; break;
+                    }
+                    put(want, (std::size_t)(top + y) * dw + left + x, sprite[sy * sw + sx], 0, true);
+                }
+            }
+            const bool same = got == want;
+            ok = ok && same;
+            std::fprintf(out, "rotate=%3d   scale=%d %s\n", q * 90, k, same ? "ok" : "MISMATCH");
+        }
+    }
+    return ok;
+}
+
+/** @brief 小数倍・任意角: 倍精度で求めた最近傍と比べます。 */
+bool checkArbitrary(std::FILE* out, double scaleX, double scaleY, int angle)
+{
+    const std::uint32_t sw = 16, sh = 16, dw = 64, dh = 64;
+    const auto sprite = makeSprite(sw, sh, (std::uint32_t)angle + 100);
+    auto got = makeCanvas(dw, dh);
+    const double cx = 31.37, cy = 33.71;
+    SpriteXform xf;
+    sprite_xform_make(sw, sh, (std::int32_t)std::lround(cx * SPRITE_ONE), (std::int32_t)std::lround(cy * SPRITE_ONE),
+                      (std::int32_t)std::lround(scaleX * SPRITE_ONE), (std::int32_t)std::lround(scaleY * SPRITE_ONE), (std::uint8_t)angle, xf);
+    sprite_blit(got.data(), dw, dh, sprite.data(), sw, sh, xf, SPRITE_NEAREST, 0, true);
+
+    const double th = angle * 2.0 * M_PI / 256.0;
+    int bad = 0, edge = 0, covered = 0;
+    for (std::uint32_t y = 0; y < dh; y++) {
+        for (std::uint32_t x = 0; x < dw; x++) {
+            const double u = x + 0.5 - cx, v = y + 0.5 - cy;
+            const double sx = (std::cos(th) * u + std::sin(th) * v) / scaleX + sw / 2.0;
+            const double sy = (-std::sin(th) * u + std::cos(th) * v) / scaleY + sh / 2.0;
+            // 境界ちょうど（1/64 ピクセル以内）は固定小数点の丸めでどちらにもなりうる
+            const double ex = std::fabs(sx - std::floor(sx + 0.5)), ey = std::fabs(sy - std::floor(sy + 0.5));
+            if (ex < 1.0 / 64 || ey < 1.0 / 64) {
+                edge++;
+                continue;
+            }
+            std::uint32_t want = 0x030201u;
+            if (sx >= 0 && sy >= 0 && sx < sw && sy < sh) {
+                covered++;
+                const std::uint32_t c = sprite[(std::uint32_t)sy * sw + (std::uint32_t)sx];
+                if (c != 0) want = c;
+            }
+            if (got[y * dw + x] != want) bad++;
+        }
+    }
+    std::fprintf(out, "scale=%.2fx%.2f angle=%3d covered=%-4d boundary=%-3d %s\n", scaleX, scaleY, angle, covered, edge, bad ? "MISMATCH" : "ok");
+    return bad == 0;
+}
+
+/** @brief 双線形: 単色は単色のまま、等倍は元画像のまま（補間の重みが0）。 */
+bool checkBilinear(std::FILE* out)
+{
+    const std::uint32_t sw = 16, sh = 16, dw = 64, dh = 64;
+    std::vector<std::uint32_t> flat(sw * sh, 0x405060u);
+    auto got = makeCanvas(dw, dh);
+    SpriteXform xf;
+    sprite_xform_make(sw, sh, 32 * SPRITE_ONE, 32 * SPRITE_ONE, 3 * SPRITE_ONE + 12345, 3 * SPRITE_ONE, 37, xf);
+    const std::size_t written = sprite_blit(got.data(), dw, dh, flat.data(), sw, sh, xf, SPRITE_BILINEAR, 0, false);
+    std::size_t flatCount = 0;
+    for (std::uint32_t c : got) flatCount += c == 0x405060u;
+    bool ok = flatCount == written && written > 0;
+
+    const auto sprite = makeSprite(sw, sh, 21);
+    auto a = makeCanvas(dw, dh), b = makeCanvas(dw, dh);
+    const SpriteXform one = placeScaled(sw, sh, 7, 9, 1, 0);
+    sprite_blit(a.data(), dw, dh, sprite.data(), sw, sh, one, SPRITE_NEAREST, 0, true);
+    sprite_blit(b.data(), dw, dh, sprite.data(), sw, sh, one, SPRITE_BILINEAR, 0, true);
+    ok = ok && a == b;
+    std::fprintf(out, "bilinear flat=%zu/%zu identity=%s %s\n", flatCount, written, a == b ? "same" : "differs", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 変形描画の結果を基準画像と比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すればtrue
+ */
+bool runSpriteCheck(std::FILE* out)
+{
+    bool ok = checkDrawBuffer(out);
+    const std::int32_t pos[][2] = {{0, 0}, {5, 3}, {-7, -2}, {40, 30}};
+    for (std::int32_t k = 1; k <= 4; k++) {
+        for (const auto& p : pos) {
+            ok = checkScaled(out, k, p[0], p[1], 0, false) && ok;
+            ok = checkScaled(out, k, p[0], p[1], 0, true) && ok;
+            ok = checkScaled(out, k, p[0], p[1], 0x070000u, true) && ok;
+        }
+    }
+    ok = checkQuarterTurns(out) && ok;
+    const double scales[][2] = {{1.5, 1.5}, {2.75, 2.75}, {0.6, 0.6}, {3.3, 2.2}};
+    for (const auto& s : scales) {
+        for (int angle : {0, 13, 32, 64, 100, 200}) ok = checkArbitrary(out, s[0], s[1], angle) && ok;
+    }
+    ok = checkBilinear(out) && ok;
+    std::fprintf(out, "%s\n", ok ? "all ok" : "FAILED");
+    return ok;
+}
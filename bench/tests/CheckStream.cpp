@@ -0,0 +1,226 @@
+/**
+ * @file CheckStream.cpp
+ * @brief フラッシュ上のフィルム（FrameStream.h）の再生の確認
+ * @details
+ * - フラッシュの代わりに、フィルムを一時ファイルへ書き出し、読み取り専用でメモリへ割り付けたもの（mmap）を使います。
+ *   ホストの DMA の代わりは開始した時点でコピーを終えるので、先読みは常に間に合います（stats().waits は0）。
+ * - 確認: 歩行パターンをずらしながら並べた長いフィルム（16x16）と炎のフィルム（64x64）を、無圧縮とランレングスで2周再生し、
+ *   元のフレームとビット単位で比べます。
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "Checks.h"
+#include "Effects.h"
+#include "FrameRender.h"
+#include "FrameStream.h"
+#include "PatMario.h"
+#include "WS2812.h"
+
+namespace {
+
+/**
+ * @brief ファイルへ書き出し、読み取り専用でメモリへ割り付けたフィルム（フラッシュの代わり）。
+ * @details mmap のない環境では、書き出したファイルを読み戻したものを使います。
+ */
+class MappedFilm {
+public:
+    explicit MappedFilm(const std::vector<std::uint32_t>& words)
+        : bytes_(words.size() * sizeof(std::uint32_t))
+    {
+#if defined(_WIN32)
+        std::FILE* f = std::tmpfile();
+        if (f == nullptr) return;
+        copy_.resize(words.size());
+        const bool written = std::fwrite(words.data(), 1, bytes_, f) == bytes_;
+        std::rewind(f);
+        if (written && std::fread(copy_.data(), 1, bytes_, f) == bytes_) data_ = copy_.data();
+        std::fclose(f);
+#else
+        const char* dir = std::getenv("TMPDIR");
+        std::string path = std::string(dir && *dir ? dir : "/tmp") + "/lgmfilmXXXXXX";
+        const int fd = mkstemp(&path[0]);
+        if (fd < 0) return;
+        unlink(path.c_str()); // 割り付けを解けば消える
+        std::FILE* f = fdopen(fd, "wb");
+        const bool written = f != nullptr && std::fwrite(words.data(), 1, bytes_, f) == bytes_ && std::fflush(f) == 0;
+        if (written) {
+            void* p = mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) data_ = p;
+        }
+        if (f) {
+            std::fclose(f);
+        } else {
+            close(fd);
+        }
+#endif
+    }
+    ~MappedFilm()
+    {
+#if !defined(_WIN32)
+        if (data_) munmap(data_, bytes_);
+#endif
+    }
+    MappedFilm(const MappedFilm&) = delete;
+    MappedFilm& operator=(const MappedFilm&) = delete;
+
+    /** @brief 先頭（割り付けられなければ nullptr）。 */
+    const void* data() const { return data_; }
+    /** @brief 大きさ（バイト）。 */
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    void* data_ { nullptr };
+    std::size_t bytes_ { 0 };
+#if defined(_WIN32)
+    std::vector<std::uint32_t> copy_;
+#endif
+};
+
+/** @brief フレームの列からフィルムを作ります。 */
+std::vector<std::uint32_t> buildFilm(const std::vector<std::uint32_t>& frames, std::size_t count, std::uint16_t w, std::uint16_t h,
+                                     FILM_CODEC codec)
+{
+    std::vector<std::uint32_t> film(film_build(frames.data(), count, w, h, codec, nullptr, 0));
+    film_build(frames.data(), count, w, h, codec, film.data(), film.size());
+    return film;
+}
+
+/** @brief 歩行パターン（16x16）を、一周ごとに1ピクセルずつ横へずらしながら count フレーム並べます。 */
+std::vector<std::uint32_t> walkFrames(std::size_t count)
+{
+    std::vector<std::uint32_t> frames(count * 256);
+    for (std::size_t f = 0; f < count; f++) {
+        const std::uint32_t* src = MRORunBaked + (f % MROPatCount) * 256;
+        const std::size_t shift = (f / MROPatCount) % 16;
+        std::uint32_t* dst = &frames[f * 256];
+        for (std::size_t y = 0; y < 16; y++) {
+            for (std::size_t x = 0; x < 16; x++) dst[y * 16 + x] = src[y * 16 + (x + shift) % 16];
+        }
+    }
+    return frames;
+}
+
+/** @brief 炎のエフェクトを count フレーム焼き込みます（16ms 間隔）。 */
+std::vector<std::uint32_t> fireFrames(std::uint16_t w, std::uint16_t h, std::size_t count)
+{
+    const std::size_t n = (std::size_t)w * h;
+    std::vector<std::uint32_t> frames(count * n);
+    EffectEngine fx;
+    fx.begin(w, h);
+    fx.select(EFFECT_FIRE);
+    for (std::size_t f = 0; f < count; f++) fx.render(&frames[f * n], (std::uint32_t)(f * 16));
+    return frames;
+}
+
+/**
+ * @brief フィルムを2周再生し、途中へ飛んだ場合も含めて元のフレームと比べます。
+ * @param out 出力先
+ * @param name 名前
+ * @param frames 元のフレーム
+ * @param count フレーム数
+ * @param w 幅
+ * @param h 高さ
+ * @param codec 圧縮形式
+ * @return 一致し、先読みの統計が期待どおりなら true
+ */
+bool checkFilm(std::FILE* out, const char* name, const std::vector<std::uint32_t>& frames, std::size_t count, std::uint16_t w,
+               std::uint16_t h, FILM_CODEC codec)
+{
+    const std::size_t n = (std::size_t)w * h;
+    const std::vector<std::uint32_t> film = buildFilm(frames, count, w, h, codec);
+    MappedFilm flash(film);
+    if (flash.data() == nullptr) {
+        std::fprintf(out, "%s %s: cannot map the film\n", name, codec == FILM_RLE ? "rle" : "raw");
+        return false;
+    }
+    FilmHeader hdr;
+    std::memcpy(&hdr, flash.data(), sizeof(hdr));
+    std::vector<std::uint32_t> ring(FrameStream::ringWords(hdr));
+    FrameStream fs;
+    bool ok = fs.open(flash.data(), flash.bytes(), ring.data(), ring.size()) && fs.slots() == FRAME_STREAM_SLOTS;
+
+    std::size_t diff = 0;
+    for (std::size_t i = 0; ok && i < 2 * count; i++) {
+        const std::uint32_t* p = fs.frame(i);
+        diff += p == nullptr || std::memcmp(p, &frames[(i % count) * n], n * sizeof(std::uint32_t)) != 0;
+    }
+    const FrameStreamStats seq = fs.stats();
+    // 途中へ飛ぶ: 飛んだ先だけをその場で読み、続きは先読みされている
+    const std::size_t seek = count / 2 + 1;
+    for (std::size_t i = seek; ok && i < seek + 4; i++) {
+        const std::uint32_t* p = fs.frame(i);
+        diff += p == nullptr || std::memcmp(p, &frames[(i % count) * n], n * sizeof(std::uint32_t)) != 0;
+    }
+    const bool seekOk = fs.stats().misses == seq.misses + 1;
+    ok = ok && diff == 0 && seq.misses == 1 && seq.hits == 2 * count - 1 && seekOk;
+    // リングはフレーム数によらず、段数分（RLE は展開先の1フレームを足す）を超えない
+    ok = ring.size() <= (FRAME_STREAM_SLOTS + 1) * n && ok;
+    std::fprintf(out, "%s %s %ux%u: %zu frames x2, film %zu words (%.2fx raw), ring %zu words, %u hits / %u misses / %u waits, "
+                 "%llu words read, seek %s, %zu differing frames %s\n",
+                 name, codec == FILM_RLE ? "rle" : "raw", (unsigned)w, (unsigned)h, count, film.size(),
+                 (double)film.size() / (double)(count * n), ring.size(), (unsigned)seq.hits, (unsigned)seq.misses, (unsigned)seq.waits,
+                 (unsigned long long)seq.wordsRead, seekOk ? "ok" : "MISMATCH", diff, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief フィルムを再生し、元のフレームと一致するかを確かめます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runStreamCheck(std::FILE* out)
+{
+    bool ok = true;
+    const std::size_t walkCount = 2400;
+    const std::vector<std::uint32_t> walk = walkFrames(walkCount);
+    const std::size_t fireCount = 240;
+    const std::vector<std::uint32_t> fire = fireFrames(64, 64, fireCount);
+    for (FILM_CODEC codec : {FILM_RAW, FILM_RLE}) {
+        ok = checkFilm(out, "walk", walk, walkCount, 16, 16, codec) && ok;
+        ok = checkFilm(out, "fire", fire, fireCount, 64, 64, codec) && ok;
+    }
+
+    // 壊れたフィルムは開かない
+    {
+        std::vector<std::uint32_t> ring(FRAME_STREAM_SLOTS * 256 + 256);
+        FrameStream fs;
+        std::vector<std::uint32_t> bad = buildFilm(walk, 8, 16, 16, FILM_RAW);
+        bad[0] ^= 1; // magic
+        bool rejected = !fs.open(bad.data(), bad.size() * sizeof(std::uint32_t), ring.data(), ring.size());
+        bad = buildFilm(walk, 8, 16, 16, FILM_RAW);
+        rejected = !fs.open(bad.data(), (bad.size() - 1) * sizeof(std::uint32_t), ring.data(), ring.size()) && rejected; // 短い
+        bad = buildFilm(walk, 8, 16, 16, FILM_RLE);
+        bad[sizeof(FilmHeader) / sizeof(std::uint32_t) + 3] = 0xFFFFFFu; // 表
+        rejected = !fs.open(bad.data(), bad.size() * sizeof(std::uint32_t), ring.data(), ring.size()) && rejected;
+        bad = buildFilm(walk, 8, 16, 16, FILM_RAW);
+        rejected = !fs.open(bad.data(), bad.size() * sizeof(std::uint32_t), ring.data(), 256) && rejected; // リングが1段
+        ok = rejected && !fs.isOpen() && ok;
+        std::fprintf(out, "corrupt header/table, short film, 1-slot ring: %s\n", rejected ? "rejected ok" : "MISMATCH");
+    }
+
+    // 焼き込み済みのパターン（ヘッダなし）をそのまま再生し、drawFilmFrame() で VRAM へ描く
+    {
+        std::vector<std::uint32_t> ring(FRAME_STREAM_SLOTS * 256);
+        FrameStream fs;
+        bool same = fs.openRaw(MRORunBaked, MROPatCount, 16, 16, ring.data(), ring.size());
+        std::unique_ptr<WS2812> led(new WS2812(22, 16, 16));
+        for (std::size_t i = 0; same && i < 2 * MROPatCount; i++) {
+            same = drawFilmFrame(*led, fs, i) &&
+                   std::memcmp(led->pVRam, MRORunBaked + (i % MROPatCount) * 256, 256 * sizeof(std::uint32_t)) == 0;
+        }
+        same = same && fs.stats().misses == 1;
+        ok = same && ok;
+        std::fprintf(out, "openRaw(MRORunBaked, %zu frames) via drawFilmFrame x2: %s\n", MROPatCount, same ? "ok" : "MISMATCH");
+    }
+    return ok;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file CheckTileMap.cpp
+ * @brief タイルマップ（TileMap.h）の描画の確認
+ * @details
+ * - 確認: 8x8/4bpp（パレット3個）と 16x16/8bpp のタイルセットに、反転・範囲外のタイル番号/パレット番号を含むマップで、
+ *   いろいろな描画先の大きさ・スクロール位置（負、マップより大きい値）・重ね描き・行を分けた描画を基準画像と比べます。
+ *   決まった街並みの画像から tilemap_build() でタイルマップを作り、元の画像に戻ること、描画結果のハッシュが固定値と一致することも確かめます。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "PatMario.h"
+#include "TileMap.h"
+#include "WS2812.h"
+
+namespace {
+
+/** @brief タイルセットとマップ（とその中身）。 */
+struct TileFixture {
+    std::vector<std::uint8_t> pixels;
+    std::vector<std::uint32_t> palette;
+    std::vector<std::uint16_t> cells;
+    TileSet ts {};
+    TileMap map {};
+};
+
+/**
+ * @brief 乱数でタイルセットとマップを作ります。
+ * @param tileSize タイルの一辺
+ * @param bpp 4 または 8
+ * @param tileCount タイル数
+ * @param paletteCount パレット数（4bpp）
+ * @param mapW 横のマス数
+ * @param mapH 縦のマス数
+ * @param invalid 範囲外のタイル番号/パレット番号も使う
+ * @param seed 乱数の種
+ */
+std::unique_ptr<TileFixture> makeFixture(std::uint8_t tileSize, std::uint8_t bpp, std::uint16_t tileCount, std::uint8_t paletteCount,
+                                         std::uint16_t mapW, std::uint16_t mapH, bool invalid, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::unique_ptr<TileFixture> f(new TileFixture);
+    f->pixels.resize((std::size_t)tileCount * tileSize * tileSize * bpp / 8);
+    for (auto& b : f->pixels) b = (std::uint8_t)rng();
+    f->palette.resize(bpp == 4 ? (std::size_t)paletteCount * 16 : 256);
+    for (auto& c : f->palette) c = rng() & 0xFFFFFFu;
+    f->cells.resize((std::size_t)mapW * mapH);
+    for (auto& c : f->cells) {
+        const std::uint32_t tile = rng() % (tileCount + (invalid ? 3u : 0u));
+        const std::uint32_t pal = rng() % (paletteCount + (invalid ? 1u : 0u));
+        c = TILE_CELL(tile, pal, rng() & (TILE_HFLIP | TILE_VFLIP));
+    }
+    f->ts = {f->pixels.data(), f->palette.data(), tileCount, tileSize, bpp, paletteCount};
+    f->map = {f->cells.data(), mapW, mapH};
+    return f;
+}
+
+/**
+ * @brief 基準: マップのピクセル (mx, my) の色。
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @param mx マップのX（0..幅-1）
+ * @param my マップのY
+ * @param opaque [out] 番号が0でなければ true
+ */
+std::uint32_t refPixel(const TileSet& ts, const TileMap& map, std::uint32_t mx, std::uint32_t my, bool& opaque)
+{
+    const std::uint32_t size = ts.tileSize;
+    const std::uint16_t cell = map.cells[(my / size) * map.width + mx / size];
+    std::uint32_t fx = mx % size, fy = my % size;
+    if (cell & TILE_HFLIP) fx = size - 1 - fx;
+    if (cell & TILE_VFLIP) fy = size - 1 - fy;
+    const std::uint32_t tile = cell & TILE_INDEX_MASK;
+    std::uint32_t idx = 0;
+    if (tile < ts.tileCount) {
+        const std::size_t bit = ((std::size_t)tile * size * size + fy * size + fx) * ts.bitsPerPixel;
+        idx = ts.bitsPerPixel == 8 ? ts.pixels[bit / 8] : (ts.pixels[bit / 8] >> (bit % 8)) & 15u;
+    }
+    std::uint32_t pal = 0;
+    if (ts.bitsPerPixel == 4) {
+        pal = (cell >> TILE_PALETTE_SHIFT) & 15u;
+        if (pal >= ts.paletteCount) pal = 0;
+    }
+    opaque = idx != 0;
+    return ts.palette[pal * 16 + idx];
+}
+
+/** @brief 負の数も 0..m-1 に入れる剰余。 */
+std::int64_t wrapMod(std::int64_t v, std::int64_t m) { return ((v % m) + m) % m; }
+
+/**
+ * @brief 1つのタイルセットとマップを、描画先の大きさ・スクロール位置・重ね描き・行の分け方を変えて基準と比べます。
+ * @param out 出力先
+ * @param name 名前
+ * @param ts タイルセット
+ * @param map タイルマップ
+ * @return すべて一致すれば true
+ */
+bool checkFixture(std::FILE* out, const char* name, const TileSet& ts, const TileMap& map)
+{
+    // 基準画像: マップ全体を1ピクセルずつ展開
+    const std::uint32_t mapW = (std::uint32_t)map.width * ts.tileSize, mapH = (std::uint32_t)map.height * ts.tileSize;
+    std::vector<std::uint32_t> color((std::size_t)mapW * mapH);
+    std::vector<bool> opaque(color.size());
+    for (std::uint32_t y = 0; y < mapH; y++) {
+        for (std::uint32_t x = 0; x < mapW; x++) {
+            bool o;
+            color[(std::size_t)y * mapW + x] = refPixel(ts, map, x, y, o);
+            opaque[(std::size_t)y * mapW + x] = o;
+        }
+    }
+
+    static const std::uint32_t kSizes[][2] = {{40, 24}, {128, 64}, {7, 5}, {300, 20}};
+    static const std::int32_t kScrolls[][2] = {{0, 0}, {5, 3}, {-13, -7}, {1000, -999}, {INT32_MIN, INT32_MAX}};
+    const std::uint32_t background = 0x123456;
+    int cases = 0, failed = 0;
+    for (const auto& sz : kSizes) {
+        const std::uint32_t w = sz[0], h = sz[1];
+        for (const auto& sc : kScrolls) {
+            for (int overlay = 0; overlay < 2; overlay++) {
+                std::vector<std::uint32_t> expect((std::size_t)w * h);
+                for (std::uint32_t y = 0; y < h; y++) {
+                    const std::size_t my = (std::size_t)wrapMod((std::int64_t)sc[1] + y, mapH);
+                    for (std::uint32_t x = 0; x < w; x++) {
+                        const std::size_t i = my * mapW + (std::size_t)wrapMod((std::int64_t)sc[0] + x, mapW);
+                        expect[(std::size_t)y * w + x] = (overlay && !opaque[i]) ? background : color[i];
+                    }
+                }
+                // 一度に描く
+                std::vector<std::uint32_t> dst((std::size_t)w * h, background);
+                const std::size_t n = tilemap_draw(dst.data(), w, h, ts, map, sc[0], sc[1], overlay != 0);
+                // 5行ずつ分けて描く
+                std::vector<std::uint32_t> banded((std::size_t)w * h, background);
+                for (std::uint32_t y = 0; y < h; y += 5) tilemap_draw(banded.data(), w, h, ts, map, sc[0], sc[1], overlay != 0, y, 5);
+                cases++;
+                if (dst != expect || banded != expect || n != (std::size_t)w * h) {
+                    failed++;
+                    std::fprintf(out, "  %ux%u scroll (%d,%d)%s MISMATCH\n", (unsigned)w, (unsigned)h, (int)sc[0], (int)sc[1],
+                                 overlay ? " overlay" : "");
+                }
+            }
+        }
+    }
+    std::fprintf(out, "%-40s %3d cases %s\n", name, cases, failed == 0 ? "ok" : "MISMATCH");
+    return failed == 0;
+}
+
+/**
+ * @brief LedCanvas::DrawTileMap が tilemap_draw と同じ結果になるかを確かめます。
+ * @param out 出力先
+ * @param f タイルセットとマップ
+ * @return 一致すれば true
+ */
+bool checkCanvas(std::FILE* out, const TileFixture& f)
+{
+    std::unique_ptr<WS2812> led(new WS2812(22, 16, 16, 4, 2));
+    const std::size_t n = (std::size_t)led->xVRam * led->yVRam;
+    led->Clear(0x010203);
+    led->DrawTileMap(f.ts, f.map, -21, 77, true);
+    std::vector<std::uint32_t> expect(n, 0x010203);
+    tilemap_draw(expect.data(), led->xVRam, led->yVRam, f.ts, f.map, -21, 77, true);
+    const bool same = std::equal(expect.begin(), expect.end(), led->pVRam);
+    std::fprintf(out, "%-40s %s\n", "LedCanvas::DrawTileMap on 64x32", same ? "ok" : "MISMATCH");
+    return same;
+}
+
+/** @brief 0x00GGRRBB の色。 */
+constexpr std::uint32_t grb(std::uint32_t r, std::uint32_t g, std::uint32_t b) { return (g << 16) | (r << 8) | b; }
+
+/**
+ * @brief 決まった街並みの画像（256x64: 空、ビルと窓、歩道のれんが、道路と車線、左右反転を含むキャラクタ）。
+ */
+std::vector<std::uint32_t> makeStreet()
+{
+    const std::uint32_t W = 256, H = 64;
+    std::vector<std::uint32_t> img((std::size_t)W * H);
+    for (std::uint32_t y = 0; y < H; y++) {
+        for (std::uint32_t x = 0; x < W; x++) {
+            std::uint32_t c;
+            const std::uint32_t b = x / 32;
+            const std::uint32_t top = 16 + 8 * ((b * 5) % 3);
+            if (y < 40 && y >= top) {
+                const bool window = (x % 8) >= 2 && (x % 8) < 6 && (y % 8) >= 2 && (y % 8) < 6;
+                if (window) c = ((x / 8 + y / 8 + b) % 3 != 0) ? grb(40, 36, 8) : grb(4, 4, 8);
+                else c = (b % 3 == 0) ? grb(20, 10, 8) : (b % 3 == 1 ? grb(12, 12, 14) : grb(18, 16, 10));
+            } else if (y < 40) {
+                c = y < 8 ? grb(2, 4, 20) : grb(4, 8, 28);
+            } else if (y < 48) {
+                const bool mortar = (y % 4) == 0 || ((x + ((y / 4) % 2) * 4) % 8) == 0;
+                c = mortar ? grb(10, 10, 10) : grb(24, 12, 8);
+            } else if (y == 48) {
+                c = grb(20, 20, 20);
+            } else {
+                c = (y >= 55 && y < 57 && (x % 32) < 16) ? grb(40, 40, 40) : grb(6, 6, 6);
+            }
+            img[(std::size_t)y * W + x] = c;
+        }
+    }
+    // 空のキャラクタ（右向きと、左右反転した左向き）
+    for (std::uint32_t y = 0; y < 16; y++) {
+        for (std::uint32_t x = 0; x < 16; x++) {
+            const std::uint32_t c = MRORunBaked[y * 16 + x];
+            if (c == 0) continue;
+            img[(std::size_t)y * W + 40 + x] = c;
+            img[(std::size_t)y * W + 168 + 15 - x] = c;
+        }
+    }
+    return img;
+}
+
+/** @brief 街並みを 128x64 へスクロール (37,-5) で描いた結果のハッシュ（描画の仕様を変えたら更新する）。 */
+constexpr std::uint32_t kStreetHash = 0x643ffde6u;
+
+/** @brief FNV-1a（32bit）。 */
+std::uint32_t fnv1a(const std::vector<std::uint32_t>& v)
+{
+    std::uint32_t h = 2166136261u;
+    for (std::uint32_t px : v) {
+        for (int k = 0; k < 4; k++) {
+            h ^= (px >> (8 * k)) & 0xFFu;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+/**
+ * @brief 街並みの画像からタイルマップを作り、元の画像に戻るか・決まった描画結果になるかを確かめます。
+ * @param out 出力先
+ * @param tileSize タイルの一辺
+ * @param golden 128x64 へスクロール (37,-5) で描いた結果のハッシュ
+ * @return 一致すれば true
+ */
+bool checkStreet(std::FILE* out, std::uint8_t tileSize, std::uint32_t golden)
+{
+    const std::uint32_t W = 256, H = 64;
+    const std::vector<std::uint32_t> img = makeStreet();
+    const std::size_t maxTiles = (W / tileSize) * (H / tileSize);
+    std::vector<std::uint8_t> pixels(maxTiles * tileSize * tileSize);
+    std::vector<std::uint32_t> palette(256);
+    std::vector<std::uint16_t> cells(maxTiles);
+    TileSet ts {};
+    TileMap map {};
+    if (!tilemap_build(img.data(), W, H, tileSize, pixels.data(), maxTiles, palette.data(), cells.data(), ts, map)) {
+        std::fprintf(out, "street %ux%u tiles: tilemap_build failed MISMATCH\n", (unsigned)tileSize, (unsigned)tileSize);
+        return false;
+    }
+    std::size_t flipped = 0;
+    for (std::uint16_t c : cells) flipped += (c & (TILE_HFLIP | TILE_VFLIP)) != 0;
+
+    // 元の画像に戻る
+    std::vector<std::uint32_t> full((std::size_t)W * H);
+    tilemap_draw(full.data(), W, H, ts, map, 0, 0, false);
+    const bool roundTrip = full == img;
+    // 一周させたスクロール
+    std::vector<std::uint32_t> view(128 * 64);
+    tilemap_draw(view.data(), 128, 64, ts, map, 37, -5, false);
+    bool wrapped = true;
+    for (std::uint32_t y = 0; y < 64; y++)
+        for (std::uint32_t x = 0; x < 128; x++)
+            wrapped = wrapped && view[y * 128 + x] == img[(std::size_t)wrapMod((std::int64_t)y - 5, H) * W + (x + 37) % W];
+    const std::uint32_t hash = fnv1a(view);
+
+    const std::size_t colors = 1 + (std::size_t)std::count_if(palette.begin() + 1, palette.end(), [](std::uint32_t c) { return c != 0; });
+    const std::size_t frameBytes = (std::size_t)W * H * sizeof(std::uint32_t);
+    const std::size_t bytes = tilemap_bytes(ts, map);
+    std::fprintf(out, "street %ux%u tiles: %u tiles (%zu cells flipped), %zu colors, %zu bytes vs %zu full-frame (%.1f%%)\n",
+                 (unsigned)tileSize, (unsigned)tileSize, (unsigned)ts.tileCount, flipped, colors, bytes, frameBytes,
+                 100.0 * (double)bytes / (double)frameBytes);
+    std::fprintf(out, "  round trip %s, scroll (37,-5) on 128x64 %s, hash %08x %s\n", roundTrip ? "ok" : "MISMATCH",
+                 wrapped ? "ok" : "MISMATCH", (unsigned)hash, hash == golden ? "ok" : "MISMATCH");
+    return roundTrip && wrapped && hash == golden;
+}
+
+} // namespace
+
+/**
+ * @brief タイルマップの描画を基準画像と比べます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runTileMapCheck(std::FILE* out)
+{
+    const auto f8 = makeFixture(8, 4, 24, 3, 13, 7, true, 1);
+    const auto f16 = makeFixture(16, 8, 20, 1, 5, 3, true, 2);
+    bool ok = checkFixture(out, "8x8 4bpp, 3 palettes, 13x7 cells", f8->ts, f8->map);
+    ok = checkFixture(out, "16x16 8bpp, 5x3 cells", f16->ts, f16->map) && ok;
+    ok = checkCanvas(out, *f8) && ok;
+    ok = checkStreet(out, 8, kStreetHash) && ok;
+    ok = checkStreet(out, 16, kStreetHash) && ok;
+    std::fprintf(out, "tile map rendering matches the reference images: %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file CheckTiming.cpp
+ * @brief WS2812 のビットタイミング（WS2812Timing.h）の確認
+ * @details 許容範囲は readme の表（HIGH/LOW はそれぞれ ±150ns、1bit は 1.25µs±600ns）です。
+ */
+#include <cstdint>
+#include "Checks.h"
+#include "hardware/clocks.h"
+#include "WS2812.h"
+#include "WS2812Timing.h"
+#include "ws2812.pio.h"
+
+namespace {
+
+/** @brief 区間の名前と許容範囲(ns)。 */
+struct Window {
+    const char* name;
+    std::uint32_t minNs;
+    std::uint32_t maxNs;
+};
+
+const Window kT0H { "T0H", 400 - 150, 400 + 150 };
+const Window kT1H { "T1H", 800 - 150, 800 + 150 };
+const Window kT0L { "T0L", 850 - 150, 850 + 150 };
+const Window kT1L { "T1L", 450 - 150, 450 + 150 };
+const Window kBit { "bit", 1250 - 600, 1250 + 600 };
+
+/**
+ * @brief 区間が揺らぎを含めて許容範囲に収まるかを出力します。
+ * @param out 出力先
+ * @param w 許容範囲
+ * @param ns 区間の平均(ns)
+ * @param jitterNs 揺らぎ(ns)
+ * @return 収まれば true
+ */
+bool inWindow(std::FILE* out, const Window& w, std::uint32_t ns, std::uint32_t jitterNs)
+{
+    const std::uint32_t lo = ns - jitterNs, hi = ns + jitterNs;
+    const bool ok = lo >= w.minNs && hi <= w.maxNs;
+    std::fprintf(out, " %s %u..%u%s", w.name, (unsigned)lo, (unsigned)hi, ok ? "" : "(!)");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief clk_sys ごとのビットタイミングを確かめて出力します。
+ * @param out 出力先
+ * @return すべて許容範囲なら true
+ */
+bool runTimingCheck(std::FILE* out)
+{
+    struct Clock {
+        const char* name;
+        std::uint32_t hz;
+    };
+    static const Clock kClocks[] = {
+        {"150 MHz", 150000000u},
+        {"48 MHz", 48000000u},
+        {"XOSC 12 MHz", 12000000u},
+    };
+    bool ok = true;
+    std::fprintf(out, "program: T1=%d T2=%d T3=%d cycles\n", ws2812_T1, ws2812_T2, ws2812_T3);
+    for (const Clock& c : kClocks) {
+        WS2812Timing t;
+        bool fits = ws2812_calc_timing(c.hz, 800000u, WS2812_CYCLES_PER_BIT, ws2812_T1, ws2812_T2, t);
+        fits = t.errorPpm <= WS2812_MAX_ERROR_PPM && t.errorPpm >= -WS2812_MAX_ERROR_PPM && fits;
+        std::fprintf(out, "%-11s div %u+%u/256 (%d ppm) ns:", c.name, (unsigned)t.divInt, (unsigned)t.divFrac, (int)t.errorPpm);
+        fits = inWindow(out, kT0H, t.t0HighNs, t.jitterNs) && fits;
+        fits = inWindow(out, kT1H, t.t1HighNs, t.jitterNs) && fits;
+        fits = inWindow(out, kT0L, t.bitNs - t.t0HighNs, t.jitterNs) && fits;
+        fits = inWindow(out, kT1L, t.bitNs - t.t1HighNs, t.jitterNs) && fits;
+        fits = inWindow(out, kBit, t.bitNs, t.jitterNs) && fits;
+        std::fprintf(out, " %s\n", fits ? "ok" : "OUT OF TOLERANCE");
+        ok = fits && ok;
+    }
+
+    // 分周器の範囲外の clk_sys（1bit 10サイクルに足りない 6MHz）: UpdateClock()/Resume() は最後に求めた分周のまま
+    {
+        WS2812 led(0, 16, 16);
+        const WS2812Timing good = led.GetTiming();
+        set_sys_clock_khz(6000u, true);
+        const bool updated = led.UpdateClock();
+        const bool keptUpdate = led.GetTiming().divInt == good.divInt && led.GetTiming().divFrac == good.divFrac && led.GetTiming().sysHz == good.sysHz;
+        led.Suspend();
+        const bool resumed = led.Resume();
+        const bool keptResume = led.GetTiming().divInt == good.divInt && led.GetTiming().divFrac == good.divFrac && led.GetTiming().sysHz == good.sysHz;
+        set_sys_clock_khz(good.sysHz / 1000u, true);
+        const bool restored = led.UpdateClock() && led.GetTiming().divInt == good.divInt;
+        const bool fallback = !updated && keptUpdate && !resumed && keptResume && restored;
+        std::fprintf(out, "6 MHz       out of range: UpdateClock %s, Resume %s, kept div %u+%u/256 %s\n", updated ? "true" : "false",
+                     resumed ? "true" : "false", (unsigned)led.GetTiming().divInt, (unsigned)led.GetTiming().divFrac, fallback ? "ok" : "FAILED");
+        ok = fallback && ok;
+    }
+    return ok;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file CheckWireCache.cpp
+ * @brief 送出データキャッシュ（WireCache.h と WS2812::ShowCached/ScanBufferCached）の確認
+ * @details
+ * - 期待値は手順ごとに表で与えます（LRU の模擬から求めるのではなく、追い出す順を書き下したもの）。
+ * - WS2812 の手順は FrameRender.cpp の drawRunFrame と同じく、ShowCached() で見つからなければ描画して ScanBufferCached() します。
+ */
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "Checks.h"
+#include "FrameRender.h"
+#include "HostShims.h"
+#include "PatMario.h"
+#include "WS2812.h"
+#include "WireCache.h"
+
+namespace {
+
+/** @brief 統計の期待値。 */
+struct StatsExpect {
+    std::uint32_t hits;
+    std::uint32_t misses;
+    std::uint32_t evictions;
+    std::uint32_t entries;
+};
+
+/**
+ * @brief 統計を期待値と比べて1行出力します。
+ * @param frameBytes 1フレームのバイト数（保持しているバイト数は entries * frameBytes）
+ * @return 一致すれば true
+ */
+bool reportStats(std::FILE* out, const char* name, const WireCacheStats& s, const StatsExpect& e, std::size_t frameBytes, bool extra)
+{
+    const bool ok = extra && s.hits == e.hits && s.misses == e.misses && s.evictions == e.evictions && s.entries == e.entries &&
+                    s.usedBytes == e.entries * frameBytes;
+    std::fprintf(out, "  %-30s hits %2u misses %2u evictions %2u resident %2u frames %6zu bytes %s\n", name, (unsigned)s.hits,
+                 (unsigned)s.misses, (unsigned)s.evictions, (unsigned)s.entries, s.usedBytes, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/**
+ * @brief WireCache 単体の手順。
+ * @return すべて一致すれば true
+ */
+bool checkCache(std::FILE* out)
+{
+    std::fprintf(out, "WireCache (64-word frames, budget 4 frames):\n");
+    constexpr std::size_t kWords = 64, kBytes = kWords * sizeof(std::uint32_t);
+    WireCache c(4 * kBytes);
+    std::size_t words = 0;
+    bool ok = true;
+
+    bool step = c.Find(1, 0, words) == nullptr && words == 0;
+    ok = reportStats(out, "find 1 (empty)", c.Stats(), {0, 1, 0, 0}, kBytes, step) && ok;
+    std::uint32_t* p = c.Insert(1, 0, kWords);
+    step = p != nullptr;
+    if (p) p[0] = 0x11;
+    ok = reportStats(out, "insert 1", c.Stats(), {0, 1, 0, 1}, kBytes, step) && ok;
+    const std::uint32_t* f = c.Find(1, 0, words);
+    step = f != nullptr && words == kWords && f[0] == 0x11;
+    ok = reportStats(out, "find 1", c.Stats(), {1, 1, 0, 1}, kBytes, step) && ok;
+    // 同じキーでも走査方法（タグ）が違えば別のフレーム
+    step = c.Find(1, 1, words) == nullptr;
+    ok = reportStats(out, "find 1 with another tag", c.Stats(), {1, 2, 0, 1}, kBytes, step) && ok;
+    step = c.Insert(1, 1, kWords) != nullptr;
+    ok = reportStats(out, "insert 1 with another tag", c.Stats(), {1, 2, 0, 2}, kBytes, step) && ok;
+    // 同じキーとタグは置き換え（追い出しには数えない）
+    p = c.Insert(1, 0, kWords);
+    step = p != nullptr;
+    if (p) p[0] = 0x22;
+    f = c.Find(1, 0, words);
+    step = step && f != nullptr && f[0] == 0x22;
+    ok = reportStats(out, "replace 1 + find", c.Stats(), {2, 2, 0, 2}, kBytes, step) && ok;
+    // 上限を超える1フレームは登録せず、保持しているフレームも解放しない
+    step = c.Insert(9, 0, 5 * kWords) == nullptr;
+    ok = reportStats(out, "insert larger than budget", c.Stats(), {2, 2, 0, 2}, kBytes, step) && ok;
+    c.Clear();
+    ok = reportStats(out, "clear", c.Stats(), {2, 2, 0, 0}, kBytes, true) && ok;
+
+    // フレーム数の上限: バイト数に余裕があっても33個目で最も古いものを追い出す
+    WireCache many(1024 * kBytes);
+    step = true;
+    for (std::uint32_t k = 0; k <= WIRECACHE_MAX_ENTRIES; k++) step = many.Insert(100 + k, 0, kWords) != nullptr && step;
+    step = many.Find(100, 0, words) == nullptr && many.Find(101, 0, words) != nullptr && step;
+    char name[48];
+    std::snprintf(name, sizeof(name), "%u frames into %u slots", (unsigned)(WIRECACHE_MAX_ENTRIES + 1), (unsigned)WIRECACHE_MAX_ENTRIES);
+    ok = reportStats(out, name, many.Stats(), {1, 1, 1, WIRECACHE_MAX_ENTRIES}, kBytes, step) && ok;
+    ok = many.Stats().peakBytes == WIRECACHE_MAX_ENTRIES * kBytes && ok;
+    return ok;
+}
+
+/** @brief WS2812 で表示するフレーム。 */
+enum Frame { FRAME_STOP, FRAME_WALK0, FRAME_WALK1, FRAME_WALK2 };
+
+/** @brief WS2812 の1手順。 */
+struct DriverStep {
+    const char* name;
+    char op;         ///< 'S' = 表示、'B' = 上限の変更、'C' = ClearWireCache
+    int frame;       ///< 表示するフレーム（'S'）
+    int budget;      ///< 上限（フレーム数、'B'。負なら512バイト = 1フレーム未満）
+    bool hit;        ///< ShowCached() で見つかる（'S'）
+    StatsExpect expect;
+};
+
+/**
+ * @brief 停止表示と歩行のフレームの列（上限3フレーム）。
+ * @details 2周目の歩行はすべてヒットします。停止表示を挟むと、4フレームを3フレームの LRU で回すことになり、歩行の1周はすべてミスします。
+ */
+const DriverStep kDriverSteps[] = {
+    {"stop", 'S', FRAME_STOP, 0, false, {0, 1, 0, 1}},
+    {"stop again", 'S', FRAME_STOP, 0, true, {1, 1, 0, 1}},
+    {"walk 0", 'S', FRAME_WALK0, 0, false, {1, 2, 0, 2}},
+    {"walk 1", 'S', FRAME_WALK1, 0, false, {1, 3, 0, 3}},
+    {"walk 2 (evicts stop)", 'S', FRAME_WALK2, 0, false, {1, 4, 1, 3}},
+    {"walk 0 (lap 2)", 'S', FRAME_WALK0, 0, true, {2, 4, 1, 3}},
+    {"walk 1 (lap 2)", 'S', FRAME_WALK1, 0, true, {3, 4, 1, 3}},
+    {"walk 2 (lap 2)", 'S', FRAME_WALK2, 0, true, {4, 4, 1, 3}},
+    {"stop (evicts walk 0)", 'S', FRAME_STOP, 0, false, {4, 5, 2, 3}},
+    {"walk 0 (evicts walk 1)", 'S', FRAME_WALK0, 0, false, {4, 6, 3, 3}},
+    {"walk 1 (evicts walk 2)", 'S', FRAME_WALK1, 0, false, {4, 7, 4, 3}},
+    {"walk 2 (evicts stop)", 'S', FRAME_WALK2, 0, false, {4, 8, 5, 3}},
+    {"budget 1 frame", 'B', 0, 1, false, {4, 8, 7, 1}},
+    {"walk 2", 'S', FRAME_WALK2, 0, true, {5, 8, 7, 1}},
+    {"walk 0 (evicts walk 2)", 'S', FRAME_WALK0, 0, false, {5, 9, 8, 1}},
+    {"clear", 'C', 0, 0, false, {5, 9, 8, 0}},
+    {"budget 512 bytes", 'B', 0, -1, false, {5, 9, 8, 0}},
+    {"walk 1 (not stored)", 'S', FRAME_WALK1, 0, false, {5, 10, 8, 0}},
+    {"walk 1 again", 'S', FRAME_WALK1, 0, false, {5, 11, 8, 0}},
+};
+
+/** @brief フレームを VRAM へ描画します。 */
+void drawFrame(WS2812& led, int frame)
+{
+    led.Clear(0);
+    const std::uint32_t* buf = frame == FRAME_STOP ? MROStayBaked : MRORunBaked + (std::size_t)(frame - FRAME_WALK0) * 256;
+    led.DrawBuffer(buf, 16, 16, 0, 0, 0, false);
+}
+
+/**
+ * @brief WS2812 の手順。
+ * @return すべて一致すれば true
+ */
+bool checkDriver(std::FILE* out)
+{
+    WS2812 led(22, 16, 16);
+    const std::size_t frameBytes = (std::size_t)16 * 16 * sizeof(std::uint32_t);
+    std::fprintf(out, "WS2812 16x16 (%zu bytes per frame, budget 3 frames):\n", frameBytes);
+    led.SetWireCacheBudget(3 * frameBytes);
+
+    std::vector<std::uint32_t> expectWire((std::size_t)16 * 16);
+    bool ok = true;
+    for (const DriverStep& s : kDriverSteps) {
+        bool step = true;
+        if (s.op == 'S') {
+            // 送るはずの語列（ShowCached() は VRAM を使わないので、先に描画して求める）
+            drawFrame(led, s.frame);
+            led.EncodeWire(expectWire.data(), true, false);
+            led.Clear(0);
+
+            g_benchWireLog.words.clear();
+            g_benchWireLog.latches.clear();
+            g_benchWireLog.enabled = true;
+            const std::uint32_t key = 0x01000000u | (std::uint32_t)s.frame;
+            const bool hit = led.ShowCached(key, true, false);
+            if (!hit) {
+                led.Reset();
+                drawFrame(led, s.frame);
+                led.ScanBufferCached(key, true, false);
+            }
+            led.WaitTransmit();
+            g_benchWireLog.enabled = false;
+            step = hit == s.hit && g_benchWireLog.words == expectWire && g_benchWireLog.latches.size() == 1;
+        } else if (s.op == 'B') {
+            led.SetWireCacheBudget(s.budget < 0 ? 512 : (std::size_t)s.budget * frameBytes);
+        } else {
+            led.ClearWireCache();
+        }
+        ok = reportStats(out, s.name, led.GetWireCacheStats(), s.expect, frameBytes, step) && ok;
+    }
+    const bool peak = led.GetWireCacheStats().peakBytes == 3 * frameBytes;
+    std::fprintf(out, "  peak %zu bytes (3 frames) %s\n", led.GetWireCacheStats().peakBytes, peak ? "ok" : "MISMATCH");
+    return peak && ok;
+}
+
+/**
+ * @brief frameKey() が 256 枚を超えるパターン番号でも別のキーになるかを確かめます。
+ * @return 一致すれば true
+ */
+bool checkFrameKey(std::FILE* out)
+{
+    // 以前は番号の下位 8bit だけをキーにしていたため、44 と 300 が同じキーになっていた
+    std::set<std::uint64_t> keys;
+    const std::size_t kFrames = 1024;
+    for (std::size_t f = 0; f < kFrames; f++) {
+        keys.insert(frameKey(1, 0, 0, f, false, false));
+        keys.insert(frameKey(1, 0, f, (f + 1) % kFrames, true, false));
+        keys.insert(frameKey(1, 0, f, (f + 1) % kFrames, true, true));
+    }
+    keys.insert(frameKey(1, FRAME_KEY_STOP, 0, 0, false, false));
+    const bool ok = keys.size() == 3 * kFrames + 1 && frameKey(1, 0, 0, 300, false, false) != frameKey(1, 0, 0, 44, false, false);
+    std::fprintf(out, "frameKey: %zu distinct keys for %zu frames x 3 + stop %s\n", keys.size(), kFrames, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+bool runWireCacheCheck(std::FILE* out)
+{
+    bool ok = checkCache(out);
+    ok = checkDriver(out) && ok;
+    ok = checkFrameKey(out) && ok;
+    return ok;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file CheckWirePack.cpp
+ * @brief 送出データを 4ピクセル = 3語 に詰める形式（WirePack.h、WS2812::SetPackedWire）の確認
+ * @details
+ * - 確認: 1ピクセル1語の送出データの上位24bitを並べたビット列を32bitずつ区切った基準と、ビット単位で比べます。
+ */
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Checks.h"
+#include "HostShims.h"
+#include "WirePack.h"
+#include "WS2812.h"
+#include "WS2812Static.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/** @brief 基準: 各語の上位24bitを MSB から1bitずつ並べ、32bitごとに区切る（余りは0）。 */
+std::vector<std::uint32_t> refPack(const std::vector<std::uint32_t>& wire)
+{
+    std::vector<std::uint32_t> out;
+    std::uint32_t acc = 0, n = 0;
+    for (std::uint32_t w : wire) {
+        for (int b = 31; b >= 8; b--) {
+            acc = (acc << 1) | ((w >> b) & 1u);
+            if (++n == 32) {
+                out.push_back(acc);
+                acc = 0;
+                n = 0;
+            }
+        }
+    }
+    if (n) out.push_back(acc << (32 - n));
+    return out;
+}
+
+std::uint32_t wireHash(const std::vector<std::uint32_t>& wire)
+{
+    std::uint32_t h = 2166136261u;
+    for (std::uint32_t v : wire) h = (h ^ v) * 16777619u;
+    return h;
+}
+
+/** @brief wire_pack と WirePacker（1ピクセルずつ/行ごと）を端数を含む長さで比べる。 */
+bool checkPacker(std::FILE* out)
+{
+    bool ok = true;
+    for (std::size_t n = 0; n <= 37; n++) {
+        auto wire = makeData(n, (std::uint32_t)n + 1);
+        for (auto& w : wire) w <<= 8;
+        const auto want = refPack(wire);
+        std::vector<std::uint32_t> a(WIRE_PACK_WORDS(n) + 1, 0xDEADBEEFu), b = a, c = wire;
+        const std::size_t words = wire_pack(a.data(), wire.data(), n);
+        WirePacker pk;
+        pk.begin(b.data());
+        for (std::size_t i = 0; i < n; i += 5) pk.putRow(&wire[i], (std::uint32_t)std::min<std::size_t>(5, n - i)); // 行の長さが4の倍数でない場合
+        const std::size_t words2 = (std::size_t)(pk.finish() - b.data());
+        const std::size_t words3 = wire_pack(c.data(), c.data(), n); // 同じ領域へ上書き
+        const bool sizeOk = words == want.size() && words2 == want.size() && words3 == want.size() && a[words] == 0xDEADBEEFu;
+        const bool dataOk = std::equal(want.begin(), want.end(), a.begin()) && std::equal(want.begin(), want.end(), b.begin()) &&
+                            std::equal(want.begin(), want.end(), c.begin());
+        if (!sizeOk || !dataOk) {
+            std::fprintf(out, "wire_pack n=%zu MISMATCH\n", n);
+            ok = false;
+        }
+    }
+    std::fprintf(out, "wire_pack / WirePacker, 0..37 pixels, in place %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief WS2812 の EncodeWire/ScanBuffer/ScanPanel/ScanBufferCached を詰める形式で比べる。 */
+bool checkLayout(std::FILE* out, uint8_t xs, uint8_t ys, uint8_t xp, uint8_t yp, bool serpentine, bool leftToRight, bool calibrated)
+{
+    WS2812 led(22, xs, ys, xp, yp);
+    const std::size_t pixels = (std::size_t)led.xVRam * led.yVRam;
+    const auto data = makeData(pixels, xs * 13u + yp);
+    std::copy(data.begin(), data.end(), led.pVRam);
+    std::vector<LedColorMatrix> m((std::size_t)xp * yp);
+    for (std::size_t i = 0; i < m.size(); i++) {
+        ledcal_matrix_identity(m[i]);
+        m[i].m[1] = (int16_t)(100 * i); // パネルごとに少し違う行列
+    }
+    std::vector<std::uint8_t> gain(pixels);
+    for (std::size_t i = 0; i < pixels; i++) gain[i] = (std::uint8_t)(255 - i % 64);
+    if (calibrated) led.SetCalibration(m.data(), gain.data());
+
+    std::vector<std::uint32_t> wire(pixels);
+    led.EncodeWire(wire.data(), serpentine, leftToRight);
+    const auto want = refPack(wire);
+
+    led.SetPackedWire(true);
+    bool ok = led.WireWords() == want.size();
+    std::vector<std::uint32_t> got(pixels, 0xDEADBEEFu);
+    led.EncodeWire(got.data(), serpentine, leftToRight);
+    ok = std::equal(want.begin(), want.end(), got.begin()) && (want.size() == pixels || got[want.size()] == 0xDEADBEEFu) && ok;
+
+    // FIFO: ScanBuffer と、パネルごとの ScanPanel + Reset（端数はパネルをまたいで続く）
+    const std::uint64_t w0 = g_benchSink.fifoWords;
+    g_benchSink.hash = 2166136261u;
+    led.ScanBuffer(serpentine, leftToRight);
+    ok = g_benchSink.hash == wireHash(want) && g_benchSink.fifoWords - w0 == want.size() && ok;
+    g_benchSink.hash = 2166136261u;
+    for (int y = 0; y < yp; y++)
+        for (int x = 0; x < xp; x++) led.ScanPanel((uint8_t)(x * xs), (uint8_t)(y * ys), serpentine, leftToRight);
+    led.Reset();
+    ok = g_benchSink.hash == wireHash(want) && ok;
+
+    // DMA: 語数が 3/4
+    const std::uint64_t d0 = g_benchSink.dmaWords;
+    led.ScanBufferCached(7, serpentine, leftToRight);
+    ok = g_benchSink.dmaWords - d0 == want.size() && ok;
+
+    led.SetPackedWire(false);
+    ok = !led.ShowCached(7, serpentine, leftToRight) && ok; // 形式を変えたらキャッシュは使わない
+    std::fprintf(out, "packed %2ux%-2u panels %ux%u serpentine=%d leftToRight=%d calibrated=%d words %zu -> %zu %s\n", xs, ys, xp, yp,
+                 serpentine, leftToRight, calibrated, pixels, want.size(), ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+/** @brief WS2812Static でも基底と同じ詰め方か。 */
+bool checkStatic(std::FILE* out)
+{
+    typedef WS2812Static<8, 5, 3, 2, WS2812SerpentineLR> Led;
+    std::unique_ptr<Led> s(new Led(22));
+    const auto data = makeData(Led::kPixels, 31);
+    std::copy(data.begin(), data.end(), s->pVRam);
+    std::vector<std::uint32_t> wire(Led::kPixels);
+    s->EncodeWire(wire.data());
+    const auto want = refPack(wire);
+    s->SetPackedWire(true);
+    std::vector<std::uint32_t> got(Led::kPixels);
+    s->EncodeWire(got.data());
+    const std::uint64_t d0 = g_benchSink.dmaWords;
+    s->ScanBuffer();
+    const bool ok = std::equal(want.begin(), want.end(), got.begin()) && g_benchSink.dmaWords - d0 == want.size();
+    std::fprintf(out, "WS2812Static packed matches %s\n", ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief 詰めた送出データを基準と比べます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ */
+bool runWirePackCheck(std::FILE* out)
+{
+    bool ok = checkPacker(out);
+    ok = checkLayout(out, 16, 16, 1, 1, false, true, false) && ok;
+    ok = checkLayout(out, 16, 16, 2, 2, true, false, false) && ok;
+    ok = checkLayout(out, 16, 16, 2, 2, true, false, true) && ok;
+    ok = checkLayout(out, 8, 5, 3, 2, true, true, false) && ok;
+    ok = checkLayout(out, 7, 3, 2, 3, true, false, true) && ok;   // 1パネル21ピクセル（語の境界がパネルの途中）
+    ok = checkLayout(out, 5, 1, 1, 1, false, false, false) && ok;  // 端数だけのフレーム
+    ok = checkLayout(out, 40, 2, 1, 1, true, true, true) && ok;    // 32ピクセルより長い行
+    ok = checkStatic(out) && ok;
+    return ok;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file CheckWs2812Static.cpp
+ * @brief パネル構成をコンパイル時に決めた WS2812Static と、実行時の WS2812 の比較
+ * @details
+ * - 確認: 配線3種とパネル構成（奇数行・複数パネル）を変え、描画（はみ出しを含む）と送出データが WS2812 と一致することを確かめます。
+ */
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+#include "Checks.h"
+#include "WS2812Static.h"
+
+namespace {
+
+/** @brief 約1/3が黒のテストデータ。 */
+std::vector<std::uint32_t> makeData(std::size_t pixels, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> v(pixels);
+    for (auto& px : v) px = rng() % 3 == 0 ? 0u : (rng() & 0xFFFFFFu);
+    return v;
+}
+
+/** @brief 同じ描画を WS2812 と WS2812Static に行い、VRAM と送出データを比べます。 */
+template <uint8_t X, uint8_t Y, uint8_t PX, uint8_t PY, class Layout>
+bool checkLayout(std::FILE* out, const char* name)
+{
+    typedef WS2812Static<X, Y, PX, PY, Layout> Led;
+    std::unique_ptr<Led> fixed(new Led(22));
+    WS2812 dynamic(22, X, Y, PX, PY);
+    const std::size_t pixels = Led::kPixels;
+    const auto sprite = makeData(5 * 7, 7);
+    const auto frame = makeData(pixels, 8);
+
+    // 全面に描いてから、はみ出しを含む位置へ重ねる
+    for (uint32_t y = 0; y < Led::kHeight; y++) {
+        for (uint32_t x = 0; x < Led::kWidth; x++) {
+            fixed->SetPixel((uint16_t)x, (uint16_t)y, frame[y * Led::kWidth + x]);
+            dynamic.SetPixel((uint16_t)x, (uint16_t)y, frame[y * Led::kWidth + x]);
+        }
+    }
+    const uint8_t pos[][2] = {{0, 0}, {1, 2}, {(uint8_t)(Led::kWidth - 3), 1}, {2, (uint8_t)(Led::kHeight - 4)}, {(uint8_t)Led::kWidth, 0}};
+    int n = 0;
+    for (const auto& p : pos) {
+        const uint32_t replace = (n % 3 == 2) ? 0x070000u : 0u;
+        const bool overlay = (n % 2) == 1;
+        fixed->DrawBuffer(sprite.data(), 5, 7, p[0], p[1], replace, overlay);
+        dynamic.DrawBuffer(sprite.data(), 5, 7, p[0], p[1], replace, overlay);
+        fixed->template DrawSprite<5, 7>(sprite.data(), (uint8_t)(p[1] % Led::kWidth), (uint8_t)(p[0] % Led::kHeight), replace, !overlay);
+        dynamic.DrawBuffer(sprite.data(), 5, 7, (uint8_t)(p[1] % Led::kWidth), (uint8_t)(p[0] % Led::kHeight), replace, !overlay);
+        n++;
+    }
+    fixed->SetPixel(Led::kWidth, 0, 0xFFFFFF); // 範囲外は無視
+    bool ok = true;
+    for (std::size_t i = 0; i < pixels; i++) ok = ok && fixed->pVRam[i] == dynamic.pVRam[i];
+
+    std::vector<std::uint32_t> a(pixels), b(pixels);
+    fixed->EncodeWire(a.data());
+    dynamic.EncodeWire(b.data(), Layout::serpentine, Layout::leftToRight);
+    ok = ok && a == b;
+    fixed->Clear(0x123456);
+    dynamic.Clear(0x123456);
+    for (std::size_t i = 0; i < pixels; i++) ok = ok && fixed->pVRam[i] == dynamic.pVRam[i];
+
+    std::fprintf(out, "%-14s panel=%ux%u panels=%ux%u %s\n", name, X, Y, PX, PY, ok ? "ok" : "MISMATCH");
+    return ok;
+}
+
+} // namespace
+
+/**
+ * @brief WS2812Static と WS2812 の描画と送出データを比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すればtrue
+ */
+bool runWs2812StaticCheck(std::FILE* out)
+{
+    bool ok = true;
+    ok = checkLayout<16, 16, 1, 1, WS2812Progressive>(out, "progressive") && ok;
+    ok = checkLayout<16, 16, 1, 1, WS2812SerpentineLR>(out, "serpentine-lr") && ok;
+    ok = checkLayout<16, 16, 1, 1, WS2812SerpentineRL>(out, "serpentine-rl") && ok;
+    ok = checkLayout<16, 16, 2, 2, WS2812SerpentineRL>(out, "serpentine-rl") && ok;
+    ok = checkLayout<8, 5, 3, 2, WS2812SerpentineLR>(out, "serpentine-lr") && ok;
+    ok = checkLayout<7, 3, 2, 3, WS2812SerpentineRL>(out, "serpentine-rl") && ok;
+    ok = checkLayout<8, 8, 4, 1, WS2812Progressive>(out, "progressive") && ok;
+    return ok;
+}
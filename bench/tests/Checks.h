@@ -0,0 +1,192 @@
+/**
+ * @file Checks.h
+ * @brief ホスト用テスト（LGMSerialLED_hosttest）の確認
+ * @details 各確認は結果を out へ出力し、すべて期待どおりなら true を返します。CheckMain.cpp が名前で呼び分け、ctest が1つずつ実行します。
+ *          runPixelOpsCheck() は実機用ベンチマーク（bench/device）からも呼びます。
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief 送出フレームの形（スタート/LED/エンド）と、5bit輝度を使った変換の誤差と階調数を確かめて出力します。
+ * @param out 出力先
+ * @return すべて期待どおりならtrue
+ */
+bool runApa102Check(std::FILE* out);
+
+/**
+ * @brief 焼き込み済みのテーブルと実行時の補正の結果を、以前の PatManager の浮動小数点のLUTで補正した結果と比べます。
+ * @param out 出力先
+ * @return キャラクタの補正結果がすべて一致し、LUTの違いが記録した範囲内なら true
+ * @details
+ * - キャラクタ: 5キャラクタの停止/全グループのフレームを、焼き込み済み・実行時（整数のLUT）・以前の浮動小数点の3通りで比べます。
+ * - LUT: レンジ（min/max の全組）、明度/コントラスト（-100..100 の全組）、ガンマ 1.0 について、整数のLUTと以前の浮動小数点のLUTの違いを数えます。
+ *   明度/コントラストは、ちょうど .5 になる値の丸めが浮動小数点の誤差で変わる所だけが 1 違います（FMA で融合した場合も数えます）。
+ */
+bool runBakedCheck(std::FILE* out);
+
+/**
+ * @brief フラッシュの起動フレームが最初のキャラクタの停止表示と一致するかを確かめ、起動の各段階の時刻の見積もりを出力します。
+ * @param out 出力先
+ * @return 一致すれば true
+ * @details 時刻は、ホストで測った CPU 時間に sleep_us で待つはずだった時間（リセットラッチ等）を足したものです。
+ */
+bool runBootCheck(std::FILE* out);
+
+/**
+ * @brief 色補正の精度と、LEDの物理順（パネル・千鳥配線）への対応を確かめて出力します。
+ * @param out 出力先
+ * @return すべて許容範囲なら true
+ * @details 固定小数点の結果を倍精度の計算（実数の行列、明るさ gain/255）と比べて誤差 1 以下か、
+ *          単位行列・等倍で素通しか、EncodeWire と ScanBuffer（FIFO）と WS2812Static の送出内容が一致するかを見ます。
+ */
+bool runCalibrationCheck(std::FILE* out);
+
+/**
+ * @brief 仮想時計でスクリプトを動かし、再開の順序と時刻を期待値と比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details 遅延/フレーム/イベント待ち（タイムアウト付き）の並行動作、入れ子の待ち、cancel()、フレームプールの枯渇、
+ *          1ms ごとに run() する場合と nextWake() の時刻だけ run() する場合の一致、時刻(ms)の一周を確かめます。
+ */
+bool runCoroCheck(std::FILE* out);
+
+/**
+ * @brief 同じ描画を、変化したLEDまでだけ送るドライバとすべて送るドライバで行い、LEDの状態が一致するかを確かめます。
+ * @param out 出力先
+ * @return すべてのフレームで一致し、送らないはずのフレームを送っていなければ true
+ * @details LEDの状態は、FIFO/DMA へ送った語とリセットラッチの記録（g_benchWireLog）から、LEDが先頭から24bitずつ受け取るものとして求めます。
+ *          パネルの行ごとに送る VRAM（64x64）の場合と、VRAMの高さによらず送出用の作業領域（WS2812::WireBufferBytes）が上限以内であることも確かめます。
+ */
+bool runDeltaCheck(std::FILE* out);
+
+/**
+ * @brief イベントキューの満杯と一周、デバウンスの判定、停止/再始動したタイマーのイベントの破棄を確かめます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details AppEvents は仮想時計とアラーム/GPIOの代替（bench/host）で動かすため、時刻は実行環境によらず決まります。
+ */
+bool runEventsCheck(std::FILE* out);
+
+/**
+ * @brief パネルの大きさ/ビット深度ごとのリフレッシュレートとCPU負荷を出力し、ビットプレーンを模擬走査で確かめます。
+ * @param out 出力先
+ * @param sysHz clk_sys(Hz)
+ * @return すべての模擬走査が VRAM と一致すればtrue
+ * @details 模擬走査は PIO（データSM/行SM）と同じ順で制御語とビットプレーンを読み、
+ *          各LEDの点灯時間の合計と1フレームのサイクル数を求めて、VRAM と hub75_calc_timing() の結果と比べます。
+ */
+bool runHub75Report(std::FILE* out, std::uint32_t sysHz);
+
+/**
+ * @brief 幅/高さが255を超えるVRAMとパネル、VRAMからはみ出すパターン、16x16 でないキャラクタの表示を基準と比べます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details 送出データは FIFO/DMA へ送った語の記録（g_benchWireLog）と、VRAMから1ピクセルずつ求めた語列を比べます。
+ */
+bool runLargeCheck(std::FILE* out);
+
+/**
+ * @brief px_* / swar:: の各カーネルを pixelops::ref と比べます。
+ * @param out 出力先
+ * @return すべてビット単位で一致すれば true
+ * @details
+ * - 2入力の演算（飽和加算/減算・平均・最大）: 各レーンについて 256x256 の全組を、ほかのレーンを乱数にして比べます。
+ * - アルファ倍: 全値 x アルファ 0..256。ブレンド: 全組 x 代表的なアルファ（0, 1, 16刻み, 255, 256）。合計: 全値の各レーン。
+ * - 乱数の語とアルファでの比較、バッファ版（px_*_buffer）と ref のループの比較も行います。
+ * - ホスト以外（実機用ベンチマーク）でも同じ関数を呼ぶため、RP2350 では DSP 命令の経路を確かめられます。出力の先頭に経路（DSP/SWAR）を出します。
+ */
+bool runPixelOpsCheck(std::FILE* out);
+
+/**
+ * @brief 休止の状態機械の遷移と統計、PowerManager::hibernate() の手順を確かめます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details hibernate() は既定のビルド（LGM_HAVE_PICO_SLEEP なし）の XOSC+WFE の経路を、仮想時計とクロック/PLL/GPIO の代替（bench/host）で動かします。
+ *          DORMANT の経路（pico-extras）はホストでは確かめられません。
+ */
+bool runPowerCheck(std::FILE* out);
+
+/**
+ * @brief 仮想時計で AnimSequencer を動かし、選んだフレームと歩き/走り/グループの切り替え時刻を、以前の実装の模擬と比べます。
+ * @param out 出力先
+ * @return すべてのキャラクタで一致（許容範囲内）すれば true
+ * @details
+ * 以前の実装は、10秒周期のタイマー割り込みで回数を数え、フレームの先頭で「前のパターンと重ねた表示 → パターン表示」を sleep_ms で待つループでした。
+ * 模擬はこのループを1ms単位の時刻で再現します（タイマーとフレームの先頭が同じ時刻なら、タイマーが先）。
+ */
+bool runSequencerCheck(std::FILE* out);
+
+/**
+ * @brief キャラクタ切り替え（PatCache::acquire/prefetch）を繰り返し、ヒープの確保回数と使ったアドレスの範囲を出力します。
+ * @param out 出力先
+ * @param switches 切り替え回数
+ * @return アリーナ使用時にヒープを使わず、内容とアドレスの範囲が期待どおりならtrue
+ * @details 同じ切り替え順で、ヒープ（reserveArena() なし）とアリーナの2通りを実行します。
+ */
+bool runPatSoak(std::FILE* out, unsigned long switches);
+
+/**
+ * @brief 変形描画の結果を基準画像と比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すればtrue
+ * @details 等倍（DrawBuffer と同じ結果、はみ出しを含む）、整数倍（ピクセルの複製）、90°単位の回転（並べ替え）はビット単位で、
+ *          小数倍と任意角は倍精度の逆変換で求めた最近傍と比べます（ピクセルの境界ちょうどの位置は除く）。
+ */
+bool runSpriteCheck(std::FILE* out);
+
+/**
+ * @brief ファイルへ書き出してメモリへ読み取り専用で割り付けたフィルム（フラッシュの代わり）を再生し、元のフレームと一致するかを確かめます。
+ * @param out 出力先
+ * @return すべて一致し、先読みの統計が期待どおりなら true
+ * @details リングの大きさがフレーム数によらないこと、壊れた先頭を開かないこと、焼き込み済みのパターンを openRaw() で開けることも確かめます。
+ */
+bool runStreamCheck(std::FILE* out);
+
+/**
+ * @brief タイルマップの描画を基準画像と比べ、画像から作ったタイルマップが元の画像に戻るかを確かめます。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details 基準は、マップ全体を1ピクセルずつ展開した画像をスクロール位置から一周させて切り出したものです。
+ *          決まった背景（街並み）を描いた結果のハッシュも固定値と比べ、画像とタイルマップのバイト数を出力します。
+ */
+bool runTileMapCheck(std::FILE* out);
+
+/**
+ * @brief clk_sys が 150MHz・48MHz・XOSC(12MHz) のとき、ws2812_calc_timing() の分周で T0H/T1H/T0L/T1L と1bitの周期が WS2812 の許容範囲に収まるかを確かめます。
+ * @param out 出力先
+ * @return すべて収まれば true
+ * @details 小数分周では各区間が clk_sys 1周期分だけ前後するため、その揺らぎ（jitterNs）を含めた最小/最大で判定します。
+ *          分周器の範囲外の clk_sys では、WS2812::UpdateClock()/Resume() が false を返し、最後に求めた分周のままであることも確かめます。
+ */
+bool runTimingCheck(std::FILE* out);
+
+/**
+ * @brief 決まったフレームの列を送出し、ヒット/ミス/追い出しの回数と保持しているバイト数を1手順ごとに期待値と比べます。
+ * @param out 出力先
+ * @return すべての手順で一致すれば true
+ * @details
+ * - WireCache 単体: タグの区別、同じキーの置き換え、上限を超える登録の拒否、フレーム数の上限（WIRECACHE_MAX_ENTRIES）での追い出し。
+ * - WS2812: 停止表示と歩行の3フレームを、上限3フレームで表示します（2周目はヒット、停止表示を挟むとLRUで追い出しが続く）。
+ *   上限の変更、ClearWireCache()、1フレームに満たない上限（登録せずに送出）も含みます。
+ *   送った語（g_benchWireLog）も、そのフレームを EncodeWire() した語列と比べます。
+ * - frameKey(): 256 枚を超えるパターン番号でもキーが重ならないこと。
+ */
+bool runWireCacheCheck(std::FILE* out);
+
+/**
+ * @brief 詰めた送出データを、1ピクセル1語の送出データのビット列から作った基準と比べて出力します。
+ * @param out 出力先
+ * @return すべて一致すれば true
+ * @details ピクセル数の端数（4の倍数以外）、配線とパネル構成、色補正、FIFO（ScanBuffer/ScanPanel+Reset）と DMA の語数、WS2812Static を確かめます。
+ */
+bool runWirePackCheck(std::FILE* out);
+
+/**
+ * @brief WS2812Static の描画と送出データが WS2812 と一致することを、配線とパネル構成を変えて確かめて出力します。
+ * @param out 出力先
+ * @return すべて一致すればtrue
+ */
+bool runWs2812StaticCheck(std::FILE* out);